@@ -0,0 +1,108 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "Maths.h"
+#include "MathArray.h"
+#include "MathExpression.h"
+
+namespace GALAXY::Math
+{
+	// Full local transform of a bone at one time, the three channels of a key are read together
+	struct Keyframe
+	{
+		float time = 0.f;
+		Vec3f translation;
+		Quat rotation;
+		Vec3f scale = Vec3f(1.f);
+	};
+
+	// Tracks of keyframes stored one after the other in a single array, the keys of every track sorted by time
+	class AnimationClip
+	{
+	public:
+		// Index of the new track, keys are sorted by time and a track without keys gets the identity
+		inline size_t AddTrack(std::span<const Keyframe> keys);
+
+		inline size_t GetTrackCount() const { return offsets.size() - 1; }
+
+		inline std::span<const Keyframe> GetTrack(size_t track) const;
+
+		// Time of the last key of the longest track
+		inline float GetDuration() const { return duration; }
+
+	private:
+		std::vector<Keyframe> keys;
+		std::vector<uint32_t> offsets = { 0 };
+		float duration = 0.f;
+	};
+
+	// Local transforms of many bones as one array per component
+	class TransformSoA
+	{
+	public:
+		explicit inline TransformSoA(size_t count = 0);
+
+		inline size_t GetSize() const { return translation.GetSize(); }
+
+		inline void Resize(size_t count);
+
+		inline Quat GetRotation(size_t index) const;
+
+		inline Mat4 GetMatrix(size_t index) const;
+
+		inline void GetMatrices(std::span<Mat4> output) const;
+
+		Vec3SoA<float> translation;
+		MathArray<float> rotationX, rotationY, rotationZ, rotationW;
+		Vec3SoA<float> scale;
+	};
+
+	enum class Interpolation
+	{
+		// Normalized linear blend of the rotations, the cheapest and the usual choice between close keys
+		NLerp,
+		// Constant angular speed: NLerp with the blend weight corrected by a polynomial in the angle between keys
+		SLerp,
+	};
+
+	// Samples every track of a clip at once. Each track remembers the key it was last sampled at,
+	// so playing forward finds the next keys in constant time and only a jump back searches the track.
+	class AnimationSampler
+	{
+	public:
+		explicit inline AnimationSampler(const AnimationClip& clip);
+
+		// One transform per track into output, times outside a track hold its first or last key.
+		// Tracks added to the clip after the sampler was built are sampled too
+		inline void Sample(float time, TransformSoA& output, Interpolation interpolation = Interpolation::NLerp);
+
+		inline void Reset();
+
+	private:
+		enum Column : size_t
+		{
+			FromTranslation = 0, FromRotation = 3, FromScale = 7,
+			ToTranslation = 10, ToRotation = 13, ToScale = 17,
+			Weight = 20, ColumnCount = 21
+		};
+
+		// Tracks gathered and blended together, the staging columns of a block stay in L1
+		static constexpr size_t BlockSize = 64;
+
+		typedef float Block[ColumnCount][BlockSize];
+
+		// Index of the last key at or before time
+		inline uint32_t Seek(size_t track, float time);
+
+		// Translation, rotation and scale of key into the ten columns from column
+		static inline void Stage(Block& block, size_t column, size_t lane, const Keyframe& key);
+
+		const AnimationClip* clip;
+		std::vector<uint32_t> cursors;
+	};
+}
+
+#include "MathAnimation.inl"
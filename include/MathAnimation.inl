@@ -0,0 +1,197 @@
+#pragma once
+#include <algorithm>
+
+#include "MathAnimation.h"
+
+namespace GALAXY::Math
+{
+#pragma region AnimationClip
+	inline size_t AnimationClip::AddTrack(std::span<const Keyframe> trackKeys)
+	{
+		const size_t begin = keys.size();
+		if (trackKeys.empty())
+			keys.push_back(Keyframe());
+		else
+			keys.insert(keys.end(), trackKeys.begin(), trackKeys.end());
+		std::stable_sort(keys.begin() + begin, keys.end(), [](const Keyframe& a, const Keyframe& b) { return a.time < b.time; });
+		offsets.push_back(static_cast<uint32_t>(keys.size()));
+		duration = std::max(duration, keys.back().time);
+		return offsets.size() - 2;
+	}
+
+	inline std::span<const Keyframe> AnimationClip::GetTrack(size_t track) const
+	{
+		return std::span<const Keyframe>(keys.data() + offsets[track], offsets[track + 1] - offsets[track]);
+	}
+#pragma endregion
+
+#pragma region TransformSoA
+	inline TransformSoA::TransformSoA(size_t count)
+	{
+		Resize(count);
+	}
+
+	inline void TransformSoA::Resize(size_t count)
+	{
+		translation.Resize(count);
+		rotationX.resize(count, 0.f);
+		rotationY.resize(count, 0.f);
+		rotationZ.resize(count, 0.f);
+		rotationW.resize(count, 1.f);
+		scale.Resize(count, Vec3f(1.f));
+	}
+
+	inline Quat TransformSoA::GetRotation(size_t index) const
+	{
+		return Quat(rotationX[index], rotationY[index], rotationZ[index], rotationW[index]);
+	}
+
+	inline Mat4 TransformSoA::GetMatrix(size_t index) const
+	{
+		return Mat4::CreateTransformMatrix(translation.Get(index), GetRotation(index), scale.Get(index));
+	}
+
+	inline void TransformSoA::GetMatrices(std::span<Mat4> output) const
+	{
+		MATH_INSTRUMENT_SCOPE("TransformSoA::GetMatrices(span)");
+		MATH_INSTRUMENT_ITEMS(output.size());
+		for (size_t i = 0; i < output.size(); i++)
+			output[i] = GetMatrix(i);
+	}
+#pragma endregion
+
+#pragma region AnimationSampler
+	inline AnimationSampler::AnimationSampler(const AnimationClip& _clip) : clip(&_clip), cursors(_clip.GetTrackCount(), 0)
+	{
+	}
+
+	inline void AnimationSampler::Reset()
+	{
+		std::fill(cursors.begin(), cursors.end(), 0u);
+	}
+
+	inline uint32_t AnimationSampler::Seek(size_t track, float time)
+	{
+		const std::span<const Keyframe> keys = clip->GetTrack(track);
+		uint32_t key = cursors[track];
+		if (key < keys.size() && keys[key].time <= time)
+		{
+			// Playing forward, usually zero or one step
+			while (key + 1 < keys.size() && keys[key + 1].time <= time)
+				key++;
+		}
+		else
+		{
+			const auto next = std::upper_bound(keys.begin(), keys.end(), time, [](float t, const Keyframe& k) { return t < k.time; });
+			key = next == keys.begin() ? 0 : static_cast<uint32_t>(next - keys.begin() - 1);
+		}
+		cursors[track] = key;
+		return key;
+	}
+
+	inline void AnimationSampler::Stage(Block& block, size_t column, size_t lane, const Keyframe& key)
+	{
+		const float values[10] = { key.translation.x, key.translation.y, key.translation.z,
+			key.rotation.x, key.rotation.y, key.rotation.z, key.rotation.w, key.scale.x, key.scale.y, key.scale.z };
+		for (size_t c = 0; c < 10; c++)
+			block[column + c][lane] = values[c];
+	}
+
+	inline void AnimationSampler::Sample(float time, TransformSoA& output, Interpolation interpolation)
+	{
+		using namespace Expression;
+		MATH_INSTRUMENT_SCOPE("AnimationSampler::Sample(float, TransformSoA, Interpolation)");
+		const size_t count = clip->GetTrackCount();
+		MATH_INSTRUMENT_ITEMS(count);
+		if (output.GetSize() != count)
+			output.Resize(count);
+		// Tracks added to the clip since the last call start from their first key
+		if (cursors.size() != count)
+			cursors.resize(count, 0);
+
+		float* outputs[10] = { output.translation.x.data(), output.translation.y.data(), output.translation.z.data(),
+			output.rotationX.data(), output.rotationY.data(), output.rotationZ.data(), output.rotationW.data(),
+			output.scale.x.data(), output.scale.y.data(), output.scale.z.data() };
+		constexpr size_t pack = PackSize<float>;
+		static_assert(BlockSize % pack == 0, "A block is a whole number of packs");
+		const Pack<float> one = BroadcastPack(1.f);
+		alignas(32) Block block;
+		for (size_t begin = 0; begin < count; begin += BlockSize)
+		{
+			// Gather the two keys around time of every track of the block into columns
+			const size_t size = std::min(BlockSize, count - begin);
+			for (size_t lane = 0; lane < size; lane++)
+			{
+				const std::span<const Keyframe> keys = clip->GetTrack(begin + lane);
+				const uint32_t key = Seek(begin + lane, time);
+				const Keyframe& from = keys[key];
+				const Keyframe& to = keys[std::min<size_t>(key + 1, keys.size() - 1)];
+				const float length = to.time - from.time;
+				block[Weight][lane] = length > 0.f ? std::clamp((time - from.time) / length, 0.f, 1.f) : 0.f;
+				Stage(block, FromTranslation, lane, from);
+				Stage(block, ToTranslation, lane, to);
+			}
+			// The lanes after the last track blend identity transforms, they are computed with the rest and never stored
+			for (size_t lane = size; lane < (size + pack - 1) / pack * pack; lane++)
+			{
+				Stage(block, FromTranslation, lane, Keyframe());
+				Stage(block, ToTranslation, lane, Keyframe());
+				block[Weight][lane] = 0.f;
+			}
+
+			// Blend PackSize tracks at a time, a partial last pack goes through a temporary
+			for (size_t i = 0; i < size; i += pack)
+			{
+				auto load = [&](size_t column) { return LoadPack(block[column] + i); };
+				auto store = [&](size_t component, const Pack<float>& value)
+				{
+					float* destination = outputs[component] + begin + i;
+					if (i + pack <= size)
+						StorePack(destination, value);
+					else
+					{
+						float lanes[pack];
+						StorePack(lanes, value);
+						std::copy(lanes, lanes + (size - i), destination);
+					}
+				};
+
+				Pack<float> weight = load(Weight);
+				for (size_t c = 0; c < 3; c++)
+				{
+					const Pack<float> fromTranslation = load(FromTranslation + c), fromScale = load(FromScale + c);
+					store(c, fromTranslation + (load(ToTranslation + c) - fromTranslation) * weight);
+					store(7 + c, fromScale + (load(ToScale + c) - fromScale) * weight);
+				}
+
+				Pack<float> from[4], to[4];
+				for (size_t c = 0; c < 4; c++)
+				{
+					from[c] = load(FromRotation + c);
+					to[c] = load(ToRotation + c);
+				}
+				// Shortest arc: the second key is negated where the dot product is negative, which also makes it positive
+				const Pack<float> sign = CopySignPack(one, from[0] * to[0] + from[1] * to[1] + from[2] * to[2] + from[3] * to[3]);
+				for (size_t c = 0; c < 4; c++)
+					to[c] = to[c] * sign;
+				if (interpolation == Interpolation::SLerp)
+				{
+					// Kapoulkine's fit of the slerp weight as a function of the weight and the cosine between keys, within 5e-4 rad
+					const Pack<float> d = from[0] * to[0] + from[1] * to[1] + from[2] * to[2] + from[3] * to[3];
+					const Pack<float> ca = BroadcastPack(1.0904f) + d * (BroadcastPack(-3.2452f) + d * (BroadcastPack(3.55645f) - d * BroadcastPack(1.43519f)));
+					const Pack<float> cb = BroadcastPack(0.848013f) + d * (BroadcastPack(-1.06021f) + d * BroadcastPack(0.215638f));
+					const Pack<float> centered = weight - BroadcastPack(0.5f);
+					const Pack<float> k = ca * centered * centered + cb;
+					weight = weight + weight * centered * (weight - one) * k;
+				}
+				Pack<float> blended[4];
+				for (size_t c = 0; c < 4; c++)
+					blended[c] = from[c] + (to[c] - from[c]) * weight;
+				const Pack<float> inverseLength = one / SqrtPack(blended[0] * blended[0] + blended[1] * blended[1] + blended[2] * blended[2] + blended[3] * blended[3]);
+				for (size_t c = 0; c < 4; c++)
+					store(3 + c, blended[c] * inverseLength);
+			}
+		}
+	}
+#pragma endregion
+}
@@ -0,0 +1,140 @@
+#pragma once
+#include <cstddef>
+#include <new>
+#include <span>
+#include <vector>
+
+#include "Maths.h"
+
+namespace GALAXY::Math
+{
+	// Allocator returning memory aligned on Alignment bytes, so batch kernels can stream full cache lines.
+	template<typename T, size_t Alignment = 64>
+	class AlignedAllocator
+	{
+	public:
+		static_assert(Alignment >= alignof(T) && (Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two");
+
+		typedef T value_type;
+
+		template<typename U>
+		struct rebind { typedef AlignedAllocator<U, Alignment> other; };
+
+		inline constexpr AlignedAllocator() noexcept {}
+
+		template<typename U>
+		inline constexpr AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+		inline T* allocate(size_t count);
+
+		inline void deallocate(T* pointer, size_t count) noexcept;
+
+		template<typename U>
+		inline constexpr bool operator==(const AlignedAllocator<U, Alignment>&) const noexcept { return true; }
+	};
+
+	// Bump allocator for temporary batches, memory is only given back by Reset.
+	// An arena is not thread safe, use one per job thread (see ThreadLocal).
+	class FrameArena
+	{
+	public:
+		explicit inline FrameArena(size_t blockSize = 1 << 20);
+
+		inline ~FrameArena();
+
+		FrameArena(const FrameArena&) = delete;
+		FrameArena& operator=(const FrameArena&) = delete;
+
+		inline void* Allocate(size_t size, size_t alignment);
+
+		// Makes all the memory available again in O(1), blocks are kept for the next frame.
+		inline void Reset();
+
+		// Bytes handed out since the last Reset, alignment padding included.
+		inline size_t GetUsedSize() const;
+
+		// Bytes owned by the arena across all of its blocks.
+		inline size_t GetCapacity() const;
+
+		// Arena of the calling thread, each thread resets its own one at the start of a frame.
+		static inline FrameArena& ThreadLocal();
+
+	private:
+		struct Block
+		{
+			std::byte* data = nullptr;
+			size_t size = 0;
+			Block* next = nullptr;
+		};
+
+		inline Block* CreateBlock(size_t size);
+
+		size_t blockSize;
+		Block* first = nullptr;
+		Block* current = nullptr;
+		size_t offset = 0;
+		size_t used = 0;
+	};
+
+	// std allocator on top of a FrameArena, deallocate does nothing.
+	template<typename T, size_t Alignment = 64>
+	class ArenaAllocator
+	{
+	public:
+		typedef T value_type;
+
+		template<typename U>
+		struct rebind { typedef ArenaAllocator<U, Alignment> other; };
+
+		inline ArenaAllocator(FrameArena& _arena = FrameArena::ThreadLocal()) noexcept : arena(&_arena) {}
+
+		template<typename U>
+		inline ArenaAllocator(const ArenaAllocator<U, Alignment>& other) noexcept : arena(other.arena) {}
+
+		inline T* allocate(size_t count);
+
+		inline void deallocate(T*, size_t) noexcept {}
+
+		template<typename U>
+		inline bool operator==(const ArenaAllocator<U, Alignment>& other) const noexcept { return arena == other.arena; }
+
+		FrameArena* arena;
+	};
+
+	// Contiguous array for batch APIs, converts to std::span like any vector.
+	template<typename T, typename Alloc = AlignedAllocator<T, 64>>
+	using MathArray = std::vector<T, Alloc>;
+
+	// Per frame temporary array, reserve up front: growing leaves the old storage in the arena until Reset.
+	template<typename T>
+	using FrameArray = MathArray<T, ArenaAllocator<T>>;
+
+	// Vec3 stream stored as one array per component, so each component is a contiguous stream for SIMD loops.
+	template<typename T>
+	class Vec3SoA
+	{
+	public:
+		inline Vec3SoA() = default;
+
+		explicit inline Vec3SoA(size_t count, const Vec3<T>& value = Vec3<T>());
+
+		explicit inline Vec3SoA(std::span<const Vec3<T>> values);
+
+		inline size_t GetSize() const;
+
+		inline void Resize(size_t count, const Vec3<T>& value = Vec3<T>());
+
+		inline Vec3<T> Get(size_t index) const;
+
+		inline void Set(size_t index, const Vec3<T>& value);
+
+		// Interleaves the components back into output
+		inline void Store(std::span<Vec3<T>> output) const;
+
+		MathArray<T> x;
+		MathArray<T> y;
+		MathArray<T> z;
+	};
+}
+
+#include "MathArray.inl"
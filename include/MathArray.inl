@@ -0,0 +1,160 @@
+#include <algorithm>
+#include <cstdint>
+
+#include "MathArray.h"
+
+namespace GALAXY::Math {
+#pragma region AlignedAllocator
+	template<typename T, size_t Alignment>
+	inline T* AlignedAllocator<T, Alignment>::allocate(size_t count)
+	{
+		return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t(Alignment)));
+	}
+
+	template<typename T, size_t Alignment>
+	inline void AlignedAllocator<T, Alignment>::deallocate(T* pointer, size_t /*count*/) noexcept
+	{
+		::operator delete(pointer, std::align_val_t(Alignment));
+	}
+#pragma endregion
+
+#pragma region FrameArena
+	inline FrameArena::FrameArena(size_t _blockSize /*= 1 << 20*/) : blockSize(_blockSize)
+	{
+		first = current = CreateBlock(blockSize);
+	}
+
+	inline FrameArena::~FrameArena()
+	{
+		while (first)
+		{
+			Block* next = first->next;
+			::operator delete(first->data, std::align_val_t(64));
+			delete first;
+			first = next;
+		}
+	}
+
+	inline FrameArena::Block* FrameArena::CreateBlock(size_t size)
+	{
+		Block* block = new Block();
+		block->data = static_cast<std::byte*>(::operator new(size, std::align_val_t(64)));
+		block->size = size;
+		return block;
+	}
+
+	inline void* FrameArena::Allocate(size_t size, size_t alignment)
+	{
+		// The address is aligned rather than the offset, blocks themselves are only 64 byte aligned
+		auto alignStart = [&]()
+		{
+			const uintptr_t base = reinterpret_cast<uintptr_t>(current->data);
+			return static_cast<size_t>(((base + offset + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1)) - base);
+		};
+		size_t start = alignStart();
+		while (start + size > current->size)
+		{
+			// Reuse the blocks of previous frames before growing
+			if (!current->next || current->next->size < size + alignment)
+			{
+				Block* block = CreateBlock(std::max(blockSize, size + alignment));
+				block->next = current->next;
+				current->next = block;
+			}
+			used += current->size - offset;
+			current = current->next;
+			offset = 0;
+			start = alignStart();
+		}
+		used += start + size - offset;
+		offset = start + size;
+		return current->data + start;
+	}
+
+	inline void FrameArena::Reset()
+	{
+		current = first;
+		offset = 0;
+		used = 0;
+	}
+
+	inline size_t FrameArena::GetUsedSize() const
+	{
+		return used;
+	}
+
+	inline size_t FrameArena::GetCapacity() const
+	{
+		size_t capacity = 0;
+		for (Block* block = first; block; block = block->next)
+			capacity += block->size;
+		return capacity;
+	}
+
+	inline FrameArena& FrameArena::ThreadLocal()
+	{
+		thread_local FrameArena arena;
+		return arena;
+	}
+#pragma endregion
+
+#pragma region ArenaAllocator
+	template<typename T, size_t Alignment>
+	inline T* ArenaAllocator<T, Alignment>::allocate(size_t count)
+	{
+		return static_cast<T*>(arena->Allocate(count * sizeof(T), std::max(Alignment, alignof(T))));
+	}
+#pragma endregion
+
+#pragma region Vec3SoA
+	template<typename T>
+	inline Vec3SoA<T>::Vec3SoA(size_t count, const Vec3<T>& value)
+		: x(count, value.x), y(count, value.y), z(count, value.z)
+	{
+	}
+
+	template<typename T>
+	inline Vec3SoA<T>::Vec3SoA(std::span<const Vec3<T>> values)
+		: x(values.size()), y(values.size()), z(values.size())
+	{
+		for (size_t i = 0; i < values.size(); i++)
+			Set(i, values[i]);
+	}
+
+	template<typename T>
+	inline size_t Vec3SoA<T>::GetSize() const
+	{
+		return x.size();
+	}
+
+	template<typename T>
+	inline void Vec3SoA<T>::Resize(size_t count, const Vec3<T>& value)
+	{
+		x.resize(count, value.x);
+		y.resize(count, value.y);
+		z.resize(count, value.z);
+	}
+
+	template<typename T>
+	inline Vec3<T> Vec3SoA<T>::Get(size_t index) const
+	{
+		return Vec3<T>(x[index], y[index], z[index]);
+	}
+
+	template<typename T>
+	inline void Vec3SoA<T>::Set(size_t index, const Vec3<T>& value)
+	{
+		x[index] = value.x;
+		y[index] = value.y;
+		z[index] = value.z;
+	}
+
+	template<typename T>
+	inline void Vec3SoA<T>::Store(std::span<Vec3<T>> output) const
+	{
+		const size_t count = std::min(GetSize(), output.size());
+		for (size_t i = 0; i < count; i++)
+			output[i] = Get(i);
+	}
+#pragma endregion
+}
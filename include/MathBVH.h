@@ -0,0 +1,169 @@
+#pragma once
+#include <cfloat>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "Maths.h"
+#include "MathArray.h"
+#include "MathGeometry.h"
+#include "MathParallel.h"
+
+namespace GALAXY::Math
+{
+	struct RayHit
+	{
+		static constexpr uint32_t None = 0xFFFFFFFF;
+
+		float t = FLT_MAX;
+		// Barycentric weights of the second and third vertex, 0 for boxes
+		float u = 0.f, v = 0.f;
+		// Index of the primitive in the span the hierarchy was built from
+		uint32_t primitive = None;
+	};
+
+	struct BVHSettings
+	{
+		// Ranges of up to this many primitives become a leaf when the SAH prefers it, larger ones are always split
+		uint32_t maxLeafSize = 4;
+		// Centroid bins per axis for the SAH sweep, at most MaxBins
+		uint32_t binCount = 16;
+		// Cost of visiting a node relative to intersecting one primitive
+		float traversalCost = 1.f;
+	};
+
+	// Bounding volume hierarchy of Width wide nodes over triangles or boxes.
+	// The builder bins primitive centroids per axis and splits where the surface area heuristic is lowest,
+	// opening the largest child until a node has Width of them, then builds the subtrees below the top of the tree on the ParallelFor workers.
+	// A node keeps the bounds of its children as one array per bound so a ray is tested against all of them at once.
+	template<size_t Width>
+	class BVHT
+	{
+	public:
+		static_assert(Width == 4 || Width == 8, "Nodes are 4 or 8 wide");
+
+		static constexpr uint32_t MaxBins = 32;
+
+		// Marks an unused child, its bounds are empty
+		static constexpr uint32_t EmptyChild = 0xFFFFFFFF;
+
+		// A child is the node first (count 0), a leaf of count primitives from first, or unused
+		struct alignas(32) Node
+		{
+			// minX, minY, minZ, maxX, maxY, maxZ of every child
+			float bounds[6][Width];
+			uint32_t first[Width];
+			uint32_t count[Width];
+		};
+
+		inline BVHT() = default;
+
+		explicit inline BVHT(std::span<const AABB> boxes, const BVHSettings& settings = BVHSettings());
+
+		explicit inline BVHT(std::span<const Triangle> triangles, const BVHSettings& settings = BVHSettings());
+
+		inline const AABB& GetBounds() const { return bounds; }
+
+		inline size_t GetNodeCount() const { return nodes.size(); }
+
+		inline std::span<const Node> GetNodes() const { return nodes; }
+
+		inline size_t GetPrimitiveCount() const { return indices.size(); }
+
+		// Closest primitive along the ray, boxes are hit where the ray enters them. hit is left unchanged on a miss
+		inline bool Intersect(const Ray& ray, RayHit& hit) const;
+
+		// Whether any primitive is hit, stops at the first one found
+		inline bool Occluded(const Ray& ray) const;
+
+		// Indices of the primitives whose bounds overlap box, appended to output
+		inline void Overlap(const AABB& box, std::vector<uint32_t>& output) const;
+
+		// One closest hit per ray, spread over the workers
+		inline void Intersect(std::span<const Ray> rays, std::span<RayHit> hits) const;
+
+	private:
+		// Primitive bounds during the build, 32 bytes so partitioning moves one cache line per two
+		struct BuildPrimitive
+		{
+			float min[3];
+			uint32_t index;
+			float max[3];
+			uint32_t padding;
+		};
+
+		struct BuildRange
+		{
+			uint32_t begin = 0, end = 0;
+			AABB bounds;
+			// Bounds of min + max of the primitives, centroids scaled by two
+			AABB centroids;
+		};
+
+		// Range left for the pool once the top of the tree is built, its root goes in child slot child of node parent
+		struct Subtree
+		{
+			BuildRange range;
+			uint32_t parent, child, depth;
+			MathArray<Node> nodes;
+		};
+
+		struct BuildContext
+		{
+			BVHSettings settings;
+			BuildPrimitive* primitives;
+			// Children of at most this many primitives are built later as subtrees, 0 builds every child in place
+			uint32_t subtreeSize;
+			std::vector<Subtree>* subtrees;
+		};
+
+		// Ray constants shared by every node test
+		struct RayData
+		{
+			float inverse[3];
+			float origin[3];
+			// Bound array the ray enters (min or max) and leaves the children through per axis, from the sign of the direction
+			size_t enter[3];
+			size_t leave[3];
+			float tMin;
+		};
+
+		// Mask of the children the ray enters before maxT, distances gets the entry distance of every child
+		static inline uint32_t IntersectChildren(const Node& node, const RayData& ray, float maxT, float* distances);
+
+		static inline uint32_t OverlapChildren(const Node& node, const AABB& box);
+
+		static inline RayData PrepareRay(const Ray& ray);
+
+		inline void Build(std::span<const AABB> boxes, const BVHSettings& settings);
+
+		inline uint32_t BuildNode(BuildContext& context, const BuildRange& range, MathArray<Node>& output, uint32_t depth);
+
+		// Binned SAH split of range, false when a leaf is cheaper
+		static inline bool Split(BuildContext& context, const BuildRange& range, BuildRange& left, BuildRange& right, bool median);
+
+		static inline BuildRange GetRange(const BuildPrimitive* primitives, uint32_t begin, uint32_t end);
+
+		inline bool IntersectPrimitive(uint32_t index, const Ray& ray, RayHit& hit) const;
+
+		inline AABB GetPrimitiveBounds(uint32_t index) const;
+
+		// Stack entries a traversal can need: the builder falls back to median splits past MaxSAHDepth
+		static constexpr uint32_t MaxSAHDepth = 32;
+		static constexpr size_t StackSize = 64 * (Width - 1) + 1;
+
+		MathArray<Node> nodes;
+		// Original index of every primitive in leaf order
+		std::vector<uint32_t> indices;
+		// Primitives in leaf order, one of the two is filled
+		std::vector<AABB> boxes;
+		std::vector<Triangle> triangles;
+		AABB bounds;
+	};
+
+	typedef BVHT<4> BVH4;
+	typedef BVHT<8> BVH8;
+}
+
+#include "MathBVH.inl"
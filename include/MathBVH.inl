@@ -0,0 +1,652 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+#include "MathBVH.h"
+
+namespace GALAXY::Math
+{
+#pragma region Build
+	template<size_t Width>
+	inline BVHT<Width>::BVHT(std::span<const AABB> primitiveBoxes, const BVHSettings& settings)
+	{
+		Build(primitiveBoxes, settings);
+		boxes.resize(indices.size());
+		ParallelFor(indices.size(), 1 << 16, [&](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; i++)
+				boxes[i] = primitiveBoxes[indices[i]];
+		});
+	}
+
+	template<size_t Width>
+	inline BVHT<Width>::BVHT(std::span<const Triangle> primitiveTriangles, const BVHSettings& settings)
+	{
+		std::vector<AABB> primitiveBoxes(primitiveTriangles.size());
+		ParallelFor(primitiveTriangles.size(), 1 << 16, [&](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; i++)
+				primitiveBoxes[i] = primitiveTriangles[i].GetBounds();
+		});
+		Build(primitiveBoxes, settings);
+		triangles.resize(indices.size());
+		ParallelFor(indices.size(), 1 << 16, [&](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; i++)
+				triangles[i] = primitiveTriangles[indices[i]];
+		});
+	}
+
+	template<size_t Width>
+	inline void BVHT<Width>::Build(std::span<const AABB> primitiveBoxes, const BVHSettings& settings)
+	{
+		MATH_INSTRUMENT_SCOPE("BVHT::Build(span, BVHSettings)");
+		MATH_INSTRUMENT_ITEMS(primitiveBoxes.size());
+		const uint32_t count = static_cast<uint32_t>(primitiveBoxes.size());
+		if (count == 0)
+			return;
+
+		std::vector<BuildPrimitive> primitives(count);
+		ParallelFor(count, 1 << 16, [&](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				const AABB& box = primitiveBoxes[i];
+				primitives[i] = { { box.min.x, box.min.y, box.min.z }, static_cast<uint32_t>(i), { box.max.x, box.max.y, box.max.z }, 0 };
+			}
+		});
+
+		// The top of the tree is built here with the binning spread over the workers, below it each worker builds whole subtrees.
+		// The split into subtrees depends on the primitive count only, so the tree is the same whatever the worker count
+		constexpr uint32_t SubtreeMinSize = 1 << 12;
+		std::vector<Subtree> subtrees;
+		BuildContext context = { settings, primitives.data(), count >= SubtreeMinSize ? std::max(SubtreeMinSize, count / 64) : 0, &subtrees };
+		context.settings.binCount = std::clamp(settings.binCount, 2u, MaxBins);
+		context.settings.maxLeafSize = std::max(settings.maxLeafSize, 1u);
+		const BuildRange root = GetRange(primitives.data(), 0, count);
+		bounds = root.bounds;
+		BuildNode(context, root, nodes, 0);
+
+		ParallelFor(subtrees.size(), 1, [&](size_t begin, size_t end)
+		{
+			BuildContext subtreeContext = { context.settings, context.primitives, 0, nullptr };
+			for (size_t i = begin; i < end; i++)
+				BuildNode(subtreeContext, subtrees[i].range, subtrees[i].nodes, subtrees[i].depth);
+		});
+
+		// Subtrees are appended with their node indices moved past the nodes already there
+		for (Subtree& subtree : subtrees)
+		{
+			const uint32_t offset = static_cast<uint32_t>(nodes.size());
+			for (Node& node : subtree.nodes)
+			{
+				for (size_t c = 0; c < Width; c++)
+				{
+					if (node.count[c] == 0 && node.first[c] != EmptyChild)
+						node.first[c] += offset;
+				}
+			}
+			nodes.insert(nodes.end(), subtree.nodes.begin(), subtree.nodes.end());
+			nodes[subtree.parent].first[subtree.child] = offset;
+		}
+
+		indices.resize(count);
+		for (uint32_t i = 0; i < count; i++)
+			indices[i] = primitives[i].index;
+	}
+
+	template<size_t Width>
+	inline uint32_t BVHT<Width>::BuildNode(BuildContext& context, const BuildRange& range, MathArray<Node>& output, uint32_t depth)
+	{
+		const uint32_t index = static_cast<uint32_t>(output.size());
+		output.emplace_back();
+
+		// Split the child with the largest surface area until there are Width of them or every one is a leaf
+		BuildRange children[Width];
+		bool leaf[Width] = {};
+		size_t childCount = 1;
+		children[0] = range;
+		while (childCount < Width)
+		{
+			size_t largest = Width;
+			float largestArea = -1.f;
+			for (size_t i = 0; i < childCount; i++)
+			{
+				const float area = children[i].bounds.GetSurfaceArea();
+				if (!leaf[i] && area > largestArea)
+				{
+					largest = i;
+					largestArea = area;
+				}
+			}
+			if (largest == Width)
+				break;
+			BuildRange left, right;
+			if (!Split(context, children[largest], left, right, depth >= MaxSAHDepth))
+			{
+				leaf[largest] = true;
+				continue;
+			}
+			children[largest] = left;
+			children[childCount++] = right;
+		}
+
+		// Children left unsplit are leaves when small enough, the others get a node of their own or are left for the subtree pass
+		uint32_t nodeIndex[Width] = {};
+		for (size_t i = 0; i < childCount; i++)
+		{
+			const uint32_t count = children[i].end - children[i].begin;
+			leaf[i] |= count <= context.settings.maxLeafSize;
+			if (leaf[i])
+				continue;
+			if (count <= context.subtreeSize)
+				context.subtrees->push_back({ children[i], index, static_cast<uint32_t>(i), depth + 1, {} });
+			else
+				nodeIndex[i] = BuildNode(context, children[i], output, depth + 1);
+		}
+
+		Node& node = output[index];
+		for (size_t i = 0; i < Width; i++)
+		{
+			const AABB box = i < childCount ? children[i].bounds : AABB();
+			const float values[6] = { box.min.x, box.min.y, box.min.z, box.max.x, box.max.y, box.max.z };
+			for (size_t b = 0; b < 6; b++)
+				node.bounds[b][i] = values[b];
+			if (i >= childCount)
+			{
+				node.first[i] = EmptyChild;
+				node.count[i] = 0;
+			}
+			else if (leaf[i])
+			{
+				node.first[i] = children[i].begin;
+				node.count[i] = children[i].end - children[i].begin;
+			}
+			else
+			{
+				node.first[i] = nodeIndex[i];
+				node.count[i] = 0;
+			}
+		}
+		return index;
+	}
+
+	template<size_t Width>
+	inline bool BVHT<Width>::Split(BuildContext& context, const BuildRange& range, BuildRange& left, BuildRange& right, bool median)
+	{
+		const uint32_t count = range.end - range.begin;
+		if (count <= 1)
+			return false;
+		const BVHSettings& settings = context.settings;
+		BuildPrimitive* primitives = context.primitives;
+		// Small ranges need fewer bins, clearing and sweeping them dominates the cost of their splits
+		const uint32_t binCount = std::min(settings.binCount, std::max(count, 2u));
+
+		// Fourth lanes unused, they let the SSE path grow a bin with one instruction per bound
+		struct alignas(16) Bin
+		{
+			float min[4], max[4];
+			float centroidMin[4], centroidMax[4];
+			uint32_t count;
+
+			inline void Reset()
+			{
+				for (size_t k = 0; k < 3; k++)
+				{
+					min[k] = centroidMin[k] = FLT_MAX;
+					max[k] = centroidMax[k] = -FLT_MAX;
+				}
+				count = 0;
+			}
+
+			inline void Grow(const Bin& bin)
+			{
+				for (size_t k = 0; k < 3; k++)
+				{
+					min[k] = std::min(min[k], bin.min[k]);
+					max[k] = std::max(max[k], bin.max[k]);
+					centroidMin[k] = std::min(centroidMin[k], bin.centroidMin[k]);
+					centroidMax[k] = std::max(centroidMax[k], bin.centroidMax[k]);
+				}
+				count += bin.count;
+			}
+
+			inline float GetSurfaceArea() const
+			{
+				const float x = max[0] - min[0], y = max[1] - min[1], z = max[2] - min[2];
+				return count == 0 ? 0.f : 2.f * (x * y + y * z + z * x);
+			}
+		};
+		struct Bins
+		{
+			Bin axes[3][MaxBins];
+
+			inline void Reset(uint32_t binCount)
+			{
+				for (size_t axis = 0; axis < 3; axis++)
+				{
+					for (uint32_t b = 0; b < binCount; b++)
+						axes[axis][b].Reset();
+				}
+			}
+		};
+
+		// Bins of every axis spread evenly over the centroid bounds, an axis where they are flat has none
+		const Vec3f extent = range.centroids.GetSize();
+		float scale[3];
+		for (size_t axis = 0; axis < 3; axis++)
+			scale[axis] = extent[axis] > 0.f ? binCount / extent[axis] : 0.f;
+		auto getBin = [&](const BuildPrimitive& primitive, size_t axis)
+		{
+			const float centroid = primitive.min[axis] + primitive.max[axis];
+			return std::min(static_cast<uint32_t>((centroid - range.centroids.min[axis]) * scale[axis]), binCount - 1);
+		};
+		auto fill = [&](uint32_t begin, uint32_t end, Bins& bins)
+		{
+			bins.Reset(binCount);
+#if defined(MATH_SSE)
+			const __m128 centroidMin = _mm_setr_ps(range.centroids.min.x, range.centroids.min.y, range.centroids.min.z, 0.f);
+			const __m128 binScale = _mm_setr_ps(scale[0], scale[1], scale[2], 0.f);
+			for (uint32_t i = begin; i < end; i++)
+			{
+				// The fourth lanes load the index and padding, they are never read back
+				const __m128 min = _mm_loadu_ps(primitives[i].min), max = _mm_loadu_ps(primitives[i].max);
+				const __m128 centroid = _mm_add_ps(min, max);
+				alignas(16) int32_t binIndex[4];
+				_mm_store_si128(reinterpret_cast<__m128i*>(binIndex), _mm_cvttps_epi32(_mm_mul_ps(_mm_sub_ps(centroid, centroidMin), binScale)));
+				for (size_t axis = 0; axis < 3; axis++)
+				{
+					Bin& bin = bins.axes[axis][std::min(static_cast<uint32_t>(binIndex[axis]), binCount - 1)];
+					_mm_store_ps(bin.min, _mm_min_ps(_mm_load_ps(bin.min), min));
+					_mm_store_ps(bin.max, _mm_max_ps(_mm_load_ps(bin.max), max));
+					_mm_store_ps(bin.centroidMin, _mm_min_ps(_mm_load_ps(bin.centroidMin), centroid));
+					_mm_store_ps(bin.centroidMax, _mm_max_ps(_mm_load_ps(bin.centroidMax), centroid));
+					bin.count++;
+				}
+			}
+#else
+			for (uint32_t i = begin; i < end; i++)
+			{
+				const BuildPrimitive& primitive = primitives[i];
+				for (size_t axis = 0; axis < 3; axis++)
+				{
+					Bin& bin = bins.axes[axis][getBin(primitive, axis)];
+					for (size_t k = 0; k < 3; k++)
+					{
+						const float centroid = primitive.min[k] + primitive.max[k];
+						bin.min[k] = std::min(bin.min[k], primitive.min[k]);
+						bin.max[k] = std::max(bin.max[k], primitive.max[k]);
+						bin.centroidMin[k] = std::min(bin.centroidMin[k], centroid);
+						bin.centroidMax[k] = std::max(bin.centroidMax[k], centroid);
+					}
+					bin.count++;
+				}
+			}
+#endif
+		};
+
+		const bool flat = scale[0] == 0.f && scale[1] == 0.f && scale[2] == 0.f;
+		if (!median && !flat)
+		{
+			// Large ranges are binned in chunks on the workers and the chunks merged
+			constexpr uint32_t Chunk = 1 << 16;
+			Bins binned;
+			auto& bins = binned.axes;
+			if (count <= Chunk)
+				fill(range.begin, range.end, binned);
+			else
+			{
+				std::vector<Bins> partial((count + Chunk - 1) / Chunk);
+				ParallelFor(count, Chunk, [&](size_t begin, size_t end) { fill(range.begin + static_cast<uint32_t>(begin), range.begin + static_cast<uint32_t>(end), partial[begin / Chunk]); });
+				binned.Reset(binCount);
+				for (const Bins& chunk : partial)
+				{
+					for (size_t axis = 0; axis < 3; axis++)
+					{
+						for (uint32_t b = 0; b < binCount; b++)
+							bins[axis][b].Grow(chunk.axes[axis][b]);
+					}
+				}
+			}
+
+			// Sweep the split planes between bins, area times count on each side
+			float bestCost = FLT_MAX;
+			size_t bestAxis = 3;
+			uint32_t bestSplit = 0;
+			for (size_t axis = 0; axis < 3; axis++)
+			{
+				if (scale[axis] == 0.f)
+					continue;
+				float rightCost[MaxBins] = {};
+				Bin accumulated;
+				accumulated.Reset();
+				for (uint32_t b = binCount - 1; b > 0; b--)
+				{
+					accumulated.Grow(bins[axis][b]);
+					rightCost[b] = accumulated.count == 0 ? FLT_MAX : accumulated.GetSurfaceArea() * accumulated.count;
+				}
+				accumulated.Reset();
+				for (uint32_t b = 1; b < binCount; b++)
+				{
+					accumulated.Grow(bins[axis][b - 1]);
+					const float cost = accumulated.count == 0 ? FLT_MAX : accumulated.GetSurfaceArea() * accumulated.count + rightCost[b];
+					if (cost < bestCost)
+					{
+						bestCost = cost;
+						bestAxis = axis;
+						bestSplit = b;
+					}
+				}
+			}
+
+			if (bestAxis < 3)
+			{
+				const float area = range.bounds.GetSurfaceArea();
+				const float splitCost = settings.traversalCost + (area > 0.f ? bestCost / area : 0.f);
+				if (count <= settings.maxLeafSize && splitCost >= static_cast<float>(count))
+					return false;
+
+				std::partition(primitives + range.begin, primitives + range.end, [&](const BuildPrimitive& primitive) { return getBin(primitive, bestAxis) < bestSplit; });
+				Bin sides[2];
+				sides[0].Reset();
+				sides[1].Reset();
+				for (uint32_t b = 0; b < binCount; b++)
+					sides[b < bestSplit ? 0 : 1].Grow(bins[bestAxis][b]);
+				BuildRange* ranges[2] = { &left, &right };
+				for (size_t side = 0; side < 2; side++)
+				{
+					ranges[side]->bounds = AABB(Vec3f(sides[side].min[0], sides[side].min[1], sides[side].min[2]), Vec3f(sides[side].max[0], sides[side].max[1], sides[side].max[2]));
+					ranges[side]->centroids = AABB(Vec3f(sides[side].centroidMin[0], sides[side].centroidMin[1], sides[side].centroidMin[2]),
+						Vec3f(sides[side].centroidMax[0], sides[side].centroidMax[1], sides[side].centroidMax[2]));
+				}
+				left.begin = range.begin;
+				left.end = range.begin + sides[0].count;
+				right.begin = left.end;
+				right.end = range.end;
+				return true;
+			}
+		}
+
+		// Identical centroids or a tree too deep for the SAH: halves around the median on the longest axis
+		if (count <= settings.maxLeafSize)
+			return false;
+		const size_t axis = extent.x >= extent.y && extent.x >= extent.z ? 0 : extent.y >= extent.z ? 1 : 2;
+		const uint32_t middle = range.begin + count / 2;
+		std::nth_element(primitives + range.begin, primitives + middle, primitives + range.end, [axis](const BuildPrimitive& a, const BuildPrimitive& b)
+		{
+			return a.min[axis] + a.max[axis] < b.min[axis] + b.max[axis];
+		});
+		left = GetRange(primitives, range.begin, middle);
+		right = GetRange(primitives, middle, range.end);
+		return true;
+	}
+
+	template<size_t Width>
+	inline typename BVHT<Width>::BuildRange BVHT<Width>::GetRange(const BuildPrimitive* primitives, uint32_t begin, uint32_t end)
+	{
+		constexpr uint32_t Chunk = 1 << 16;
+		std::vector<BuildRange> partial((end - begin + Chunk - 1) / Chunk);
+		ParallelFor(end - begin, Chunk, [&](size_t chunkBegin, size_t chunkEnd)
+		{
+			BuildRange& chunk = partial[chunkBegin / Chunk];
+			for (size_t i = begin + chunkBegin; i < begin + chunkEnd; i++)
+			{
+				const AABB box(Vec3f(primitives[i].min[0], primitives[i].min[1], primitives[i].min[2]), Vec3f(primitives[i].max[0], primitives[i].max[1], primitives[i].max[2]));
+				chunk.bounds.Grow(box);
+				chunk.centroids.Grow(box.min + box.max);
+			}
+		});
+		BuildRange range;
+		range.begin = begin;
+		range.end = end;
+		for (const BuildRange& chunk : partial)
+		{
+			range.bounds.Grow(chunk.bounds);
+			range.centroids.Grow(chunk.centroids);
+		}
+		return range;
+	}
+#pragma endregion
+
+#pragma region Queries
+	template<size_t Width>
+	inline typename BVHT<Width>::RayData BVHT<Width>::PrepareRay(const Ray& ray)
+	{
+		RayData data;
+		for (size_t axis = 0; axis < 3; axis++)
+		{
+			// A zero component would give 0 * inf = NaN on a bound through the origin, a tiny one keeps the inverse finite
+			const float direction = ray.direction[axis];
+			data.inverse[axis] = 1.f / (std::abs(direction) > 1e-20f ? direction : std::copysign(1e-20f, direction));
+			data.origin[axis] = ray.origin[axis];
+			// The sign bit, not direction < 0, so a -0 component enters through the max bound like its -1e20 inverse says
+			data.enter[axis] = std::signbit(direction) ? axis + 3 : axis;
+			data.leave[axis] = std::signbit(direction) ? axis : axis + 3;
+		}
+		data.tMin = ray.tMin;
+		return data;
+	}
+
+	template<size_t Width>
+	inline uint32_t BVHT<Width>::IntersectChildren(const Node& node, const RayData& ray, float maxT, float* distances)
+	{
+#if defined(MATH_AVX)
+		if constexpr (Width == 8)
+		{
+			__m256 tEnter = _mm256_set1_ps(ray.tMin), tLeave = _mm256_set1_ps(maxT);
+			for (size_t axis = 0; axis < 3; axis++)
+			{
+				const __m256 origin = _mm256_set1_ps(ray.origin[axis]), inverse = _mm256_set1_ps(ray.inverse[axis]);
+				tEnter = _mm256_max_ps(tEnter, _mm256_mul_ps(_mm256_sub_ps(_mm256_load_ps(node.bounds[ray.enter[axis]]), origin), inverse));
+				tLeave = _mm256_min_ps(tLeave, _mm256_mul_ps(_mm256_sub_ps(_mm256_load_ps(node.bounds[ray.leave[axis]]), origin), inverse));
+			}
+			_mm256_storeu_ps(distances, tEnter);
+			return static_cast<uint32_t>(_mm256_movemask_ps(_mm256_cmp_ps(tEnter, tLeave, _CMP_LE_OQ)));
+		}
+#endif
+#if defined(MATH_SSE)
+		uint32_t mask = 0;
+		for (size_t lane = 0; lane < Width; lane += 4)
+		{
+			__m128 tEnter = _mm_set1_ps(ray.tMin), tLeave = _mm_set1_ps(maxT);
+			for (size_t axis = 0; axis < 3; axis++)
+			{
+				const __m128 origin = _mm_set1_ps(ray.origin[axis]), inverse = _mm_set1_ps(ray.inverse[axis]);
+				tEnter = _mm_max_ps(tEnter, _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.bounds[ray.enter[axis]] + lane), origin), inverse));
+				tLeave = _mm_min_ps(tLeave, _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.bounds[ray.leave[axis]] + lane), origin), inverse));
+			}
+			_mm_storeu_ps(distances + lane, tEnter);
+			mask |= static_cast<uint32_t>(_mm_movemask_ps(_mm_cmple_ps(tEnter, tLeave))) << lane;
+		}
+		return mask;
+#else
+		uint32_t mask = 0;
+		for (size_t i = 0; i < Width; i++)
+		{
+			float tEnter = ray.tMin, tLeave = maxT;
+			for (size_t axis = 0; axis < 3; axis++)
+			{
+				tEnter = std::max(tEnter, (node.bounds[ray.enter[axis]][i] - ray.origin[axis]) * ray.inverse[axis]);
+				tLeave = std::min(tLeave, (node.bounds[ray.leave[axis]][i] - ray.origin[axis]) * ray.inverse[axis]);
+			}
+			distances[i] = tEnter;
+			mask |= static_cast<uint32_t>(tEnter <= tLeave) << i;
+		}
+		return mask;
+#endif
+	}
+
+	template<size_t Width>
+	inline uint32_t BVHT<Width>::OverlapChildren(const Node& node, const AABB& box)
+	{
+		uint32_t mask = 0;
+		for (size_t i = 0; i < Width; i++)
+		{
+			const bool overlaps = (node.bounds[0][i] <= box.max.x) & (node.bounds[3][i] >= box.min.x)
+				& (node.bounds[1][i] <= box.max.y) & (node.bounds[4][i] >= box.min.y)
+				& (node.bounds[2][i] <= box.max.z) & (node.bounds[5][i] >= box.min.z);
+			mask |= static_cast<uint32_t>(overlaps & (node.first[i] != EmptyChild)) << i;
+		}
+		return mask;
+	}
+
+	template<size_t Width>
+	inline bool BVHT<Width>::IntersectPrimitive(uint32_t index, const Ray& ray, RayHit& hit) const
+	{
+		Ray bounded = ray;
+		bounded.tMax = hit.t;
+		float t, u = 0.f, v = 0.f;
+		if (!(triangles.empty() ? IntersectRay(bounded, boxes[index], t) : IntersectRay(bounded, triangles[index], t, u, v)) || t >= hit.t)
+			return false;
+		hit.t = t;
+		hit.u = u;
+		hit.v = v;
+		hit.primitive = indices[index];
+		return true;
+	}
+
+	template<size_t Width>
+	inline AABB BVHT<Width>::GetPrimitiveBounds(uint32_t index) const
+	{
+		return triangles.empty() ? boxes[index] : triangles[index].GetBounds();
+	}
+
+	template<size_t Width>
+	inline bool BVHT<Width>::Intersect(const Ray& ray, RayHit& hit) const
+	{
+		MATH_INSTRUMENT_SCOPE("BVHT::Intersect(Ray, RayHit)");
+		if (nodes.empty())
+			return false;
+		const RayData data = PrepareRay(ray);
+
+		struct Entry
+		{
+			uint32_t first;
+			uint32_t count;
+			float t;
+		};
+		Entry stack[StackSize];
+		size_t size = 0;
+		stack[size++] = { 0, 0, ray.tMin };
+		RayHit closest;
+		closest.t = ray.tMax;
+		bool found = false;
+		while (size > 0)
+		{
+			const Entry entry = stack[--size];
+			if (entry.t > closest.t)
+				continue;
+			if (entry.count != 0)
+			{
+				for (uint32_t i = entry.first; i < entry.first + entry.count; i++)
+					found |= IntersectPrimitive(i, ray, closest);
+				continue;
+			}
+
+			// Children pushed sorted so the nearest is visited first and farther ones are skipped once something closer is hit
+			const Node& node = nodes[entry.first];
+			float distances[Width];
+			uint32_t mask = IntersectChildren(node, data, closest.t, distances);
+			const size_t base = size;
+			while (mask != 0)
+			{
+				const size_t i = static_cast<size_t>(std::countr_zero(mask));
+				mask &= mask - 1;
+				const Entry child = { node.first[i], node.count[i], distances[i] };
+				size_t j = size++;
+				for (; j > base && stack[j - 1].t < child.t; j--)
+					stack[j] = stack[j - 1];
+				stack[j] = child;
+			}
+		}
+		if (found)
+			hit = closest;
+		return found;
+	}
+
+	template<size_t Width>
+	inline bool BVHT<Width>::Occluded(const Ray& ray) const
+	{
+		MATH_INSTRUMENT_SCOPE("BVHT::Occluded(Ray)");
+		if (nodes.empty())
+			return false;
+		const RayData data = PrepareRay(ray);
+
+		uint32_t stack[StackSize];
+		size_t size = 0;
+		stack[size++] = 0;
+		RayHit any;
+		any.t = ray.tMax;
+		while (size > 0)
+		{
+			const Node& node = nodes[stack[--size]];
+			float distances[Width];
+			uint32_t mask = IntersectChildren(node, data, ray.tMax, distances);
+			while (mask != 0)
+			{
+				const size_t i = static_cast<size_t>(std::countr_zero(mask));
+				mask &= mask - 1;
+				if (node.count[i] == 0)
+				{
+					stack[size++] = node.first[i];
+					continue;
+				}
+				for (uint32_t p = node.first[i]; p < node.first[i] + node.count[i]; p++)
+				{
+					if (IntersectPrimitive(p, ray, any))
+						return true;
+				}
+			}
+		}
+		return false;
+	}
+
+	template<size_t Width>
+	inline void BVHT<Width>::Overlap(const AABB& box, std::vector<uint32_t>& output) const
+	{
+		MATH_INSTRUMENT_SCOPE("BVHT::Overlap(AABB, vector)");
+		if (nodes.empty())
+			return;
+		uint32_t stack[StackSize];
+		size_t size = 0;
+		stack[size++] = 0;
+		while (size > 0)
+		{
+			const Node& node = nodes[stack[--size]];
+			uint32_t mask = OverlapChildren(node, box);
+			while (mask != 0)
+			{
+				const size_t i = static_cast<size_t>(std::countr_zero(mask));
+				mask &= mask - 1;
+				if (node.count[i] == 0)
+				{
+					stack[size++] = node.first[i];
+					continue;
+				}
+				for (uint32_t p = node.first[i]; p < node.first[i] + node.count[i]; p++)
+				{
+					if (GetPrimitiveBounds(p).Overlaps(box))
+						output.push_back(indices[p]);
+				}
+			}
+		}
+	}
+
+	template<size_t Width>
+	inline void BVHT<Width>::Intersect(std::span<const Ray> rays, std::span<RayHit> hits) const
+	{
+		MATH_INSTRUMENT_SCOPE("BVHT::Intersect(span, span)");
+		const size_t count = std::min(rays.size(), hits.size());
+		MATH_INSTRUMENT_ITEMS(count);
+		ParallelFor(count, 1024, [&](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				hits[i] = RayHit();
+				Intersect(rays[i], hits[i]);
+			}
+		});
+	}
+#pragma endregion
+}
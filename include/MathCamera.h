@@ -0,0 +1,188 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+#include "Maths.h"
+#include "MathGeometry.h"
+#include "MathExpression.h"
+#include "MathParallel.h"
+
+namespace GALAXY::Math
+{
+	// Projection matrix with its inverse, both written in closed form rather than inverted
+	struct Projection
+	{
+		Mat4f matrix;
+		Mat4f inverse;
+
+		// Vertical field of view in degrees. An infinite far plane puts it at the far end of the depth range
+		static inline Projection CreatePerspective(float fov, float aspect, float nearPlane, float farPlane, DepthRange range = DepthRange::NegativeOneToOne);
+
+		static inline Projection CreateOrthographic(float left, float right, float bottom, float top, float nearPlane, float farPlane, DepthRange range = DepthRange::NegativeOneToOne);
+	};
+
+	// Normalized device coordinates, z in the depth range of the projection, back to world space
+	inline Vec3f Unproject(const Mat4f& inverseViewProjection, const Vec3f& ndc);
+
+	// Unproject in SIMD lanes and spread over the workers, stops at the shorter span
+	inline void Unproject(const Mat4f& inverseViewProjection, std::span<const Vec3f> ndc, std::span<Vec3f> points);
+
+	// World positions of the pixel centers of a depth buffer, rows from the top of the screen and depth as the projection wrote it.
+	// Rows past the end of depth or points are left out
+	inline void UnprojectDepth(const Mat4f& inverseViewProjection, size_t width, size_t height, std::span<const float> depth, std::span<Vec3f> points);
+
+	// Sides of the clip volume a projected point is outside of
+	enum ClipFlags : uint8_t
+	{
+		ClipLeft = 1 << 0,
+		ClipRight = 1 << 1,
+		ClipBottom = 1 << 2,
+		ClipTop = 1 << 3,
+		// Also set for every point at or behind w = 0 or with a coordinate that is not finite, which has no screen position
+		ClipNear = 1 << 4,
+		ClipFar = 1 << 5,
+		ClipSides = ClipLeft | ClipRight | ClipBottom | ClipTop | ClipNear | ClipFar,
+		// Beyond the guard band in x or y, where a rasterizer has to clip instead of scissoring
+		ClipGuardBand = 1 << 6,
+	};
+
+	// Screen a view projection maps to, in pixels from the top left
+	struct Viewport
+	{
+		float width = 1.f;
+		float height = 1.f;
+		DepthRange range = DepthRange::NegativeOneToOne;
+		// Half extent of the guard band in multiples of the half viewport
+		float guardBand = 2.f;
+	};
+
+	// Points through a view projection to the screen, x and y in pixels and z the depth the projection gives, with the clip flags of each.
+	// In SIMD lanes with the divide by w from a refined reciprocal, and spread over the workers. Stops at the shortest of the spans
+	inline void ProjectToScreen(const Mat4f& viewProjection, const Viewport& viewport, std::span<const Vec3f> points, std::span<Vec3f> screen, std::span<uint8_t> clipFlags);
+
+	// Points grouped by the square screen tile they fall in, tiles row major from the top left.
+	// The points of tile t are indices[offsets[t]] up to indices[offsets[t + 1]], in increasing order
+	struct ScreenTiles
+	{
+		uint32_t tileSize = 0;
+		uint32_t columns = 0;
+		uint32_t rows = 0;
+		std::vector<uint32_t> offsets;
+		std::vector<uint32_t> indices;
+
+		inline size_t GetTileCount() const { return static_cast<size_t>(columns) * rows; }
+
+		inline std::span<const uint32_t> GetTile(size_t tile) const { return std::span<const uint32_t>(indices).subspan(offsets[tile], offsets[tile + 1] - offsets[tile]); }
+	};
+
+	// Bins the output of ProjectToScreen, points outside one of the sides are left out. Every chunk counts and scatters its own points
+	// so the result does not depend on the worker count. A tile size of 0 gives no tiles
+	inline void BinToTiles(std::span<const Vec3f> screen, std::span<const uint8_t> clipFlags, const Viewport& viewport, uint32_t tileSize, ScreenTiles& tiles);
+
+	// Perspective camera whose matrices are rebuilt only when read after one of their inputs changed.
+	// Setters compare with the current value and mark the dependent matrices stale, so re-setting a camera every frame is cheap.
+	// The matrices match Mat4::CreateViewMatrix and Projection::CreatePerspective.
+	// The const getters write the matrices they rebuild, so concurrent reads race unless Update was called after the last setter
+	class Camera
+	{
+	public:
+		inline Camera() = default;
+
+		inline Camera(const Vec3f& position, const Quat& rotation, float fov, float aspect, float nearPlane, float farPlane, DepthRange depthRange = DepthRange::NegativeOneToOne);
+
+		inline void SetPosition(const Vec3f& position);
+
+		inline void SetRotation(const Quat& rotation);
+
+		// Vertical field of view in degrees
+		inline void SetFov(float fov);
+
+		inline void SetAspect(float aspect);
+
+		// The far plane can be infinite
+		inline void SetClipPlanes(float nearPlane, float farPlane);
+
+		inline void SetDepthRange(DepthRange depthRange);
+
+		inline const Vec3f& GetPosition() const { return position; }
+
+		inline const Quat& GetRotation() const { return rotation; }
+
+		inline float GetFov() const { return fov; }
+
+		inline float GetAspect() const { return aspect; }
+
+		inline float GetNearPlane() const { return nearPlane; }
+
+		inline float GetFarPlane() const { return farPlane; }
+
+		inline DepthRange GetDepthRange() const { return depthRange; }
+
+		// Bumped by every setter that changes something, for caches built on the camera
+		inline uint32_t GetVersion() const { return version; }
+
+		// Rigid transform, inverted by transposing the rotation
+		inline const Mat4f& GetViewMatrix() const;
+
+		inline const Mat4f& GetInverseViewMatrix() const;
+
+		inline const Mat4f& GetProjectionMatrix() const;
+
+		// Built with the projection, in closed form
+		inline const Mat4f& GetInverseProjectionMatrix() const;
+
+		inline const Mat4f& GetViewProjectionMatrix() const;
+
+		inline const Mat4f& GetInverseViewProjectionMatrix() const;
+
+		inline const Frustum& GetFrustum() const;
+
+		// Rebuilds every stale matrix now, the getters then only read until the next setter
+		inline void Update();
+
+	private:
+		enum Stale : uint8_t
+		{
+			View = 1 << 0,
+			InverseView = 1 << 1,
+			Lens = 1 << 2,
+			ViewProjection = 1 << 3,
+			InverseViewProjection = 1 << 4,
+			Planes = 1 << 5,
+			Combined = ViewProjection | InverseViewProjection | Planes,
+			Pose = View | InverseView | Combined,
+			Optics = Lens | Combined,
+		};
+
+		inline void Invalidate(uint8_t flags);
+
+		Vec3f position;
+		Quat rotation;
+		float fov = 60.f;
+		float aspect = 1.f;
+		float nearPlane = 0.1f;
+		float farPlane = 1000.f;
+		DepthRange depthRange = DepthRange::NegativeOneToOne;
+		uint32_t version = 0;
+
+		mutable uint8_t stale = Pose | Optics;
+		mutable Mat4f view, inverseView;
+		mutable Projection projection;
+		mutable Mat4f viewProjection, inverseViewProjection;
+		mutable Frustum frustum;
+	};
+
+	namespace Projector
+	{
+		// Homogenized inverseViewProjection * (x, y, z, 1) of every lane into output[coordinate][lane]
+		inline void Unproject(const Mat4f& inverseViewProjection, const Expression::Pack<float>& x, const Expression::Pack<float>& y, const Expression::Pack<float>& z, float (&output)[3][Expression::PackSize<float>]);
+
+		// Clip flags of every lane of the clip coordinates, lane i in output[i]
+		inline void GetClipFlags(const Expression::Pack<float>& x, const Expression::Pack<float>& y, const Expression::Pack<float>& z, const Expression::Pack<float>& w, const Viewport& viewport, uint8_t* output);
+	}
+}
+
+#include "MathCamera.inl"
@@ -0,0 +1,473 @@
+#pragma once
+#include "MathCamera.h"
+
+namespace GALAXY::Math
+{
+#pragma region Projection
+	inline Projection Projection::CreatePerspective(float fov, float aspect, float nearPlane, float farPlane, DepthRange range)
+	{
+		MATH_INSTRUMENT_SCOPE("Projection::CreatePerspective(float, float, float, float, DepthRange)");
+		// Clip z = c * z + d and w = -z, so z = -w and the view w = (z + c * w) / d
+		const float tanHalfFov = Tan(fov * DegToRad * 0.5f);
+		const bool infinite = std::isinf(farPlane);
+		const float depth = farPlane - nearPlane;
+		float c, d;
+		switch (range)
+		{
+		case DepthRange::ZeroToOne:
+			c = infinite ? -1.f : -farPlane / depth;
+			d = infinite ? -nearPlane : -farPlane * nearPlane / depth;
+			break;
+		case DepthRange::ReverseZ:
+			c = infinite ? 0.f : nearPlane / depth;
+			d = infinite ? nearPlane : farPlane * nearPlane / depth;
+			break;
+		default:
+			c = infinite ? -1.f : -(farPlane + nearPlane) / depth;
+			d = infinite ? -2.f * nearPlane : -(2.f * farPlane * nearPlane) / depth;
+			break;
+		}
+
+		Projection projection;
+		projection.matrix[0][0] = 1.f / (aspect * tanHalfFov);
+		projection.matrix[1][1] = 1.f / tanHalfFov;
+		projection.matrix[2][2] = c;
+		projection.matrix[2][3] = -1.f;
+		projection.matrix[3][2] = d;
+		projection.inverse[0][0] = aspect * tanHalfFov;
+		projection.inverse[1][1] = tanHalfFov;
+		projection.inverse[2][3] = 1.f / d;
+		projection.inverse[3][2] = -1.f;
+		projection.inverse[3][3] = c / d;
+		return projection;
+	}
+
+	inline Projection Projection::CreateOrthographic(float left, float right, float bottom, float top, float nearPlane, float farPlane, DepthRange range)
+	{
+		MATH_INSTRUMENT_SCOPE("Projection::CreateOrthographic(float, float, float, float, float, float, DepthRange)");
+		// Clip z = c * z + e, undone by z = (clip z - e) / c
+		const float depth = farPlane - nearPlane;
+		float c, e;
+		switch (range)
+		{
+		case DepthRange::ZeroToOne:
+			c = -1.f / depth;
+			e = -nearPlane / depth;
+			break;
+		case DepthRange::ReverseZ:
+			c = 1.f / depth;
+			e = farPlane / depth;
+			break;
+		default:
+			c = -2.f / depth;
+			e = -(farPlane + nearPlane) / depth;
+			break;
+		}
+
+		Projection projection;
+		projection.matrix[0][0] = 2.f / (right - left);
+		projection.matrix[1][1] = 2.f / (top - bottom);
+		projection.matrix[2][2] = c;
+		projection.matrix[3] = Vec4f(-(right + left) / (right - left), -(top + bottom) / (top - bottom), e, 1.f);
+		projection.inverse[0][0] = (right - left) * 0.5f;
+		projection.inverse[1][1] = (top - bottom) * 0.5f;
+		projection.inverse[2][2] = 1.f / c;
+		projection.inverse[3] = Vec4f((right + left) * 0.5f, (top + bottom) * 0.5f, -e / c, 1.f);
+		return projection;
+	}
+#pragma endregion
+
+#pragma region Unproject
+	inline Vec3f Unproject(const Mat4f& inverseViewProjection, const Vec3f& ndc)
+	{
+		MATH_INSTRUMENT_SCOPE("Unproject(Mat4, Vec3)");
+		const Mat4f& m = inverseViewProjection;
+		const Vec4f point = m.content[0] * ndc.x + m.content[1] * ndc.y + m.content[2] * ndc.z + m.content[3];
+		return Vec3f(point) / point.w;
+	}
+
+	inline void Projector::Unproject(const Mat4f& inverseViewProjection, const Expression::Pack<float>& x, const Expression::Pack<float>& y, const Expression::Pack<float>& z, float (&output)[3][Expression::PackSize<float>])
+	{
+		using namespace Expression;
+		const Mat4f& m = inverseViewProjection;
+		auto row = [&](size_t r) { return BroadcastPack(m.content[0][r]) * x + BroadcastPack(m.content[1][r]) * y + BroadcastPack(m.content[2][r]) * z + BroadcastPack(m.content[3][r]); };
+		const Pack<float> inverseW = BroadcastPack(1.f) / row(3);
+		for (size_t r = 0; r < 3; r++)
+			StorePack(output[r], row(r) * inverseW);
+	}
+
+	inline void Unproject(const Mat4f& inverseViewProjection, std::span<const Vec3f> ndc, std::span<Vec3f> points)
+	{
+		MATH_INSTRUMENT_SCOPE("Unproject(Mat4, span, span)");
+		const size_t count = std::min(ndc.size(), points.size());
+		MATH_INSTRUMENT_ITEMS(count);
+		using namespace Expression;
+		constexpr size_t Lanes = PackSize<float>;
+		ParallelFor(count, 1 << 14, [&](size_t begin, size_t end)
+		{
+			for (size_t first = begin; first < end; first += Lanes)
+			{
+				const size_t lanes = std::min(Lanes, end - first);
+				// Padding lanes repeat the last point
+				float buffer[3][Lanes];
+				for (size_t lane = 0; lane < Lanes; lane++)
+				{
+					const Vec3f& point = ndc[first + std::min(lane, lanes - 1)];
+					buffer[0][lane] = point.x;
+					buffer[1][lane] = point.y;
+					buffer[2][lane] = point.z;
+				}
+				Projector::Unproject(inverseViewProjection, LoadPack(buffer[0]), LoadPack(buffer[1]), LoadPack(buffer[2]), buffer);
+				for (size_t lane = 0; lane < lanes; lane++)
+					points[first + lane] = Vec3f(buffer[0][lane], buffer[1][lane], buffer[2][lane]);
+			}
+		});
+	}
+
+	inline void UnprojectDepth(const Mat4f& inverseViewProjection, size_t width, size_t height, std::span<const float> depth, std::span<Vec3f> points)
+	{
+		MATH_INSTRUMENT_SCOPE("UnprojectDepth(Mat4, size_t, size_t, span, span)");
+		using namespace Expression;
+		constexpr size_t Lanes = PackSize<float>;
+		if (width == 0)
+			return;
+		// Only the rows both spans hold in full, the y step still comes from the full height
+		const size_t rows = std::min(height, std::min(depth.size(), points.size()) / width);
+		MATH_INSTRUMENT_ITEMS(width * rows);
+		// Pixel centers step by 2 / width in x, the lanes of a pack hold consecutive pixels of a row
+		const float stepX = 2.f / static_cast<float>(width);
+		const float stepY = 2.f / static_cast<float>(height);
+		float laneOffsets[Lanes];
+		for (size_t lane = 0; lane < Lanes; lane++)
+			laneOffsets[lane] = static_cast<float>(lane) * stepX;
+		const Pack<float> offsets = LoadPack(laneOffsets);
+		ParallelFor(rows, std::max<size_t>(1, (1 << 14) / width), [&](size_t begin, size_t end)
+		{
+			float buffer[3][Lanes];
+			float padded[Lanes];
+			for (size_t row = begin; row < end; row++)
+			{
+				const Pack<float> y = BroadcastPack(1.f - (static_cast<float>(row) + 0.5f) * stepY);
+				const float* rowDepth = depth.data() + row * width;
+				Vec3f* rowPoints = points.data() + row * width;
+				for (size_t first = 0; first < width; first += Lanes)
+				{
+					const size_t lanes = std::min(Lanes, width - first);
+					const Pack<float> x = BroadcastPack((static_cast<float>(first) + 0.5f) * stepX - 1.f) + offsets;
+					Pack<float> z;
+					if (lanes == Lanes)
+						z = LoadPack(rowDepth + first);
+					else
+					{
+						for (size_t lane = 0; lane < Lanes; lane++)
+							padded[lane] = rowDepth[first + std::min(lane, lanes - 1)];
+						z = LoadPack(padded);
+					}
+					Projector::Unproject(inverseViewProjection, x, y, z, buffer);
+					for (size_t lane = 0; lane < lanes; lane++)
+						rowPoints[first + lane] = Vec3f(buffer[0][lane], buffer[1][lane], buffer[2][lane]);
+				}
+			}
+		});
+	}
+#pragma endregion
+
+#pragma region Screen Projection
+	inline void Projector::GetClipFlags(const Expression::Pack<float>& x, const Expression::Pack<float>& y, const Expression::Pack<float>& z, const Expression::Pack<float>& w, const Viewport& viewport, uint8_t* output)
+	{
+		using namespace Expression;
+		constexpr size_t Lanes = PackSize<float>;
+		const Pack<float> zero = BroadcastPack(0.f);
+		const Pack<float> infinity = BroadcastPack(std::numeric_limits<float>::infinity());
+		const Pack<float> guard = BroadcastPack(viewport.guardBand) * w;
+		// Lanes where w > 0 fails, NaN included, and lanes with a coordinate that is not finite: none of them has a screen position
+		auto finite = [&](const Pack<float>& v) { return LessMask(-infinity, v) & LessMask(v, infinity); };
+		const uint32_t behind = ~(LessMask(zero, w) & finite(x) & finite(y) & finite(z) & finite(w)) & ((1u << Lanes) - 1);
+		uint32_t nearMask, farMask;
+		switch (viewport.range)
+		{
+		case DepthRange::ZeroToOne:
+			nearMask = LessMask(z, zero);
+			farMask = LessMask(w, z);
+			break;
+		case DepthRange::ReverseZ:
+			nearMask = LessMask(w, z);
+			farMask = LessMask(z, zero);
+			break;
+		default:
+			nearMask = LessMask(z, -w);
+			farMask = LessMask(w, z);
+			break;
+		}
+		// In the bit order of ClipFlags
+		const uint32_t masks[7] = { LessMask(x, -w), LessMask(w, x), LessMask(y, -w), LessMask(w, y), nearMask | behind, farMask,
+			LessMask(x, -guard) | LessMask(guard, x) | LessMask(y, -guard) | LessMask(guard, y) };
+		for (size_t lane = 0; lane < Lanes; lane++)
+		{
+			uint32_t flags = 0;
+			for (size_t bit = 0; bit < 7; bit++)
+				flags |= (masks[bit] >> lane & 1) << bit;
+			output[lane] = static_cast<uint8_t>(flags);
+		}
+	}
+
+	inline void ProjectToScreen(const Mat4f& viewProjection, const Viewport& viewport, std::span<const Vec3f> points, std::span<Vec3f> screen, std::span<uint8_t> clipFlags)
+	{
+		MATH_INSTRUMENT_SCOPE("ProjectToScreen(Mat4, Viewport, span, span, span)");
+		const size_t count = std::min({ points.size(), screen.size(), clipFlags.size() });
+		MATH_INSTRUMENT_ITEMS(count);
+		using namespace Expression;
+		constexpr size_t Lanes = PackSize<float>;
+		const Mat4f& m = viewProjection;
+		ParallelFor(count, 1 << 14, [&](size_t begin, size_t end)
+		{
+			const Pack<float> zero = BroadcastPack(0.f);
+			const Pack<float> one = BroadcastPack(1.f);
+			const Pack<float> halfWidth = BroadcastPack(viewport.width * 0.5f);
+			const Pack<float> halfHeight = BroadcastPack(viewport.height * 0.5f);
+			float buffer[3][Lanes];
+			uint8_t flags[Lanes];
+			for (size_t first = begin; first < end; first += Lanes)
+			{
+				const size_t lanes = std::min(Lanes, end - first);
+				// Padding lanes repeat the last point
+				for (size_t lane = 0; lane < Lanes; lane++)
+				{
+					const Vec3f& point = points[first + std::min(lane, lanes - 1)];
+					buffer[0][lane] = point.x;
+					buffer[1][lane] = point.y;
+					buffer[2][lane] = point.z;
+				}
+				const Pack<float> x = LoadPack(buffer[0]), y = LoadPack(buffer[1]), z = LoadPack(buffer[2]);
+				auto row = [&](size_t r) { return BroadcastPack(m.content[0][r]) * x + BroadcastPack(m.content[1][r]) * y + BroadcastPack(m.content[2][r]) * z + BroadcastPack(m.content[3][r]); };
+				const Pack<float> clipX = row(0), clipY = row(1), clipZ = row(2), clipW = row(3);
+				Projector::GetClipFlags(clipX, clipY, clipZ, clipW, viewport, flags);
+
+				// Lanes at or behind w = 0 are divided by 1 so they stay finite
+				const Pack<float> inverseW = ReciprocalPack(SelectLessPack(zero, clipW, clipW, one));
+				StorePack(buffer[0], clipX * inverseW * halfWidth + halfWidth);
+				StorePack(buffer[1], halfHeight - clipY * inverseW * halfHeight);
+				StorePack(buffer[2], clipZ * inverseW);
+				for (size_t lane = 0; lane < lanes; lane++)
+				{
+					screen[first + lane] = Vec3f(buffer[0][lane], buffer[1][lane], buffer[2][lane]);
+					clipFlags[first + lane] = flags[lane];
+				}
+			}
+		});
+	}
+
+	inline void BinToTiles(std::span<const Vec3f> screen, std::span<const uint8_t> clipFlags, const Viewport& viewport, uint32_t tileSize, ScreenTiles& tiles)
+	{
+		MATH_INSTRUMENT_SCOPE("BinToTiles(span, span, Viewport, uint32_t, ScreenTiles)");
+		const size_t count = std::min(screen.size(), clipFlags.size());
+		MATH_INSTRUMENT_ITEMS(count);
+		constexpr size_t Grain = 1 << 14;
+		constexpr uint32_t Outside = UINT32_MAX;
+		if (tileSize == 0)
+		{
+			tiles = ScreenTiles();
+			return;
+		}
+		tiles.tileSize = tileSize;
+		tiles.columns = std::max(1u, (static_cast<uint32_t>(std::ceil(viewport.width)) + tileSize - 1) / tileSize);
+		tiles.rows = std::max(1u, (static_cast<uint32_t>(std::ceil(viewport.height)) + tileSize - 1) / tileSize);
+		const size_t tileCount = tiles.GetTileCount();
+		const size_t chunks = (count + Grain - 1) / Grain;
+		const float inverseSize = 1.f / static_cast<float>(tileSize);
+
+		std::vector<uint32_t> tileOf(count);
+		std::vector<uint32_t> chunkOffsets(chunks * tileCount, 0);
+		ParallelFor(count, Grain, [&](size_t begin, size_t end)
+		{
+			uint32_t* counts = chunkOffsets.data() + begin / Grain * tileCount;
+			for (size_t i = begin; i < end; i++)
+			{
+				if (clipFlags[i] & ClipSides)
+				{
+					tileOf[i] = Outside;
+					continue;
+				}
+				// Points on the right and bottom edges, or past them by a rounding, go to the last tile.
+				// Clamped before the conversion so unflagged positions off screen or NaN stay defined
+				const float lastColumn = static_cast<float>(tiles.columns - 1), lastRow = static_cast<float>(tiles.rows - 1);
+				const uint32_t column = static_cast<uint32_t>(screen[i].x > 0.f ? std::min(screen[i].x * inverseSize, lastColumn) : 0.f);
+				const uint32_t row = static_cast<uint32_t>(screen[i].y > 0.f ? std::min(screen[i].y * inverseSize, lastRow) : 0.f);
+				tileOf[i] = row * tiles.columns + column;
+				counts[tileOf[i]]++;
+			}
+		});
+
+		// Chunk c writes tile t after every smaller tile and after tile t of the chunks before it
+		tiles.offsets.assign(tileCount + 1, 0);
+		uint32_t start = 0;
+		for (size_t tile = 0; tile < tileCount; tile++)
+		{
+			tiles.offsets[tile] = start;
+			for (size_t chunk = 0; chunk < chunks; chunk++)
+			{
+				const uint32_t chunkCount = chunkOffsets[chunk * tileCount + tile];
+				chunkOffsets[chunk * tileCount + tile] = start;
+				start += chunkCount;
+			}
+		}
+		tiles.offsets[tileCount] = start;
+		tiles.indices.resize(start);
+		ParallelFor(count, Grain, [&](size_t begin, size_t end)
+		{
+			uint32_t* next = chunkOffsets.data() + begin / Grain * tileCount;
+			for (size_t i = begin; i < end; i++)
+			{
+				if (tileOf[i] != Outside)
+					tiles.indices[next[tileOf[i]]++] = static_cast<uint32_t>(i);
+			}
+		});
+	}
+#pragma endregion
+
+#pragma region Camera
+	inline Camera::Camera(const Vec3f& _position, const Quat& _rotation, float _fov, float _aspect, float _nearPlane, float _farPlane, DepthRange _depthRange)
+		: position(_position), rotation(_rotation), fov(_fov), aspect(_aspect), nearPlane(_nearPlane), farPlane(_farPlane), depthRange(_depthRange)
+	{
+	}
+
+	inline void Camera::Invalidate(uint8_t flags)
+	{
+		stale |= flags;
+		version++;
+	}
+
+	inline void Camera::SetPosition(const Vec3f& _position)
+	{
+		if (_position.x == position.x && _position.y == position.y && _position.z == position.z)
+			return;
+		position = _position;
+		Invalidate(Pose);
+	}
+
+	inline void Camera::SetRotation(const Quat& _rotation)
+	{
+		if (_rotation.x == rotation.x && _rotation.y == rotation.y && _rotation.z == rotation.z && _rotation.w == rotation.w)
+			return;
+		rotation = _rotation;
+		Invalidate(Pose);
+	}
+
+	inline void Camera::SetFov(float _fov)
+	{
+		if (_fov == fov)
+			return;
+		fov = _fov;
+		Invalidate(Optics);
+	}
+
+	inline void Camera::SetAspect(float _aspect)
+	{
+		if (_aspect == aspect)
+			return;
+		aspect = _aspect;
+		Invalidate(Optics);
+	}
+
+	inline void Camera::SetClipPlanes(float _nearPlane, float _farPlane)
+	{
+		if (_nearPlane == nearPlane && _farPlane == farPlane)
+			return;
+		nearPlane = _nearPlane;
+		farPlane = _farPlane;
+		Invalidate(Optics);
+	}
+
+	inline void Camera::SetDepthRange(DepthRange _depthRange)
+	{
+		if (_depthRange == depthRange)
+			return;
+		depthRange = _depthRange;
+		Invalidate(Optics);
+	}
+
+	inline const Mat4f& Camera::GetViewMatrix() const
+	{
+		if (stale & View)
+		{
+			MATH_INSTRUMENT_SCOPE("Camera::GetViewMatrix()");
+			// Inverse of translation * rotation * scale(1, 1, -1): the transposed rotation with its third row negated,
+			// then the position moved by it
+			const Mat4f r = rotation.ToRotationMatrix();
+			const Vec3f axes[3] = { Vec3f(r.content[0]), Vec3f(r.content[1]), -Vec3f(r.content[2]) };
+			for (size_t c = 0; c < 3; c++)
+				view.content[c] = Vec4f(axes[0][c], axes[1][c], axes[2][c], 0.f);
+			view.content[3] = Vec4f(-axes[0].Dot(position), -axes[1].Dot(position), -axes[2].Dot(position), 1.f);
+			stale &= ~View;
+		}
+		return view;
+	}
+
+	inline const Mat4f& Camera::GetInverseViewMatrix() const
+	{
+		if (stale & InverseView)
+		{
+			MATH_INSTRUMENT_SCOPE("Camera::GetInverseViewMatrix()");
+			const Mat4f r = rotation.ToRotationMatrix();
+			inverseView = Mat4f(r.content[0], r.content[1], -r.content[2], Vec4f(position, 1.f));
+			stale &= ~InverseView;
+		}
+		return inverseView;
+	}
+
+	inline const Mat4f& Camera::GetProjectionMatrix() const
+	{
+		if (stale & Lens)
+		{
+			projection = Projection::CreatePerspective(fov, aspect, nearPlane, farPlane, depthRange);
+			stale &= ~Lens;
+		}
+		return projection.matrix;
+	}
+
+	inline const Mat4f& Camera::GetInverseProjectionMatrix() const
+	{
+		GetProjectionMatrix();
+		return projection.inverse;
+	}
+
+	inline const Mat4f& Camera::GetViewProjectionMatrix() const
+	{
+		if (stale & ViewProjection)
+		{
+			MATH_INSTRUMENT_SCOPE("Camera::GetViewProjectionMatrix()");
+			viewProjection = GetProjectionMatrix() * GetViewMatrix();
+			stale &= ~ViewProjection;
+		}
+		return viewProjection;
+	}
+
+	inline const Mat4f& Camera::GetInverseViewProjectionMatrix() const
+	{
+		if (stale & InverseViewProjection)
+		{
+			MATH_INSTRUMENT_SCOPE("Camera::GetInverseViewProjectionMatrix()");
+			inverseViewProjection = GetInverseViewMatrix() * GetInverseProjectionMatrix();
+			stale &= ~InverseViewProjection;
+		}
+		return inverseViewProjection;
+	}
+
+	inline const Frustum& Camera::GetFrustum() const
+	{
+		if (stale & Planes)
+		{
+			MATH_INSTRUMENT_SCOPE("Camera::GetFrustum()");
+			frustum = Frustum::FromMatrix(GetViewProjectionMatrix(), depthRange);
+			stale &= ~Planes;
+		}
+		return frustum;
+	}
+
+	inline void Camera::Update()
+	{
+		GetFrustum();
+		GetInverseViewProjectionMatrix();
+	}
+#pragma endregion
+}
@@ -0,0 +1,157 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "Maths.h"
+#include "MathArray.h"
+#include "MathGeometry.h"
+#include "MathParallel.h"
+
+namespace GALAXY::Math
+{
+	// Convex hull of a point set, built with quickhull. Triangles wind counter clockwise seen from outside.
+	// Flat point sets give a polygon triangulated on both sides, collinear ones a segment without triangles
+	class ConvexHull
+	{
+	public:
+		static constexpr uint32_t None = 0xFFFFFFFF;
+
+		inline ConvexHull() = default;
+
+		explicit inline ConvexHull(std::span<const Vec3f> points);
+
+		inline std::span<const Vec3f> GetVertices() const { return vertices; }
+
+		// Three vertex indices per triangle
+		inline std::span<const uint32_t> GetIndices() const { return indices; }
+
+		inline size_t GetTriangleCount() const { return indices.size() / 3; }
+
+		inline const AABB& GetBounds() const { return bounds; }
+
+		// True when built from no points, such a hull has no support and collides with nothing
+		inline bool IsEmpty() const { return vertices.empty(); }
+
+		// Index of the vertex furthest along direction, the first one on ties, None when the hull is empty
+		inline uint32_t GetSupport(const Vec3f& direction) const;
+
+	private:
+		std::vector<Vec3f> vertices;
+		std::vector<uint32_t> indices;
+		// Vertices one array per component, padded to a multiple of 8 with the first vertex for the SIMD search
+		Vec3SoA<float> search;
+		AABB bounds;
+	};
+
+	// Index of the point of the stream furthest along direction, the first one on ties
+	inline uint32_t FindSupport(std::span<const float> x, std::span<const float> y, std::span<const float> z, const Vec3f& direction);
+
+	// A hull placed in the world by a linear transform and a translation, swept by a sphere of radius.
+	// A one point hull with a radius is a sphere, a two point one a capsule. The hull must outlive the shape
+	struct ConvexShape
+	{
+		const ConvexHull* hull = nullptr;
+		// Columns of the linear part, rotation and scale
+		Vec3f axes[3] = { Vec3f(1.f, 0.f, 0.f), Vec3f(0.f, 1.f, 0.f), Vec3f(0.f, 0.f, 1.f) };
+		Vec3f position;
+		float radius = 0.f;
+
+		inline ConvexShape() = default;
+
+		inline ConvexShape(const ConvexHull& hull, const Mat4f& transform, float radius = 0.f);
+
+		inline ConvexShape(const ConvexHull& hull, const Vec3f& position, const Quat& rotation, float radius = 0.f);
+
+		// Furthest point of the transformed hull along direction, radius not included. The hull must not be empty
+		inline Vec3f GetSupport(const Vec3f& direction) const;
+
+		// Radius included
+		inline AABB GetBounds() const;
+	};
+
+	struct ClosestPoints
+	{
+		Vec3f pointA, pointB;
+		float distance = 0.f;
+	};
+
+	struct Contact
+	{
+		// From A to B: moving B by normal * depth separates the shapes
+		Vec3f normal;
+		float depth = 0.f;
+		// Deepest point of each shape inside the other
+		Vec3f pointA, pointB;
+	};
+
+	// GJK: closest points of the shapes' surfaces, false when they touch or overlap or a hull is empty
+	inline bool ComputeDistance(const ConvexShape& a, const ConvexShape& b, ClosestPoints& result);
+
+	// GJK, then EPA on the hulls when they overlap: false when the shapes do not touch or a hull is empty
+	inline bool ComputePenetration(const ConvexShape& a, const ConvexShape& b, Contact& contact);
+
+	// Contacts of the broadphase pairs of shapes, spread over the workers. Pairs whose bounds do not overlap are skipped.
+	// touching gets the index of every touching pair and contacts its contact, in pair order
+	inline void CollidePairs(std::span<const ConvexShape> shapes, std::span<const std::pair<uint32_t, uint32_t>> pairs, std::vector<uint32_t>& touching, std::vector<Contact>& contacts);
+
+	namespace Collision
+	{
+		// Quickhull face, neighbour k shares the edge from vertex k to vertex k + 1
+		struct HullFace
+		{
+			uint32_t vertex[3];
+			uint32_t neighbour[3];
+			Vec3f normal;
+			float offset = 0.f;
+			// Points above the face not yet on the hull
+			std::vector<uint32_t> outside;
+			bool visible = false;
+			bool removed = false;
+
+			inline float GetDistance(const Vec3f& point) const { return normal.Dot(point) - offset; }
+		};
+
+		inline HullFace MakeHullFace(std::span<const Vec3f> points, uint32_t a, uint32_t b, uint32_t c);
+
+		// Neighbours of a closed set of faces from the edges they share, used for the starting tetrahedra
+		inline void LinkHullFaces(std::span<HullFace> faces);
+
+		// Polygon of a flat point set in the plane of normal, counter clockwise around it
+		inline std::vector<uint32_t> GetFlatHull(std::span<const Vec3f> points, const Vec3f& normal, const Vec3f& tangent);
+
+		// Point of the Minkowski difference A - B with the support points it came from
+		struct SupportPoint
+		{
+			Vec3f w, a, b;
+		};
+
+		struct Simplex
+		{
+			SupportPoint points[4];
+			float weights[4];
+			uint32_t count = 0;
+		};
+
+		inline void SolveSegment(Simplex& simplex, Vec3f& closest);
+
+		inline void SolveTriangle(Simplex& simplex, Vec3f& closest);
+
+		// Closest point of the simplex to the origin, dropping the vertices it does not depend on. False when a tetrahedron holds the origin
+		inline bool SolveSimplex(Simplex& simplex, Vec3f& closest);
+
+		// GJK on the hulls without radius, the simplex is kept for EPA. False when they overlap
+		inline bool Distance(const ConvexShape& a, const ConvexShape& b, Simplex& simplex, Vec3f& closest);
+
+		// EPA from a simplex holding the origin. The polytope grows like quickhull, when rounding breaks its surface
+		// the closest face found so far is the answer
+		inline bool Penetration(const ConvexShape& a, const ConvexShape& b, Simplex& simplex, Contact& contact);
+
+		// ComputePenetration without instrumentation, shared with the batch
+		inline bool Collide(const ConvexShape& a, const ConvexShape& b, Contact& contact);
+	}
+}
+
+#include "MathCollision.inl"
@@ -0,0 +1,939 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+
+#include "MathCollision.h"
+
+namespace GALAXY::Math
+{
+#pragma region Convex Hull
+	namespace Collision
+	{
+		inline HullFace MakeHullFace(std::span<const Vec3f> points, uint32_t a, uint32_t b, uint32_t c)
+		{
+			HullFace face;
+			face.vertex[0] = a;
+			face.vertex[1] = b;
+			face.vertex[2] = c;
+			const Vec3f normal = (points[b] - points[a]).Cross(points[c] - points[a]);
+			const float length = normal.Length();
+			face.normal = length > 0.f ? normal / length : Vec3f();
+			face.offset = face.normal.Dot(points[a]);
+			return face;
+		}
+
+		inline void LinkHullFaces(std::span<HullFace> faces)
+		{
+			for (HullFace& face : faces)
+			{
+				for (uint32_t k = 0; k < 3; k++)
+				{
+					for (uint32_t g = 0; g < faces.size(); g++)
+					{
+						const uint32_t* other = faces[g].vertex;
+						for (uint32_t j = 0; j < 3; j++)
+						{
+							if (other[j] == face.vertex[(k + 1) % 3] && other[(j + 1) % 3] == face.vertex[k])
+								face.neighbour[k] = g;
+						}
+					}
+				}
+			}
+		}
+
+		// Andrew's monotone chain on the points projected on the plane
+		inline std::vector<uint32_t> GetFlatHull(std::span<const Vec3f> points, const Vec3f& normal, const Vec3f& tangent)
+		{
+			const Vec3f bitangent = normal.Cross(tangent);
+			std::vector<std::pair<float, float>> projected(points.size());
+			std::vector<uint32_t> order(points.size());
+			for (size_t i = 0; i < points.size(); i++)
+			{
+				projected[i] = { points[i].Dot(tangent), points[i].Dot(bitangent) };
+				order[i] = static_cast<uint32_t>(i);
+			}
+			std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return projected[a] < projected[b]; });
+			auto turn = [&](uint32_t o, uint32_t a, uint32_t b)
+			{
+				return (projected[a].first - projected[o].first) * (projected[b].second - projected[o].second) - (projected[a].second - projected[o].second) * (projected[b].first - projected[o].first);
+			};
+
+			std::vector<uint32_t> polygon(2 * points.size());
+			size_t count = 0;
+			for (size_t i = 0; i < order.size(); i++)
+			{
+				while (count >= 2 && turn(polygon[count - 2], polygon[count - 1], order[i]) <= 0.f)
+					count--;
+				polygon[count++] = order[i];
+			}
+			for (size_t i = order.size() - 1, lower = count + 1; i-- > 0;)
+			{
+				while (count >= lower && turn(polygon[count - 2], polygon[count - 1], order[i]) <= 0.f)
+					count--;
+				polygon[count++] = order[i];
+			}
+			polygon.resize(count - 1);
+			return polygon;
+		}
+	}
+
+	inline ConvexHull::ConvexHull(std::span<const Vec3f> points)
+	{
+		MATH_INSTRUMENT_SCOPE("ConvexHull::ConvexHull(span)");
+		MATH_INSTRUMENT_ITEMS(points.size());
+		using Collision::HullFace;
+		if (points.empty())
+			return;
+
+		// Tolerance from the magnitude of the coordinates, points closer than this to a face are on it
+		AABB box;
+		for (const Vec3f& point : points)
+			box.Grow(point);
+		float epsilon = 0.f;
+		for (size_t axis = 0; axis < 3; axis++)
+			epsilon += std::max(std::abs(box.min[axis]), std::abs(box.max[axis]));
+		epsilon *= 8.f * FLT_EPSILON;
+
+		// Initial tetrahedron from the extreme points, each step giving up on a dimension when the points do not span it
+		uint32_t extremes[6] = {};
+		for (uint32_t i = 0; i < points.size(); i++)
+		{
+			for (size_t axis = 0; axis < 3; axis++)
+			{
+				if (points[i][axis] < points[extremes[axis]][axis])
+					extremes[axis] = i;
+				if (points[i][axis] > points[extremes[axis + 3]][axis])
+					extremes[axis + 3] = i;
+			}
+		}
+		uint32_t simplex[4] = {};
+		float best = -1.f;
+		for (size_t axis = 0; axis < 3; axis++)
+		{
+			const float distance = (points[extremes[axis + 3]] - points[extremes[axis]]).LengthSquared();
+			if (distance > best)
+			{
+				best = distance;
+				simplex[0] = extremes[axis];
+				simplex[1] = extremes[axis + 3];
+			}
+		}
+
+		std::vector<uint32_t> kept;
+		const Vec3f line = points[simplex[1]] - points[simplex[0]];
+		if (best <= epsilon * epsilon)
+		{
+			kept = { simplex[0] };
+		}
+		else
+		{
+			best = 0.f;
+			for (uint32_t i = 0; i < points.size(); i++)
+			{
+				const float distance = line.Cross(points[i] - points[simplex[0]]).LengthSquared();
+				if (distance > best)
+				{
+					best = distance;
+					simplex[2] = i;
+				}
+			}
+			if (best <= line.LengthSquared() * epsilon * epsilon)
+				kept = { simplex[0], simplex[1] };
+		}
+
+		Vec3f normal;
+		if (kept.empty())
+		{
+			normal = line.Cross(points[simplex[2]] - points[simplex[0]]).GetNormalize();
+			best = 0.f;
+			for (uint32_t i = 0; i < points.size(); i++)
+			{
+				const float distance = std::abs(normal.Dot(points[i] - points[simplex[0]]));
+				if (distance > best)
+				{
+					best = distance;
+					simplex[3] = i;
+				}
+			}
+		}
+
+		std::vector<HullFace> faces;
+		if (kept.empty() && best <= epsilon)
+		{
+			// Flat: the polygon once per side
+			kept = Collision::GetFlatHull(points, normal, line.GetNormalize());
+			const uint32_t count = static_cast<uint32_t>(kept.size());
+			for (uint32_t i = 1; i + 1 < count; i++)
+			{
+				indices.insert(indices.end(), { 0, i, i + 1 });
+				indices.insert(indices.end(), { 0, i + 1, i });
+			}
+		}
+		else if (kept.empty())
+		{
+			// The base faces away from the fourth point, the sides wind around it
+			if (normal.Dot(points[simplex[3]] - points[simplex[0]]) > 0.f)
+				std::swap(simplex[1], simplex[2]);
+			faces.push_back(Collision::MakeHullFace(points, simplex[0], simplex[1], simplex[2]));
+			faces.push_back(Collision::MakeHullFace(points, simplex[0], simplex[3], simplex[1]));
+			faces.push_back(Collision::MakeHullFace(points, simplex[1], simplex[3], simplex[2]));
+			faces.push_back(Collision::MakeHullFace(points, simplex[2], simplex[3], simplex[0]));
+			Collision::LinkHullFaces(faces);
+
+			for (uint32_t i = 0; i < points.size(); i++)
+			{
+				if (i == simplex[0] || i == simplex[1] || i == simplex[2] || i == simplex[3])
+					continue;
+				for (HullFace& face : faces)
+				{
+					if (face.GetDistance(points[i]) > epsilon)
+					{
+						face.outside.push_back(i);
+						break;
+					}
+				}
+			}
+
+			// Adds the furthest outside point of a face: the faces it sees are replaced by a fan from the horizon to it
+			struct HorizonEdge
+			{
+				uint32_t from, to, face;
+			};
+			std::vector<uint32_t> pending = { 0, 1, 2, 3 }, visible, stack;
+			std::vector<HorizonEdge> horizon;
+			while (!pending.empty())
+			{
+				const uint32_t start = pending.back();
+				pending.pop_back();
+				if (faces[start].removed || faces[start].outside.empty())
+					continue;
+
+				uint32_t eye = faces[start].outside[0];
+				float eyeDistance = -FLT_MAX;
+				for (uint32_t i : faces[start].outside)
+				{
+					const float distance = faces[start].GetDistance(points[i]);
+					if (distance > eyeDistance)
+					{
+						eyeDistance = distance;
+						eye = i;
+					}
+				}
+
+				visible.clear();
+				horizon.clear();
+				stack = { start };
+				faces[start].visible = true;
+				while (!stack.empty())
+				{
+					const uint32_t f = stack.back();
+					stack.pop_back();
+					visible.push_back(f);
+					for (uint32_t k = 0; k < 3; k++)
+					{
+						const uint32_t n = faces[f].neighbour[k];
+						if (!faces[n].visible && faces[n].GetDistance(points[eye]) > epsilon)
+						{
+							faces[n].visible = true;
+							stack.push_back(n);
+						}
+					}
+				}
+				for (uint32_t f : visible)
+				{
+					for (uint32_t k = 0; k < 3; k++)
+					{
+						if (!faces[faces[f].neighbour[k]].visible)
+							horizon.push_back({ faces[f].vertex[k], faces[f].vertex[(k + 1) % 3], faces[f].neighbour[k] });
+					}
+				}
+
+				// The horizon must be one loop, rounding can break that for points barely outside: they are dropped
+				bool loop = true;
+				for (size_t i = 0; i + 1 < horizon.size() && loop; i++)
+				{
+					size_t next = i + 1;
+					while (next < horizon.size() && horizon[next].from != horizon[i].to)
+						next++;
+					loop = next < horizon.size();
+					if (loop)
+						std::swap(horizon[i + 1], horizon[next]);
+				}
+				loop &= horizon.size() >= 3 && horizon.back().to == horizon.front().from;
+				if (!loop)
+				{
+					for (uint32_t f : visible)
+						faces[f].visible = false;
+					std::erase(faces[start].outside, eye);
+					pending.push_back(start);
+					continue;
+				}
+
+				const uint32_t first = static_cast<uint32_t>(faces.size());
+				const uint32_t count = static_cast<uint32_t>(horizon.size());
+				for (uint32_t i = 0; i < count; i++)
+				{
+					HullFace face = Collision::MakeHullFace(points, horizon[i].from, horizon[i].to, eye);
+					face.neighbour[0] = horizon[i].face;
+					face.neighbour[1] = first + (i + 1) % count;
+					face.neighbour[2] = first + (i + count - 1) % count;
+					HullFace& outer = faces[horizon[i].face];
+					for (uint32_t k = 0; k < 3; k++)
+					{
+						if (outer.vertex[k] == horizon[i].to)
+							outer.neighbour[k] = first + i;
+					}
+					faces.push_back(std::move(face));
+					pending.push_back(first + i);
+				}
+				for (uint32_t f : visible)
+				{
+					for (uint32_t i : faces[f].outside)
+					{
+						if (i == eye)
+							continue;
+						for (uint32_t g = first; g < first + count; g++)
+						{
+							if (faces[g].GetDistance(points[i]) > epsilon)
+							{
+								faces[g].outside.push_back(i);
+								break;
+							}
+						}
+					}
+					faces[f].removed = true;
+					faces[f].outside = std::vector<uint32_t>();
+				}
+			}
+		}
+
+		// Keep the vertices the faces use: in input order for a solid hull, in polygon order for a flat one
+		std::vector<uint32_t> remap(points.size(), 0xFFFFFFFF);
+		if (faces.empty())
+		{
+			for (uint32_t& index : indices)
+				index = kept[index];
+		}
+		else
+		{
+			for (const HullFace& face : faces)
+			{
+				if (!face.removed)
+					indices.insert(indices.end(), face.vertex, face.vertex + 3);
+			}
+			kept = indices;
+			std::sort(kept.begin(), kept.end());
+			kept.erase(std::unique(kept.begin(), kept.end()), kept.end());
+		}
+		for (uint32_t i : kept)
+		{
+			remap[i] = static_cast<uint32_t>(vertices.size());
+			vertices.push_back(points[i]);
+			bounds.Grow(points[i]);
+		}
+		for (uint32_t& index : indices)
+			index = remap[index];
+
+		search.Resize((vertices.size() + 7) / 8 * 8, vertices[0]);
+		for (size_t i = 0; i < vertices.size(); i++)
+			search.Set(i, vertices[i]);
+	}
+
+	inline uint32_t ConvexHull::GetSupport(const Vec3f& direction) const
+	{
+		if (vertices.empty())
+			return None;
+		return FindSupport(search.x, search.y, search.z, direction);
+	}
+
+	inline uint32_t FindSupport(std::span<const float> x, std::span<const float> y, std::span<const float> z, const Vec3f& direction)
+	{
+		const size_t count = x.size();
+		size_t i = 0;
+		float best = -FLT_MAX;
+		uint32_t bestIndex = 0;
+#if defined(MATH_AVX)
+		if (count >= 8)
+		{
+			// Best dot and its index per lane, indices kept as floats so the select is one blend
+			const __m256 dx = _mm256_set1_ps(direction.x), dy = _mm256_set1_ps(direction.y), dz = _mm256_set1_ps(direction.z);
+			__m256 bestDots = _mm256_set1_ps(-FLT_MAX);
+			__m256 bestLanes = _mm256_setzero_ps();
+			__m256 lanes = _mm256_setr_ps(0.f, 1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f);
+			const __m256 step = _mm256_set1_ps(8.f);
+			for (; i + 8 <= count; i += 8)
+			{
+				const __m256 dot = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(&x[i]), dx), _mm256_mul_ps(_mm256_loadu_ps(&y[i]), dy)), _mm256_mul_ps(_mm256_loadu_ps(&z[i]), dz));
+				const __m256 greater = _mm256_cmp_ps(dot, bestDots, _CMP_GT_OQ);
+				bestDots = _mm256_blendv_ps(bestDots, dot, greater);
+				bestLanes = _mm256_blendv_ps(bestLanes, lanes, greater);
+				lanes = _mm256_add_ps(lanes, step);
+			}
+			alignas(32) float dots[8], indices[8];
+			_mm256_store_ps(dots, bestDots);
+			_mm256_store_ps(indices, bestLanes);
+			for (size_t lane = 0; lane < 8; lane++)
+			{
+				const uint32_t index = static_cast<uint32_t>(indices[lane]);
+				if (dots[lane] > best || (dots[lane] == best && index < bestIndex))
+				{
+					best = dots[lane];
+					bestIndex = index;
+				}
+			}
+		}
+#elif defined(MATH_SSE)
+		if (count >= 4)
+		{
+			const __m128 dx = _mm_set1_ps(direction.x), dy = _mm_set1_ps(direction.y), dz = _mm_set1_ps(direction.z);
+			__m128 bestDots = _mm_set1_ps(-FLT_MAX);
+			__m128 bestLanes = _mm_setzero_ps();
+			__m128 lanes = _mm_setr_ps(0.f, 1.f, 2.f, 3.f);
+			const __m128 step = _mm_set1_ps(4.f);
+			for (; i + 4 <= count; i += 4)
+			{
+				const __m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&x[i]), dx), _mm_mul_ps(_mm_loadu_ps(&y[i]), dy)), _mm_mul_ps(_mm_loadu_ps(&z[i]), dz));
+				const __m128 greater = _mm_cmpgt_ps(dot, bestDots);
+				bestDots = _mm_or_ps(_mm_and_ps(greater, dot), _mm_andnot_ps(greater, bestDots));
+				bestLanes = _mm_or_ps(_mm_and_ps(greater, lanes), _mm_andnot_ps(greater, bestLanes));
+				lanes = _mm_add_ps(lanes, step);
+			}
+			alignas(16) float dots[4], indices[4];
+			_mm_store_ps(dots, bestDots);
+			_mm_store_ps(indices, bestLanes);
+			for (size_t lane = 0; lane < 4; lane++)
+			{
+				const uint32_t index = static_cast<uint32_t>(indices[lane]);
+				if (dots[lane] > best || (dots[lane] == best && index < bestIndex))
+				{
+					best = dots[lane];
+					bestIndex = index;
+				}
+			}
+		}
+#endif
+		for (; i < count; i++)
+		{
+			const float dot = x[i] * direction.x + y[i] * direction.y + z[i] * direction.z;
+			if (dot > best)
+			{
+				best = dot;
+				bestIndex = static_cast<uint32_t>(i);
+			}
+		}
+		return bestIndex;
+	}
+#pragma endregion
+
+#pragma region Convex Shape
+	inline ConvexShape::ConvexShape(const ConvexHull& _hull, const Mat4f& transform, float _radius) : hull(&_hull), radius(_radius)
+	{
+		for (size_t i = 0; i < 3; i++)
+			axes[i] = Vec3f(transform.content[i].x, transform.content[i].y, transform.content[i].z);
+		position = Vec3f(transform.content[3].x, transform.content[3].y, transform.content[3].z);
+	}
+
+	inline ConvexShape::ConvexShape(const ConvexHull& _hull, const Vec3f& _position, const Quat& rotation, float _radius) : hull(&_hull), position(_position), radius(_radius)
+	{
+		axes[0] = rotation * Vec3f(1.f, 0.f, 0.f);
+		axes[1] = rotation * Vec3f(0.f, 1.f, 0.f);
+		axes[2] = rotation * Vec3f(0.f, 0.f, 1.f);
+	}
+
+	inline Vec3f ConvexShape::GetSupport(const Vec3f& direction) const
+	{
+		// The support of a linear map is the map of the support along the transposed direction
+		const Vec3f local(axes[0].Dot(direction), axes[1].Dot(direction), axes[2].Dot(direction));
+		const Vec3f& vertex = hull->GetVertices()[hull->GetSupport(local)];
+		return position + axes[0] * vertex.x + axes[1] * vertex.y + axes[2] * vertex.z;
+	}
+
+	inline AABB ConvexShape::GetBounds() const
+	{
+		const AABB& local = hull->GetBounds();
+		const Vec3f center = local.GetCenter();
+		const Vec3f extent = local.GetSize() * 0.5f;
+		Vec3f worldExtent(radius);
+		for (size_t axis = 0; axis < 3; axis++)
+			worldExtent[axis] += std::abs(axes[0][axis]) * extent.x + std::abs(axes[1][axis]) * extent.y + std::abs(axes[2][axis]) * extent.z;
+		const Vec3f worldCenter = position + axes[0] * center.x + axes[1] * center.y + axes[2] * center.z;
+		return AABB(worldCenter - worldExtent, worldCenter + worldExtent);
+	}
+#pragma endregion
+
+#pragma region GJK And EPA
+	namespace Collision
+	{
+		inline void SolveSegment(Simplex& simplex, Vec3f& closest)
+		{
+			const Vec3f& a = simplex.points[0].w;
+			const Vec3f ab = simplex.points[1].w - a;
+			const float length = ab.LengthSquared();
+			const float t = length > 0.f ? std::clamp(-a.Dot(ab) / length, 0.f, 1.f) : 0.f;
+			if (t <= 0.f || t >= 1.f)
+			{
+				simplex.points[0] = simplex.points[t <= 0.f ? 0 : 1];
+				simplex.weights[0] = 1.f;
+				simplex.count = 1;
+				closest = simplex.points[0].w;
+				return;
+			}
+			simplex.weights[0] = 1.f - t;
+			simplex.weights[1] = t;
+			closest = a + ab * t;
+		}
+
+		// Ericson's closest point on a triangle by Voronoi regions, the origin standing for the query point
+		inline void SolveTriangle(Simplex& simplex, Vec3f& closest)
+		{
+			const SupportPoint a = simplex.points[0], b = simplex.points[1], c = simplex.points[2];
+			auto keep = [&](const SupportPoint& p, float wp, const SupportPoint& q, float wq)
+			{
+				simplex.points[0] = p;
+				simplex.points[1] = q;
+				simplex.weights[0] = wp;
+				simplex.weights[1] = wq;
+				simplex.count = wq > 0.f ? 2 : 1;
+				closest = p.w * wp + q.w * wq;
+			};
+			const Vec3f ab = b.w - a.w, ac = c.w - a.w;
+			const float d1 = -ab.Dot(a.w), d2 = -ac.Dot(a.w);
+			if (d1 <= 0.f && d2 <= 0.f)
+				return keep(a, 1.f, a, 0.f);
+			const float d3 = -ab.Dot(b.w), d4 = -ac.Dot(b.w);
+			if (d3 >= 0.f && d4 <= d3)
+				return keep(b, 1.f, b, 0.f);
+			const float vc = d1 * d4 - d3 * d2;
+			if (vc <= 0.f && d1 >= 0.f && d3 <= 0.f)
+			{
+				const float t = d1 / (d1 - d3);
+				return keep(a, 1.f - t, b, t);
+			}
+			const float d5 = -ab.Dot(c.w), d6 = -ac.Dot(c.w);
+			if (d6 >= 0.f && d5 <= d6)
+				return keep(c, 1.f, c, 0.f);
+			const float vb = d5 * d2 - d1 * d6;
+			if (vb <= 0.f && d2 >= 0.f && d6 <= 0.f)
+			{
+				const float t = d2 / (d2 - d6);
+				return keep(a, 1.f - t, c, t);
+			}
+			const float va = d3 * d6 - d5 * d4;
+			if (va <= 0.f && d4 - d3 >= 0.f && d5 - d6 >= 0.f)
+			{
+				const float t = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+				return keep(b, 1.f - t, c, t);
+			}
+			const float denominator = 1.f / (va + vb + vc);
+			simplex.weights[1] = vb * denominator;
+			simplex.weights[2] = vc * denominator;
+			simplex.weights[0] = 1.f - simplex.weights[1] - simplex.weights[2];
+			closest = a.w * simplex.weights[0] + b.w * simplex.weights[1] + c.w * simplex.weights[2];
+		}
+
+		inline bool SolveSimplex(Simplex& simplex, Vec3f& closest)
+		{
+			switch (simplex.count)
+			{
+			case 1:
+				simplex.weights[0] = 1.f;
+				closest = simplex.points[0].w;
+				return true;
+			case 2:
+				SolveSegment(simplex, closest);
+				return true;
+			case 3:
+				SolveTriangle(simplex, closest);
+				return true;
+			default:
+				break;
+			}
+
+			// Tetrahedron: the closest of the faces the origin is outside of, none means it is inside.
+			// Inside a face also takes the origin no further from its plane than the opposite vertex, which keeps
+			// a flat tetrahedron, whose side tests are only rounding, from holding an origin off its plane
+			static constexpr uint32_t Faces[4][4] = { { 0, 1, 2, 3 }, { 0, 3, 1, 2 }, { 0, 2, 3, 1 }, { 1, 3, 2, 0 } };
+			const Simplex tetrahedron = simplex;
+			float best = FLT_MAX;
+			for (const uint32_t (&face)[4] : Faces)
+			{
+				const Vec3f& a = tetrahedron.points[face[0]].w;
+				const Vec3f normal = (tetrahedron.points[face[1]].w - a).Cross(tetrahedron.points[face[2]].w - a);
+				const float origin = normal.Dot(a), opposite = normal.Dot(tetrahedron.points[face[3]].w - a);
+				if (origin * opposite < 0.f && std::abs(origin) <= std::abs(opposite))
+					continue;
+				Simplex candidate;
+				candidate.points[0] = tetrahedron.points[face[0]];
+				candidate.points[1] = tetrahedron.points[face[1]];
+				candidate.points[2] = tetrahedron.points[face[2]];
+				candidate.count = 3;
+				Vec3f point;
+				SolveTriangle(candidate, point);
+				if (point.LengthSquared() < best)
+				{
+					best = point.LengthSquared();
+					simplex = candidate;
+					closest = point;
+				}
+			}
+			return best != FLT_MAX;
+		}
+
+		inline bool Distance(const ConvexShape& a, const ConvexShape& b, Simplex& simplex, Vec3f& closest)
+		{
+			constexpr uint32_t MaxIterations = 64;
+			Vec3f v = a.position - b.position;
+			if (v.LengthSquared() == 0.f)
+				v = Vec3f(1.f, 0.f, 0.f);
+			simplex.count = 0;
+			float size = 0.f;
+			for (uint32_t iteration = 0; iteration < MaxIterations; iteration++)
+			{
+				SupportPoint point;
+				point.a = a.GetSupport(-v);
+				point.b = b.GetSupport(v);
+				point.w = point.a - point.b;
+
+				// Converged once the new support point gets no closer to the origin than v, or repeats a vertex.
+				// The absolute term is the rounding of the dot products, which a relative one misses at small distances
+				const float vv = v.Dot(v);
+				size = std::max(size, point.w.LengthSquared());
+				bool repeated = false;
+				for (uint32_t i = 0; i < simplex.count; i++)
+					repeated |= simplex.points[i].w == point.w;
+				if (repeated || (simplex.count > 0 && vv - v.Dot(point.w) <= 1e-6f * vv + 1e-8f * size))
+					break;
+
+				// v only gets shorter, rounding that says otherwise ends the search on the previous simplex
+				const Simplex previous = simplex;
+				simplex.points[simplex.count++] = point;
+				Vec3f next;
+				if (!SolveSimplex(simplex, next))
+					return false;
+				if (previous.count > 0 && next.LengthSquared() >= vv)
+				{
+					simplex = previous;
+					break;
+				}
+				v = next;
+				if (v.LengthSquared() <= 1e-10f * size)
+					return false;
+			}
+			closest = v;
+			return true;
+		}
+
+		inline bool Penetration(const ConvexShape& a, const ConvexShape& b, Simplex& simplex, Contact& contact)
+		{
+			constexpr uint32_t MaxIterations = 64;
+			auto support = [&](const Vec3f& direction)
+			{
+				SupportPoint point;
+				point.a = a.GetSupport(direction);
+				point.b = b.GetSupport(-direction);
+				point.w = point.a - point.b;
+				return point;
+			};
+
+			// GJK stops on a segment or triangle when the origin is on it, grow it into a tetrahedron around the origin
+			float scale = 0.f;
+			for (uint32_t i = 0; i < simplex.count; i++)
+				scale = std::max(scale, simplex.points[i].w.Length());
+			const float epsilon = 1e-5f * std::max(scale, 1e-3f);
+			if (simplex.count == 1)
+			{
+				const Vec3f directions[6] = { Vec3f(1.f, 0.f, 0.f), Vec3f(-1.f, 0.f, 0.f), Vec3f(0.f, 1.f, 0.f), Vec3f(0.f, -1.f, 0.f), Vec3f(0.f, 0.f, 1.f), Vec3f(0.f, 0.f, -1.f) };
+				for (const Vec3f& direction : directions)
+				{
+					const SupportPoint point = support(direction);
+					if ((point.w - simplex.points[0].w).Length() > epsilon)
+					{
+						simplex.points[simplex.count++] = point;
+						break;
+					}
+				}
+			}
+			if (simplex.count == 2)
+			{
+				const Vec3f line = (simplex.points[1].w - simplex.points[0].w).GetNormalize();
+				const Vec3f axis = std::abs(line.x) < 0.57f ? Vec3f(1.f, 0.f, 0.f) : std::abs(line.y) < 0.57f ? Vec3f(0.f, 1.f, 0.f) : Vec3f(0.f, 0.f, 1.f);
+				const Vec3f tangent = line.Cross(axis).GetNormalize();
+				const Vec3f directions[4] = { tangent, -tangent, line.Cross(tangent), -line.Cross(tangent) };
+				for (const Vec3f& direction : directions)
+				{
+					const SupportPoint point = support(direction);
+					if (line.Cross(point.w - simplex.points[0].w).Length() > epsilon)
+					{
+						simplex.points[simplex.count++] = point;
+						break;
+					}
+				}
+			}
+			if (simplex.count == 3)
+			{
+				const Vec3f normal = (simplex.points[1].w - simplex.points[0].w).Cross(simplex.points[2].w - simplex.points[0].w).GetNormalize();
+				for (const Vec3f& direction : { normal, -normal })
+				{
+					const SupportPoint point = support(direction);
+					if (std::abs(normal.Dot(point.w - simplex.points[0].w)) > epsilon)
+					{
+						simplex.points[simplex.count++] = point;
+						break;
+					}
+				}
+			}
+			// The polytope as quickhull faces over the w of the support points, wound away from the opposite vertex
+			std::vector<SupportPoint> vertices(simplex.points, simplex.points + simplex.count);
+			std::vector<Vec3f> points;
+			for (const SupportPoint& vertex : vertices)
+				points.push_back(vertex.w);
+			std::vector<HullFace> faces;
+			if (simplex.count == 4)
+			{
+				const bool flip = (points[1] - points[0]).Cross(points[2] - points[0]).Dot(points[3] - points[0]) > 0.f;
+				faces.push_back(MakeHullFace(points, 0, flip ? 2 : 1, flip ? 1 : 2));
+				faces.push_back(MakeHullFace(points, 0, flip ? 1 : 3, flip ? 3 : 1));
+				faces.push_back(MakeHullFace(points, 1, flip ? 2 : 3, flip ? 3 : 2));
+				faces.push_back(MakeHullFace(points, 2, flip ? 0 : 3, flip ? 3 : 0));
+				LinkHullFaces(faces);
+			}
+			if (faces.empty() || std::any_of(faces.begin(), faces.end(), [](const HullFace& face) { return face.normal.LengthSquared() == 0.f; }))
+			{
+				// Flat Minkowski difference: the shapes touch without depth
+				contact.normal = Vec3f(0.f, 1.f, 0.f);
+				contact.depth = 0.f;
+				contact.pointA = contact.pointB = simplex.points[0].a;
+				return true;
+			}
+
+			struct HorizonEdge
+			{
+				uint32_t from, to, face;
+			};
+			std::vector<uint32_t> visible, stack, next;
+			std::vector<HorizonEdge> horizon, loop;
+			size_t live = faces.size();
+			auto findClosest = [&]()
+			{
+				uint32_t closest = ConvexHull::None;
+				for (uint32_t f = 0; f < faces.size(); f++)
+				{
+					if (!faces[f].removed && (closest == ConvexHull::None || faces[f].offset < faces[closest].offset))
+						closest = f;
+				}
+				return closest;
+			};
+			for (uint32_t iteration = 0; iteration < MaxIterations; iteration++)
+			{
+				const uint32_t closest = findClosest();
+				const SupportPoint point = support(faces[closest].normal);
+				// The tolerance follows the size of the polytope: rounding, and FMA contraction most of all,
+				// puts points lying on a face on either side of it
+				scale = std::max(scale, point.w.Length());
+				const float tolerance = 1e-5f * std::max(scale, 1e-3f);
+				if (faces[closest].GetDistance(point.w) <= tolerance)
+					break;
+
+				// The faces that see the new point, flood filled from the closest one so they stay a single patch
+				visible.clear();
+				horizon.clear();
+				stack = { closest };
+				faces[closest].visible = true;
+				while (!stack.empty())
+				{
+					const uint32_t f = stack.back();
+					stack.pop_back();
+					visible.push_back(f);
+					for (uint32_t k = 0; k < 3; k++)
+					{
+						const uint32_t n = faces[f].neighbour[k];
+						if (!faces[n].visible && faces[n].GetDistance(point.w) > tolerance)
+						{
+							faces[n].visible = true;
+							stack.push_back(n);
+						}
+					}
+				}
+				for (uint32_t f : visible)
+				{
+					for (uint32_t k = 0; k < 3; k++)
+					{
+						if (!faces[faces[f].neighbour[k]].visible)
+							horizon.push_back({ faces[f].vertex[k], faces[f].vertex[(k + 1) % 3], faces[f].neighbour[k] });
+					}
+				}
+				for (uint32_t f : visible)
+					faces[f].visible = false;
+
+				// The horizon keyed by its first vertex must chain into one loop of non degenerate faces around the new point,
+				// and a closed surface of V vertices has at most 2V - 4 faces. Otherwise the surface is broken and the search ends
+				next.assign(vertices.size(), ConvexHull::None);
+				bool closed = horizon.size() >= 3 && live - visible.size() + horizon.size() <= 2 * (vertices.size() + 1) - 4;
+				for (uint32_t i = 0; i < horizon.size() && closed; i++)
+				{
+					closed = next[horizon[i].from] == ConvexHull::None && (points[horizon[i].to] - points[horizon[i].from]).Cross(point.w - points[horizon[i].from]).LengthSquared() > 0.f;
+					next[horizon[i].from] = i;
+				}
+				loop.clear();
+				for (uint32_t i = 0; closed && loop.size() < horizon.size(); i = next[horizon[i].to])
+				{
+					loop.push_back(horizon[i]);
+					const uint32_t following = next[horizon[i].to];
+					closed = loop.size() < horizon.size() ? following != ConvexHull::None && following != 0 : following == 0;
+				}
+				if (!closed)
+					break;
+
+				// A fan from the horizon to the new point replaces the visible faces
+				const uint32_t index = static_cast<uint32_t>(vertices.size());
+				vertices.push_back(point);
+				points.push_back(point.w);
+				const uint32_t first = static_cast<uint32_t>(faces.size());
+				const uint32_t count = static_cast<uint32_t>(loop.size());
+				for (uint32_t i = 0; i < count; i++)
+				{
+					HullFace face = MakeHullFace(points, loop[i].from, loop[i].to, index);
+					face.neighbour[0] = loop[i].face;
+					face.neighbour[1] = first + (i + 1) % count;
+					face.neighbour[2] = first + (i + count - 1) % count;
+					HullFace& outer = faces[loop[i].face];
+					for (uint32_t k = 0; k < 3; k++)
+					{
+						if (outer.vertex[k] == loop[i].to)
+							outer.neighbour[k] = first + i;
+					}
+					faces.push_back(face);
+				}
+				for (uint32_t f : visible)
+					faces[f].removed = true;
+				live += count - visible.size();
+			}
+
+			// Weights of the origin's projection on the closest face give the points on each shape
+			const HullFace& face = faces[findClosest()];
+			const SupportPoint& p0 = vertices[face.vertex[0]];
+			const SupportPoint& p1 = vertices[face.vertex[1]];
+			const SupportPoint& p2 = vertices[face.vertex[2]];
+			const Vec3f e0 = p1.w - p0.w, e1 = p2.w - p0.w, e2 = face.normal * face.offset - p0.w;
+			const float d00 = e0.Dot(e0), d01 = e0.Dot(e1), d11 = e1.Dot(e1), d20 = e2.Dot(e0), d21 = e2.Dot(e1);
+			const float denominator = d00 * d11 - d01 * d01;
+			const float v = denominator != 0.f ? (d11 * d20 - d01 * d21) / denominator : 0.f;
+			const float w = denominator != 0.f ? (d00 * d21 - d01 * d20) / denominator : 0.f;
+			const float u = 1.f - v - w;
+			contact.normal = face.normal;
+			contact.depth = std::max(face.offset, 0.f);
+			contact.pointA = p0.a * u + p1.a * v + p2.a * w;
+			contact.pointB = p0.b * u + p1.b * v + p2.b * w;
+			return true;
+		}
+
+		inline bool Collide(const ConvexShape& a, const ConvexShape& b, Contact& contact)
+		{
+			if (a.hull->IsEmpty() || b.hull->IsEmpty())
+				return false;
+			Simplex simplex;
+			Vec3f closest;
+			const float radius = a.radius + b.radius;
+			if (Distance(a, b, simplex, closest))
+			{
+				const float distance = closest.Length();
+				if (distance >= radius)
+					return false;
+				contact.normal = -closest / distance;
+				contact.depth = radius - distance;
+				contact.pointA = contact.pointB = Vec3f();
+				for (uint32_t i = 0; i < simplex.count; i++)
+				{
+					contact.pointA += simplex.points[i].a * simplex.weights[i];
+					contact.pointB += simplex.points[i].b * simplex.weights[i];
+				}
+			}
+			else if (!Penetration(a, b, simplex, contact))
+			{
+				return false;
+			}
+			else
+			{
+				contact.depth += radius;
+			}
+			contact.pointA += contact.normal * a.radius;
+			contact.pointB -= contact.normal * b.radius;
+			return true;
+		}
+	}
+#pragma endregion
+
+#pragma region Queries
+
+	inline bool ComputeDistance(const ConvexShape& a, const ConvexShape& b, ClosestPoints& result)
+	{
+		MATH_INSTRUMENT_SCOPE("ComputeDistance(ConvexShape, ConvexShape, ClosestPoints)");
+		if (a.hull->IsEmpty() || b.hull->IsEmpty())
+			return false;
+		Collision::Simplex simplex;
+		Vec3f closest;
+		if (!Collision::Distance(a, b, simplex, closest))
+			return false;
+		const float distance = closest.Length();
+		if (distance <= a.radius + b.radius)
+			return false;
+		const Vec3f normal = -closest / distance;
+		result.pointA = result.pointB = Vec3f();
+		for (uint32_t i = 0; i < simplex.count; i++)
+		{
+			result.pointA += simplex.points[i].a * simplex.weights[i];
+			result.pointB += simplex.points[i].b * simplex.weights[i];
+		}
+		result.pointA += normal * a.radius;
+		result.pointB -= normal * b.radius;
+		result.distance = distance - a.radius - b.radius;
+		return true;
+	}
+
+	inline bool ComputePenetration(const ConvexShape& a, const ConvexShape& b, Contact& contact)
+	{
+		MATH_INSTRUMENT_BATCHABLE("ComputePenetration(ConvexShape, ConvexShape, Contact)", "CollidePairs(span, span, vector, vector)");
+		return Collision::Collide(a, b, contact);
+	}
+
+	inline void CollidePairs(std::span<const ConvexShape> shapes, std::span<const std::pair<uint32_t, uint32_t>> pairs, std::vector<uint32_t>& touching, std::vector<Contact>& contacts)
+	{
+		MATH_INSTRUMENT_SCOPE("CollidePairs(span, span, vector, vector)");
+		MATH_INSTRUMENT_ITEMS(pairs.size());
+		constexpr size_t Grain = 256;
+
+		std::vector<AABB> bounds(shapes.size());
+		ParallelFor(shapes.size(), 4 * Grain, [&](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; i++)
+				bounds[i] = shapes[i].GetBounds();
+		});
+
+		// Each chunk of pairs collects its contacts apart, then the chunks are joined in order
+		std::vector<std::vector<uint32_t>> chunkTouching((pairs.size() + Grain - 1) / Grain);
+		std::vector<std::vector<Contact>> chunkContacts(chunkTouching.size());
+		ParallelFor(pairs.size(), Grain, [&](size_t begin, size_t end)
+		{
+			std::vector<uint32_t>& chunk = chunkTouching[begin / Grain];
+			std::vector<Contact>& chunkContact = chunkContacts[begin / Grain];
+			for (size_t i = begin; i < end; i++)
+			{
+				const auto [first, second] = pairs[i];
+				Contact contact;
+				if (bounds[first].Overlaps(bounds[second]) && Collision::Collide(shapes[first], shapes[second], contact))
+				{
+					chunk.push_back(static_cast<uint32_t>(i));
+					chunkContact.push_back(contact);
+				}
+			}
+		});
+		touching.clear();
+		contacts.clear();
+		for (size_t c = 0; c < chunkTouching.size(); c++)
+		{
+			touching.insert(touching.end(), chunkTouching[c].begin(), chunkTouching[c].end());
+			contacts.insert(contacts.end(), chunkContacts[c].begin(), chunkContacts[c].end());
+		}
+	}
+#pragma endregion
+}
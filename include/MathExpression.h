@@ -0,0 +1,276 @@
+#pragma once
+#include <concepts>
+#include <cstddef>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "Maths.h"
+#include "MathArray.h"
+
+// Lazily evaluated array arithmetic: Lazy(a) + Lazy(b) * s - Lazy(c) only builds a tree of nodes,
+// Evaluate then runs the whole tree in a single pass instead of one pass and one temporary array per operator.
+// Every operator is element wise, so the output may be one of the inputs but must not partially overlap one.
+namespace GALAXY::Math::Expression
+{
+	// Lanes evaluated together, one SIMD register
+#if defined(MATH_AVX)
+	template<typename T>
+	constexpr size_t PackSize = 32 / sizeof(T);
+#elif defined(MATH_SSE)
+	template<typename T>
+	constexpr size_t PackSize = 16 / sizeof(T);
+#else
+	template<typename T>
+	constexpr size_t PackSize = 4;
+#endif
+
+	template<typename T>
+	struct Pack
+	{
+		T lanes[PackSize<T>];
+	};
+
+#if defined(MATH_AVX)
+	template<>
+	struct Pack<float> { __m256 lanes; };
+
+	template<>
+	struct Pack<double> { __m256d lanes; };
+#elif defined(MATH_SSE)
+	template<>
+	struct Pack<float> { __m128 lanes; };
+
+	template<>
+	struct Pack<double> { __m128d lanes; };
+#endif
+
+	template<typename V>
+	struct ValueTraits
+	{
+		typedef V Scalar;
+	};
+
+	template<typename T, size_t N>
+	struct ValueTraits<VecN<T, N>> { typedef T Scalar; };
+
+	template<typename E>
+	concept Node = requires { typename E::Value; typename E::Scalar; } && std::same_as<typename E::NodeTag, void>;
+
+	// Component C of a vector, a scalar stands for all of its components
+	template<int C, typename V>
+	inline constexpr auto GetComponent(const V& value);
+
+	struct Add
+	{
+		template<typename A, typename B>
+		static inline constexpr auto Apply(const A& a, const B& b) { return a + b; }
+	};
+
+	struct Subtract
+	{
+		template<typename A, typename B>
+		static inline constexpr auto Apply(const A& a, const B& b) { return a - b; }
+	};
+
+	struct Multiply
+	{
+		// Vectors only define vector * scalar, scalar * vector is swapped
+		template<typename A, typename B>
+		static inline constexpr auto Apply(const A& a, const B& b)
+		{
+			if constexpr (std::is_arithmetic_v<A> && !std::is_arithmetic_v<B>)
+				return b * a;
+			else
+				return a * b;
+		}
+	};
+
+	struct Divide
+	{
+		template<typename A, typename B>
+		static inline constexpr auto Apply(const A& a, const B& b) { return a / b; }
+	};
+
+	// Elements of an array of vectors or scalars
+	template<typename V>
+	class ArrayNode
+	{
+	public:
+		typedef void NodeTag;
+		typedef V Value;
+		typedef typename ValueTraits<V>::Scalar Scalar;
+
+		explicit inline ArrayNode(std::span<const V> _data) : data(_data) {}
+
+		inline size_t GetSize() const { return data.size(); }
+
+		inline Value At(size_t i) const { return data[i]; }
+
+		template<int C>
+		inline Pack<Scalar> Load(size_t i) const;
+
+	private:
+		std::span<const V> data;
+	};
+
+	template<typename T>
+	class SoANode
+	{
+	public:
+		typedef void NodeTag;
+		typedef Vec3<T> Value;
+		typedef T Scalar;
+
+		explicit inline SoANode(const Vec3SoA<T>& _array) : array(&_array) {}
+
+		inline size_t GetSize() const { return array->GetSize(); }
+
+		inline Value At(size_t i) const { return array->Get(i); }
+
+		template<int C>
+		inline Pack<Scalar> Load(size_t i) const;
+
+	private:
+		const Vec3SoA<T>* array;
+	};
+
+	// Scalar or vector repeated for every element
+	template<typename V>
+	class ConstantNode
+	{
+	public:
+		typedef void NodeTag;
+		typedef V Value;
+		typedef typename ValueTraits<V>::Scalar Scalar;
+
+		explicit inline ConstantNode(const V& _value) : value(_value) {}
+
+		inline size_t GetSize() const { return SIZE_MAX; }
+
+		inline Value At(size_t) const { return value; }
+
+		template<int C>
+		inline Pack<Scalar> Load(size_t i) const;
+
+	private:
+		V value;
+	};
+
+	template<typename Op, Node L, Node R>
+	class BinaryNode
+	{
+	public:
+		static_assert(std::is_same_v<typename L::Scalar, typename R::Scalar>, "Both operands must have the same scalar type");
+
+		typedef void NodeTag;
+		typedef decltype(Op::Apply(std::declval<typename L::Value>(), std::declval<typename R::Value>())) Value;
+		typedef typename L::Scalar Scalar;
+
+		inline BinaryNode(const L& _left, const R& _right) : left(_left), right(_right) {}
+
+		inline size_t GetSize() const { return std::min(left.GetSize(), right.GetSize()); }
+
+		inline Value At(size_t i) const { return Op::Apply(left.At(i), right.At(i)); }
+
+		template<int C>
+		inline Pack<Scalar> Load(size_t i) const;
+
+	private:
+		L left;
+		R right;
+	};
+
+	template<Node E>
+	class NegateNode
+	{
+	public:
+		typedef void NodeTag;
+		typedef typename E::Value Value;
+		typedef typename E::Scalar Scalar;
+
+		explicit inline NegateNode(const E& _node) : node(_node) {}
+
+		inline size_t GetSize() const { return node.GetSize(); }
+
+		inline Value At(size_t i) const { return -node.At(i); }
+
+		template<int C>
+		inline Pack<Scalar> Load(size_t i) const;
+
+	private:
+		E node;
+	};
+
+	// Operand that is not a node: a scalar or a vector, converted to the scalar type of the expression
+	template<typename V, typename S>
+	struct ConstantOf { typedef S Type; };
+
+	template<typename U, size_t N, typename S>
+	struct ConstantOf<VecN<U, N>, S> { typedef VecN<S, N> Type; };
+
+	template<typename V>
+	concept Operand = !Node<V> && (std::is_arithmetic_v<V> || !std::is_same_v<typename ValueTraits<V>::Scalar, V>);
+
+#pragma region Operators
+	template<Node L, Node R>
+	inline BinaryNode<Add, L, R> operator+(const L& left, const R& right);
+
+	template<Node L, Node R>
+	inline BinaryNode<Subtract, L, R> operator-(const L& left, const R& right);
+
+	template<Node L, Node R>
+	inline BinaryNode<Multiply, L, R> operator*(const L& left, const R& right);
+
+	template<Node L, Node R>
+	inline BinaryNode<Divide, L, R> operator/(const L& left, const R& right);
+
+	template<Node E>
+	inline NegateNode<E> operator-(const E& node);
+
+	template<Node L, Operand V>
+	inline auto operator+(const L& left, const V& right);
+
+	template<Operand V, Node R>
+	inline auto operator+(const V& left, const R& right);
+
+	template<Node L, Operand V>
+	inline auto operator-(const L& left, const V& right);
+
+	template<Operand V, Node R>
+	inline auto operator-(const V& left, const R& right);
+
+	template<Node L, Operand V>
+	inline auto operator*(const L& left, const V& right);
+
+	// Vectors only multiply from the right, Vec3::operator* already takes any left hand side
+	template<Operand V, Node R> requires std::is_arithmetic_v<V>
+	inline auto operator*(const V& left, const R& right);
+
+	template<Node L, Operand V>
+	inline auto operator/(const L& left, const V& right);
+#pragma endregion
+}
+
+namespace GALAXY::Math
+{
+	// Leaf of an expression over an existing array, the array must outlive the expression
+	template<typename V, typename A>
+	inline Expression::ArrayNode<V> Lazy(const std::vector<V, A>& array);
+
+	template<typename V>
+	inline Expression::ArrayNode<V> Lazy(std::span<const V> array);
+
+	template<typename T>
+	inline Expression::SoANode<T> Lazy(const Vec3SoA<T>& array);
+
+	// One pass over the elements, the vector operators of every node are inlined into the loop
+	template<Expression::Node E>
+	inline void Evaluate(const E& expression, std::span<typename E::Value> output);
+
+	// One pass per component in blocks of PackSize lanes, each block is a few SIMD instructions per node
+	template<Expression::Node E>
+	inline void Evaluate(const E& expression, Vec3SoA<typename E::Scalar>& output);
+}
+
+#include "MathExpression.inl"
@@ -0,0 +1,424 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "MathExpression.h"
+
+namespace GALAXY::Math::Expression
+{
+#pragma region Pack
+	template<typename T>
+	inline Pack<T> LoadPack(const T* data)
+	{
+		Pack<T> result;
+		for (size_t i = 0; i < PackSize<T>; i++)
+			result.lanes[i] = data[i];
+		return result;
+	}
+
+	template<typename T>
+	inline void StorePack(T* data, const Pack<T>& pack)
+	{
+		for (size_t i = 0; i < PackSize<T>; i++)
+			data[i] = pack.lanes[i];
+	}
+
+	template<typename T>
+	inline Pack<T> BroadcastPack(T value)
+	{
+		Pack<T> result;
+		for (size_t i = 0; i < PackSize<T>; i++)
+			result.lanes[i] = value;
+		return result;
+	}
+
+	template<typename T, typename Function>
+	inline Pack<T> ApplyLanes(const Pack<T>& a, const Pack<T>& b, Function function)
+	{
+		Pack<T> result;
+		for (size_t i = 0; i < PackSize<T>; i++)
+			result.lanes[i] = function(a.lanes[i], b.lanes[i]);
+		return result;
+	}
+
+	template<typename T>
+	inline Pack<T> operator+(const Pack<T>& a, const Pack<T>& b) { return ApplyLanes(a, b, [](T x, T y) { return x + y; }); }
+
+	template<typename T>
+	inline Pack<T> operator-(const Pack<T>& a, const Pack<T>& b) { return ApplyLanes(a, b, [](T x, T y) { return x - y; }); }
+
+	template<typename T>
+	inline Pack<T> operator*(const Pack<T>& a, const Pack<T>& b) { return ApplyLanes(a, b, [](T x, T y) { return x * y; }); }
+
+	template<typename T>
+	inline Pack<T> operator/(const Pack<T>& a, const Pack<T>& b) { return ApplyLanes(a, b, [](T x, T y) { return x / y; }); }
+
+	template<typename T>
+	inline Pack<T> operator-(const Pack<T>& a)
+	{
+		Pack<T> result;
+		for (size_t i = 0; i < PackSize<T>; i++)
+			result.lanes[i] = -a.lanes[i];
+		return result;
+	}
+
+	template<typename T>
+	inline Pack<T> SqrtPack(const Pack<T>& a)
+	{
+		Pack<T> result;
+		for (size_t i = 0; i < PackSize<T>; i++)
+			result.lanes[i] = std::sqrt(a.lanes[i]);
+		return result;
+	}
+
+	// Magnitude of the first pack with the sign bits of the second
+	template<typename T>
+	inline Pack<T> CopySignPack(const Pack<T>& magnitude, const Pack<T>& sign) { return ApplyLanes(magnitude, sign, [](T x, T y) { return std::copysign(x, y); }); }
+
+	// Second operand when either is NaN, like minps / maxps
+	template<typename T>
+	inline Pack<T> MinPack(const Pack<T>& a, const Pack<T>& b) { return ApplyLanes(a, b, [](T x, T y) { return x < y ? x : y; }); }
+
+	template<typename T>
+	inline Pack<T> MaxPack(const Pack<T>& a, const Pack<T>& b) { return ApplyLanes(a, b, [](T x, T y) { return x > y ? x : y; }); }
+
+	// Lanes of a where x < y, of b elsewhere
+	template<typename T>
+	inline Pack<T> SelectLessPack(const Pack<T>& x, const Pack<T>& y, const Pack<T>& a, const Pack<T>& b)
+	{
+		Pack<T> result;
+		for (size_t i = 0; i < PackSize<T>; i++)
+			result.lanes[i] = x.lanes[i] < y.lanes[i] ? a.lanes[i] : b.lanes[i];
+		return result;
+	}
+
+	// 1 / a, the SIMD float version from the reciprocal estimate and one Newton step, about 22 bits.
+	// The estimate differs between CPU vendors, MATH_DETERMINISTIC divides instead
+	template<typename T>
+	inline Pack<T> ReciprocalPack(const Pack<T>& a)
+	{
+		Pack<T> result;
+		for (size_t i = 0; i < PackSize<T>; i++)
+			result.lanes[i] = static_cast<T>(1) / a.lanes[i];
+		return result;
+	}
+
+	// Bit i set where lane i of x is less than lane i of y, NaN lanes compare false
+	template<typename T>
+	inline uint32_t LessMask(const Pack<T>& x, const Pack<T>& y)
+	{
+		uint32_t mask = 0;
+		for (size_t i = 0; i < PackSize<T>; i++)
+			mask |= static_cast<uint32_t>(x.lanes[i] < y.lanes[i]) << i;
+		return mask;
+	}
+
+#if defined(MATH_AVX)
+	inline Pack<float> LoadPack(const float* data) { return { _mm256_loadu_ps(data) }; }
+	inline Pack<double> LoadPack(const double* data) { return { _mm256_loadu_pd(data) }; }
+	inline void StorePack(float* data, const Pack<float>& pack) { _mm256_storeu_ps(data, pack.lanes); }
+	inline void StorePack(double* data, const Pack<double>& pack) { _mm256_storeu_pd(data, pack.lanes); }
+	inline Pack<float> BroadcastPack(float value) { return { _mm256_set1_ps(value) }; }
+	inline Pack<double> BroadcastPack(double value) { return { _mm256_set1_pd(value) }; }
+	inline Pack<float> operator+(const Pack<float>& a, const Pack<float>& b) { return { _mm256_add_ps(a.lanes, b.lanes) }; }
+	inline Pack<double> operator+(const Pack<double>& a, const Pack<double>& b) { return { _mm256_add_pd(a.lanes, b.lanes) }; }
+	inline Pack<float> operator-(const Pack<float>& a, const Pack<float>& b) { return { _mm256_sub_ps(a.lanes, b.lanes) }; }
+	inline Pack<double> operator-(const Pack<double>& a, const Pack<double>& b) { return { _mm256_sub_pd(a.lanes, b.lanes) }; }
+	inline Pack<float> operator*(const Pack<float>& a, const Pack<float>& b) { return { _mm256_mul_ps(a.lanes, b.lanes) }; }
+	inline Pack<double> operator*(const Pack<double>& a, const Pack<double>& b) { return { _mm256_mul_pd(a.lanes, b.lanes) }; }
+	inline Pack<float> operator/(const Pack<float>& a, const Pack<float>& b) { return { _mm256_div_ps(a.lanes, b.lanes) }; }
+	inline Pack<double> operator/(const Pack<double>& a, const Pack<double>& b) { return { _mm256_div_pd(a.lanes, b.lanes) }; }
+	// Flips the sign bit, so -0 stays distinct from 0 like the scalar negation
+	inline Pack<float> operator-(const Pack<float>& a) { return { _mm256_xor_ps(a.lanes, _mm256_set1_ps(-0.f)) }; }
+	inline Pack<double> operator-(const Pack<double>& a) { return { _mm256_xor_pd(a.lanes, _mm256_set1_pd(-0.0)) }; }
+	inline Pack<float> SqrtPack(const Pack<float>& a) { return { _mm256_sqrt_ps(a.lanes) }; }
+	inline Pack<double> SqrtPack(const Pack<double>& a) { return { _mm256_sqrt_pd(a.lanes) }; }
+	inline Pack<float> CopySignPack(const Pack<float>& magnitude, const Pack<float>& sign)
+	{
+		const __m256 signBit = _mm256_set1_ps(-0.f);
+		return { _mm256_or_ps(_mm256_andnot_ps(signBit, magnitude.lanes), _mm256_and_ps(signBit, sign.lanes)) };
+	}
+	inline Pack<double> CopySignPack(const Pack<double>& magnitude, const Pack<double>& sign)
+	{
+		const __m256d signBit = _mm256_set1_pd(-0.0);
+		return { _mm256_or_pd(_mm256_andnot_pd(signBit, magnitude.lanes), _mm256_and_pd(signBit, sign.lanes)) };
+	}
+	inline Pack<float> MinPack(const Pack<float>& a, const Pack<float>& b) { return { _mm256_min_ps(a.lanes, b.lanes) }; }
+	inline Pack<double> MinPack(const Pack<double>& a, const Pack<double>& b) { return { _mm256_min_pd(a.lanes, b.lanes) }; }
+	inline Pack<float> MaxPack(const Pack<float>& a, const Pack<float>& b) { return { _mm256_max_ps(a.lanes, b.lanes) }; }
+	inline Pack<double> MaxPack(const Pack<double>& a, const Pack<double>& b) { return { _mm256_max_pd(a.lanes, b.lanes) }; }
+	inline Pack<float> SelectLessPack(const Pack<float>& x, const Pack<float>& y, const Pack<float>& a, const Pack<float>& b) { return { _mm256_blendv_ps(b.lanes, a.lanes, _mm256_cmp_ps(x.lanes, y.lanes, _CMP_LT_OQ)) }; }
+	inline Pack<double> SelectLessPack(const Pack<double>& x, const Pack<double>& y, const Pack<double>& a, const Pack<double>& b) { return { _mm256_blendv_pd(b.lanes, a.lanes, _mm256_cmp_pd(x.lanes, y.lanes, _CMP_LT_OQ)) }; }
+	inline Pack<float> ReciprocalPack(const Pack<float>& a)
+	{
+#ifdef MATH_DETERMINISTIC
+		return { _mm256_div_ps(_mm256_set1_ps(1.f), a.lanes) };
+#else
+		const __m256 estimate = _mm256_rcp_ps(a.lanes);
+		return { _mm256_mul_ps(estimate, _mm256_sub_ps(_mm256_set1_ps(2.f), _mm256_mul_ps(a.lanes, estimate))) };
+#endif
+	}
+	inline Pack<double> ReciprocalPack(const Pack<double>& a) { return { _mm256_div_pd(_mm256_set1_pd(1.0), a.lanes) }; }
+	inline uint32_t LessMask(const Pack<float>& x, const Pack<float>& y) { return static_cast<uint32_t>(_mm256_movemask_ps(_mm256_cmp_ps(x.lanes, y.lanes, _CMP_LT_OQ))); }
+	inline uint32_t LessMask(const Pack<double>& x, const Pack<double>& y) { return static_cast<uint32_t>(_mm256_movemask_pd(_mm256_cmp_pd(x.lanes, y.lanes, _CMP_LT_OQ))); }
+#elif defined(MATH_SSE)
+	inline Pack<float> LoadPack(const float* data) { return { _mm_loadu_ps(data) }; }
+	inline Pack<double> LoadPack(const double* data) { return { _mm_loadu_pd(data) }; }
+	inline void StorePack(float* data, const Pack<float>& pack) { _mm_storeu_ps(data, pack.lanes); }
+	inline void StorePack(double* data, const Pack<double>& pack) { _mm_storeu_pd(data, pack.lanes); }
+	inline Pack<float> BroadcastPack(float value) { return { _mm_set1_ps(value) }; }
+	inline Pack<double> BroadcastPack(double value) { return { _mm_set1_pd(value) }; }
+	inline Pack<float> operator+(const Pack<float>& a, const Pack<float>& b) { return { _mm_add_ps(a.lanes, b.lanes) }; }
+	inline Pack<double> operator+(const Pack<double>& a, const Pack<double>& b) { return { _mm_add_pd(a.lanes, b.lanes) }; }
+	inline Pack<float> operator-(const Pack<float>& a, const Pack<float>& b) { return { _mm_sub_ps(a.lanes, b.lanes) }; }
+	inline Pack<double> operator-(const Pack<double>& a, const Pack<double>& b) { return { _mm_sub_pd(a.lanes, b.lanes) }; }
+	inline Pack<float> operator*(const Pack<float>& a, const Pack<float>& b) { return { _mm_mul_ps(a.lanes, b.lanes) }; }
+	inline Pack<double> operator*(const Pack<double>& a, const Pack<double>& b) { return { _mm_mul_pd(a.lanes, b.lanes) }; }
+	inline Pack<float> operator/(const Pack<float>& a, const Pack<float>& b) { return { _mm_div_ps(a.lanes, b.lanes) }; }
+	inline Pack<double> operator/(const Pack<double>& a, const Pack<double>& b) { return { _mm_div_pd(a.lanes, b.lanes) }; }
+	inline Pack<float> operator-(const Pack<float>& a) { return { _mm_xor_ps(a.lanes, _mm_set1_ps(-0.f)) }; }
+	inline Pack<double> operator-(const Pack<double>& a) { return { _mm_xor_pd(a.lanes, _mm_set1_pd(-0.0)) }; }
+	inline Pack<float> SqrtPack(const Pack<float>& a) { return { _mm_sqrt_ps(a.lanes) }; }
+	inline Pack<double> SqrtPack(const Pack<double>& a) { return { _mm_sqrt_pd(a.lanes) }; }
+	inline Pack<float> CopySignPack(const Pack<float>& magnitude, const Pack<float>& sign)
+	{
+		const __m128 signBit = _mm_set1_ps(-0.f);
+		return { _mm_or_ps(_mm_andnot_ps(signBit, magnitude.lanes), _mm_and_ps(signBit, sign.lanes)) };
+	}
+	inline Pack<double> CopySignPack(const Pack<double>& magnitude, const Pack<double>& sign)
+	{
+		const __m128d signBit = _mm_set1_pd(-0.0);
+		return { _mm_or_pd(_mm_andnot_pd(signBit, magnitude.lanes), _mm_and_pd(signBit, sign.lanes)) };
+	}
+	inline Pack<float> MinPack(const Pack<float>& a, const Pack<float>& b) { return { _mm_min_ps(a.lanes, b.lanes) }; }
+	inline Pack<double> MinPack(const Pack<double>& a, const Pack<double>& b) { return { _mm_min_pd(a.lanes, b.lanes) }; }
+	inline Pack<float> MaxPack(const Pack<float>& a, const Pack<float>& b) { return { _mm_max_ps(a.lanes, b.lanes) }; }
+	inline Pack<double> MaxPack(const Pack<double>& a, const Pack<double>& b) { return { _mm_max_pd(a.lanes, b.lanes) }; }
+	inline Pack<float> SelectLessPack(const Pack<float>& x, const Pack<float>& y, const Pack<float>& a, const Pack<float>& b)
+	{
+		const __m128 mask = _mm_cmplt_ps(x.lanes, y.lanes);
+		return { _mm_or_ps(_mm_and_ps(mask, a.lanes), _mm_andnot_ps(mask, b.lanes)) };
+	}
+	inline Pack<double> SelectLessPack(const Pack<double>& x, const Pack<double>& y, const Pack<double>& a, const Pack<double>& b)
+	{
+		const __m128d mask = _mm_cmplt_pd(x.lanes, y.lanes);
+		return { _mm_or_pd(_mm_and_pd(mask, a.lanes), _mm_andnot_pd(mask, b.lanes)) };
+	}
+	inline Pack<float> ReciprocalPack(const Pack<float>& a)
+	{
+#ifdef MATH_DETERMINISTIC
+		return { _mm_div_ps(_mm_set1_ps(1.f), a.lanes) };
+#else
+		const __m128 estimate = _mm_rcp_ps(a.lanes);
+		return { _mm_mul_ps(estimate, _mm_sub_ps(_mm_set1_ps(2.f), _mm_mul_ps(a.lanes, estimate))) };
+#endif
+	}
+	inline Pack<double> ReciprocalPack(const Pack<double>& a) { return { _mm_div_pd(_mm_set1_pd(1.0), a.lanes) }; }
+	inline uint32_t LessMask(const Pack<float>& x, const Pack<float>& y) { return static_cast<uint32_t>(_mm_movemask_ps(_mm_cmplt_ps(x.lanes, y.lanes))); }
+	inline uint32_t LessMask(const Pack<double>& x, const Pack<double>& y) { return static_cast<uint32_t>(_mm_movemask_pd(_mm_cmplt_pd(x.lanes, y.lanes))); }
+#endif
+#pragma endregion
+
+#pragma region Nodes
+	template<int C, typename V>
+	inline constexpr auto GetComponent(const V& value)
+	{
+		if constexpr (std::is_arithmetic_v<V>)
+			return value;
+		else if constexpr (C == 0)
+			return value.x;
+		else if constexpr (C == 1)
+			return value.y;
+		else if constexpr (C == 2)
+			return value.z;
+		else
+			return value.w;
+	}
+
+	template<typename V>
+	template<int C>
+	inline Pack<typename ArrayNode<V>::Scalar> ArrayNode<V>::Load(size_t i) const
+	{
+		if constexpr (std::is_arithmetic_v<V>)
+			return LoadPack(data.data() + i);
+		else
+		{
+			// Strided gather, prefer a Vec3SoA for the arrays on the hot path
+			Scalar lanes[PackSize<Scalar>];
+			for (size_t lane = 0; lane < PackSize<Scalar>; lane++)
+				lanes[lane] = GetComponent<C>(data[i + lane]);
+			return LoadPack(lanes);
+		}
+	}
+
+	template<typename T>
+	template<int C>
+	inline Pack<T> SoANode<T>::Load(size_t i) const
+	{
+		if constexpr (C == 0)
+			return LoadPack(array->x.data() + i);
+		else if constexpr (C == 1)
+			return LoadPack(array->y.data() + i);
+		else
+			return LoadPack(array->z.data() + i);
+	}
+
+	template<typename V>
+	template<int C>
+	inline Pack<typename ConstantNode<V>::Scalar> ConstantNode<V>::Load(size_t) const
+	{
+		return BroadcastPack(static_cast<Scalar>(GetComponent<C>(value)));
+	}
+
+	template<typename Op, Node L, Node R>
+	template<int C>
+	inline Pack<typename BinaryNode<Op, L, R>::Scalar> BinaryNode<Op, L, R>::Load(size_t i) const
+	{
+		return Op::Apply(left.template Load<C>(i), right.template Load<C>(i));
+	}
+
+	template<Node E>
+	template<int C>
+	inline Pack<typename NegateNode<E>::Scalar> NegateNode<E>::Load(size_t i) const
+	{
+		return -node.template Load<C>(i);
+	}
+#pragma endregion
+
+#pragma region Operators
+	template<Node L, Node R>
+	inline BinaryNode<Add, L, R> operator+(const L& left, const R& right)
+	{
+		return BinaryNode<Add, L, R>(left, right);
+	}
+
+	template<Node L, Node R>
+	inline BinaryNode<Subtract, L, R> operator-(const L& left, const R& right)
+	{
+		return BinaryNode<Subtract, L, R>(left, right);
+	}
+
+	template<Node L, Node R>
+	inline BinaryNode<Multiply, L, R> operator*(const L& left, const R& right)
+	{
+		return BinaryNode<Multiply, L, R>(left, right);
+	}
+
+	template<Node L, Node R>
+	inline BinaryNode<Divide, L, R> operator/(const L& left, const R& right)
+	{
+		return BinaryNode<Divide, L, R>(left, right);
+	}
+
+	template<Node E>
+	inline NegateNode<E> operator-(const E& node)
+	{
+		return NegateNode<E>(node);
+	}
+
+	template<typename S, typename V>
+	inline auto MakeConstant(const V& value)
+	{
+		typedef typename ConstantOf<V, S>::Type Type;
+		return ConstantNode<Type>(static_cast<Type>(value));
+	}
+
+	template<Node L, Operand V>
+	inline auto operator+(const L& left, const V& right)
+	{
+		return left + MakeConstant<typename L::Scalar>(right);
+	}
+
+	template<Operand V, Node R>
+	inline auto operator+(const V& left, const R& right)
+	{
+		return MakeConstant<typename R::Scalar>(left) + right;
+	}
+
+	template<Node L, Operand V>
+	inline auto operator-(const L& left, const V& right)
+	{
+		return left - MakeConstant<typename L::Scalar>(right);
+	}
+
+	template<Operand V, Node R>
+	inline auto operator-(const V& left, const R& right)
+	{
+		return MakeConstant<typename R::Scalar>(left) - right;
+	}
+
+	template<Node L, Operand V>
+	inline auto operator*(const L& left, const V& right)
+	{
+		return left * MakeConstant<typename L::Scalar>(right);
+	}
+
+	template<Operand V, Node R> requires std::is_arithmetic_v<V>
+	inline auto operator*(const V& left, const R& right)
+	{
+		return MakeConstant<typename R::Scalar>(left) * right;
+	}
+
+	template<Node L, Operand V>
+	inline auto operator/(const L& left, const V& right)
+	{
+		return left / MakeConstant<typename L::Scalar>(right);
+	}
+#pragma endregion
+}
+
+namespace GALAXY::Math
+{
+#pragma region Evaluation
+	template<typename V, typename A>
+	inline Expression::ArrayNode<V> Lazy(const std::vector<V, A>& array)
+	{
+		return Expression::ArrayNode<V>(std::span<const V>(array));
+	}
+
+	template<typename V>
+	inline Expression::ArrayNode<V> Lazy(std::span<const V> array)
+	{
+		return Expression::ArrayNode<V>(array);
+	}
+
+	template<typename T>
+	inline Expression::SoANode<T> Lazy(const Vec3SoA<T>& array)
+	{
+		return Expression::SoANode<T>(array);
+	}
+
+	template<Expression::Node E>
+	inline void Evaluate(const E& expression, std::span<typename E::Value> output)
+	{
+		MATH_INSTRUMENT_SCOPE("Evaluate(Expression, span)");
+		const size_t count = std::min(expression.GetSize(), output.size());
+		MATH_INSTRUMENT_ITEMS(count);
+		for (size_t i = 0; i < count; i++)
+			output[i] = expression.At(i);
+	}
+
+	template<Expression::Node E>
+	inline void Evaluate(const E& expression, Vec3SoA<typename E::Scalar>& output)
+	{
+		MATH_INSTRUMENT_SCOPE("Evaluate(Expression, Vec3SoA)");
+		typedef typename E::Scalar T;
+		constexpr size_t lanes = Expression::PackSize<T>;
+		const size_t count = std::min(expression.GetSize(), output.GetSize());
+		MATH_INSTRUMENT_ITEMS(count);
+		const size_t packed = count - count % lanes;
+
+		auto column = [&]<int C>(T* data)
+		{
+			for (size_t i = 0; i < packed; i += lanes)
+				Expression::StorePack(data + i, expression.template Load<C>(i));
+			for (size_t i = packed; i < count; i++)
+				data[i] = Expression::GetComponent<C>(expression.At(i));
+		};
+		column.template operator()<0>(output.x.data());
+		column.template operator()<1>(output.y.data());
+		column.template operator()<2>(output.z.data());
+	}
+#pragma endregion
+}
@@ -0,0 +1,191 @@
+#pragma once
+#include <cfloat>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "Maths.h"
+#include "MathArray.h"
+#include "MathExpression.h"
+
+namespace GALAXY::Math
+{
+	// Axis aligned box, default constructed empty (min above max) so growing it by anything gives that thing's bounds
+	struct AABB
+	{
+		Vec3f min = Vec3f(FLT_MAX);
+		Vec3f max = Vec3f(-FLT_MAX);
+
+		inline constexpr AABB() = default;
+
+		inline constexpr AABB(const Vec3f& _min, const Vec3f& _max) : min(_min), max(_max) {}
+
+		inline void Grow(const Vec3f& point);
+
+		inline void Grow(const AABB& box);
+
+		inline bool IsEmpty() const;
+
+		inline Vec3f GetCenter() const;
+
+		inline Vec3f GetSize() const;
+
+		// 0 for an empty box
+		inline float GetSurfaceArea() const;
+
+		inline bool Contains(const Vec3f& point) const;
+
+		inline bool Overlaps(const AABB& box) const;
+	};
+
+	// Points origin + t * direction for t in [tMin, tMax], the direction does not need to be normalized
+	struct Ray
+	{
+		Vec3f origin;
+		Vec3f direction = Vec3f::Forward();
+		float tMin = 0.f;
+		float tMax = FLT_MAX;
+
+		inline Vec3f GetPoint(float t) const { return origin + direction * t; }
+	};
+
+	struct Triangle
+	{
+		Vec3f a, b, c;
+
+		inline AABB GetBounds() const;
+
+		// Not normalized, twice the area long
+		inline Vec3f GetNormal() const;
+	};
+
+	// Points p with normal.Dot(p) == distance. The constructors from points keep the normal unit length
+	struct Plane
+	{
+		Vec3f normal = Vec3f::Up();
+		float distance = 0.f;
+
+		inline constexpr Plane() = default;
+
+		inline constexpr Plane(const Vec3f& _normal, float _distance) : normal(_normal), distance(_distance) {}
+
+		inline Plane(const Vec3f& normal, const Vec3f& point);
+
+		// Facing the side the triangle winds counter clockwise from
+		inline Plane(const Vec3f& a, const Vec3f& b, const Vec3f& c);
+
+		// Positive in front, scaled by the normal length
+		inline float GetSignedDistance(const Vec3f& point) const;
+	};
+
+	// Where a projection puts the near and far planes in clip space z / w
+	enum class DepthRange : uint8_t
+	{
+		// Near at -1 and far at 1, as Mat4::CreateProjectionMatrix
+		NegativeOneToOne,
+		// Near at 0 and far at 1
+		ZeroToOne,
+		// Near at 1 and far at 0, float depth then keeps its precision far away
+		ReverseZ,
+	};
+
+	// Six planes facing inside, a point is in the frustum when it is in front of all of them
+	struct Frustum
+	{
+		enum Side : size_t
+		{
+			Left, Right, Bottom, Top, Near, Far, SideCount
+		};
+
+		Plane planes[SideCount];
+
+		// Planes of the clip volume of a view projection matrix (Gribb and Hartmann), normalized. The far plane of an infinite
+		// projection has no normal and keeps everything in front of it
+		static inline Frustum FromMatrix(const Mat4f& viewProjection, DepthRange range = DepthRange::NegativeOneToOne);
+
+		inline bool Contains(const Vec3f& point) const;
+
+		// False only when the box is fully behind one plane, boxes near the corners outside may pass
+		inline bool Intersects(const AABB& box) const;
+	};
+
+	struct Segment
+	{
+		Vec3f a, b;
+	};
+
+	// Triangles one array per vertex component, the layout of the batch queries against many triangles
+	struct TriangleSoA
+	{
+		Vec3SoA<float> a, b, c;
+
+		inline TriangleSoA() = default;
+
+		explicit inline TriangleSoA(std::span<const Triangle> triangles);
+
+		inline size_t GetSize() const { return a.GetSize(); }
+
+		inline void Resize(size_t count);
+
+		inline Triangle Get(size_t index) const;
+
+		inline void Set(size_t index, const Triangle& triangle);
+	};
+
+	// Distance where the ray enters box, tMin when it starts inside
+	inline bool IntersectRay(const Ray& ray, const AABB& box, float& t);
+
+	// Möller-Trumbore, both faces are hit. u and v weight b and c in the hit point
+	inline bool IntersectRay(const Ray& ray, const Triangle& triangle, float& t, float& u, float& v);
+
+	// Both sides are hit, a ray in the plane never is
+	inline bool IntersectRay(const Ray& ray, const Plane& plane, float& t);
+
+	// Closest point of the shape to point, point itself when inside the box
+	inline Vec3f ClosestPoint(const Vec3f& point, const Plane& plane);
+	inline Vec3f ClosestPoint(const Vec3f& point, const Segment& segment);
+	inline Vec3f ClosestPoint(const Vec3f& point, const AABB& box);
+	inline Vec3f ClosestPoint(const Vec3f& point, const Triangle& triangle);
+
+	// u and v weight b and c in the closest point
+	inline Vec3f ClosestPoint(const Vec3f& point, const Triangle& triangle, float& u, float& v);
+
+	// Closest pair of points of two segments, returns their squared distance
+	inline float DistanceSquared(const Segment& first, const Segment& second, Vec3f& onFirst, Vec3f& onSecond);
+
+	inline float DistanceSquared(const Vec3f& point, const Segment& segment);
+	inline float DistanceSquared(const Vec3f& point, const AABB& box);
+	inline float DistanceSquared(const Vec3f& point, const Triangle& triangle);
+
+	// Squared distance of point to every triangle, SIMD across the triangles. Stops at the shorter of triangles and output
+	inline void DistanceSquared(const Vec3f& point, const TriangleSoA& triangles, std::span<float> output);
+
+	// Index of the triangle closest to point and the closest point on it, 0xFFFFFFFF without triangles
+	inline uint32_t FindClosest(const Vec3f& point, const TriangleSoA& triangles, Vec3f& closest);
+
+	// Closest point of triangle to every point, SIMD across the points. output is resized to the points
+	inline void ClosestPoint(const Vec3SoA<float>& points, const Triangle& triangle, Vec3SoA<float>& output);
+
+	namespace Geometry
+	{
+		struct PackVec3
+		{
+			Expression::Pack<float> x, y, z;
+		};
+
+		// Closest point to p of the triangle in each lane without branches: the projection on the plane when it is inside every edge,
+		// else the closest of the three edge points. Degenerate triangles fall back to their edges
+		inline PackVec3 ClosestPoint(const PackVec3& p, const PackVec3& a, const PackVec3& b, const PackVec3& c, Expression::Pack<float>& distanceSquared);
+
+		// Runs block(i, lanes) over [0, count) a pack at a time, lanes is below the pack size only for the last one
+		template<typename F>
+		inline void ForEachPack(size_t count, F&& block);
+
+		// Pack of values from i, the lanes past the end repeat the last value
+		inline Expression::Pack<float> LoadLanes(const MathArray<float>& values, size_t i, size_t lanes);
+
+		inline void StoreLanes(float* output, const Expression::Pack<float>& pack, size_t lanes);
+	}
+}
+
+#include "MathGeometry.inl"
@@ -0,0 +1,496 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+
+#include "MathGeometry.h"
+
+namespace GALAXY::Math
+{
+#pragma region AABB
+	inline void AABB::Grow(const Vec3f& point)
+	{
+		min = Vec3f(std::min(min.x, point.x), std::min(min.y, point.y), std::min(min.z, point.z));
+		max = Vec3f(std::max(max.x, point.x), std::max(max.y, point.y), std::max(max.z, point.z));
+	}
+
+	inline void AABB::Grow(const AABB& box)
+	{
+		min = Vec3f(std::min(min.x, box.min.x), std::min(min.y, box.min.y), std::min(min.z, box.min.z));
+		max = Vec3f(std::max(max.x, box.max.x), std::max(max.y, box.max.y), std::max(max.z, box.max.z));
+	}
+
+	inline bool AABB::IsEmpty() const
+	{
+		return min.x > max.x || min.y > max.y || min.z > max.z;
+	}
+
+	inline Vec3f AABB::GetCenter() const
+	{
+		return (min + max) * 0.5f;
+	}
+
+	inline Vec3f AABB::GetSize() const
+	{
+		return max - min;
+	}
+
+	inline float AABB::GetSurfaceArea() const
+	{
+		if (IsEmpty())
+			return 0.f;
+		const Vec3f size = max - min;
+		return 2.f * (size.x * size.y + size.y * size.z + size.z * size.x);
+	}
+
+	inline bool AABB::Contains(const Vec3f& point) const
+	{
+		return point.x >= min.x && point.x <= max.x && point.y >= min.y && point.y <= max.y && point.z >= min.z && point.z <= max.z;
+	}
+
+	inline bool AABB::Overlaps(const AABB& box) const
+	{
+		return min.x <= box.max.x && max.x >= box.min.x && min.y <= box.max.y && max.y >= box.min.y && min.z <= box.max.z && max.z >= box.min.z;
+	}
+#pragma endregion
+
+#pragma region Triangle
+	inline AABB Triangle::GetBounds() const
+	{
+		AABB bounds(a, a);
+		bounds.Grow(b);
+		bounds.Grow(c);
+		return bounds;
+	}
+
+	inline Vec3f Triangle::GetNormal() const
+	{
+		return (b - a).Cross(c - a);
+	}
+#pragma endregion
+
+#pragma region Plane
+	inline Plane::Plane(const Vec3f& _normal, const Vec3f& point) : normal(_normal.GetNormalize()), distance(normal.Dot(point))
+	{
+	}
+
+	inline Plane::Plane(const Vec3f& a, const Vec3f& b, const Vec3f& c) : Plane((b - a).Cross(c - a), a)
+	{
+	}
+
+	inline float Plane::GetSignedDistance(const Vec3f& point) const
+	{
+		return normal.Dot(point) - distance;
+	}
+#pragma endregion
+
+#pragma region Frustum
+	inline Frustum Frustum::FromMatrix(const Mat4f& viewProjection, DepthRange range)
+	{
+		// Row i of the matrix against the clip coordinates: -w <= x, y <= w is w + row i >= 0 and w - row i >= 0,
+		// z is bounded the same way or by 0 depending on the range
+		auto row = [&](size_t i) { return Vec4f(viewProjection.content[0][i], viewProjection.content[1][i], viewProjection.content[2][i], viewProjection.content[3][i]); };
+		const Vec4f w = row(3);
+		const Vec4f z = row(2);
+		const Vec4f nearSide = range == DepthRange::NegativeOneToOne ? w + z : range == DepthRange::ZeroToOne ? z : w - z;
+		const Vec4f farSide = range == DepthRange::ReverseZ ? z : w - z;
+		const Vec4f sides[SideCount] = { w + row(0), w - row(0), w + row(1), w - row(1), nearSide, farSide };
+		Frustum frustum;
+		for (size_t i = 0; i < SideCount; i++)
+		{
+			const float length = Vec3f(sides[i]).Length();
+			const float inverseLength = length > 0.f ? 1.f / length : 1.f;
+			frustum.planes[i] = Plane(Vec3f(sides[i]) * inverseLength, -sides[i].w * inverseLength);
+		}
+		return frustum;
+	}
+
+	inline bool Frustum::Contains(const Vec3f& point) const
+	{
+		for (const Plane& plane : planes)
+		{
+			if (plane.GetSignedDistance(point) < 0.f)
+				return false;
+		}
+		return true;
+	}
+
+	inline bool Frustum::Intersects(const AABB& box) const
+	{
+		// The corner furthest along each normal
+		for (const Plane& plane : planes)
+		{
+			const Vec3f corner(plane.normal.x >= 0.f ? box.max.x : box.min.x, plane.normal.y >= 0.f ? box.max.y : box.min.y, plane.normal.z >= 0.f ? box.max.z : box.min.z);
+			if (plane.GetSignedDistance(corner) < 0.f)
+				return false;
+		}
+		return true;
+	}
+#pragma endregion
+
+#pragma region Triangle SoA
+	inline TriangleSoA::TriangleSoA(std::span<const Triangle> triangles)
+	{
+		Resize(triangles.size());
+		for (size_t i = 0; i < triangles.size(); i++)
+			Set(i, triangles[i]);
+	}
+
+	inline void TriangleSoA::Resize(size_t count)
+	{
+		a.Resize(count);
+		b.Resize(count);
+		c.Resize(count);
+	}
+
+	inline Triangle TriangleSoA::Get(size_t index) const
+	{
+		return { a.Get(index), b.Get(index), c.Get(index) };
+	}
+
+	inline void TriangleSoA::Set(size_t index, const Triangle& triangle)
+	{
+		a.Set(index, triangle.a);
+		b.Set(index, triangle.b);
+		c.Set(index, triangle.c);
+	}
+#pragma endregion
+
+#pragma region Intersection
+	inline bool IntersectRay(const Ray& ray, const AABB& box, float& t)
+	{
+		float tNear = ray.tMin, tFar = ray.tMax;
+		for (size_t axis = 0; axis < 3; axis++)
+		{
+			const float inverse = 1.f / ray.direction[axis];
+			float t0 = (box.min[axis] - ray.origin[axis]) * inverse;
+			float t1 = (box.max[axis] - ray.origin[axis]) * inverse;
+			if (t0 > t1)
+				std::swap(t0, t1);
+			// Written so a NaN slab (origin on the slab plane of a parallel ray) keeps the current interval
+			tNear = t0 > tNear ? t0 : tNear;
+			tFar = t1 < tFar ? t1 : tFar;
+		}
+		t = tNear;
+		return tNear <= tFar;
+	}
+
+	inline bool IntersectRay(const Ray& ray, const Triangle& triangle, float& t, float& u, float& v)
+	{
+		const Vec3f edge1 = triangle.b - triangle.a;
+		const Vec3f edge2 = triangle.c - triangle.a;
+		const Vec3f p = ray.direction.Cross(edge2);
+		const float determinant = edge1.Dot(p);
+		if (std::abs(determinant) < 1e-12f)
+			return false;
+		const float inverse = 1.f / determinant;
+		const Vec3f s = ray.origin - triangle.a;
+		u = s.Dot(p) * inverse;
+		if (u < 0.f || u > 1.f)
+			return false;
+		const Vec3f q = s.Cross(edge1);
+		v = ray.direction.Dot(q) * inverse;
+		if (v < 0.f || u + v > 1.f)
+			return false;
+		t = edge2.Dot(q) * inverse;
+		return t >= ray.tMin && t <= ray.tMax;
+	}
+
+	inline bool IntersectRay(const Ray& ray, const Plane& plane, float& t)
+	{
+		const float denominator = plane.normal.Dot(ray.direction);
+		if (std::abs(denominator) < 1e-12f)
+			return false;
+		t = (plane.distance - plane.normal.Dot(ray.origin)) / denominator;
+		return t >= ray.tMin && t <= ray.tMax;
+	}
+#pragma endregion
+
+#pragma region Closest Points
+	inline Vec3f ClosestPoint(const Vec3f& point, const Plane& plane)
+	{
+		return point - plane.normal * (plane.GetSignedDistance(point) / plane.normal.LengthSquared());
+	}
+
+	inline Vec3f ClosestPoint(const Vec3f& point, const Segment& segment)
+	{
+		const Vec3f edge = segment.b - segment.a;
+		const float length = edge.LengthSquared();
+		const float t = length > 0.f ? std::clamp((point - segment.a).Dot(edge) / length, 0.f, 1.f) : 0.f;
+		return segment.a + edge * t;
+	}
+
+	inline Vec3f ClosestPoint(const Vec3f& point, const AABB& box)
+	{
+		return Vec3f(std::clamp(point.x, box.min.x, box.max.x), std::clamp(point.y, box.min.y, box.max.y), std::clamp(point.z, box.min.z, box.max.z));
+	}
+
+	inline Vec3f ClosestPoint(const Vec3f& point, const Triangle& triangle)
+	{
+		float u, v;
+		return ClosestPoint(point, triangle, u, v);
+	}
+
+	inline Vec3f ClosestPoint(const Vec3f& point, const Triangle& triangle, float& u, float& v)
+	{
+		// Ericson, Real-Time Collision Detection 5.1.5: the vertex, edge or face Voronoi region point is in
+		const Vec3f ab = triangle.b - triangle.a;
+		const Vec3f ac = triangle.c - triangle.a;
+		const Vec3f ap = point - triangle.a;
+		const float d1 = ab.Dot(ap), d2 = ac.Dot(ap);
+		u = v = 0.f;
+		if (d1 <= 0.f && d2 <= 0.f)
+			return triangle.a;
+
+		const Vec3f bp = point - triangle.b;
+		const float d3 = ab.Dot(bp), d4 = ac.Dot(bp);
+		if (d3 >= 0.f && d4 <= d3)
+		{
+			u = 1.f;
+			return triangle.b;
+		}
+		const float vc = d1 * d4 - d3 * d2;
+		if (vc <= 0.f && d1 >= 0.f && d3 <= 0.f)
+		{
+			u = d1 / (d1 - d3);
+			return triangle.a + ab * u;
+		}
+
+		const Vec3f cp = point - triangle.c;
+		const float d5 = ab.Dot(cp), d6 = ac.Dot(cp);
+		if (d6 >= 0.f && d5 <= d6)
+		{
+			v = 1.f;
+			return triangle.c;
+		}
+		const float vb = d5 * d2 - d1 * d6;
+		if (vb <= 0.f && d2 >= 0.f && d6 <= 0.f)
+		{
+			v = d2 / (d2 - d6);
+			return triangle.a + ac * v;
+		}
+		const float va = d3 * d6 - d5 * d4;
+		if (va <= 0.f && d4 - d3 >= 0.f && d5 - d6 >= 0.f)
+		{
+			v = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+			u = 1.f - v;
+			return triangle.b + (triangle.c - triangle.b) * v;
+		}
+
+		const float denominator = 1.f / (va + vb + vc);
+		u = vb * denominator;
+		v = vc * denominator;
+		return triangle.a + ab * u + ac * v;
+	}
+
+	inline float DistanceSquared(const Segment& first, const Segment& second, Vec3f& onFirst, Vec3f& onSecond)
+	{
+		// Ericson 5.1.9: the closest points of the lines, clamped to the first segment then to the second
+		const Vec3f d1 = first.b - first.a;
+		const Vec3f d2 = second.b - second.a;
+		const Vec3f r = first.a - second.a;
+		const float a = d1.LengthSquared(), e = d2.LengthSquared(), f = d2.Dot(r);
+		float s = 0.f, t = 0.f;
+		if (a <= 1e-12f && e <= 1e-12f)
+		{
+		}
+		else if (a <= 1e-12f)
+		{
+			t = std::clamp(f / e, 0.f, 1.f);
+		}
+		else
+		{
+			const float c = d1.Dot(r);
+			if (e <= 1e-12f)
+			{
+				s = std::clamp(-c / a, 0.f, 1.f);
+			}
+			else
+			{
+				const float b = d1.Dot(d2);
+				const float denominator = a * e - b * b;
+				// Parallel segments: any s works, the clamps below pick the overlap end
+				s = denominator > 0.f ? std::clamp((b * f - c * e) / denominator, 0.f, 1.f) : 0.f;
+				t = (b * s + f) / e;
+				if (t < 0.f)
+				{
+					t = 0.f;
+					s = std::clamp(-c / a, 0.f, 1.f);
+				}
+				else if (t > 1.f)
+				{
+					t = 1.f;
+					s = std::clamp((b - c) / a, 0.f, 1.f);
+				}
+			}
+		}
+		onFirst = first.a + d1 * s;
+		onSecond = second.a + d2 * t;
+		return (onFirst - onSecond).LengthSquared();
+	}
+
+	inline float DistanceSquared(const Vec3f& point, const Segment& segment)
+	{
+		return (ClosestPoint(point, segment) - point).LengthSquared();
+	}
+
+	inline float DistanceSquared(const Vec3f& point, const AABB& box)
+	{
+		return (ClosestPoint(point, box) - point).LengthSquared();
+	}
+
+	inline float DistanceSquared(const Vec3f& point, const Triangle& triangle)
+	{
+		return (ClosestPoint(point, triangle) - point).LengthSquared();
+	}
+#pragma endregion
+
+#pragma region Batches
+	namespace Geometry
+	{
+		inline PackVec3 ClosestPoint(const PackVec3& p, const PackVec3& a, const PackVec3& b, const PackVec3& c, Expression::Pack<float>& distanceSquared)
+		{
+			using namespace Expression;
+			typedef Pack<float> P;
+			auto sub = [](const PackVec3& l, const PackVec3& r) { return PackVec3{ l.x - r.x, l.y - r.y, l.z - r.z }; };
+			auto dot = [](const PackVec3& l, const PackVec3& r) { return l.x * r.x + l.y * r.y + l.z * r.z; };
+			auto cross = [](const PackVec3& l, const PackVec3& r) { return PackVec3{ l.y * r.z - l.z * r.y, l.z * r.x - l.x * r.z, l.x * r.y - l.y * r.x }; };
+			auto select = [](const P& x, const P& y, const PackVec3& l, const PackVec3& r) { return PackVec3{ SelectLessPack(x, y, l.x, r.x), SelectLessPack(x, y, l.y, r.y), SelectLessPack(x, y, l.z, r.z) }; };
+			const P zero = BroadcastPack(0.f), one = BroadcastPack(1.f), tiny = BroadcastPack(FLT_MIN);
+
+			const PackVec3 ab = sub(b, a), bc = sub(c, b), ca = sub(a, c);
+			const PackVec3 ap = sub(p, a), bp = sub(p, b), cp = sub(p, c);
+			auto onEdge = [&](const PackVec3& start, const PackVec3& edge, const PackVec3& offset, P& squared)
+			{
+				const P t = MaxPack(MinPack(dot(offset, edge) / MaxPack(dot(edge, edge), tiny), one), zero);
+				const PackVec3 point = { start.x + edge.x * t, start.y + edge.y * t, start.z + edge.z * t };
+				const PackVec3 difference = sub(p, point);
+				squared = dot(difference, difference);
+				return point;
+			};
+			P squaredAB, squaredBC, squaredCA;
+			const PackVec3 pointAB = onEdge(a, ab, ap, squaredAB);
+			const PackVec3 pointBC = onEdge(b, bc, bp, squaredBC);
+			const PackVec3 pointCA = onEdge(c, ca, cp, squaredCA);
+			PackVec3 closest = select(squaredBC, squaredAB, pointBC, pointAB);
+			distanceSquared = MinPack(squaredAB, squaredBC);
+			closest = select(squaredCA, distanceSquared, pointCA, closest);
+			distanceSquared = MinPack(squaredCA, distanceSquared);
+
+			// Inside when p is left of every edge seen from the normal
+			const PackVec3 normal = cross(ab, sub(c, a));
+			const P inside = MinPack(MinPack(dot(cross(ab, ap), normal), dot(cross(bc, bp), normal)), dot(cross(ca, cp), normal));
+			const P height = dot(ap, normal) / dot(normal, normal);
+			const PackVec3 projected = { p.x - normal.x * height, p.y - normal.y * height, p.z - normal.z * height };
+			distanceSquared = SelectLessPack(zero, inside, height * height * dot(normal, normal), distanceSquared);
+			return select(zero, inside, projected, closest);
+		}
+
+		template<typename F>
+		inline void ForEachPack(size_t count, F&& block)
+		{
+			constexpr size_t Lanes = Expression::PackSize<float>;
+			for (size_t i = 0; i < count; i += Lanes)
+				block(i, std::min(Lanes, count - i));
+		}
+
+		inline Expression::Pack<float> LoadLanes(const MathArray<float>& values, size_t i, size_t lanes)
+		{
+			constexpr size_t Lanes = Expression::PackSize<float>;
+			if (lanes == Lanes)
+				return Expression::LoadPack(values.data() + i);
+			float padded[Lanes];
+			for (size_t k = 0; k < Lanes; k++)
+				padded[k] = values[i + std::min(k, lanes - 1)];
+			return Expression::LoadPack(padded);
+		}
+
+		inline void StoreLanes(float* output, const Expression::Pack<float>& pack, size_t lanes)
+		{
+			constexpr size_t Lanes = Expression::PackSize<float>;
+			if (lanes == Lanes)
+				return Expression::StorePack(output, pack);
+			float padded[Lanes];
+			Expression::StorePack(padded, pack);
+			std::copy_n(padded, lanes, output);
+		}
+	}
+
+	inline void DistanceSquared(const Vec3f& point, const TriangleSoA& triangles, std::span<float> output)
+	{
+		MATH_INSTRUMENT_SCOPE("DistanceSquared(Vec3f, TriangleSoA, span)");
+		const size_t count = std::min(triangles.GetSize(), output.size());
+		MATH_INSTRUMENT_ITEMS(count);
+		using namespace Expression;
+		const Geometry::PackVec3 p = { BroadcastPack(point.x), BroadcastPack(point.y), BroadcastPack(point.z) };
+		Geometry::ForEachPack(count, [&](size_t i, size_t lanes)
+		{
+			auto load = [&](const Vec3SoA<float>& vertex) { return Geometry::PackVec3{ Geometry::LoadLanes(vertex.x, i, lanes), Geometry::LoadLanes(vertex.y, i, lanes), Geometry::LoadLanes(vertex.z, i, lanes) }; };
+			Pack<float> squared;
+			Geometry::ClosestPoint(p, load(triangles.a), load(triangles.b), load(triangles.c), squared);
+			Geometry::StoreLanes(output.data() + i, squared, lanes);
+		});
+	}
+
+	inline uint32_t FindClosest(const Vec3f& point, const TriangleSoA& triangles, Vec3f& closest)
+	{
+		MATH_INSTRUMENT_SCOPE("FindClosest(Vec3f, TriangleSoA, Vec3f)");
+		MATH_INSTRUMENT_ITEMS(triangles.GetSize());
+		using namespace Expression;
+		constexpr size_t Lanes = PackSize<float>;
+		if (triangles.GetSize() == 0)
+			return 0xFFFFFFFF;
+
+		// Nearest distance and its triangle per lane. The lanes are compared out of the register so the indices stay integers,
+		// a float index is only exact up to 2^24 triangles
+		const Geometry::PackVec3 p = { BroadcastPack(point.x), BroadcastPack(point.y), BroadcastPack(point.z) };
+		float best[Lanes];
+		uint32_t indices[Lanes] = {};
+		std::fill_n(best, Lanes, FLT_MAX);
+		Geometry::ForEachPack(triangles.GetSize(), [&](size_t i, size_t lanes)
+		{
+			auto load = [&](const Vec3SoA<float>& vertex) { return Geometry::PackVec3{ Geometry::LoadLanes(vertex.x, i, lanes), Geometry::LoadLanes(vertex.y, i, lanes), Geometry::LoadLanes(vertex.z, i, lanes) }; };
+			Pack<float> squared;
+			Geometry::ClosestPoint(p, load(triangles.a), load(triangles.b), load(triangles.c), squared);
+			float distances[Lanes];
+			StorePack(distances, squared);
+			for (size_t k = 0; k < lanes; k++)
+			{
+				if (distances[k] < best[k])
+				{
+					best[k] = distances[k];
+					indices[k] = static_cast<uint32_t>(i + k);
+				}
+			}
+		});
+
+		size_t lane = 0;
+		for (size_t k = 1; k < Lanes; k++)
+		{
+			if (best[k] < best[lane] || (best[k] == best[lane] && indices[k] < indices[lane]))
+				lane = k;
+		}
+		const uint32_t index = indices[lane];
+		closest = ClosestPoint(point, triangles.Get(index));
+		return index;
+	}
+
+	inline void ClosestPoint(const Vec3SoA<float>& points, const Triangle& triangle, Vec3SoA<float>& output)
+	{
+		MATH_INSTRUMENT_SCOPE("ClosestPoint(Vec3SoA, Triangle, Vec3SoA)");
+		MATH_INSTRUMENT_ITEMS(points.GetSize());
+		using namespace Expression;
+		auto broadcast = [](const Vec3f& vertex) { return Geometry::PackVec3{ BroadcastPack(vertex.x), BroadcastPack(vertex.y), BroadcastPack(vertex.z) }; };
+		const Geometry::PackVec3 a = broadcast(triangle.a), b = broadcast(triangle.b), c = broadcast(triangle.c);
+		output.Resize(points.GetSize());
+		Geometry::ForEachPack(points.GetSize(), [&](size_t i, size_t lanes)
+		{
+			const Geometry::PackVec3 p = { Geometry::LoadLanes(points.x, i, lanes), Geometry::LoadLanes(points.y, i, lanes), Geometry::LoadLanes(points.z, i, lanes) };
+			Pack<float> squared;
+			const Geometry::PackVec3 closest = Geometry::ClosestPoint(p, a, b, c, squared);
+			Geometry::StoreLanes(output.x.data() + i, closest.x, lanes);
+			Geometry::StoreLanes(output.y.data() + i, closest.y, lanes);
+			Geometry::StoreLanes(output.z.data() + i, closest.z, lanes);
+		});
+	}
+#pragma endregion
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+// MATH_INSTRUMENT counts every call to the public Maths.inl functions on a per thread
+// counter and times one call out of SetSamplePeriod with the cycle counter.
+// Without it the MATH_INSTRUMENT_* macros expand to nothing.
+#ifdef MATH_INSTRUMENT
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// Counts the enclosing function under name
+#define MATH_INSTRUMENT_SCOPE(name) ::GALAXY::Math::Instrument::Scope<name> mathInstrumentScope(nullptr)
+// Counts a scalar function that has a batch alternative, reported when it is called often enough to be worth batching
+#define MATH_INSTRUMENT_BATCHABLE(name, alternative) ::GALAXY::Math::Instrument::Scope<name> mathInstrumentScope(alternative)
+// Adds the number of elements processed by the enclosing batch function
+#define MATH_INSTRUMENT_ITEMS(count) mathInstrumentScope.AddItems(count)
+
+namespace GALAXY::Math::Instrument
+{
+	constexpr uint32_t MaxSites = 512; // the last site collects every function past the limit
+
+	// String literal usable as a template argument, so each function gets its own counter slot
+	template<size_t N>
+	struct SiteName
+	{
+		char value[N];
+
+		inline constexpr SiteName(const char (&name)[N])
+		{
+			for (size_t i = 0; i < N; i++)
+				value[i] = name[i];
+		}
+	};
+
+	// Site name of a VecN function, "VecN" becomes "Vec2", "Vec3" or "Vec4" for those sizes
+	template<size_t Size, size_t N>
+	inline constexpr SiteName<N> VecSiteName(const char (&name)[N])
+	{
+		SiteName<N> site(name);
+		for (size_t i = 0; Size >= 2 && Size <= 4 && i + 3 < N; i++)
+		{
+			if (site.value[i] == 'V' && site.value[i + 1] == 'e' && site.value[i + 2] == 'c' && site.value[i + 3] == 'N')
+				site.value[i + 3] = static_cast<char>('0' + Size);
+		}
+		return site;
+	}
+
+	struct Counter
+	{
+		std::atomic<uint64_t> calls = 0;
+		std::atomic<uint64_t> items = 0;
+		std::atomic<uint64_t> sampledCalls = 0;
+		std::atomic<uint64_t> sampledCycles = 0;
+	};
+
+	struct FunctionStats
+	{
+		std::string name;
+		std::string batchAlternative; // empty when the function has none
+		uint64_t calls = 0;
+		uint64_t items = 0; // elements processed, batch functions only
+		uint64_t sampledCalls = 0;
+		uint64_t sampledCycles = 0;
+
+		// Inclusive of the instrumented functions it calls
+		inline double GetCyclesPerCall() const;
+
+		// Cycles per call extrapolated to every call
+		inline double GetEstimatedCycles() const;
+
+		inline double GetItemsPerCall() const;
+	};
+
+	inline uint64_t ReadCycles();
+
+	// Assigns the counter slot of a function on its first call
+	inline uint32_t RegisterSite(std::atomic<uint32_t>& index, const char* name, const char* batchAlternative);
+
+	// Counters of the calling thread, allocated on its first instrumented call and kept after it exits
+	inline Counter* GetThreadCounters();
+
+	// Returns true when the current call is to be timed
+	inline bool TakeSample();
+
+	// One call out of period is timed, 0 only counts calls
+	inline void SetSamplePeriod(uint32_t period);
+
+	// Counters of every thread summed per function, sorted by estimated cycles
+	inline std::vector<FunctionStats> Snapshot();
+
+	inline void Reset();
+
+	// Table of the top functions, followed by the scalar functions worth replacing by their batch alternative
+	inline std::string Report(size_t top = 20);
+
+	template<SiteName Name>
+	inline std::atomic<uint32_t> siteIndex = 0;
+
+	template<SiteName Name>
+	class Scope
+	{
+	public:
+		inline constexpr Scope(const char* batchAlternative)
+		{
+			if (!std::is_constant_evaluated())
+				Begin(batchAlternative);
+		}
+
+		inline constexpr ~Scope()
+		{
+			if (!std::is_constant_evaluated())
+				End();
+		}
+
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+
+		inline constexpr void AddItems(size_t count)
+		{
+			if (!std::is_constant_evaluated())
+				CountItems(count);
+		}
+
+	private:
+		inline void Begin(const char* batchAlternative);
+
+		inline void End();
+
+		inline void CountItems(size_t count);
+
+		Counter* counter = nullptr;
+		uint64_t start = 0;
+	};
+}
+
+#include "MathInstrument.inl"
+#else
+#define MATH_INSTRUMENT_SCOPE(name)
+#define MATH_INSTRUMENT_BATCHABLE(name, alternative)
+#define MATH_INSTRUMENT_ITEMS(count)
+#endif
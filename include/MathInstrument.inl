@@ -0,0 +1,240 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define MATH_INSTRUMENT_RDTSC
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define MATH_INSTRUMENT_RDTSC
+#endif
+
+namespace GALAXY::Math::Instrument
+{
+#pragma region Storage
+	struct Site
+	{
+		std::atomic<const char*> name = nullptr;
+		std::atomic<const char*> batchAlternative = nullptr;
+	};
+
+	struct ThreadBlock
+	{
+		Counter counters[MaxSites];
+		ThreadBlock* next = nullptr;
+	};
+
+	inline Site sites[MaxSites];
+	inline std::atomic<uint32_t> siteCount = 0;
+	inline std::mutex siteMutex;
+
+	// Blocks are only ever pushed, a snapshot walks them without locking
+	inline std::atomic<ThreadBlock*> threadBlocks = nullptr;
+
+	inline std::atomic<uint32_t> samplePeriod = 64;
+
+	// Only the owning thread writes its counters, a relaxed load and store is enough and avoids a locked add
+	inline void Add(std::atomic<uint64_t>& value, uint64_t amount)
+	{
+		value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+	}
+#pragma endregion
+
+#pragma region Functions
+	inline uint64_t ReadCycles()
+	{
+#ifdef MATH_INSTRUMENT_RDTSC
+		return __rdtsc();
+#else
+		return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+	}
+
+	inline uint32_t RegisterSite(std::atomic<uint32_t>& index, const char* name, const char* batchAlternative)
+	{
+		std::lock_guard<std::mutex> lock(siteMutex);
+		uint32_t current = index.load(std::memory_order_relaxed);
+		if (current != 0)
+			return current;
+
+		const uint32_t slot = siteCount.load(std::memory_order_relaxed);
+		if (slot < MaxSites)
+		{
+			sites[slot].name.store(slot == MaxSites - 1 ? "<other>" : name, std::memory_order_relaxed);
+			sites[slot].batchAlternative.store(slot == MaxSites - 1 ? nullptr : batchAlternative, std::memory_order_relaxed);
+			siteCount.store(slot + 1, std::memory_order_release);
+		}
+		current = std::min(slot, MaxSites - 1) + 1;
+		index.store(current, std::memory_order_release);
+		return current;
+	}
+
+	inline Counter* GetThreadCounters()
+	{
+		thread_local ThreadBlock* block = nullptr;
+		if (!block)
+		{
+			block = new ThreadBlock();
+			block->next = threadBlocks.load(std::memory_order_relaxed);
+			while (!threadBlocks.compare_exchange_weak(block->next, block, std::memory_order_release, std::memory_order_relaxed));
+		}
+		return block->counters;
+	}
+
+	inline bool TakeSample()
+	{
+		thread_local uint32_t countdown = 0;
+		const uint32_t period = samplePeriod.load(std::memory_order_relaxed);
+		if (period == 0)
+			return false;
+		if (countdown == 0)
+		{
+			countdown = period - 1;
+			return true;
+		}
+		countdown--;
+		return false;
+	}
+
+	inline void SetSamplePeriod(uint32_t period)
+	{
+		samplePeriod.store(period, std::memory_order_relaxed);
+	}
+
+	inline std::vector<FunctionStats> Snapshot()
+	{
+		const uint32_t count = siteCount.load(std::memory_order_acquire);
+		std::vector<FunctionStats> stats(count);
+		for (uint32_t i = 0; i < count; i++)
+		{
+			stats[i].name = sites[i].name.load(std::memory_order_relaxed);
+			if (const char* alternative = sites[i].batchAlternative.load(std::memory_order_relaxed))
+				stats[i].batchAlternative = alternative;
+		}
+
+		for (ThreadBlock* block = threadBlocks.load(std::memory_order_acquire); block; block = block->next)
+		{
+			for (uint32_t i = 0; i < count; i++)
+			{
+				const Counter& counter = block->counters[i];
+				stats[i].calls += counter.calls.load(std::memory_order_relaxed);
+				stats[i].items += counter.items.load(std::memory_order_relaxed);
+				stats[i].sampledCalls += counter.sampledCalls.load(std::memory_order_relaxed);
+				stats[i].sampledCycles += counter.sampledCycles.load(std::memory_order_relaxed);
+			}
+		}
+
+		stats.erase(std::remove_if(stats.begin(), stats.end(), [](const FunctionStats& s) { return s.calls == 0; }), stats.end());
+		std::sort(stats.begin(), stats.end(), [](const FunctionStats& a, const FunctionStats& b)
+		{
+			if (a.GetEstimatedCycles() != b.GetEstimatedCycles())
+				return a.GetEstimatedCycles() > b.GetEstimatedCycles();
+			return a.calls > b.calls;
+		});
+		return stats;
+	}
+
+	// Counts written by a thread while it is reset may survive, reset between frames
+	inline void Reset()
+	{
+		for (ThreadBlock* block = threadBlocks.load(std::memory_order_acquire); block; block = block->next)
+		{
+			for (Counter& counter : block->counters)
+			{
+				counter.calls.store(0, std::memory_order_relaxed);
+				counter.items.store(0, std::memory_order_relaxed);
+				counter.sampledCalls.store(0, std::memory_order_relaxed);
+				counter.sampledCycles.store(0, std::memory_order_relaxed);
+			}
+		}
+	}
+
+	inline std::string Report(size_t top)
+	{
+		constexpr uint64_t batchCandidateCalls = 1024; // fewer scalar calls than this are not worth batching
+		constexpr double smallBatch = 8.0;
+
+		const std::vector<FunctionStats> stats = Snapshot();
+		std::ostringstream oss;
+		oss << std::left << std::setw(40) << "Function" << std::right << std::setw(14) << "Calls" << std::setw(14) << "Cycles/call"
+			<< std::setw(16) << "Est. cycles" << std::setw(12) << "Items/call" << "\n";
+		for (size_t i = 0; i < std::min(top, stats.size()); i++)
+		{
+			const FunctionStats& s = stats[i];
+			oss << std::left << std::setw(40) << s.name << std::right << std::setw(14) << s.calls << std::fixed << std::setprecision(1)
+				<< std::setw(14) << s.GetCyclesPerCall() << std::setprecision(0) << std::setw(16) << s.GetEstimatedCycles();
+			if (s.items > 0)
+				oss << std::setprecision(1) << std::setw(12) << s.GetItemsPerCall();
+			oss << std::defaultfloat << "\n";
+		}
+
+		bool header = false;
+		for (const FunctionStats& s : stats)
+		{
+			const bool scalarHot = !s.batchAlternative.empty() && s.calls >= batchCandidateCalls;
+			const bool batchSmall = s.items > 0 && s.GetItemsPerCall() < smallBatch;
+			if (!scalarHot && !batchSmall)
+				continue;
+			if (!header)
+				oss << "Batch candidates:\n";
+			header = true;
+			if (scalarHot)
+				oss << "   " << s.name << " called " << s.calls << " times, use " << s.batchAlternative << "\n";
+			else
+				oss << "   " << s.name << " averages " << std::fixed << std::setprecision(1) << s.GetItemsPerCall() << std::defaultfloat << " items per call, gather larger batches\n";
+		}
+		return oss.str();
+	}
+#pragma endregion
+
+#pragma region FunctionStats
+	inline double FunctionStats::GetCyclesPerCall() const
+	{
+		return sampledCalls > 0 ? static_cast<double>(sampledCycles) / static_cast<double>(sampledCalls) : 0.0;
+	}
+
+	inline double FunctionStats::GetEstimatedCycles() const
+	{
+		return GetCyclesPerCall() * static_cast<double>(calls);
+	}
+
+	inline double FunctionStats::GetItemsPerCall() const
+	{
+		return calls > 0 ? static_cast<double>(items) / static_cast<double>(calls) : 0.0;
+	}
+#pragma endregion
+
+#pragma region Scope
+	template<SiteName Name>
+	inline void Scope<Name>::Begin(const char* batchAlternative)
+	{
+		uint32_t index = siteIndex<Name>.load(std::memory_order_acquire);
+		if (index == 0)
+			index = RegisterSite(siteIndex<Name>, Name.value, batchAlternative);
+		counter = &GetThreadCounters()[index - 1];
+		Add(counter->calls, 1);
+		if (TakeSample())
+			start = ReadCycles();
+	}
+
+	template<SiteName Name>
+	inline void Scope<Name>::End()
+	{
+		if (start == 0)
+			return;
+		const uint64_t cycles = ReadCycles() - start;
+		Add(counter->sampledCalls, 1);
+		Add(counter->sampledCycles, cycles);
+	}
+
+	template<SiteName Name>
+	inline void Scope<Name>::CountItems(size_t count)
+	{
+		Add(counter->items, count);
+	}
+#pragma endregion
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace GALAXY::Math
+{
+	// Threads the parallel algorithms run on, the calling thread included. Hardware concurrency until set, 1 runs everything inline
+	inline size_t GetWorkerCount();
+
+	inline void SetWorkerCount(size_t count);
+
+	// Calls task(begin, end) on the chunks [k * grain, (k + 1) * grain) of [0, count), the last one shorter, from up to GetWorkerCount() threads.
+	// Chunks are claimed one at a time so uneven chunks balance out, returns once every chunk is done.
+	// The calling thread works along with the threads of one pool shared by every caller, started on first use and kept asleep between loops.
+	// Called from a task or from a pool thread it runs inline, nested loops do not add threads
+	template<typename F>
+	inline void ParallelFor(size_t count, size_t grain, F&& task);
+
+	// Stable sort of uint32_t or uint64_t keys, values moved along with them, stops at the shorter span. A byte per pass from the lowest,
+	// passes where every key has the same byte are skipped. Every chunk counts and scatters its own keys so the result does not depend on the worker count
+	template<typename K, typename V>
+	inline void RadixSort(std::span<K> keys, std::span<V> values);
+
+	namespace Parallel
+	{
+		inline std::atomic<size_t> workerCount = 0;
+
+		// Set on the pool threads and while the caller of ParallelFor runs tasks
+		inline thread_local bool insideWorker = false;
+
+		// Marks the current thread as a worker while in scope, its ParallelFor calls then run inline
+		class WorkerScope
+		{
+		public:
+			inline WorkerScope() : previous(insideWorker) { insideWorker = true; }
+			inline ~WorkerScope() { insideWorker = previous; }
+
+			WorkerScope(const WorkerScope&) = delete;
+			WorkerScope& operator=(const WorkerScope&) = delete;
+
+		private:
+			bool previous;
+		};
+
+		// One ParallelFor call: the chunks still to claim and the pool threads helping with them
+		struct Job
+		{
+			void (*run)(void* task, size_t begin, size_t end);
+			void* task;
+			size_t count, grain, chunks, maxHelpers;
+			std::atomic<size_t> next = 0;
+			// Guarded by the pool mutex
+			size_t helpers = 0;
+
+			// Claims and runs chunks until none is left
+			inline void Execute();
+		};
+
+		// Threads that sleep until a job has chunks left, grown up to the worker count and joined at exit
+		class Pool
+		{
+		public:
+			inline ~Pool();
+
+			// Runs job on the calling thread and up to job.maxHelpers pool threads, returns once every chunk is done
+			inline void Run(Job& job);
+
+		private:
+			inline void Work();
+
+			std::mutex mutex;
+			std::condition_variable wake, finished;
+			std::vector<Job*> jobs;
+			std::vector<std::thread> threads;
+			bool stopping = false;
+		};
+
+		inline Pool& GetPool();
+	}
+}
+
+#include "MathParallel.inl"
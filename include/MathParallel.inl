@@ -0,0 +1,219 @@
+#pragma once
+#include <algorithm>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "MathInstrument.h"
+
+#include "MathParallel.h"
+
+namespace GALAXY::Math
+{
+	inline size_t GetWorkerCount()
+	{
+		const size_t count = Parallel::workerCount.load(std::memory_order_relaxed);
+		return count != 0 ? count : std::max<size_t>(1, std::thread::hardware_concurrency());
+	}
+
+	inline void SetWorkerCount(size_t count)
+	{
+		Parallel::workerCount.store(count, std::memory_order_relaxed);
+	}
+
+	namespace Parallel
+	{
+		inline void Job::Execute()
+		{
+			for (size_t chunk = next.fetch_add(1, std::memory_order_relaxed); chunk < chunks; chunk = next.fetch_add(1, std::memory_order_relaxed))
+				run(task, chunk * grain, std::min((chunk + 1) * grain, count));
+		}
+
+		inline Pool::~Pool()
+		{
+			{
+				std::lock_guard lock(mutex);
+				stopping = true;
+			}
+			wake.notify_all();
+			for (std::thread& thread : threads)
+				thread.join();
+		}
+
+		inline void Pool::Run(Job& job)
+		{
+			{
+				std::lock_guard lock(mutex);
+				while (threads.size() < job.maxHelpers)
+					threads.emplace_back([this]() { Work(); });
+				jobs.push_back(&job);
+			}
+			wake.notify_all();
+			{
+				WorkerScope scope;
+				job.Execute();
+			}
+
+			// Every chunk is claimed, the job only has to wait for the helpers still running one
+			std::unique_lock lock(mutex);
+			std::erase(jobs, &job);
+			finished.wait(lock, [&]() { return job.helpers == 0; });
+		}
+
+		inline void Pool::Work()
+		{
+			insideWorker = true;
+			std::unique_lock lock(mutex);
+			while (true)
+			{
+				Job* job = nullptr;
+				wake.wait(lock, [&]()
+				{
+					for (Job* candidate : jobs)
+					{
+						if (candidate->helpers < candidate->maxHelpers && candidate->next.load(std::memory_order_relaxed) < candidate->chunks)
+						{
+							job = candidate;
+							return true;
+						}
+					}
+					return stopping;
+				});
+				if (job == nullptr)
+					return;
+				job->helpers++;
+				lock.unlock();
+				job->Execute();
+				lock.lock();
+				if (--job->helpers == 0)
+					finished.notify_all();
+			}
+		}
+
+		inline Pool& GetPool()
+		{
+			static Pool pool;
+			return pool;
+		}
+	}
+
+	template<typename F>
+	inline void ParallelFor(size_t count, size_t grain, F&& task)
+	{
+		grain = std::max<size_t>(grain, 1);
+		const size_t chunks = (count + grain - 1) / grain;
+		const size_t threads = std::min(GetWorkerCount(), chunks);
+		if (threads <= 1 || Parallel::insideWorker)
+		{
+			for (size_t begin = 0; begin < count; begin += grain)
+				task(begin, std::min(begin + grain, count));
+			return;
+		}
+
+		using Task = std::remove_reference_t<F>;
+		Parallel::Job job;
+		job.run = [](void* pointer, size_t begin, size_t end) { (*static_cast<Task*>(pointer))(begin, end); };
+		job.task = const_cast<void*>(static_cast<const void*>(std::addressof(task)));
+		job.count = count;
+		job.grain = grain;
+		job.chunks = chunks;
+		job.maxHelpers = threads - 1;
+		Parallel::GetPool().Run(job);
+	}
+
+	template<typename K, typename V>
+	inline void RadixSort(std::span<K> keys, std::span<V> values)
+	{
+		static_assert(std::is_same_v<K, uint32_t> || std::is_same_v<K, uint64_t>, "Keys are uint32_t or uint64_t");
+		MATH_INSTRUMENT_SCOPE("RadixSort(span, span)");
+		const size_t count = std::min(keys.size(), values.size());
+		keys = keys.first(count);
+		values = values.first(count);
+		MATH_INSTRUMENT_ITEMS(count);
+		constexpr size_t Grain = 1 << 16;
+		constexpr size_t Digits = 256;
+		if (count <= 1)
+			return;
+
+		// Every byte histogram up front: a pass is skipped when one digit has every key
+		const size_t chunks = (count + Grain - 1) / Grain;
+		std::vector<uint32_t> chunkTotals(chunks * sizeof(K) * Digits, 0);
+		ParallelFor(count, Grain, [&](size_t begin, size_t end)
+		{
+			uint32_t* totals = chunkTotals.data() + begin / Grain * sizeof(K) * Digits;
+			for (size_t i = begin; i < end; i++)
+			{
+				for (size_t pass = 0; pass < sizeof(K); pass++)
+					totals[pass * Digits + (keys[i] >> (8 * pass) & 0xFF)]++;
+			}
+		});
+
+		std::vector<K> keyBuffer(count);
+		std::vector<V> valueBuffer(count);
+		std::span<K> sourceKeys = keys, targetKeys = keyBuffer;
+		std::span<V> sourceValues = values, targetValues = valueBuffer;
+		std::vector<uint32_t> offsets(chunks * Digits);
+		bool scattered = false;
+		for (size_t pass = 0; pass < sizeof(K); pass++)
+		{
+			const size_t shift = 8 * pass;
+			uint32_t total[Digits] = {};
+			for (size_t chunk = 0; chunk < chunks; chunk++)
+			{
+				for (size_t digit = 0; digit < Digits; digit++)
+					total[digit] += chunkTotals[(chunk * sizeof(K) + pass) * Digits + digit];
+			}
+			if (std::find(total, total + Digits, static_cast<uint32_t>(count)) != total + Digits)
+				continue;
+
+			// The up front counts per chunk only hold until the first scatter moves keys between chunks
+			if (scattered)
+			{
+				ParallelFor(count, Grain, [&](size_t begin, size_t end)
+				{
+					uint32_t* counts = offsets.data() + begin / Grain * Digits;
+					std::fill(counts, counts + Digits, 0);
+					for (size_t i = begin; i < end; i++)
+						counts[sourceKeys[i] >> shift & 0xFF]++;
+				});
+			}
+			else
+			{
+				for (size_t chunk = 0; chunk < chunks; chunk++)
+					std::copy_n(chunkTotals.data() + (chunk * sizeof(K) + pass) * Digits, Digits, offsets.data() + chunk * Digits);
+			}
+			// Chunk c writes digit d after every smaller digit and after digit d of the chunks before it
+			uint32_t start = 0;
+			for (size_t digit = 0; digit < Digits; digit++)
+			{
+				for (size_t chunk = 0; chunk < chunks; chunk++)
+				{
+					const uint32_t chunkCount = offsets[chunk * Digits + digit];
+					offsets[chunk * Digits + digit] = start;
+					start += chunkCount;
+				}
+			}
+
+			ParallelFor(count, Grain, [&](size_t begin, size_t end)
+			{
+				uint32_t* next = offsets.data() + begin / Grain * Digits;
+				for (size_t i = begin; i < end; i++)
+				{
+					const uint32_t target = next[sourceKeys[i] >> shift & 0xFF]++;
+					targetKeys[target] = sourceKeys[i];
+					targetValues[target] = std::move(sourceValues[i]);
+				}
+			});
+			std::swap(sourceKeys, targetKeys);
+			std::swap(sourceValues, targetValues);
+			scattered = true;
+		}
+
+		if (sourceKeys.data() != keys.data())
+		{
+			std::copy(sourceKeys.begin(), sourceKeys.end(), keys.begin());
+			std::move(sourceValues.begin(), sourceValues.end(), values.begin());
+		}
+	}
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "Maths.h"
+
+namespace GALAXY::Math
+{
+	// xoshiro128+ run on Lanes independent states at once, one SIMD step yields Lanes numbers.
+	// The lane count is the same in every build so a seed gives the same sequence with AVX2, SSE or no SIMD.
+	// Shapes are sampled in batches: the uniforms of a whole block are generated first, then transformed.
+	class Random
+	{
+	public:
+		static constexpr size_t Lanes = 8;
+		static constexpr uint64_t DefaultSeed = 0x853C49E6748FEA9Bull;
+
+		explicit inline Random(uint64_t seed = DefaultSeed, uint64_t stream = 0);
+
+		// Streams of the same seed are seeded through different SplitMix64 sequences and do not overlap in practice
+		inline void Seed(uint64_t seed, uint64_t stream = 0);
+
+		inline uint32_t NextUInt();
+
+		// Uniform in [0, 1) with 24 bits of randomness
+		inline float NextFloat();
+
+		inline float Range(float min, float max);
+
+		// Uniform in the unit disk
+		inline Vec2f InDisk();
+
+		// Uniform on the unit sphere
+		inline Vec3f OnSphere();
+
+		// Uniform in the unit ball
+		inline Vec3f InSphere();
+
+		template<typename V> requires (std::is_same_v<V, Vec2f> || std::is_same_v<V, Vec3f> || std::is_same_v<V, Vec4f>)
+		inline V InBox(const V& min, const V& max);
+
+		// Uniform rotation (Shoemake)
+		inline Quat Rotation();
+
+		// Batch versions, one SIMD step per Lanes uniforms
+		inline void Uniform(std::span<float> output);
+
+		inline void InDisk(std::span<Vec2f> output);
+
+		inline void OnSphere(std::span<Vec3f> output);
+
+		inline void InSphere(std::span<Vec3f> output);
+
+		template<typename V> requires (std::is_same_v<V, Vec2f> || std::is_same_v<V, Vec3f> || std::is_same_v<V, Vec4f>)
+		inline void InBox(std::span<V> output, const V& min, const V& max);
+
+		inline void Rotation(std::span<Quat> output);
+
+		// Generator of the calling thread, every thread gets its own stream of the thread seed
+		static inline Random& ForThread();
+
+		// Seed of the streams of threads that call ForThread for the first time afterwards
+		static inline void SetThreadSeed(uint64_t seed);
+
+	private:
+		// Advances every lane once
+		inline void Step(uint32_t* output);
+
+		inline void StepFloats(float* output);
+
+		template<size_t Count>
+		inline void Fill(float (&block)[Count]);
+
+		static inline Vec3f SphereFromDisk(float u, float v, float squaredLength);
+
+		// Sine and cosine of turn * 2 pi for a turn in [0, 1)
+		static inline void SinCosTurn(float turn, float& sin, float& cos);
+
+		static inline Quat RotationFromUniform(float u1, float u2, float u3);
+
+		alignas(32) uint32_t state[4][Lanes] = {};
+		alignas(32) uint32_t buffer[Lanes] = {};
+		size_t buffered = 0;
+
+		static inline std::atomic<uint64_t> threadSeed = DefaultSeed;
+		static inline std::atomic<uint64_t> threadStreams = 0;
+	};
+}
+
+#include "MathRandom.inl"
@@ -0,0 +1,357 @@
+#pragma once
+#include "MathRandom.h"
+
+namespace GALAXY::Math
+{
+#pragma region Generator
+	inline Random::Random(uint64_t seed, uint64_t stream)
+	{
+		Seed(seed, stream);
+	}
+
+	inline void Random::Seed(uint64_t seed, uint64_t stream)
+	{
+		auto splitMix = [](uint64_t& x)
+		{
+			uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+			z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+			z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+			return z ^ (z >> 31);
+		};
+		// The stream goes through an extra odd multiply so swapping seed and stream gives another generator
+		uint64_t x = splitMix(seed) ^ (splitMix(stream) * 0xD1B54A32D192ED03ull);
+		for (size_t lane = 0; lane < Lanes; lane++)
+		{
+			const uint64_t a = splitMix(x), b = splitMix(x);
+			state[0][lane] = static_cast<uint32_t>(a);
+			state[1][lane] = static_cast<uint32_t>(a >> 32);
+			state[2][lane] = static_cast<uint32_t>(b);
+			state[3][lane] = static_cast<uint32_t>(b >> 32);
+			// An all zero state would only ever produce zeros
+			if ((a | b) == 0)
+				state[0][lane] = 1;
+		}
+		buffered = 0;
+	}
+
+	inline uint32_t Random::NextUInt()
+	{
+		if (buffered == 0)
+		{
+			Step(buffer);
+			buffered = Lanes;
+		}
+		return buffer[Lanes - buffered--];
+	}
+
+	inline float Random::NextFloat()
+	{
+		return static_cast<float>(NextUInt() >> 8) * 0x1.0p-24f;
+	}
+
+	inline float Random::Range(float min, float max)
+	{
+		return min + (max - min) * NextFloat();
+	}
+
+	inline Random& Random::ForThread()
+	{
+		thread_local Random random(threadSeed.load(std::memory_order_relaxed), threadStreams.fetch_add(1, std::memory_order_relaxed));
+		return random;
+	}
+
+	inline void Random::SetThreadSeed(uint64_t seed)
+	{
+		threadSeed.store(seed, std::memory_order_relaxed);
+	}
+
+	inline void Random::Step(uint32_t* output)
+	{
+#if defined(MATH_AVX) && defined(__AVX2__)
+		__m256i s0 = _mm256_load_si256(reinterpret_cast<const __m256i*>(state[0]));
+		__m256i s1 = _mm256_load_si256(reinterpret_cast<const __m256i*>(state[1]));
+		__m256i s2 = _mm256_load_si256(reinterpret_cast<const __m256i*>(state[2]));
+		__m256i s3 = _mm256_load_si256(reinterpret_cast<const __m256i*>(state[3]));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(output), _mm256_add_epi32(s0, s3));
+		const __m256i t = _mm256_slli_epi32(s1, 9);
+		s2 = _mm256_xor_si256(s2, s0);
+		s3 = _mm256_xor_si256(s3, s1);
+		s1 = _mm256_xor_si256(s1, s2);
+		s0 = _mm256_xor_si256(s0, s3);
+		s2 = _mm256_xor_si256(s2, t);
+		s3 = _mm256_or_si256(_mm256_slli_epi32(s3, 11), _mm256_srli_epi32(s3, 21));
+		_mm256_store_si256(reinterpret_cast<__m256i*>(state[0]), s0);
+		_mm256_store_si256(reinterpret_cast<__m256i*>(state[1]), s1);
+		_mm256_store_si256(reinterpret_cast<__m256i*>(state[2]), s2);
+		_mm256_store_si256(reinterpret_cast<__m256i*>(state[3]), s3);
+#elif defined(MATH_SSE)
+		for (size_t lane = 0; lane < Lanes; lane += 4)
+		{
+			__m128i s0 = _mm_load_si128(reinterpret_cast<const __m128i*>(state[0] + lane));
+			__m128i s1 = _mm_load_si128(reinterpret_cast<const __m128i*>(state[1] + lane));
+			__m128i s2 = _mm_load_si128(reinterpret_cast<const __m128i*>(state[2] + lane));
+			__m128i s3 = _mm_load_si128(reinterpret_cast<const __m128i*>(state[3] + lane));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(output + lane), _mm_add_epi32(s0, s3));
+			const __m128i t = _mm_slli_epi32(s1, 9);
+			s2 = _mm_xor_si128(s2, s0);
+			s3 = _mm_xor_si128(s3, s1);
+			s1 = _mm_xor_si128(s1, s2);
+			s0 = _mm_xor_si128(s0, s3);
+			s2 = _mm_xor_si128(s2, t);
+			s3 = _mm_or_si128(_mm_slli_epi32(s3, 11), _mm_srli_epi32(s3, 21));
+			_mm_store_si128(reinterpret_cast<__m128i*>(state[0] + lane), s0);
+			_mm_store_si128(reinterpret_cast<__m128i*>(state[1] + lane), s1);
+			_mm_store_si128(reinterpret_cast<__m128i*>(state[2] + lane), s2);
+			_mm_store_si128(reinterpret_cast<__m128i*>(state[3] + lane), s3);
+		}
+#else
+		for (size_t lane = 0; lane < Lanes; lane++)
+		{
+			uint32_t& s0 = state[0][lane];
+			uint32_t& s1 = state[1][lane];
+			uint32_t& s2 = state[2][lane];
+			uint32_t& s3 = state[3][lane];
+			output[lane] = s0 + s3;
+			const uint32_t t = s1 << 9;
+			s2 ^= s0;
+			s3 ^= s1;
+			s1 ^= s2;
+			s0 ^= s3;
+			s2 ^= t;
+			s3 = (s3 << 11) | (s3 >> 21);
+		}
+#endif
+	}
+
+	inline void Random::StepFloats(float* output)
+	{
+		alignas(32) uint32_t bits[Lanes];
+		Step(bits);
+		// The top 24 bits convert to float exactly, every build produces the same values
+#if defined(MATH_AVX) && defined(__AVX2__)
+		const __m256i top = _mm256_srli_epi32(_mm256_load_si256(reinterpret_cast<const __m256i*>(bits)), 8);
+		_mm256_storeu_ps(output, _mm256_mul_ps(_mm256_cvtepi32_ps(top), _mm256_set1_ps(0x1.0p-24f)));
+#elif defined(MATH_SSE)
+		for (size_t lane = 0; lane < Lanes; lane += 4)
+		{
+			const __m128i top = _mm_srli_epi32(_mm_load_si128(reinterpret_cast<const __m128i*>(bits + lane)), 8);
+			_mm_storeu_ps(output + lane, _mm_mul_ps(_mm_cvtepi32_ps(top), _mm_set1_ps(0x1.0p-24f)));
+		}
+#else
+		for (size_t lane = 0; lane < Lanes; lane++)
+			output[lane] = static_cast<float>(bits[lane] >> 8) * 0x1.0p-24f;
+#endif
+	}
+
+	template<size_t Count>
+	inline void Random::Fill(float (&block)[Count])
+	{
+		static_assert(Count % Lanes == 0, "Blocks are a whole number of steps");
+		for (size_t i = 0; i < Count; i += Lanes)
+			StepFloats(block + i);
+	}
+#pragma endregion
+
+#pragma region Shapes
+	inline Vec3f Random::SphereFromDisk(float u, float v, float squaredLength)
+	{
+		// Marsaglia: a point of the unit disk lifted onto the sphere
+		const float scale = 2.f * Sqrt(1.f - squaredLength);
+		return Vec3f(u * scale, v * scale, 1.f - 2.f * squaredLength);
+	}
+
+	inline void Random::SinCosTurn(float turn, float& sin, float& cos)
+	{
+		// Nearest quarter turn, then Taylor polynomials on [-pi / 4, pi / 4]: no branches and no libm call, so the loops vectorize
+		const float quarter = static_cast<float>(static_cast<int>(turn * 4.f + 0.5f));
+		const float x = (turn - quarter * 0.25f) * (2.f * PI);
+		const float x2 = x * x;
+		const float s = x * (1.f + x2 * (-1.f / 6.f + x2 * (1.f / 120.f + x2 * (-1.f / 5040.f))));
+		const float c = 1.f + x2 * (-0.5f + x2 * (1.f / 24.f + x2 * (-1.f / 720.f + x2 * (1.f / 40320.f))));
+		// Quarter q rotates (s, c) q times by 90 degrees: odd quarters swap sine and cosine, the sign bits follow
+		const uint32_t q = static_cast<uint32_t>(quarter);
+		const uint32_t swap = 0u - (q & 1u);
+		const uint32_t sBits = std::bit_cast<uint32_t>(s), cBits = std::bit_cast<uint32_t>(c);
+		sin = std::bit_cast<float>(((sBits & ~swap) | (cBits & swap)) ^ ((q & 2u) << 30));
+		cos = std::bit_cast<float>(((cBits & ~swap) | (sBits & swap)) ^ (((q + 1u) & 2u) << 30));
+	}
+
+	inline Quat Random::RotationFromUniform(float u1, float u2, float u3)
+	{
+		const float r1 = Sqrt(1.f - u1), r2 = Sqrt(u1);
+		float sin1, cos1, sin2, cos2;
+		SinCosTurn(u2, sin1, cos1);
+		SinCosTurn(u3, sin2, cos2);
+		return Quat(r1 * sin1, r1 * cos1, r2 * sin2, r2 * cos2);
+	}
+
+	inline Vec2f Random::InDisk()
+	{
+		MATH_INSTRUMENT_BATCHABLE("Random::InDisk()", "Random::InDisk(span)");
+		while (true)
+		{
+			const float u = 2.f * NextFloat() - 1.f, v = 2.f * NextFloat() - 1.f;
+			if (u * u + v * v < 1.f)
+				return Vec2f(u, v);
+		}
+	}
+
+	inline Vec3f Random::OnSphere()
+	{
+		MATH_INSTRUMENT_BATCHABLE("Random::OnSphere()", "Random::OnSphere(span)");
+		while (true)
+		{
+			const float u = 2.f * NextFloat() - 1.f, v = 2.f * NextFloat() - 1.f;
+			const float squaredLength = u * u + v * v;
+			if (squaredLength < 1.f)
+				return SphereFromDisk(u, v, squaredLength);
+		}
+	}
+
+	inline Vec3f Random::InSphere()
+	{
+		MATH_INSTRUMENT_BATCHABLE("Random::InSphere()", "Random::InSphere(span)");
+		while (true)
+		{
+			const Vec3f p(2.f * NextFloat() - 1.f, 2.f * NextFloat() - 1.f, 2.f * NextFloat() - 1.f);
+			if (p.LengthSquared() < 1.f)
+				return p;
+		}
+	}
+
+	template<typename V> requires (std::is_same_v<V, Vec2f> || std::is_same_v<V, Vec3f> || std::is_same_v<V, Vec4f>)
+	inline V Random::InBox(const V& min, const V& max)
+	{
+		MATH_INSTRUMENT_BATCHABLE("Random::InBox()", "Random::InBox(span)");
+		V result;
+		for (size_t c = 0; c < sizeof(V) / sizeof(float); c++)
+			result.Data()[c] = min.Data()[c] + (max.Data()[c] - min.Data()[c]) * NextFloat();
+		return result;
+	}
+
+	inline Quat Random::Rotation()
+	{
+		MATH_INSTRUMENT_BATCHABLE("Random::Rotation()", "Random::Rotation(span)");
+		const float u1 = NextFloat(), u2 = NextFloat();
+		return RotationFromUniform(u1, u2, NextFloat());
+	}
+#pragma endregion
+
+#pragma region Batch Shapes
+	inline void Random::Uniform(std::span<float> output)
+	{
+		MATH_INSTRUMENT_SCOPE("Random::Uniform(span)");
+		MATH_INSTRUMENT_ITEMS(output.size());
+		size_t i = 0;
+		for (; i + Lanes <= output.size(); i += Lanes)
+			StepFloats(output.data() + i);
+		if (i < output.size())
+		{
+			float tail[Lanes];
+			StepFloats(tail);
+			for (size_t k = 0; i < output.size(); i++, k++)
+				output[i] = tail[k];
+		}
+	}
+
+	inline void Random::InDisk(std::span<Vec2f> output)
+	{
+		MATH_INSTRUMENT_SCOPE("Random::InDisk(span)");
+		MATH_INSTRUMENT_ITEMS(output.size());
+		// Every candidate is written to the staging array and kept by advancing the count, rejection costs no branch.
+		// pi / 4 of the pairs are kept
+		float block[128];
+		Vec2f accepted[64];
+		size_t i = 0;
+		while (i < output.size())
+		{
+			Fill(block);
+			size_t count = 0;
+			for (size_t k = 0; k < std::size(block); k += 2)
+			{
+				const float u = 2.f * block[k] - 1.f, v = 2.f * block[k + 1] - 1.f;
+				accepted[count] = Vec2f(u, v);
+				count += u * u + v * v < 1.f;
+			}
+			for (size_t k = 0; k < count && i < output.size(); k++)
+				output[i++] = accepted[k];
+		}
+	}
+
+	inline void Random::OnSphere(std::span<Vec3f> output)
+	{
+		MATH_INSTRUMENT_SCOPE("Random::OnSphere(span)");
+		MATH_INSTRUMENT_ITEMS(output.size());
+		// Disk points are selected first, only the kept ones are lifted
+		float block[128];
+		Vec2f accepted[64];
+		size_t i = 0;
+		while (i < output.size())
+		{
+			Fill(block);
+			size_t count = 0;
+			for (size_t k = 0; k < std::size(block); k += 2)
+			{
+				const float u = 2.f * block[k] - 1.f, v = 2.f * block[k + 1] - 1.f;
+				accepted[count] = Vec2f(u, v);
+				count += u * u + v * v < 1.f;
+			}
+			for (size_t k = 0; k < count && i < output.size(); k++)
+				output[i++] = SphereFromDisk(accepted[k].x, accepted[k].y, accepted[k].x * accepted[k].x + accepted[k].y * accepted[k].y);
+		}
+	}
+
+	inline void Random::InSphere(std::span<Vec3f> output)
+	{
+		MATH_INSTRUMENT_SCOPE("Random::InSphere(span)");
+		MATH_INSTRUMENT_ITEMS(output.size());
+		// pi / 6 of the points of the cube are in the ball
+		float block[120];
+		Vec3f accepted[40];
+		size_t i = 0;
+		while (i < output.size())
+		{
+			Fill(block);
+			size_t count = 0;
+			for (size_t k = 0; k < std::size(block); k += 3)
+			{
+				const Vec3f p(2.f * block[k] - 1.f, 2.f * block[k + 1] - 1.f, 2.f * block[k + 2] - 1.f);
+				accepted[count] = p;
+				count += p.x * p.x + p.y * p.y + p.z * p.z < 1.f;
+			}
+			for (size_t k = 0; k < count && i < output.size(); k++)
+				output[i++] = accepted[k];
+		}
+	}
+
+	template<typename V> requires (std::is_same_v<V, Vec2f> || std::is_same_v<V, Vec3f> || std::is_same_v<V, Vec4f>)
+	inline void Random::InBox(std::span<V> output, const V& min, const V& max)
+	{
+		MATH_INSTRUMENT_SCOPE("Random::InBox(span)");
+		MATH_INSTRUMENT_ITEMS(output.size());
+		constexpr size_t components = sizeof(V) / sizeof(float);
+		// The uniforms are written in place, then scaled component by component
+		float* values = output.empty() ? nullptr : output[0].Data();
+		Uniform(std::span<float>(values, output.size() * components));
+		const V extent = max - min;
+		for (size_t i = 0; i < output.size(); i++)
+		{
+			for (size_t c = 0; c < components; c++)
+				values[i * components + c] = min.Data()[c] + extent.Data()[c] * values[i * components + c];
+		}
+	}
+
+	inline void Random::Rotation(std::span<Quat> output)
+	{
+		MATH_INSTRUMENT_SCOPE("Random::Rotation(span)");
+		MATH_INSTRUMENT_ITEMS(output.size());
+		float block[120];
+		for (size_t i = 0; i < output.size();)
+		{
+			Fill(block);
+			for (size_t k = 0; k < std::size(block) && i < output.size(); k += 3, i++)
+				output[i] = RotationFromUniform(block[k], block[k + 1], block[k + 2]);
+		}
+	}
+#pragma endregion
+}
@@ -0,0 +1,134 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "Maths.h"
+#include "MathVecN.h"
+#include "MathExpression.h"
+#include "MathParallel.h"
+
+// Dense solvers for small fixed size systems. Every loop runs to a compile time bound so it unrolls for the sizes
+// used by constraint and IK solvers (3, 4, 6). Matrices are Mat, m[column][row].
+namespace GALAXY::Math
+{
+	// Row pivoted LU: P * A = L * U, with L below the diagonal (its unit diagonal implied) and U on and above it
+	template<typename T, size_t N>
+	struct LUDecomposition
+	{
+		Mat<T, N, N> factors;
+		// Row of A moved to row i
+		uint32_t pivots[N] = {};
+		// Sign of the permutation
+		T sign = static_cast<T>(1);
+	};
+
+	// False when a column has no non zero pivot left, the matrix is singular
+	template<typename T, size_t N>
+	inline bool DecomposeLU(const Mat<T, N, N>& a, LUDecomposition<T, N>& result);
+
+	template<typename T, size_t N>
+	inline VecN<T, N> Solve(const LUDecomposition<T, N>& lu, const VecN<T, N>& b);
+
+	template<typename T, size_t N>
+	inline T GetDeterminant(const LUDecomposition<T, N>& lu);
+
+	// A * x = b through LU, false when A is singular
+	template<typename T, size_t N>
+	inline bool Solve(const Mat<T, N, N>& a, const VecN<T, N>& b, VecN<T, N>& x);
+
+	template<typename T, size_t N>
+	inline bool GetInverse(const Mat<T, N, N>& a, Mat<T, N, N>& inverse);
+
+	// A = L * L^T for a symmetric positive definite A, only its lower triangle is read. False when A is not positive definite
+	template<typename T, size_t N>
+	inline bool DecomposeCholesky(const Mat<T, N, N>& a, Mat<T, N, N>& lower);
+
+	template<typename T, size_t N>
+	inline VecN<T, N> SolveCholesky(const Mat<T, N, N>& lower, const VecN<T, N>& b);
+
+	// Householder QR of a matrix with at least as many rows as columns: A = Q * R, Q orthonormal and R upper triangular
+	template<typename T, size_t R, size_t C> requires (R >= C)
+	inline void DecomposeQR(const Mat<T, R, C>& a, Mat<T, R, R>& q, Mat<T, R, C>& r);
+
+	// x minimizing |A * x - b| through QR, false when the columns of A are not independent
+	template<typename T, size_t R, size_t C> requires (R >= C)
+	inline bool SolveLeastSquares(const Mat<T, R, C>& a, const VecN<T, R>& b, VecN<T, C>& x);
+
+	// Cyclic Jacobi on a symmetric A, only its upper triangle is read: A = V * diag(eigenvalues) * V^T,
+	// eigenvalues in decreasing order and the columns of V their unit eigenvectors
+	template<typename T, size_t N>
+	inline void DecomposeSymmetric(const Mat<T, N, N>& a, VecN<T, N>& eigenvalues, Mat<T, N, N>& eigenvectors);
+
+	// Polar decomposition of the linear part of a transform, linear = rotation * stretch: the rotation nearest to it and a symmetric stretch.
+	// Unlike Mat4::GetRotation it holds under shear and non uniform scale. A mirrored transform keeps the mirror in the stretch,
+	// whose determinant is then negative. False for a singular linear part, which gets the identity rotation and itself as stretch
+	template<typename T>
+	inline bool DecomposePolar(const Mat4T<T>& transform, QuatT<T>& rotation, Mat<T, 3, 3>& stretch);
+
+	// DecomposePolar over a palette, in SIMD lanes and spread over the workers. Stops at the shortest of the spans
+	inline void DecomposePolar(std::span<const Mat4f> transforms, std::span<Quat> rotations, std::span<Mat3f> stretches);
+
+	// Independent systems A * x = b solved in SIMD lanes and spread over the workers, LU with partial pivoting per lane.
+	// Singular systems give non finite solutions. Stops at the shortest of the spans
+	template<typename T, size_t N>
+	inline void SolveBatch(std::span<const Mat<T, N, N>> matrices, std::span<const VecN<T, N>> b, std::span<VecN<T, N>> x);
+
+	// SolveBatch for symmetric positive definite systems through Cholesky, without pivoting
+	template<typename T, size_t N>
+	inline void SolveCholeskyBatch(std::span<const Mat<T, N, N>> matrices, std::span<const VecN<T, N>> b, std::span<VecN<T, N>> x);
+
+	namespace Solver
+	{
+		// PackSize systems, one per lane, a[row][column]
+		template<typename T, size_t N>
+		struct PackSystem
+		{
+			Expression::Pack<T> a[N][N];
+			Expression::Pack<T> b[N];
+		};
+
+		// Systems first to first + lanes, the lanes past them get the identity
+		template<typename T, size_t N>
+		inline void LoadSystems(std::span<const Mat<T, N, N>> matrices, std::span<const VecN<T, N>> b, size_t first, size_t lanes, PackSystem<T, N>& system);
+
+		template<typename T, size_t N>
+		inline void StoreSolutions(const Expression::Pack<T> (&x)[N], size_t first, size_t lanes, std::span<VecN<T, N>> output);
+
+		// Calls body(i) for i from Begin to End as a compile time constant, so the loop unrolls whatever the optimizer decides
+		template<size_t Begin, size_t End, typename F>
+		inline constexpr void Unroll(F&& body);
+
+		// Gaussian elimination, the pivot rows swapped per lane with selects, then back substitution
+		template<typename T, size_t N>
+		inline void SolvePivoted(PackSystem<T, N>& system, Expression::Pack<T> (&x)[N]);
+
+		template<typename T, size_t N>
+		inline void SolveCholesky(PackSystem<T, N>& system, Expression::Pack<T> (&x)[N]);
+
+		// Runs solve(system, x) over the systems a pack at a time, chunks of them per worker
+		template<typename T, size_t N, typename F>
+		inline void SolveSystems(std::span<const Mat<T, N, N>> matrices, std::span<const VecN<T, N>> b, std::span<VecN<T, N>> x, F&& solve);
+	}
+
+	namespace Polar
+	{
+		// Scaled Newton iteration of Higham, X = (g * X + X^-T / g) / 2, on the columns of a matrix of positive determinant.
+		// The scale g balances the norms of X and its inverse so far from a rotation it converges in a few steps, then quadratically
+		template<typename T>
+		inline void Orthonormalize(Vec3<T> (&columns)[3]);
+
+		// Orthonormalize in the lanes of columns[column][row]
+		inline void Orthonormalize(Expression::Pack<float> (&columns)[3][3]);
+
+		// Rotation of an orthonormal matrix with a positive determinant, from its largest diagonal term (Shepperd)
+		template<typename T>
+		inline QuatT<T> ToQuaternion(const Vec3<T> (&columns)[3]);
+
+		// R^T * A made exactly symmetric
+		template<typename T>
+		inline Mat<T, 3, 3> GetStretch(const Vec3<T> (&rotation)[3], const Vec3<T> (&linear)[3]);
+	}
+}
+
+#include "MathSolver.inl"
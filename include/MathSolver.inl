@@ -0,0 +1,720 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+#include "MathSolver.h"
+
+namespace GALAXY::Math
+{
+#pragma region LU
+	template<typename T, size_t N>
+	inline bool DecomposeLU(const Mat<T, N, N>& a, LUDecomposition<T, N>& result)
+	{
+		MATH_INSTRUMENT_SCOPE("DecomposeLU(Mat, LUDecomposition)");
+		Mat<T, N, N>& f = result.factors;
+		f = a;
+		result.sign = static_cast<T>(1);
+		for (size_t i = 0; i < N; i++)
+			result.pivots[i] = static_cast<uint32_t>(i);
+
+		for (size_t k = 0; k < N; k++)
+		{
+			size_t pivot = k;
+			T best = std::abs(f[k][k]);
+			for (size_t r = k + 1; r < N; r++)
+			{
+				if (std::abs(f[k][r]) > best)
+				{
+					best = std::abs(f[k][r]);
+					pivot = r;
+				}
+			}
+			if (best == static_cast<T>(0))
+				return false;
+			if (pivot != k)
+			{
+				for (size_t c = 0; c < N; c++)
+					std::swap(f[c][k], f[c][pivot]);
+				std::swap(result.pivots[k], result.pivots[pivot]);
+				result.sign = -result.sign;
+			}
+
+			const T inverse = static_cast<T>(1) / f[k][k];
+			for (size_t r = k + 1; r < N; r++)
+			{
+				const T l = f[k][r] * inverse;
+				f[k][r] = l;
+				for (size_t c = k + 1; c < N; c++)
+					f[c][r] -= l * f[c][k];
+			}
+		}
+		return true;
+	}
+
+	template<typename T, size_t N>
+	inline VecN<T, N> Solve(const LUDecomposition<T, N>& lu, const VecN<T, N>& b)
+	{
+		const Mat<T, N, N>& f = lu.factors;
+		VecN<T, N> x;
+		for (size_t i = 0; i < N; i++)
+		{
+			T sum = b[lu.pivots[i]];
+			for (size_t j = 0; j < i; j++)
+				sum -= f[j][i] * x[j];
+			x[i] = sum;
+		}
+		for (size_t i = N; i-- > 0;)
+		{
+			T sum = x[i];
+			for (size_t j = i + 1; j < N; j++)
+				sum -= f[j][i] * x[j];
+			x[i] = sum / f[i][i];
+		}
+		return x;
+	}
+
+	template<typename T, size_t N>
+	inline T GetDeterminant(const LUDecomposition<T, N>& lu)
+	{
+		T determinant = lu.sign;
+		for (size_t i = 0; i < N; i++)
+			determinant *= lu.factors[i][i];
+		return determinant;
+	}
+
+	template<typename T, size_t N>
+	inline bool Solve(const Mat<T, N, N>& a, const VecN<T, N>& b, VecN<T, N>& x)
+	{
+		MATH_INSTRUMENT_BATCHABLE("Solve(Mat, VecN, VecN)", "SolveBatch(span, span, span)");
+		LUDecomposition<T, N> lu;
+		if (!DecomposeLU(a, lu))
+			return false;
+		x = Solve(lu, b);
+		return true;
+	}
+
+	template<typename T, size_t N>
+	inline bool GetInverse(const Mat<T, N, N>& a, Mat<T, N, N>& inverse)
+	{
+		MATH_INSTRUMENT_SCOPE("GetInverse(Mat, Mat)");
+		LUDecomposition<T, N> lu;
+		if (!DecomposeLU(a, lu))
+			return false;
+		for (size_t c = 0; c < N; c++)
+			inverse[c] = Solve(lu, VecN<T, N>::Axis(c));
+		return true;
+	}
+#pragma endregion
+
+#pragma region Cholesky
+	template<typename T, size_t N>
+	inline bool DecomposeCholesky(const Mat<T, N, N>& a, Mat<T, N, N>& lower)
+	{
+		MATH_INSTRUMENT_SCOPE("DecomposeCholesky(Mat, Mat)");
+		lower = Mat<T, N, N>();
+		for (size_t j = 0; j < N; j++)
+		{
+			T diagonal = a[j][j];
+			for (size_t k = 0; k < j; k++)
+				diagonal -= lower[k][j] * lower[k][j];
+			if (!(diagonal > static_cast<T>(0)))
+				return false;
+			diagonal = std::sqrt(diagonal);
+			lower[j][j] = diagonal;
+
+			const T inverse = static_cast<T>(1) / diagonal;
+			for (size_t i = j + 1; i < N; i++)
+			{
+				T sum = a[j][i];
+				for (size_t k = 0; k < j; k++)
+					sum -= lower[k][i] * lower[k][j];
+				lower[j][i] = sum * inverse;
+			}
+		}
+		return true;
+	}
+
+	template<typename T, size_t N>
+	inline VecN<T, N> SolveCholesky(const Mat<T, N, N>& lower, const VecN<T, N>& b)
+	{
+		MATH_INSTRUMENT_BATCHABLE("SolveCholesky(Mat, VecN)", "SolveCholeskyBatch(span, span, span)");
+		// L * y = b, then L^T * x = y
+		VecN<T, N> x;
+		for (size_t i = 0; i < N; i++)
+		{
+			T sum = b[i];
+			for (size_t k = 0; k < i; k++)
+				sum -= lower[k][i] * x[k];
+			x[i] = sum / lower[i][i];
+		}
+		for (size_t i = N; i-- > 0;)
+		{
+			T sum = x[i];
+			for (size_t k = i + 1; k < N; k++)
+				sum -= lower[i][k] * x[k];
+			x[i] = sum / lower[i][i];
+		}
+		return x;
+	}
+#pragma endregion
+
+#pragma region QR
+	template<typename T, size_t R, size_t C> requires (R >= C)
+	inline void DecomposeQR(const Mat<T, R, C>& a, Mat<T, R, R>& q, Mat<T, R, C>& r)
+	{
+		MATH_INSTRUMENT_SCOPE("DecomposeQR(Mat, Mat, Mat)");
+		r = a;
+		q = Mat<T, R, R>::Identity();
+		for (size_t k = 0; k < C && k + 1 < R; k++)
+		{
+			// Reflection through the plane orthogonal to v taking column k below the diagonal to alpha * e_k,
+			// alpha of the opposite sign of the diagonal so v does not cancel
+			T norm = static_cast<T>(0);
+			for (size_t i = k; i < R; i++)
+				norm += r[k][i] * r[k][i];
+			if (norm == static_cast<T>(0))
+				continue;
+			const T alpha = r[k][k] > static_cast<T>(0) ? -std::sqrt(norm) : std::sqrt(norm);
+			T v[R] = {};
+			for (size_t i = k; i < R; i++)
+				v[i] = r[k][i];
+			v[k] -= alpha;
+			T length = static_cast<T>(0);
+			for (size_t i = k; i < R; i++)
+				length += v[i] * v[i];
+			const T scale = static_cast<T>(2) / length;
+
+			for (size_t c = k + 1; c < C; c++)
+			{
+				T dot = static_cast<T>(0);
+				for (size_t i = k; i < R; i++)
+					dot += v[i] * r[c][i];
+				dot *= scale;
+				for (size_t i = k; i < R; i++)
+					r[c][i] -= dot * v[i];
+			}
+			r[k][k] = alpha;
+			for (size_t i = k + 1; i < R; i++)
+				r[k][i] = static_cast<T>(0);
+
+			// Q = Q * H, H = I - scale * v * v^T
+			for (size_t row = 0; row < R; row++)
+			{
+				T dot = static_cast<T>(0);
+				for (size_t i = k; i < R; i++)
+					dot += q[i][row] * v[i];
+				dot *= scale;
+				for (size_t i = k; i < R; i++)
+					q[i][row] -= dot * v[i];
+			}
+		}
+	}
+
+	template<typename T, size_t R, size_t C> requires (R >= C)
+	inline bool SolveLeastSquares(const Mat<T, R, C>& a, const VecN<T, R>& b, VecN<T, C>& x)
+	{
+		MATH_INSTRUMENT_SCOPE("SolveLeastSquares(Mat, VecN, VecN)");
+		Mat<T, R, R> q;
+		Mat<T, R, C> r;
+		DecomposeQR(a, q, r);
+
+		// Columns are dependent when a diagonal entry of R is lost in the rounding of the largest one
+		T largest = static_cast<T>(0);
+		for (size_t i = 0; i < C; i++)
+			largest = std::max(largest, std::abs(r[i][i]));
+		const T tolerance = largest * std::numeric_limits<T>::epsilon() * static_cast<T>(R);
+		for (size_t i = 0; i < C; i++)
+		{
+			if (!(std::abs(r[i][i]) > tolerance))
+				return false;
+		}
+
+		// R * x = Q^T * b
+		for (size_t i = C; i-- > 0;)
+		{
+			T sum = q[i].Dot(b);
+			for (size_t j = i + 1; j < C; j++)
+				sum -= r[j][i] * x[j];
+			x[i] = sum / r[i][i];
+		}
+		return true;
+	}
+#pragma endregion
+
+#pragma region Eigen Decomposition
+	template<typename T, size_t N>
+	inline void DecomposeSymmetric(const Mat<T, N, N>& a, VecN<T, N>& eigenvalues, Mat<T, N, N>& eigenvectors)
+	{
+		MATH_INSTRUMENT_SCOPE("DecomposeSymmetric(Mat, VecN, Mat)");
+		// d[row][column], mirrored from the upper triangle
+		T d[N][N];
+		T norm = static_cast<T>(0);
+		for (size_t row = 0; row < N; row++)
+		{
+			for (size_t column = row; column < N; column++)
+			{
+				d[row][column] = d[column][row] = a[column][row];
+				norm += (row == column ? static_cast<T>(1) : static_cast<T>(2)) * a[column][row] * a[column][row];
+			}
+		}
+		eigenvectors = Mat<T, N, N>::Identity();
+
+		// Each rotation zeroes one off diagonal pair, a few sweeps bring them all below the rounding of the matrix
+		const T tolerance = norm * std::numeric_limits<T>::epsilon() * std::numeric_limits<T>::epsilon();
+		for (size_t sweep = 0; sweep < 32; sweep++)
+		{
+			T off = static_cast<T>(0);
+			for (size_t p = 0; p < N; p++)
+			{
+				for (size_t q = p + 1; q < N; q++)
+					off += d[p][q] * d[p][q];
+			}
+			if (off <= tolerance)
+				break;
+
+			for (size_t p = 0; p < N; p++)
+			{
+				for (size_t q = p + 1; q < N; q++)
+				{
+					if (d[p][q] == static_cast<T>(0))
+						continue;
+					const T theta = (d[q][q] - d[p][p]) / (static_cast<T>(2) * d[p][q]);
+					const T t = std::copysign(static_cast<T>(1), theta) / (std::abs(theta) + std::sqrt(theta * theta + static_cast<T>(1)));
+					const T c = static_cast<T>(1) / std::sqrt(t * t + static_cast<T>(1));
+					const T s = t * c;
+					// D = J^T * D * J, V = V * J
+					for (size_t k = 0; k < N; k++)
+					{
+						const T kp = d[k][p], kq = d[k][q];
+						d[k][p] = c * kp - s * kq;
+						d[k][q] = s * kp + c * kq;
+					}
+					for (size_t k = 0; k < N; k++)
+					{
+						const T pk = d[p][k], qk = d[q][k];
+						d[p][k] = c * pk - s * qk;
+						d[q][k] = s * pk + c * qk;
+					}
+					for (size_t k = 0; k < N; k++)
+					{
+						const T kp = eigenvectors[p][k], kq = eigenvectors[q][k];
+						eigenvectors[p][k] = c * kp - s * kq;
+						eigenvectors[q][k] = s * kp + c * kq;
+					}
+				}
+			}
+		}
+
+		for (size_t i = 0; i < N; i++)
+			eigenvalues[i] = d[i][i];
+		for (size_t i = 0; i < N; i++)
+		{
+			size_t largest = i;
+			for (size_t j = i + 1; j < N; j++)
+			{
+				if (eigenvalues[j] > eigenvalues[largest])
+					largest = j;
+			}
+			if (largest != i)
+			{
+				std::swap(eigenvalues[i], eigenvalues[largest]);
+				std::swap(eigenvectors[i], eigenvectors[largest]);
+			}
+		}
+	}
+#pragma endregion
+
+#pragma region Polar Decomposition
+	namespace Polar
+	{
+		template<typename T>
+		inline void Orthonormalize(Vec3<T> (&columns)[3])
+		{
+			// Once a step moves X by about the square root of the precision the next one lands on the rotation
+			const T tolerance = static_cast<T>(3) * std::numeric_limits<T>::epsilon();
+			bool converging = false;
+			for (size_t iteration = 0; iteration < 16; iteration++)
+			{
+				const Vec3<T> cofactors[3] = { columns[1].Cross(columns[2]), columns[2].Cross(columns[0]), columns[0].Cross(columns[1]) };
+				const T inverseDeterminant = static_cast<T>(1) / columns[0].Dot(cofactors[0]);
+				T scale = static_cast<T>(1);
+				if (!converging)
+				{
+					T norm = static_cast<T>(0), inverseNorm = static_cast<T>(0);
+					for (size_t c = 0; c < 3; c++)
+					{
+						norm += columns[c].LengthSquared();
+						inverseNorm += cofactors[c].LengthSquared();
+					}
+					scale = std::sqrt(std::sqrt(inverseNorm * inverseDeterminant * inverseDeterminant / norm));
+				}
+
+				T change = static_cast<T>(0);
+				for (size_t c = 0; c < 3; c++)
+				{
+					const Vec3<T> next = (columns[c] * scale + cofactors[c] * (inverseDeterminant / scale)) * static_cast<T>(0.5);
+					change += (next - columns[c]).LengthSquared();
+					columns[c] = next;
+				}
+				if (converging)
+					break;
+				converging = change <= tolerance;
+			}
+		}
+
+		inline void Orthonormalize(Expression::Pack<float> (&columns)[3][3])
+		{
+			using namespace Expression;
+			typedef Pack<float> P;
+			auto cross = [&](size_t a, size_t b, P (&result)[3])
+			{
+				result[0] = columns[a][1] * columns[b][2] - columns[a][2] * columns[b][1];
+				result[1] = columns[a][2] * columns[b][0] - columns[a][0] * columns[b][2];
+				result[2] = columns[a][0] * columns[b][1] - columns[a][1] * columns[b][0];
+			};
+			const P half = BroadcastPack(0.5f), one = BroadcastPack(1.f);
+			const float tolerance = 3.f * std::numeric_limits<float>::epsilon();
+			bool converging = false;
+			for (size_t iteration = 0; iteration < 16; iteration++)
+			{
+				P cofactors[3][3];
+				cross(1, 2, cofactors[0]);
+				cross(2, 0, cofactors[1]);
+				cross(0, 1, cofactors[2]);
+				const P inverseDeterminant = one / (columns[0][0] * cofactors[0][0] + columns[0][1] * cofactors[0][1] + columns[0][2] * cofactors[0][2]);
+				P scale = one;
+				if (!converging)
+				{
+					P norm = BroadcastPack(0.f), inverseNorm = BroadcastPack(0.f);
+					for (size_t c = 0; c < 3; c++)
+					{
+						for (size_t r = 0; r < 3; r++)
+						{
+							norm = norm + columns[c][r] * columns[c][r];
+							inverseNorm = inverseNorm + cofactors[c][r] * cofactors[c][r];
+						}
+					}
+					scale = SqrtPack(SqrtPack(inverseNorm * inverseDeterminant * inverseDeterminant / norm));
+				}
+
+				const P inverseScale = inverseDeterminant / scale;
+				P change = BroadcastPack(0.f);
+				for (size_t c = 0; c < 3; c++)
+				{
+					for (size_t r = 0; r < 3; r++)
+					{
+						const P next = (columns[c][r] * scale + cofactors[c][r] * inverseScale) * half;
+						change = change + (next - columns[c][r]) * (next - columns[c][r]);
+						columns[c][r] = next;
+					}
+				}
+				if (converging)
+					break;
+				// Every lane has to be close, the ones already there barely move
+				float changes[PackSize<float>];
+				StorePack(changes, change);
+				converging = *std::max_element(changes, changes + PackSize<float>) <= tolerance;
+			}
+		}
+
+		template<typename T>
+		inline QuatT<T> ToQuaternion(const Vec3<T> (&columns)[3])
+		{
+			// R(row, column) = columns[column][row]
+			const T trace = columns[0].x + columns[1].y + columns[2].z;
+			QuatT<T> result;
+			if (trace > static_cast<T>(0))
+			{
+				const T s = static_cast<T>(0.5) / std::sqrt(trace + static_cast<T>(1));
+				result = QuatT<T>((columns[1].z - columns[2].y) * s, (columns[2].x - columns[0].z) * s, (columns[0].y - columns[1].x) * s, static_cast<T>(0.25) / s);
+			}
+			else if (columns[0].x > columns[1].y && columns[0].x > columns[2].z)
+			{
+				const T s = static_cast<T>(2) * std::sqrt(static_cast<T>(1) + columns[0].x - columns[1].y - columns[2].z);
+				result = QuatT<T>(static_cast<T>(0.25) * s, (columns[1].x + columns[0].y) / s, (columns[2].x + columns[0].z) / s, (columns[1].z - columns[2].y) / s);
+			}
+			else if (columns[1].y > columns[2].z)
+			{
+				const T s = static_cast<T>(2) * std::sqrt(static_cast<T>(1) + columns[1].y - columns[0].x - columns[2].z);
+				result = QuatT<T>((columns[1].x + columns[0].y) / s, static_cast<T>(0.25) * s, (columns[2].y + columns[1].z) / s, (columns[2].x - columns[0].z) / s);
+			}
+			else
+			{
+				const T s = static_cast<T>(2) * std::sqrt(static_cast<T>(1) + columns[2].z - columns[0].x - columns[1].y);
+				result = QuatT<T>((columns[2].x + columns[0].z) / s, (columns[2].y + columns[1].z) / s, static_cast<T>(0.25) * s, (columns[0].y - columns[1].x) / s);
+			}
+			return result.GetNormalize();
+		}
+
+		template<typename T>
+		inline Mat<T, 3, 3> GetStretch(const Vec3<T> (&rotation)[3], const Vec3<T> (&linear)[3])
+		{
+			Mat<T, 3, 3> stretch;
+			for (size_t c = 0; c < 3; c++)
+			{
+				for (size_t r = c; r < 3; r++)
+					stretch[c][r] = stretch[r][c] = (rotation[r].Dot(linear[c]) + rotation[c].Dot(linear[r])) * static_cast<T>(0.5);
+			}
+			return stretch;
+		}
+	}
+
+	template<typename T>
+	inline bool DecomposePolar(const Mat4T<T>& transform, QuatT<T>& rotation, Mat<T, 3, 3>& stretch)
+	{
+		MATH_INSTRUMENT_BATCHABLE("DecomposePolar(Mat4, Quat, Mat)", "DecomposePolar(span, span, span)");
+		const Vec3<T> linear[3] = { Vec3<T>(transform.content[0]), Vec3<T>(transform.content[1]), Vec3<T>(transform.content[2]) };
+		const T determinant = linear[0].Dot(linear[1].Cross(linear[2]));
+		if (determinant == static_cast<T>(0))
+		{
+			rotation = QuatT<T>();
+			for (size_t c = 0; c < 3; c++)
+				stretch[c] = VecN<T, 3>(linear[c]);
+			return false;
+		}
+
+		// The polar factor of -A is a rotation when A mirrors, the stretch takes the sign back
+		const T sign = determinant < static_cast<T>(0) ? static_cast<T>(-1) : static_cast<T>(1);
+		Vec3<T> columns[3] = { linear[0] * sign, linear[1] * sign, linear[2] * sign };
+		Polar::Orthonormalize(columns);
+		rotation = Polar::ToQuaternion(columns);
+		stretch = Polar::GetStretch(columns, linear);
+		return true;
+	}
+
+	inline void DecomposePolar(std::span<const Mat4f> transforms, std::span<Quat> rotations, std::span<Mat3f> stretches)
+	{
+		MATH_INSTRUMENT_SCOPE("DecomposePolar(span, span, span)");
+		const size_t count = std::min({ transforms.size(), rotations.size(), stretches.size() });
+		MATH_INSTRUMENT_ITEMS(count);
+		using namespace Expression;
+		constexpr size_t Lanes = PackSize<float>;
+		constexpr size_t Grain = 1 << 12;
+		ParallelFor(count, Grain, [&](size_t begin, size_t end)
+		{
+			for (size_t first = begin; first < end; first += Lanes)
+			{
+				const size_t lanes = std::min(Lanes, end - first);
+				// Mirrored lanes negated, singular and padding lanes replaced by the identity so they stay finite
+				float buffer[3][3][Lanes];
+				bool singular[Lanes];
+				for (size_t lane = 0; lane < Lanes; lane++)
+				{
+					const Mat4f* transform = lane < lanes ? &transforms[first + lane] : nullptr;
+					const float determinant = transform ? Vec3f(transform->content[0]).Dot(Vec3f(transform->content[1]).Cross(Vec3f(transform->content[2]))) : 0.f;
+					const float sign = determinant < 0.f ? -1.f : 1.f;
+					singular[lane] = determinant == 0.f;
+					for (size_t c = 0; c < 3; c++)
+					{
+						for (size_t r = 0; r < 3; r++)
+							buffer[c][r][lane] = singular[lane] ? static_cast<float>(c == r) : transform->content[c][r] * sign;
+					}
+				}
+				Pack<float> columns[3][3];
+				for (size_t c = 0; c < 3; c++)
+				{
+					for (size_t r = 0; r < 3; r++)
+						columns[c][r] = LoadPack(buffer[c][r]);
+				}
+				Polar::Orthonormalize(columns);
+				for (size_t c = 0; c < 3; c++)
+				{
+					for (size_t r = 0; r < 3; r++)
+						StorePack(buffer[c][r], columns[c][r]);
+				}
+
+				for (size_t lane = 0; lane < lanes; lane++)
+				{
+					const Mat4f& transform = transforms[first + lane];
+					const Vec3f linear[3] = { Vec3f(transform.content[0]), Vec3f(transform.content[1]), Vec3f(transform.content[2]) };
+					const Vec3f rotation[3] = { Vec3f(buffer[0][0][lane], buffer[0][1][lane], buffer[0][2][lane]), Vec3f(buffer[1][0][lane], buffer[1][1][lane], buffer[1][2][lane]), Vec3f(buffer[2][0][lane], buffer[2][1][lane], buffer[2][2][lane]) };
+					if (singular[lane])
+					{
+						rotations[first + lane] = Quat();
+						for (size_t c = 0; c < 3; c++)
+							stretches[first + lane][c] = VecN<float, 3>(linear[c]);
+						continue;
+					}
+					rotations[first + lane] = Polar::ToQuaternion(rotation);
+					stretches[first + lane] = Polar::GetStretch(rotation, linear);
+				}
+			}
+		});
+	}
+#pragma endregion
+
+#pragma region Batches
+	namespace Solver
+	{
+		template<typename T, size_t N>
+		inline void LoadSystems(std::span<const Mat<T, N, N>> matrices, std::span<const VecN<T, N>> b, size_t first, size_t lanes, PackSystem<T, N>& system)
+		{
+			using namespace Expression;
+			constexpr size_t Lanes = PackSize<T>;
+			// Transposed through a buffer, the lanes past the systems hold the identity
+			T buffer[N + 1][N][Lanes];
+			for (size_t lane = 0; lane < lanes; lane++)
+			{
+				const Mat<T, N, N>& matrix = matrices[first + lane];
+				for (size_t column = 0; column < N; column++)
+				{
+					for (size_t row = 0; row < N; row++)
+						buffer[column][row][lane] = matrix[column][row];
+					buffer[N][column][lane] = b[first + lane][column];
+				}
+			}
+			for (size_t lane = lanes; lane < Lanes; lane++)
+			{
+				for (size_t column = 0; column < N; column++)
+				{
+					for (size_t row = 0; row < N; row++)
+						buffer[column][row][lane] = static_cast<T>(row == column);
+					buffer[N][column][lane] = static_cast<T>(0);
+				}
+			}
+			for (size_t row = 0; row < N; row++)
+			{
+				for (size_t column = 0; column < N; column++)
+					system.a[row][column] = LoadPack(buffer[column][row]);
+				system.b[row] = LoadPack(buffer[N][row]);
+			}
+		}
+
+		template<typename T, size_t N>
+		inline void StoreSolutions(const Expression::Pack<T> (&x)[N], size_t first, size_t lanes, std::span<VecN<T, N>> output)
+		{
+			T buffer[Expression::PackSize<T>];
+			for (size_t row = 0; row < N; row++)
+			{
+				Expression::StorePack(buffer, x[row]);
+				for (size_t lane = 0; lane < lanes; lane++)
+					output[first + lane][row] = buffer[lane];
+			}
+		}
+
+		template<size_t Begin, size_t End, typename F>
+		inline constexpr void Unroll(F&& body)
+		{
+			if constexpr (Begin < End)
+			{
+				[&]<size_t... I>(std::index_sequence<I...>) { (body(std::integral_constant<size_t, Begin + I>()), ...); }(std::make_index_sequence<End - Begin>());
+			}
+		}
+
+		template<typename T, size_t N>
+		inline void SolvePivoted(PackSystem<T, N>& system, Expression::Pack<T> (&x)[N])
+		{
+			using namespace Expression;
+			auto& a = system.a;
+			auto& b = system.b;
+			Unroll<0, N>([&](auto k)
+			{
+				// Row r becomes the pivot row in the lanes where it beats the current one
+				Unroll<k + 1, N>([&](auto r)
+				{
+					const Pack<T> current = MaxPack(a[k][k], -a[k][k]);
+					const Pack<T> candidate = MaxPack(a[r][k], -a[r][k]);
+					Unroll<k, N>([&](auto c)
+					{
+						const Pack<T> pivot = SelectLessPack(current, candidate, a[r][c], a[k][c]);
+						a[r][c] = SelectLessPack(current, candidate, a[k][c], a[r][c]);
+						a[k][c] = pivot;
+					});
+					const Pack<T> pivot = SelectLessPack(current, candidate, b[r], b[k]);
+					b[r] = SelectLessPack(current, candidate, b[k], b[r]);
+					b[k] = pivot;
+				});
+
+				const Pack<T> inverse = BroadcastPack(static_cast<T>(1)) / a[k][k];
+				a[k][k] = inverse;
+				Unroll<k + 1, N>([&](auto r)
+				{
+					const Pack<T> l = a[r][k] * inverse;
+					Unroll<k + 1, N>([&](auto c) { a[r][c] = a[r][c] - l * a[k][c]; });
+					b[r] = b[r] - l * b[k];
+				});
+			});
+
+			Unroll<0, N>([&](auto step)
+			{
+				constexpr size_t i = N - 1 - step;
+				Pack<T> sum = b[i];
+				Unroll<i + 1, N>([&](auto j) { sum = sum - a[i][j] * x[j]; });
+				x[i] = sum * a[i][i];
+			});
+		}
+
+		template<typename T, size_t N>
+		inline void SolveCholesky(PackSystem<T, N>& system, Expression::Pack<T> (&x)[N])
+		{
+			using namespace Expression;
+			// L in the lower triangle of a, the reciprocals of its diagonal on the diagonal
+			auto& a = system.a;
+			Unroll<0, N>([&](auto j)
+			{
+				Pack<T> diagonal = a[j][j];
+				Unroll<0, j>([&](auto k) { diagonal = diagonal - a[j][k] * a[j][k]; });
+				const Pack<T> inverse = BroadcastPack(static_cast<T>(1)) / SqrtPack(diagonal);
+				a[j][j] = inverse;
+				Unroll<j + 1, N>([&](auto i)
+				{
+					Pack<T> sum = a[i][j];
+					Unroll<0, j>([&](auto k) { sum = sum - a[i][k] * a[j][k]; });
+					a[i][j] = sum * inverse;
+				});
+			});
+
+			Unroll<0, N>([&](auto i)
+			{
+				Pack<T> sum = system.b[i];
+				Unroll<0, i>([&](auto k) { sum = sum - a[i][k] * x[k]; });
+				x[i] = sum * a[i][i];
+			});
+			Unroll<0, N>([&](auto step)
+			{
+				constexpr size_t i = N - 1 - step;
+				Pack<T> sum = x[i];
+				Unroll<i + 1, N>([&](auto k) { sum = sum - a[k][i] * x[k]; });
+				x[i] = sum * a[i][i];
+			});
+		}
+
+		template<typename T, size_t N, typename F>
+		inline void SolveSystems(std::span<const Mat<T, N, N>> matrices, std::span<const VecN<T, N>> b, std::span<VecN<T, N>> x, F&& solve)
+		{
+			constexpr size_t Lanes = Expression::PackSize<T>;
+			constexpr size_t Grain = 1 << 14;
+			ParallelFor(std::min({ matrices.size(), b.size(), x.size() }), Grain, [&](size_t begin, size_t end)
+			{
+				for (size_t first = begin; first < end; first += Lanes)
+				{
+					const size_t lanes = std::min(Lanes, end - first);
+					PackSystem<T, N> system;
+					Expression::Pack<T> solution[N];
+					LoadSystems(matrices, b, first, lanes, system);
+					solve(system, solution);
+					StoreSolutions(solution, first, lanes, x);
+				}
+			});
+		}
+	}
+
+	template<typename T, size_t N>
+	inline void SolveBatch(std::span<const Mat<T, N, N>> matrices, std::span<const VecN<T, N>> b, std::span<VecN<T, N>> x)
+	{
+		MATH_INSTRUMENT_SCOPE("SolveBatch(span, span, span)");
+		MATH_INSTRUMENT_ITEMS(std::min({ matrices.size(), b.size(), x.size() }));
+		Solver::SolveSystems(matrices, b, x, [](Solver::PackSystem<T, N>& system, Expression::Pack<T> (&solution)[N]) { Solver::SolvePivoted(system, solution); });
+	}
+
+	template<typename T, size_t N>
+	inline void SolveCholeskyBatch(std::span<const Mat<T, N, N>> matrices, std::span<const VecN<T, N>> b, std::span<VecN<T, N>> x)
+	{
+		MATH_INSTRUMENT_SCOPE("SolveCholeskyBatch(span, span, span)");
+		MATH_INSTRUMENT_ITEMS(std::min({ matrices.size(), b.size(), x.size() }));
+		Solver::SolveSystems(matrices, b, x, [](Solver::PackSystem<T, N>& system, Expression::Pack<T> (&solution)[N]) { Solver::SolveCholesky(system, solution); });
+	}
+#pragma endregion
+}
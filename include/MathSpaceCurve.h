@@ -0,0 +1,79 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "Maths.h"
+#include "MathGeometry.h"
+#include "MathParallel.h"
+
+// Space filling curve keys of 3D cells: sorting by them puts points close in space close in memory.
+// Morton codes interleave the bits of the cell coordinates, x in the lowest bit; Hilbert codes never jump between
+// consecutive keys, they step to a neighbouring cell, at the price of a few more operations per bit.
+// 30 bit codes have 10 bits per axis, 63 bit codes 21 bits per axis, higher coordinate bits are ignored.
+namespace GALAXY::Math
+{
+	inline uint32_t MortonEncode30(uint32_t x, uint32_t y, uint32_t z);
+	inline uint64_t MortonEncode63(uint32_t x, uint32_t y, uint32_t z);
+	inline Vec3i MortonDecode30(uint32_t code);
+	inline Vec3i MortonDecode63(uint64_t code);
+
+	inline uint32_t HilbertEncode30(uint32_t x, uint32_t y, uint32_t z);
+	inline uint64_t HilbertEncode63(uint32_t x, uint32_t y, uint32_t z);
+	inline Vec3i HilbertDecode30(uint32_t code);
+	inline Vec3i HilbertDecode63(uint64_t code);
+
+	// Codes of the points in a grid of 2^10 or 2^21 cells per axis over bounds, points outside are clamped to it.
+	// The batches stop at the shortest of their spans
+	inline void MortonEncode(std::span<const Vec3f> points, const AABB& bounds, std::span<uint32_t> codes);
+	inline void MortonEncode(std::span<const Vec3f> points, const AABB& bounds, std::span<uint64_t> codes);
+	inline void HilbertEncode(std::span<const Vec3f> points, const AABB& bounds, std::span<uint32_t> codes);
+	inline void HilbertEncode(std::span<const Vec3f> points, const AABB& bounds, std::span<uint64_t> codes);
+
+	inline void MortonEncode(std::span<const Vec3i> cells, std::span<uint32_t> codes);
+	inline void MortonEncode(std::span<const Vec3i> cells, std::span<uint64_t> codes);
+	inline void HilbertEncode(std::span<const Vec3i> cells, std::span<uint32_t> codes);
+	inline void HilbertEncode(std::span<const Vec3i> cells, std::span<uint64_t> codes);
+
+	inline void MortonDecode(std::span<const uint32_t> codes, std::span<Vec3i> cells);
+	inline void MortonDecode(std::span<const uint64_t> codes, std::span<Vec3i> cells);
+	inline void HilbertDecode(std::span<const uint32_t> codes, std::span<Vec3i> cells);
+	inline void HilbertDecode(std::span<const uint64_t> codes, std::span<Vec3i> cells);
+
+	enum class SpaceCurve
+	{
+		Morton,
+		Hilbert,
+	};
+
+	// Indices of the points in curve order over their bounds, 30 bit keys sorted with RadixSort
+	inline void SortAlongCurve(std::span<const Vec3f> points, std::vector<uint32_t>& order, SpaceCurve curve = SpaceCurve::Morton);
+
+	namespace Curve
+	{
+		// Bits of value spread to every third bit, and back
+		inline uint32_t Spread30(uint32_t value);
+		inline uint64_t Spread63(uint64_t value);
+		inline uint32_t Compact30(uint32_t code);
+		inline uint64_t Compact63(uint64_t code);
+
+		// Hilbert state machine over the octants of a level: entry = next state << 3 | output octant, indexed by state << 3 | input octant.
+		// Encode reads Morton octants and writes Hilbert ones, decode the reverse
+		struct HilbertTables
+		{
+			uint8_t encode[24 * 8];
+			uint8_t decode[24 * 8];
+		};
+
+		inline constexpr HilbertTables MakeHilbertTables();
+
+		template<typename K>
+		inline K HilbertFromMorton(K morton, uint32_t bits);
+
+		template<typename K>
+		inline K MortonFromHilbert(K code, uint32_t bits);
+	}
+}
+
+#include "MathSpaceCurve.inl"
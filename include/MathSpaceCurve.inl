@@ -0,0 +1,299 @@
+#pragma once
+#include <algorithm>
+#include <numeric>
+
+#include "MathSpaceCurve.h"
+
+namespace GALAXY::Math
+{
+#pragma region Bits
+	namespace Curve
+	{
+		inline uint32_t Spread30(uint32_t value)
+		{
+#if defined(MATH_BMI2)
+			return _pdep_u32(value, 0x09249249);
+#else
+			value &= 0x3FF;
+			value = (value | value << 16) & 0x030000FF;
+			value = (value | value << 8) & 0x0300F00F;
+			value = (value | value << 4) & 0x030C30C3;
+			value = (value | value << 2) & 0x09249249;
+			return value;
+#endif
+		}
+
+		inline uint64_t Spread63(uint64_t value)
+		{
+#if defined(MATH_BMI2)
+			return _pdep_u64(value, 0x1249249249249249);
+#else
+			value &= 0x1FFFFF;
+			value = (value | value << 32) & 0x001F00000000FFFF;
+			value = (value | value << 16) & 0x001F0000FF0000FF;
+			value = (value | value << 8) & 0x100F00F00F00F00F;
+			value = (value | value << 4) & 0x10C30C30C30C30C3;
+			value = (value | value << 2) & 0x1249249249249249;
+			return value;
+#endif
+		}
+
+		inline uint32_t Compact30(uint32_t code)
+		{
+#if defined(MATH_BMI2)
+			return _pext_u32(code, 0x09249249);
+#else
+			code &= 0x09249249;
+			code = (code ^ code >> 2) & 0x030C30C3;
+			code = (code ^ code >> 4) & 0x0300F00F;
+			code = (code ^ code >> 8) & 0x030000FF;
+			code = (code ^ code >> 16) & 0x3FF;
+			return code;
+#endif
+		}
+
+		inline uint64_t Compact63(uint64_t code)
+		{
+#if defined(MATH_BMI2)
+			return _pext_u64(code, 0x1249249249249249);
+#else
+			code &= 0x1249249249249249;
+			code = (code ^ code >> 2) & 0x10C30C30C30C30C3;
+			code = (code ^ code >> 4) & 0x100F00F00F00F00F;
+			code = (code ^ code >> 8) & 0x001F0000FF0000FF;
+			code = (code ^ code >> 16) & 0x001F00000000FFFF;
+			code = (code ^ code >> 32) & 0x1FFFFF;
+			return code;
+#endif
+		}
+
+		inline constexpr HilbertTables MakeHilbertTables()
+		{
+			// C. Hamilton, "Compact Hilbert indices", 2006: a level of the curve is the Gray code order of the octants,
+			// reflected by the entry corner e and rotated by the direction d of the parent octant
+			auto rotateRight = [](uint32_t bits, uint32_t shift) { shift %= 3; return (bits >> shift | bits << (3 - shift)) & 7; };
+			auto grayCode = [](uint32_t index) { return index ^ index >> 1; };
+			auto trailingOnes = [](uint32_t index) { uint32_t count = 0; while (index & 1) { index >>= 1; count++; } return count; };
+			HilbertTables tables{};
+			for (uint32_t e = 0; e < 8; e++)
+			{
+				for (uint32_t d = 0; d < 3; d++)
+				{
+					for (uint32_t octant = 0; octant < 8; octant++)
+					{
+						const uint32_t gray = rotateRight(octant ^ e, d + 1);
+						const uint32_t index = gray ^ gray >> 1 ^ gray >> 2;
+						const uint32_t entry = index == 0 ? 0 : grayCode(2 * ((index - 1) / 2));
+						const uint32_t direction = index == 0 ? 0 : (index & 1) ? trailingOnes(index) : trailingOnes(index - 1);
+						const uint32_t next = (e ^ rotateRight(entry, 3 - (d + 1) % 3)) * 3 + (d + direction + 1) % 3;
+						const uint32_t state = e * 3 + d;
+						tables.encode[state * 8 + octant] = static_cast<uint8_t>(next << 3 | index);
+						tables.decode[state * 8 + index] = static_cast<uint8_t>(next << 3 | octant);
+					}
+				}
+			}
+			return tables;
+		}
+
+		inline constexpr HilbertTables hilbertTables = MakeHilbertTables();
+
+		template<typename K>
+		inline K HilbertFromMorton(K morton, uint32_t bits)
+		{
+			K code = 0;
+			uint32_t state = 0;
+			for (uint32_t level = bits; level-- > 0;)
+			{
+				const uint32_t entry = hilbertTables.encode[state << 3 | static_cast<uint32_t>(morton >> (3 * level) & 7)];
+				code |= static_cast<K>(entry & 7) << (3 * level);
+				state = entry >> 3;
+			}
+			return code;
+		}
+
+		template<typename K>
+		inline K MortonFromHilbert(K code, uint32_t bits)
+		{
+			K morton = 0;
+			uint32_t state = 0;
+			for (uint32_t level = bits; level-- > 0;)
+			{
+				const uint32_t entry = hilbertTables.decode[state << 3 | static_cast<uint32_t>(code >> (3 * level) & 7)];
+				morton |= static_cast<K>(entry & 7) << (3 * level);
+				state = entry >> 3;
+			}
+			return morton;
+		}
+
+		// Cell of every point in a grid of 2^bits cells per axis over bounds
+		template<uint32_t Bits, typename K, typename F>
+		inline void EncodePoints(std::span<const Vec3f> points, const AABB& bounds, std::span<K> codes, F&& encode)
+		{
+			const float cells = static_cast<float>(1u << Bits);
+			const float maxCell = cells - 1.f;
+			const Vec3f size = bounds.GetSize();
+			const Vec3f scale(size.x > 0.f ? cells / size.x : 0.f, size.y > 0.f ? cells / size.y : 0.f, size.z > 0.f ? cells / size.z : 0.f);
+			const Vec3f origin = bounds.min;
+			// Written so NaN goes to cell 0 instead of through the conversion
+			auto quantize = [maxCell](float cell) { return cell > 0.f ? static_cast<uint32_t>(std::min(cell, maxCell)) : 0u; };
+			ParallelFor(std::min(points.size(), codes.size()), 1 << 14, [&](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; i++)
+				{
+					const Vec3f cell = (points[i] - origin) * scale;
+					codes[i] = encode(quantize(cell.x), quantize(cell.y), quantize(cell.z));
+				}
+			});
+		}
+
+		template<typename K, typename F>
+		inline void EncodeCells(std::span<const Vec3i> cells, std::span<K> codes, F&& encode)
+		{
+			ParallelFor(std::min(cells.size(), codes.size()), 1 << 14, [&](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; i++)
+					codes[i] = encode(static_cast<uint32_t>(cells[i].x), static_cast<uint32_t>(cells[i].y), static_cast<uint32_t>(cells[i].z));
+			});
+		}
+
+		template<typename K, typename F>
+		inline void DecodeCells(std::span<const K> codes, std::span<Vec3i> cells, F&& decode)
+		{
+			ParallelFor(std::min(codes.size(), cells.size()), 1 << 14, [&](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; i++)
+					cells[i] = decode(codes[i]);
+			});
+		}
+	}
+#pragma endregion
+
+#pragma region Morton
+	inline uint32_t MortonEncode30(uint32_t x, uint32_t y, uint32_t z)
+	{
+		return Curve::Spread30(x) | Curve::Spread30(y) << 1 | Curve::Spread30(z) << 2;
+	}
+
+	inline uint64_t MortonEncode63(uint32_t x, uint32_t y, uint32_t z)
+	{
+		return Curve::Spread63(x) | Curve::Spread63(y) << 1 | Curve::Spread63(z) << 2;
+	}
+
+	inline Vec3i MortonDecode30(uint32_t code)
+	{
+		return Vec3i(static_cast<int>(Curve::Compact30(code)), static_cast<int>(Curve::Compact30(code >> 1)), static_cast<int>(Curve::Compact30(code >> 2)));
+	}
+
+	inline Vec3i MortonDecode63(uint64_t code)
+	{
+		return Vec3i(static_cast<int>(Curve::Compact63(code)), static_cast<int>(Curve::Compact63(code >> 1)), static_cast<int>(Curve::Compact63(code >> 2)));
+	}
+
+	inline void MortonEncode(std::span<const Vec3f> points, const AABB& bounds, std::span<uint32_t> codes)
+	{
+		MATH_INSTRUMENT_SCOPE("MortonEncode(span, AABB, span<uint32_t>)");
+		MATH_INSTRUMENT_ITEMS(std::min(points.size(), codes.size()));
+		Curve::EncodePoints<10>(points, bounds, codes, [](uint32_t x, uint32_t y, uint32_t z) { return MortonEncode30(x, y, z); });
+	}
+
+	inline void MortonEncode(std::span<const Vec3f> points, const AABB& bounds, std::span<uint64_t> codes)
+	{
+		MATH_INSTRUMENT_SCOPE("MortonEncode(span, AABB, span<uint64_t>)");
+		MATH_INSTRUMENT_ITEMS(std::min(points.size(), codes.size()));
+		Curve::EncodePoints<21>(points, bounds, codes, [](uint32_t x, uint32_t y, uint32_t z) { return MortonEncode63(x, y, z); });
+	}
+
+	inline void MortonEncode(std::span<const Vec3i> cells, std::span<uint32_t> codes)
+	{
+		Curve::EncodeCells(cells, codes, [](uint32_t x, uint32_t y, uint32_t z) { return MortonEncode30(x, y, z); });
+	}
+
+	inline void MortonEncode(std::span<const Vec3i> cells, std::span<uint64_t> codes)
+	{
+		Curve::EncodeCells(cells, codes, [](uint32_t x, uint32_t y, uint32_t z) { return MortonEncode63(x, y, z); });
+	}
+
+	inline void MortonDecode(std::span<const uint32_t> codes, std::span<Vec3i> cells)
+	{
+		Curve::DecodeCells(codes, cells, MortonDecode30);
+	}
+
+	inline void MortonDecode(std::span<const uint64_t> codes, std::span<Vec3i> cells)
+	{
+		Curve::DecodeCells(codes, cells, MortonDecode63);
+	}
+#pragma endregion
+
+#pragma region Hilbert
+	// One table step per level on the octant bits, which are the Morton triples
+	inline uint32_t HilbertEncode30(uint32_t x, uint32_t y, uint32_t z)
+	{
+		return Curve::HilbertFromMorton(MortonEncode30(x, y, z), 10);
+	}
+
+	inline uint64_t HilbertEncode63(uint32_t x, uint32_t y, uint32_t z)
+	{
+		return Curve::HilbertFromMorton(MortonEncode63(x, y, z), 21);
+	}
+
+	inline Vec3i HilbertDecode30(uint32_t code)
+	{
+		return MortonDecode30(Curve::MortonFromHilbert(code & 0x3FFFFFFF, 10));
+	}
+
+	inline Vec3i HilbertDecode63(uint64_t code)
+	{
+		return MortonDecode63(Curve::MortonFromHilbert(code & 0x7FFFFFFFFFFFFFFF, 21));
+	}
+
+	inline void HilbertEncode(std::span<const Vec3f> points, const AABB& bounds, std::span<uint32_t> codes)
+	{
+		MATH_INSTRUMENT_SCOPE("HilbertEncode(span, AABB, span<uint32_t>)");
+		MATH_INSTRUMENT_ITEMS(std::min(points.size(), codes.size()));
+		Curve::EncodePoints<10>(points, bounds, codes, [](uint32_t x, uint32_t y, uint32_t z) { return HilbertEncode30(x, y, z); });
+	}
+
+	inline void HilbertEncode(std::span<const Vec3f> points, const AABB& bounds, std::span<uint64_t> codes)
+	{
+		MATH_INSTRUMENT_SCOPE("HilbertEncode(span, AABB, span<uint64_t>)");
+		MATH_INSTRUMENT_ITEMS(std::min(points.size(), codes.size()));
+		Curve::EncodePoints<21>(points, bounds, codes, [](uint32_t x, uint32_t y, uint32_t z) { return HilbertEncode63(x, y, z); });
+	}
+
+	inline void HilbertEncode(std::span<const Vec3i> cells, std::span<uint32_t> codes)
+	{
+		Curve::EncodeCells(cells, codes, [](uint32_t x, uint32_t y, uint32_t z) { return HilbertEncode30(x, y, z); });
+	}
+
+	inline void HilbertEncode(std::span<const Vec3i> cells, std::span<uint64_t> codes)
+	{
+		Curve::EncodeCells(cells, codes, [](uint32_t x, uint32_t y, uint32_t z) { return HilbertEncode63(x, y, z); });
+	}
+
+	inline void HilbertDecode(std::span<const uint32_t> codes, std::span<Vec3i> cells)
+	{
+		Curve::DecodeCells(codes, cells, HilbertDecode30);
+	}
+
+	inline void HilbertDecode(std::span<const uint64_t> codes, std::span<Vec3i> cells)
+	{
+		Curve::DecodeCells(codes, cells, HilbertDecode63);
+	}
+#pragma endregion
+
+	inline void SortAlongCurve(std::span<const Vec3f> points, std::vector<uint32_t>& order, SpaceCurve curve)
+	{
+		MATH_INSTRUMENT_SCOPE("SortAlongCurve(span, vector, SpaceCurve)");
+		AABB bounds;
+		for (const Vec3f& point : points)
+			bounds.Grow(point);
+		std::vector<uint32_t> codes(points.size());
+		if (curve == SpaceCurve::Hilbert)
+			HilbertEncode(points, bounds, std::span(codes));
+		else
+			MortonEncode(points, bounds, std::span(codes));
+		order.resize(points.size());
+		std::iota(order.begin(), order.end(), 0u);
+		RadixSort(std::span(codes), std::span(order));
+	}
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "Maths.h"
+#include "MathArray.h"
+#include "MathGeometry.h"
+#include "MathParallel.h"
+
+namespace GALAXY::Math
+{
+	// Points bucketed by grid cell for radius and nearest neighbour queries, rebuilt from scratch when the points move.
+	// The grid wraps around: cell (x, y, z) goes to bucket (x mod D, y mod D, z mod D) of a D^3 table, x fastest,
+	// so far apart cells share buckets but the cells of any query box up to D wide never do, and a row of cells is one range of points.
+	// Build is a counting sort of the points by bucket, run on the workers. Within a bucket the order is the input order with a single worker.
+	class SpatialHash
+	{
+	public:
+		static constexpr uint32_t None = 0xFFFFFFFF;
+
+		// Queries are fastest for a radius around the cell size. A cell size that is not positive and finite,
+		// or points that are not finite, stay defined but crowd into a few cells
+		explicit inline SpatialHash(float cellSize = 1.f);
+
+		inline void Build(std::span<const Vec3f> points);
+
+		inline float GetCellSize() const { return cellSize; }
+
+		inline size_t GetPointCount() const { return indices.size(); }
+
+		// Cells per axis of the table, a power of two chosen from the point count
+		inline uint32_t GetTableSize() const { return 1u << tableBits; }
+
+		// Calls visit(index, distanceSquared) for every point within radius of center, in no particular order
+		template<typename F>
+		inline void ForEachInRadius(const Vec3f& center, float radius, F&& visit) const;
+
+		// Indices of the points within radius of center, appended to output
+		inline void QueryRadius(const Vec3f& center, float radius, std::vector<uint32_t>& output) const;
+
+		// Up to output.size() nearest points within maxRadius, nearest first, the rest of output filled with None. Returns how many were found
+		inline size_t QueryNearest(const Vec3f& center, float maxRadius, std::span<uint32_t> output) const;
+
+		// Neighbours of every center: those of center i are neighbours[offsets[i]] to neighbours[offsets[i + 1]]
+		inline void QueryRadius(std::span<const Vec3f> centers, float radius, std::vector<uint32_t>& offsets, std::vector<uint32_t>& neighbours) const;
+
+		// k nearest of every center into output[i * k] to output[i * k + k]
+		inline void QueryNearest(std::span<const Vec3f> centers, size_t k, float maxRadius, std::span<uint32_t> output) const;
+
+	private:
+		typedef std::pair<float, uint32_t> Candidate;
+
+		inline int32_t GetCell(float coordinate) const;
+
+		inline uint32_t GetBucket(int32_t x, int32_t y, int32_t z) const;
+
+		// Max heap of the output.size() nearest candidates, reused between the queries of a batch
+		inline size_t QueryNearest(const Vec3f& center, float maxRadius, std::span<uint32_t> output, std::vector<Candidate>& heap) const;
+
+		float cellSize;
+		float inverseCellSize;
+		uint32_t tableBits = 0;
+		// Points of bucket b are sorted[starts[b]] to sorted[starts[b + 1]]
+		std::vector<uint32_t> starts;
+		// Original index of every sorted point
+		std::vector<uint32_t> indices;
+		Vec3SoA<float> sorted;
+		AABB bounds;
+	};
+}
+
+#include "MathSpatialHash.inl"
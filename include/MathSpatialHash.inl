@@ -0,0 +1,300 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cmath>
+
+#include "MathSpatialHash.h"
+
+namespace GALAXY::Math
+{
+#pragma region Build
+	inline SpatialHash::SpatialHash(float _cellSize) : cellSize(_cellSize), inverseCellSize(1.f / _cellSize)
+	{
+	}
+
+	inline int32_t SpatialHash::GetCell(float coordinate) const
+	{
+		// Clamped so coordinates far outside the int range still give a valid cell, NaN (a NaN coordinate, or 0 over a cell size of 0) goes to cell 0
+		const float cell = coordinate * inverseCellSize;
+		if (cell != cell)
+			return 0;
+		return static_cast<int32_t>(std::floor(std::clamp(cell, -1e9f, 1e9f)));
+	}
+
+	inline uint32_t SpatialHash::GetBucket(int32_t x, int32_t y, int32_t z) const
+	{
+		const uint32_t mask = (1u << tableBits) - 1;
+		return (static_cast<uint32_t>(x) & mask) | (static_cast<uint32_t>(y) & mask) << tableBits | (static_cast<uint32_t>(z) & mask) << (2 * tableBits);
+	}
+
+	inline void SpatialHash::Build(std::span<const Vec3f> points)
+	{
+		MATH_INSTRUMENT_SCOPE("SpatialHash::Build(span)");
+		const size_t count = points.size();
+		MATH_INSTRUMENT_ITEMS(count);
+		constexpr size_t Grain = 1 << 14;
+
+		// About one bucket per point, from 16^3 to 256^3 buckets
+		tableBits = 4;
+		while (tableBits < 8 && (size_t(1) << (3 * tableBits)) < count)
+			tableBits++;
+		const size_t bucketCount = size_t(1) << (3 * tableBits);
+
+		// Counters are only shared when the work is split, an uncontended atomic increment still costs as much as the rest of the loop
+		const bool shared = GetWorkerCount() > 1 && count > Grain;
+		auto increment = [shared](uint32_t& counter) { return shared ? std::atomic_ref<uint32_t>(counter).fetch_add(1, std::memory_order_relaxed) : counter++; };
+
+		// Count the points of every bucket, in starts[bucket + 1] for the prefix sum
+		starts.assign(bucketCount + 1, 0);
+		std::vector<uint32_t> buckets(count);
+		std::vector<AABB> chunkBounds((count + Grain - 1) / Grain);
+		ParallelFor(count, Grain, [&](size_t begin, size_t end)
+		{
+			AABB& box = chunkBounds[begin / Grain];
+			for (size_t i = begin; i < end; i++)
+			{
+				const Vec3f& point = points[i];
+				box.Grow(point);
+				buckets[i] = GetBucket(GetCell(point.x), GetCell(point.y), GetCell(point.z));
+				increment(starts[buckets[i] + 1]);
+			}
+		});
+		bounds = AABB();
+		for (const AABB& box : chunkBounds)
+			bounds.Grow(box);
+
+		// Prefix sum in two passes over blocks of buckets: the total of every block, then each block offset by the ones before it
+		std::vector<uint32_t> blockOffsets((bucketCount + Grain - 1) / Grain + 1, 0);
+		ParallelFor(bucketCount, Grain, [&](size_t begin, size_t end)
+		{
+			uint32_t sum = 0;
+			for (size_t b = begin; b < end; b++)
+				sum += starts[b + 1];
+			blockOffsets[begin / Grain + 1] = sum;
+		});
+		for (size_t block = 1; block < blockOffsets.size(); block++)
+			blockOffsets[block] += blockOffsets[block - 1];
+		ParallelFor(bucketCount, Grain, [&](size_t begin, size_t end)
+		{
+			uint32_t sum = blockOffsets[begin / Grain];
+			for (size_t b = begin; b < end; b++)
+			{
+				sum += starts[b + 1];
+				starts[b + 1] = sum;
+			}
+		});
+
+		// Scatter every point to the next free slot of its bucket
+		std::vector<uint32_t> cursors(starts.begin(), starts.end() - 1);
+		indices.resize(count);
+		sorted.Resize(count);
+		ParallelFor(count, Grain, [&](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				const uint32_t slot = increment(cursors[buckets[i]]);
+				indices[slot] = static_cast<uint32_t>(i);
+				sorted.x[slot] = points[i].x;
+				sorted.y[slot] = points[i].y;
+				sorted.z[slot] = points[i].z;
+			}
+		});
+	}
+#pragma endregion
+
+#pragma region Queries
+	template<typename F>
+	inline void SpatialHash::ForEachInRadius(const Vec3f& center, float radius, F&& visit) const
+	{
+		if (indices.empty())
+			return;
+		const float radiusSquared = radius * radius;
+		const float* x = sorted.x.data();
+		const float* y = sorted.y.data();
+		const float* z = sorted.z.data();
+
+		// Distances to the points of a range, compared a SIMD register at a time
+		auto scan = [&](uint32_t begin, uint32_t end)
+		{
+			uint32_t i = begin;
+#if defined(MATH_AVX)
+			const __m256 centerX = _mm256_set1_ps(center.x), centerY = _mm256_set1_ps(center.y), centerZ = _mm256_set1_ps(center.z);
+			const __m256 limit = _mm256_set1_ps(radiusSquared);
+			for (; i + 8 <= end; i += 8)
+			{
+				const __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(x + i), centerX);
+				const __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(y + i), centerY);
+				const __m256 dz = _mm256_sub_ps(_mm256_loadu_ps(z + i), centerZ);
+				const __m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)), _mm256_mul_ps(dz, dz));
+				uint32_t mask = static_cast<uint32_t>(_mm256_movemask_ps(_mm256_cmp_ps(distance, limit, _CMP_LE_OQ)));
+				if (mask == 0)
+					continue;
+				alignas(32) float distances[8];
+				_mm256_store_ps(distances, distance);
+				for (; mask != 0; mask &= mask - 1)
+				{
+					const uint32_t lane = static_cast<uint32_t>(std::countr_zero(mask));
+					visit(indices[i + lane], distances[lane]);
+				}
+			}
+#elif defined(MATH_SSE)
+			const __m128 centerX = _mm_set1_ps(center.x), centerY = _mm_set1_ps(center.y), centerZ = _mm_set1_ps(center.z);
+			const __m128 limit = _mm_set1_ps(radiusSquared);
+			for (; i + 4 <= end; i += 4)
+			{
+				const __m128 dx = _mm_sub_ps(_mm_loadu_ps(x + i), centerX);
+				const __m128 dy = _mm_sub_ps(_mm_loadu_ps(y + i), centerY);
+				const __m128 dz = _mm_sub_ps(_mm_loadu_ps(z + i), centerZ);
+				const __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+				uint32_t mask = static_cast<uint32_t>(_mm_movemask_ps(_mm_cmple_ps(distance, limit)));
+				if (mask == 0)
+					continue;
+				alignas(16) float distances[4];
+				_mm_store_ps(distances, distance);
+				for (; mask != 0; mask &= mask - 1)
+				{
+					const uint32_t lane = static_cast<uint32_t>(std::countr_zero(mask));
+					visit(indices[i + lane], distances[lane]);
+				}
+			}
+#endif
+			for (; i < end; i++)
+			{
+				const float distance = (Vec3f(x[i], y[i], z[i]) - center).LengthSquared();
+				if (distance <= radiusSquared)
+					visit(indices[i], distance);
+			}
+		};
+
+		// At most one table width of cells per axis, every bucket is then visited once. A negative cell size mirrors the cells
+		const int32_t size = 1 << tableBits;
+		int32_t low[3], high[3];
+		for (size_t axis = 0; axis < 3; axis++)
+		{
+			const int32_t a = GetCell(center[axis] - radius), b = GetCell(center[axis] + radius);
+			low[axis] = std::min(a, b);
+			high[axis] = std::min(std::max(a, b), low[axis] + size - 1);
+		}
+		const uint32_t cells = static_cast<uint32_t>(high[0] - low[0] + 1);
+		const uint32_t wrapX = static_cast<uint32_t>(low[0]) & static_cast<uint32_t>(size - 1);
+		// A row of cells is one range of buckets, or two when it wraps around the table
+		const uint32_t first = std::min(cells, static_cast<uint32_t>(size) - wrapX);
+		for (int32_t cellZ = low[2]; cellZ <= high[2]; cellZ++)
+		{
+			for (int32_t cellY = low[1]; cellY <= high[1]; cellY++)
+			{
+				const uint32_t row = GetBucket(low[0], cellY, cellZ);
+				scan(starts[row], starts[row + first]);
+				if (first < cells)
+					scan(starts[row - wrapX], starts[row - wrapX + cells - first]);
+			}
+		}
+	}
+
+	inline void SpatialHash::QueryRadius(const Vec3f& center, float radius, std::vector<uint32_t>& output) const
+	{
+		MATH_INSTRUMENT_BATCHABLE("SpatialHash::QueryRadius(Vec3f, float, vector)", "SpatialHash::QueryRadius(span, float, vector, vector)");
+		ForEachInRadius(center, radius, [&](uint32_t index, float) { output.push_back(index); });
+	}
+
+	inline size_t SpatialHash::QueryNearest(const Vec3f& center, float maxRadius, std::span<uint32_t> output) const
+	{
+		MATH_INSTRUMENT_BATCHABLE("SpatialHash::QueryNearest(Vec3f, float, span)", "SpatialHash::QueryNearest(span, size_t, float, span)");
+		std::vector<Candidate> heap;
+		return QueryNearest(center, maxRadius, output, heap);
+	}
+
+	inline size_t SpatialHash::QueryNearest(const Vec3f& center, float maxRadius, std::span<uint32_t> output, std::vector<Candidate>& heap) const
+	{
+		const size_t k = output.size();
+		std::fill(output.begin(), output.end(), None);
+		if (k == 0 || indices.empty())
+			return 0;
+
+		// Past the farthest corner of the points every point is in the radius, searching further finds nothing new
+		Vec3f farthest;
+		for (size_t axis = 0; axis < 3; axis++)
+			farthest[axis] = std::max(std::abs(center[axis] - bounds.min[axis]), std::abs(center[axis] - bounds.max[axis]));
+		const float reach = std::min(maxRadius, farthest.Length());
+
+		// Every point within the radius is seen, so once k of them are found they are the k nearest. Otherwise the radius doubles.
+		// It starts a little past the ball that holds k points on average, so most queries need a single pass.
+		// Flat point sets have no volume and start from the cell size, which may not be positive: the start is kept above reach / 1024
+		const Vec3f size = bounds.GetSize();
+		const float volume = size.x * size.y * size.z;
+		float radius = volume > 0.f ? 1.25f * std::cbrt(0.75f / PI * volume * k / indices.size()) : cellSize;
+		radius = std::min(std::max(reach / 1024.f, radius), reach);
+		while (true)
+		{
+			heap.clear();
+			ForEachInRadius(center, radius, [&](uint32_t index, float distance)
+			{
+				if (heap.size() < k)
+				{
+					heap.emplace_back(distance, index);
+					std::push_heap(heap.begin(), heap.end());
+				}
+				else if (distance < heap.front().first)
+				{
+					std::pop_heap(heap.begin(), heap.end());
+					heap.back() = Candidate(distance, index);
+					std::push_heap(heap.begin(), heap.end());
+				}
+			});
+			// Also stops when the radius no longer grows, at an infinite reach
+			const float next = std::min(radius * 2.f, reach);
+			if (heap.size() == k || !(next > radius))
+				break;
+			radius = next;
+		}
+		std::sort_heap(heap.begin(), heap.end());
+		for (size_t i = 0; i < heap.size(); i++)
+			output[i] = heap[i].second;
+		return heap.size();
+	}
+
+	inline void SpatialHash::QueryRadius(std::span<const Vec3f> centers, float radius, std::vector<uint32_t>& offsets, std::vector<uint32_t>& neighbours) const
+	{
+		MATH_INSTRUMENT_SCOPE("SpatialHash::QueryRadius(span, float, vector, vector)");
+		const size_t count = centers.size();
+		MATH_INSTRUMENT_ITEMS(count);
+		constexpr size_t Grain = 256;
+
+		// Each chunk of centers collects its neighbours apart, offsets are local to the chunk until the chunks are joined
+		offsets.assign(count + 1, 0);
+		std::vector<std::vector<uint32_t>> chunks((count + Grain - 1) / Grain);
+		ParallelFor(count, Grain, [&](size_t begin, size_t end)
+		{
+			std::vector<uint32_t>& chunk = chunks[begin / Grain];
+			for (size_t i = begin; i < end; i++)
+			{
+				ForEachInRadius(centers[i], radius, [&](uint32_t index, float) { chunk.push_back(index); });
+				offsets[i + 1] = static_cast<uint32_t>(chunk.size());
+			}
+		});
+		neighbours.clear();
+		for (size_t c = 0; c < chunks.size(); c++)
+		{
+			const uint32_t base = static_cast<uint32_t>(neighbours.size());
+			for (size_t i = c * Grain; i < std::min(count, (c + 1) * Grain); i++)
+				offsets[i + 1] += base;
+			neighbours.insert(neighbours.end(), chunks[c].begin(), chunks[c].end());
+		}
+	}
+
+	inline void SpatialHash::QueryNearest(std::span<const Vec3f> centers, size_t k, float maxRadius, std::span<uint32_t> output) const
+	{
+		MATH_INSTRUMENT_SCOPE("SpatialHash::QueryNearest(span, size_t, float, span)");
+		const size_t count = k == 0 ? 0 : std::min(centers.size(), output.size() / k);
+		MATH_INSTRUMENT_ITEMS(count);
+		ParallelFor(count, 256, [&](size_t begin, size_t end)
+		{
+			std::vector<Candidate> heap;
+			heap.reserve(k);
+			for (size_t i = begin; i < end; i++)
+				QueryNearest(centers[i], maxRadius, output.subspan(i * k, k), heap);
+		});
+	}
+#pragma endregion
+}
@@ -0,0 +1,153 @@
+#pragma once
+#include <cstddef>
+#include <span>
+#include <vector>
+
+#include "Maths.h"
+
+namespace GALAXY::Math
+{
+	// Cubic a t^3 + b t^2 + c t + d over t in [0, 1] for Vec2, Vec3 or Vec4.
+	// Bezier, Hermite and Catmull-Rom segments are converted to this form once, evaluating is then a Horner scheme.
+	template<typename V>
+	class CubicCurve
+	{
+	public:
+		V a, b, c, d;
+
+		inline constexpr CubicCurve() = default;
+
+		inline constexpr CubicCurve(const V& _a, const V& _b, const V& _c, const V& _d) : a(_a), b(_b), c(_c), d(_d) {}
+
+		static inline constexpr CubicCurve Bezier(const V& p0, const V& p1, const V& p2, const V& p3);
+
+		// From p0 with tangent m0 to p1 with tangent m1
+		static inline constexpr CubicCurve Hermite(const V& p0, const V& m0, const V& p1, const V& m1);
+
+		// From p1 to p2, tension 0.5 is the usual Catmull-Rom
+		static inline constexpr CubicCurve CatmullRom(const V& p0, const V& p1, const V& p2, const V& p3, float tension = 0.5f);
+
+		inline constexpr V Evaluate(float t) const;
+
+		inline constexpr V Derivative(float t) const;
+
+		// The batches stop at the shortest of their spans
+		inline void Evaluate(std::span<const float> t, std::span<V> output) const;
+
+		// output.size() samples from t = start by steps of step, forward differenced: three additions per sample.
+		// Rounding accumulates along the run, a few thousand float samples stay within 1e-4 of Evaluate
+		inline void Sample(float start, float step, std::span<V> output) const;
+
+		// output.size() evenly spaced samples from t = 0 to t = 1
+		inline void Sample(std::span<V> output) const;
+
+		// Every curve at its own parameter, for many independent curves per frame
+		static inline void EvaluateEach(std::span<const CubicCurve> curves, std::span<const float> t, std::span<V> output);
+	};
+
+	// Chain of cubic segments, the parameter u runs from 0 to the segment count and its integer part picks the segment
+	template<typename V>
+	class Spline
+	{
+	public:
+		inline Spline() = default;
+
+		explicit inline Spline(std::vector<CubicCurve<V>> _segments) : segments(std::move(_segments)) {}
+
+		// Through every point, the end segments repeat the first and last point
+		static inline Spline CatmullRom(std::span<const V> points, float tension = 0.5f);
+
+		// 3n + 1 points, every segment starts on the last point of the previous one
+		static inline Spline Bezier(std::span<const V> points);
+
+		static inline Spline Hermite(std::span<const V> points, std::span<const V> tangents);
+
+		inline size_t GetSegmentCount() const { return segments.size(); }
+
+		inline const CubicCurve<V>& GetSegment(size_t index) const { return segments[index]; }
+
+		// An empty spline evaluates to V()
+		inline V Evaluate(float u) const;
+
+		inline V Derivative(float u) const;
+
+		inline void Evaluate(std::span<const float> u, std::span<V> output) const;
+
+		// output.size() samples evenly spaced in u, forward differenced inside each segment
+		inline void Sample(std::span<V> output) const;
+
+	private:
+		// Segment of u and the parameter inside it, the spline must have a segment
+		inline size_t Locate(float u, float& t) const;
+
+		std::vector<CubicCurve<V>> segments;
+	};
+
+	// Length along a spline at evenly spaced parameters, maps a distance back to the parameter for constant speed motion
+	class ArcLengthTable
+	{
+	public:
+		inline ArcLengthTable() = default;
+
+		// Chord lengths of samplesPerSegment forward differenced samples per segment
+		template<typename V>
+		explicit inline ArcLengthTable(const Spline<V>& spline, size_t samplesPerSegment = 32);
+
+		inline float GetLength() const { return lengths.empty() ? 0.f : lengths.back(); }
+
+		// Parameter u of the point at this distance from the start, clamped to the spline
+		inline float GetParameter(float distance) const;
+
+		// Parameters of output.size() points evenly spaced along the whole length, one walk over the table
+		inline void GetParameters(std::span<float> output) const;
+
+	private:
+		// lengths[i] is the length up to u = i * step
+		std::vector<float> lengths;
+		float step = 0.f;
+	};
+
+	// Spherical spline through rotation keys (SQUAD), u runs from 0 to the key count - 1
+	template<typename T>
+	class SquadSpline
+	{
+	public:
+		inline SquadSpline() = default;
+
+		// Keys are flipped where needed so consecutive keys are in the same hemisphere
+		explicit inline SquadSpline(std::span<const QuatT<T>> keys);
+
+		inline size_t GetSegmentCount() const { return keys.size() > 1 ? keys.size() - 1 : 0; }
+
+		inline QuatT<T> Evaluate(float u) const;
+
+		inline void Evaluate(std::span<const float> u, std::span<QuatT<T>> output) const;
+
+	private:
+		inline QuatT<T> Interpolate(float u) const;
+
+		// Angle between two keys, zero when they are close enough to interpolate linearly
+		struct Arc
+		{
+			T angle;
+			T inverseSin;
+		};
+
+		static inline Arc GetArc(const QuatT<T>& a, const QuatT<T>& b);
+
+		// Along the great arc from a to b even when it is the longer one, as SQUAD requires
+		static inline QuatT<T> Slerp(const QuatT<T>& a, const QuatT<T>& b, T t, const Arc& arc);
+
+		static inline QuatT<T> Log(const QuatT<T>& q);
+
+		static inline QuatT<T> Exp(const QuatT<T>& q);
+
+		std::vector<QuatT<T>> keys;
+		// Inner control of every key, the tangent of the curve at it
+		std::vector<QuatT<T>> controls;
+		std::vector<Arc> keyArcs;
+		std::vector<Arc> controlArcs;
+	};
+}
+
+#include "MathSpline.inl"
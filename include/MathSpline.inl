@@ -0,0 +1,356 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+
+#include "MathSpline.h"
+
+namespace GALAXY::Math
+{
+#pragma region CubicCurve
+	template<typename V>
+	inline constexpr CubicCurve<V> CubicCurve<V>::Bezier(const V& p0, const V& p1, const V& p2, const V& p3)
+	{
+		return CubicCurve((p1 - p2) * 3.f + p3 - p0, (p0 + p2) * 3.f - p1 * 6.f, (p1 - p0) * 3.f, p0);
+	}
+
+	template<typename V>
+	inline constexpr CubicCurve<V> CubicCurve<V>::Hermite(const V& p0, const V& m0, const V& p1, const V& m1)
+	{
+		return CubicCurve((p0 - p1) * 2.f + m0 + m1, (p1 - p0) * 3.f - m0 * 2.f - m1, m0, p0);
+	}
+
+	template<typename V>
+	inline constexpr CubicCurve<V> CubicCurve<V>::CatmullRom(const V& p0, const V& p1, const V& p2, const V& p3, float tension)
+	{
+		return Hermite(p1, (p2 - p0) * tension, p2, (p3 - p1) * tension);
+	}
+
+	template<typename V>
+	inline constexpr V CubicCurve<V>::Evaluate(float t) const
+	{
+		return ((a * t + b) * t + c) * t + d;
+	}
+
+	template<typename V>
+	inline constexpr V CubicCurve<V>::Derivative(float t) const
+	{
+		return (a * (3.f * t) + b * 2.f) * t + c;
+	}
+
+	template<typename V>
+	inline void CubicCurve<V>::Evaluate(std::span<const float> t, std::span<V> output) const
+	{
+		MATH_INSTRUMENT_SCOPE("CubicCurve::Evaluate(span, span)");
+		const size_t count = std::min(t.size(), output.size());
+		MATH_INSTRUMENT_ITEMS(count);
+		for (size_t i = 0; i < count; i++)
+			output[i] = Evaluate(t[i]);
+	}
+
+	template<typename V>
+	inline void CubicCurve<V>::Sample(float start, float step, std::span<V> output) const
+	{
+		MATH_INSTRUMENT_SCOPE("CubicCurve::Sample(float, float, span)");
+		MATH_INSTRUMENT_ITEMS(output.size());
+		if (output.empty())
+			return;
+		// Differences of the polynomial written out in start and step, they do not cancel like differences of samples
+		const float s = start, h = step;
+		const float h2 = h * h, h3 = h2 * h;
+		V point = Evaluate(s);
+		V first = a * (3.f * s * s * h + 3.f * s * h2 + h3) + b * (2.f * s * h + h2) + c * h;
+		V second = a * (6.f * s * h2 + 6.f * h3) + b * (2.f * h2);
+		const V third = a * (6.f * h3);
+		for (size_t i = 0; i < output.size(); i++)
+		{
+			output[i] = point;
+			point = point + first;
+			first = first + second;
+			second = second + third;
+		}
+	}
+
+	template<typename V>
+	inline void CubicCurve<V>::Sample(std::span<V> output) const
+	{
+		Sample(0.f, output.size() > 1 ? 1.f / static_cast<float>(output.size() - 1) : 0.f, output);
+	}
+
+	template<typename V>
+	inline void CubicCurve<V>::EvaluateEach(std::span<const CubicCurve> curves, std::span<const float> t, std::span<V> output)
+	{
+		MATH_INSTRUMENT_SCOPE("CubicCurve::EvaluateEach(span, span, span)");
+		const size_t count = std::min({ curves.size(), t.size(), output.size() });
+		MATH_INSTRUMENT_ITEMS(count);
+		for (size_t i = 0; i < count; i++)
+			output[i] = curves[i].Evaluate(t[i]);
+	}
+#pragma endregion
+
+#pragma region Spline
+	template<typename V>
+	inline Spline<V> Spline<V>::CatmullRom(std::span<const V> points, float tension)
+	{
+		std::vector<CubicCurve<V>> segments;
+		if (points.size() < 2)
+			return Spline(std::move(segments));
+		segments.reserve(points.size() - 1);
+		for (size_t i = 0; i + 1 < points.size(); i++)
+		{
+			const V& before = points[i > 0 ? i - 1 : 0];
+			const V& after = points[std::min(i + 2, points.size() - 1)];
+			segments.push_back(CubicCurve<V>::CatmullRom(before, points[i], points[i + 1], after, tension));
+		}
+		return Spline(std::move(segments));
+	}
+
+	template<typename V>
+	inline Spline<V> Spline<V>::Bezier(std::span<const V> points)
+	{
+		std::vector<CubicCurve<V>> segments;
+		if (points.size() < 4)
+			return Spline(std::move(segments));
+		segments.reserve((points.size() - 1) / 3);
+		for (size_t i = 0; i + 3 < points.size(); i += 3)
+			segments.push_back(CubicCurve<V>::Bezier(points[i], points[i + 1], points[i + 2], points[i + 3]));
+		return Spline(std::move(segments));
+	}
+
+	template<typename V>
+	inline Spline<V> Spline<V>::Hermite(std::span<const V> points, std::span<const V> tangents)
+	{
+		std::vector<CubicCurve<V>> segments;
+		if (points.size() < 2)
+			return Spline(std::move(segments));
+		segments.reserve(points.size() - 1);
+		for (size_t i = 0; i + 1 < points.size(); i++)
+			segments.push_back(CubicCurve<V>::Hermite(points[i], tangents[i], points[i + 1], tangents[i + 1]));
+		return Spline(std::move(segments));
+	}
+
+	template<typename V>
+	inline size_t Spline<V>::Locate(float u, float& t) const
+	{
+		const float last = static_cast<float>(segments.size() - 1);
+		const float segment = std::clamp(std::floor(u), 0.f, last);
+		t = std::clamp(u - segment, 0.f, 1.f);
+		return static_cast<size_t>(segment);
+	}
+
+	template<typename V>
+	inline V Spline<V>::Evaluate(float u) const
+	{
+		MATH_INSTRUMENT_BATCHABLE("Spline::Evaluate(float)", "Spline::Evaluate(span, span)");
+		if (segments.empty())
+			return V();
+		float t;
+		const size_t segment = Locate(u, t);
+		return segments[segment].Evaluate(t);
+	}
+
+	template<typename V>
+	inline V Spline<V>::Derivative(float u) const
+	{
+		MATH_INSTRUMENT_SCOPE("Spline::Derivative(float)");
+		if (segments.empty())
+			return V();
+		float t;
+		const size_t segment = Locate(u, t);
+		return segments[segment].Derivative(t);
+	}
+
+	template<typename V>
+	inline void Spline<V>::Evaluate(std::span<const float> u, std::span<V> output) const
+	{
+		MATH_INSTRUMENT_SCOPE("Spline::Evaluate(span, span)");
+		const size_t count = std::min(u.size(), output.size());
+		MATH_INSTRUMENT_ITEMS(count);
+		if (segments.empty())
+		{
+			std::fill_n(output.begin(), count, V());
+			return;
+		}
+		for (size_t i = 0; i < count; i++)
+		{
+			float t;
+			const size_t segment = Locate(u[i], t);
+			output[i] = segments[segment].Evaluate(t);
+		}
+	}
+
+	template<typename V>
+	inline void Spline<V>::Sample(std::span<V> output) const
+	{
+		MATH_INSTRUMENT_SCOPE("Spline::Sample(span)");
+		MATH_INSTRUMENT_ITEMS(output.size());
+		if (segments.empty())
+		{
+			std::fill(output.begin(), output.end(), V());
+			return;
+		}
+		const size_t count = output.size();
+		const float step = count > 1 ? static_cast<float>(segments.size()) / static_cast<float>(count - 1) : 0.f;
+		size_t begin = 0;
+		for (size_t segment = 0; segment < segments.size() && begin < count; segment++)
+		{
+			// Samples whose parameter falls in this segment, the last one also takes u = segment count
+			size_t end = begin;
+			if (segment + 1 == segments.size())
+				end = count;
+			else
+				while (end < count && static_cast<float>(end) * step < static_cast<float>(segment + 1))
+					end++;
+			segments[segment].Sample(static_cast<float>(begin) * step - static_cast<float>(segment), step, output.subspan(begin, end - begin));
+			begin = end;
+		}
+	}
+#pragma endregion
+
+#pragma region ArcLengthTable
+	template<typename V>
+	inline ArcLengthTable::ArcLengthTable(const Spline<V>& spline, size_t samplesPerSegment)
+	{
+		if (spline.GetSegmentCount() == 0 || samplesPerSegment == 0)
+			return;
+		std::vector<V> points(spline.GetSegmentCount() * samplesPerSegment + 1);
+		spline.Sample(points);
+		step = 1.f / static_cast<float>(samplesPerSegment);
+		lengths.resize(points.size());
+		lengths[0] = 0.f;
+		for (size_t i = 1; i < points.size(); i++)
+			lengths[i] = lengths[i - 1] + static_cast<float>((points[i] - points[i - 1]).Length());
+	}
+
+	inline float ArcLengthTable::GetParameter(float distance) const
+	{
+		MATH_INSTRUMENT_BATCHABLE("ArcLengthTable::GetParameter(float)", "ArcLengthTable::GetParameters(span)");
+		if (lengths.size() < 2 || distance <= 0.f)
+			return 0.f;
+		if (distance >= lengths.back())
+			return static_cast<float>(lengths.size() - 1) * step;
+		const size_t i = static_cast<size_t>(std::upper_bound(lengths.begin(), lengths.end(), distance) - lengths.begin());
+		const float width = lengths[i] - lengths[i - 1];
+		const float fraction = width > 0.f ? (distance - lengths[i - 1]) / width : 0.f;
+		return (static_cast<float>(i - 1) + fraction) * step;
+	}
+
+	inline void ArcLengthTable::GetParameters(std::span<float> output) const
+	{
+		MATH_INSTRUMENT_SCOPE("ArcLengthTable::GetParameters(span)");
+		MATH_INSTRUMENT_ITEMS(output.size());
+		if (lengths.size() < 2)
+		{
+			std::fill(output.begin(), output.end(), 0.f);
+			return;
+		}
+		const float spacing = output.size() > 1 ? GetLength() / static_cast<float>(output.size() - 1) : 0.f;
+		size_t i = 1;
+		for (size_t k = 0; k < output.size(); k++)
+		{
+			// Distances only grow, the table index never moves back
+			const float distance = static_cast<float>(k) * spacing;
+			while (i + 1 < lengths.size() && lengths[i] < distance)
+				i++;
+			const float width = lengths[i] - lengths[i - 1];
+			const float fraction = width > 0.f ? std::clamp((distance - lengths[i - 1]) / width, 0.f, 1.f) : 0.f;
+			output[k] = (static_cast<float>(i - 1) + fraction) * step;
+		}
+	}
+#pragma endregion
+
+#pragma region SquadSpline
+	template<typename T>
+	inline SquadSpline<T>::SquadSpline(std::span<const QuatT<T>> _keys) : keys(_keys.begin(), _keys.end())
+	{
+		for (size_t i = 1; i < keys.size(); i++)
+		{
+			if (keys[i - 1].Dot(keys[i]) < 0)
+				keys[i] = keys[i] * static_cast<T>(-1);
+		}
+
+		// s_i = q_i exp(-(log(q_i^-1 q_i+1) + log(q_i^-1 q_i-1)) / 4), the end keys are their own neighbours
+		controls.resize(keys.size());
+		for (size_t i = 0; i < keys.size(); i++)
+		{
+			const QuatT<T> inverse = keys[i].GetConjugate();
+			const QuatT<T>& previous = keys[i > 0 ? i - 1 : 0];
+			const QuatT<T>& next = keys[std::min(i + 1, keys.size() - 1)];
+			const QuatT<T> sum = Log(inverse * next) + Log(inverse * previous);
+			controls[i] = keys[i] * Exp(sum * static_cast<T>(-0.25));
+		}
+
+		// The outer and inner arcs of a segment do not depend on t
+		for (size_t i = 0; i + 1 < keys.size(); i++)
+		{
+			keyArcs.push_back(GetArc(keys[i], keys[i + 1]));
+			controlArcs.push_back(GetArc(controls[i], controls[i + 1]));
+		}
+	}
+
+	template<typename T>
+	inline QuatT<T> SquadSpline<T>::Evaluate(float u) const
+	{
+		MATH_INSTRUMENT_BATCHABLE("SquadSpline::Evaluate(float)", "SquadSpline::Evaluate(span, span)");
+		return Interpolate(u);
+	}
+
+	template<typename T>
+	inline void SquadSpline<T>::Evaluate(std::span<const float> u, std::span<QuatT<T>> output) const
+	{
+		MATH_INSTRUMENT_SCOPE("SquadSpline::Evaluate(span, span)");
+		const size_t count = std::min(u.size(), output.size());
+		MATH_INSTRUMENT_ITEMS(count);
+		for (size_t i = 0; i < count; i++)
+			output[i] = Interpolate(u[i]);
+	}
+
+	template<typename T>
+	inline QuatT<T> SquadSpline<T>::Interpolate(float u) const
+	{
+		if (keys.size() < 2)
+			return keys.empty() ? QuatT<T>::Identity() : keys[0];
+		const float last = static_cast<float>(keys.size() - 2);
+		const float segment = std::clamp(std::floor(u), 0.f, last);
+		const T t = static_cast<T>(std::clamp(u - segment, 0.f, 1.f));
+		const size_t i = static_cast<size_t>(segment);
+		const QuatT<T> outer = Slerp(keys[i], keys[i + 1], t, keyArcs[i]);
+		const QuatT<T> inner = Slerp(controls[i], controls[i + 1], t, controlArcs[i]);
+		return Slerp(outer, inner, 2 * t * (1 - t), GetArc(outer, inner));
+	}
+
+	template<typename T>
+	inline typename SquadSpline<T>::Arc SquadSpline<T>::GetArc(const QuatT<T>& a, const QuatT<T>& b)
+	{
+		const T d = std::clamp(a.Dot(b), static_cast<T>(-1), static_cast<T>(1));
+		if (d > static_cast<T>(0.9995))
+			return Arc{ 0, 0 };
+		const T angle = Acos(d);
+		return Arc{ angle, 1 / Sin(angle) };
+	}
+
+	template<typename T>
+	inline QuatT<T> SquadSpline<T>::Slerp(const QuatT<T>& a, const QuatT<T>& b, T t, const Arc& arc)
+	{
+		// Quat::SLerp takes the shortest arc, flipping between outer and inner whenever their dot product crosses zero
+		if (arc.angle == 0)
+			return (a * (1 - t) + b * t).GetNormalize();
+		return a * (Sin((1 - t) * arc.angle) * arc.inverseSin) + b * (Sin(t * arc.angle) * arc.inverseSin);
+	}
+
+	template<typename T>
+	inline QuatT<T> SquadSpline<T>::Log(const QuatT<T>& q)
+	{
+		const T length = Sqrt(q.x * q.x + q.y * q.y + q.z * q.z);
+		const T scale = length > static_cast<T>(1e-7) ? Atan2(length, q.w) / length : static_cast<T>(1);
+		return QuatT<T>(q.x * scale, q.y * scale, q.z * scale, 0);
+	}
+
+	template<typename T>
+	inline QuatT<T> SquadSpline<T>::Exp(const QuatT<T>& q)
+	{
+		const T length = Sqrt(q.x * q.x + q.y * q.y + q.z * q.z);
+		const T scale = length > static_cast<T>(1e-7) ? Sin(length) / length : static_cast<T>(1);
+		return QuatT<T>(q.x * scale, q.y * scale, q.z * scale, Cos(length));
+	}
+#pragma endregion
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "Maths.h"
+
+namespace GALAXY::Math
+{
+	// Matrix of R rows and C columns stored as C column vectors, the same layout as Mat4T: M * v is a sum of columns.
+	template<typename T, size_t R, size_t C>
+	class Mat
+	{
+	public:
+		VecN<T, R> columns[C] = {};
+
+		inline constexpr Mat() = default;
+
+		// Diagonal matrix, the rest is zero
+		explicit inline constexpr Mat(T diagonal);
+
+		inline constexpr Mat(const Mat4T<T>& a) requires (R == 4 && C == 4);
+
+		inline constexpr Mat4T<T> ToMat4() const requires (R == 4 && C == 4);
+
+		inline constexpr VecN<T, R>& operator[](size_t column);
+
+		inline constexpr const VecN<T, R>& operator[](size_t column) const;
+
+		inline constexpr Mat operator+(const Mat& b) const;
+
+		inline constexpr Mat operator-(const Mat& b) const;
+
+		inline constexpr Mat operator*(T b) const;
+
+		inline constexpr VecN<T, R> operator*(const VecN<T, C>& v) const;
+
+		template<size_t K>
+		inline constexpr Mat<T, R, K> operator*(const Mat<T, C, K>& b) const;
+
+		inline constexpr bool operator==(const Mat& b) const;
+
+		inline constexpr bool operator!=(const Mat& b) const;
+
+		inline constexpr VecN<T, C> GetRow(size_t row) const;
+
+		inline constexpr Mat<T, C, R> GetTranspose() const;
+
+		static inline constexpr Mat Identity() requires (R == C) { return Mat(static_cast<T>(1)); }
+	};
+
+	typedef Mat<float, 2, 2> Mat2f;
+	typedef Mat<float, 3, 3> Mat3f;
+	typedef Mat<double, 3, 3> Mat3d;
+}
+
+#include "MathVecN.inl"
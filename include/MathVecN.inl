@@ -0,0 +1,105 @@
+#pragma once
+#include "MathVecN.h"
+
+namespace GALAXY::Math
+{
+#pragma region Mat
+	template<typename T, size_t R, size_t C>
+	inline constexpr Mat<T, R, C>::Mat(T diagonal)
+	{
+		for (size_t i = 0; i < R && i < C; i++)
+			columns[i][i] = diagonal;
+	}
+
+	template<typename T, size_t R, size_t C>
+	inline constexpr Mat<T, R, C>::Mat(const Mat4T<T>& a) requires (R == 4 && C == 4)
+	{
+		for (size_t i = 0; i < 4; i++)
+			columns[i] = a.content[i];
+	}
+
+	template<typename T, size_t R, size_t C>
+	inline constexpr Mat4T<T> Mat<T, R, C>::ToMat4() const requires (R == 4 && C == 4)
+	{
+		return Mat4T<T>(columns[0], columns[1], columns[2], columns[3]);
+	}
+
+	template<typename T, size_t R, size_t C>
+	inline constexpr VecN<T, R>& Mat<T, R, C>::operator[](size_t column)
+	{
+		return columns[column];
+	}
+
+	template<typename T, size_t R, size_t C>
+	inline constexpr const VecN<T, R>& Mat<T, R, C>::operator[](size_t column) const
+	{
+		return columns[column];
+	}
+
+	template<typename T, size_t R, size_t C>
+	inline constexpr Mat<T, R, C> Mat<T, R, C>::operator+(const Mat& b) const
+	{
+		Mat result;
+		[&]<size_t... J>(std::index_sequence<J...>) { ((result.columns[J] = columns[J] + b.columns[J]), ...); }(std::make_index_sequence<C>());
+		return result;
+	}
+
+	template<typename T, size_t R, size_t C>
+	inline constexpr Mat<T, R, C> Mat<T, R, C>::operator-(const Mat& b) const
+	{
+		Mat result;
+		[&]<size_t... J>(std::index_sequence<J...>) { ((result.columns[J] = columns[J] - b.columns[J]), ...); }(std::make_index_sequence<C>());
+		return result;
+	}
+
+	template<typename T, size_t R, size_t C>
+	inline constexpr Mat<T, R, C> Mat<T, R, C>::operator*(T b) const
+	{
+		Mat result;
+		[&]<size_t... J>(std::index_sequence<J...>) { ((result.columns[J] = columns[J] * b), ...); }(std::make_index_sequence<C>());
+		return result;
+	}
+
+	template<typename T, size_t R, size_t C>
+	inline constexpr VecN<T, R> Mat<T, R, C>::operator*(const VecN<T, C>& v) const
+	{
+		return [&]<size_t... J>(std::index_sequence<J...>) { return (... + (columns[J] * v[J])); }(std::make_index_sequence<C>());
+	}
+
+	template<typename T, size_t R, size_t C>
+	template<size_t K>
+	inline constexpr Mat<T, R, K> Mat<T, R, C>::operator*(const Mat<T, C, K>& b) const
+	{
+		Mat<T, R, K> result;
+		[&]<size_t... J>(std::index_sequence<J...>) { ((result.columns[J] = *this * b.columns[J]), ...); }(std::make_index_sequence<K>());
+		return result;
+	}
+
+	template<typename T, size_t R, size_t C>
+	inline constexpr bool Mat<T, R, C>::operator==(const Mat& b) const
+	{
+		return [&]<size_t... J>(std::index_sequence<J...>) { return ((columns[J] == b.columns[J]) && ...); }(std::make_index_sequence<C>());
+	}
+
+	template<typename T, size_t R, size_t C>
+	inline constexpr bool Mat<T, R, C>::operator!=(const Mat& b) const
+	{
+		return !(*this == b);
+	}
+
+	template<typename T, size_t R, size_t C>
+	inline constexpr VecN<T, C> Mat<T, R, C>::GetRow(size_t row) const
+	{
+		return VecN<T, C>::Generate([&](size_t column) { return columns[column][row]; });
+	}
+
+	template<typename T, size_t R, size_t C>
+	inline constexpr Mat<T, C, R> Mat<T, R, C>::GetTranspose() const
+	{
+		Mat<T, C, R> result;
+		for (size_t row = 0; row < R; row++)
+			result.columns[row] = GetRow(row);
+		return result;
+	}
+#pragma endregion
+}
@@ -1,9 +1,74 @@
 #pragma once
 #include <string>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <cstdint>
+#include <ostream>
+#include <cfloat>
+
+#if !defined(MATH_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define MATH_SSE
+#if defined(__AVX__)
+#define MATH_AVX
+#endif
+#if defined(__F16C__) || (defined(_MSC_VER) && defined(__AVX2__))
+#define MATH_F16C
+#endif
+#if defined(__BMI2__) || (defined(_MSC_VER) && defined(__AVX2__))
+#define MATH_BMI2
+#endif
+#include <immintrin.h>
+#endif
+#include "MathInstrument.h"
+
+// MATH_DETERMINISTIC makes results bit-identical across compilers and platforms:
+// transcendentals come from Math::Deterministic instead of the platform libm.
+// Floating point contraction (FMA fusion) has to be disabled by the build, -ffp-contract=off or /fp:precise
+// as the xmake deterministic option passes, a pragma here would also change the code of the including translation unit.
+#ifdef MATH_DETERMINISTIC
+#if defined(__FAST_MATH__)
+#error "MATH_DETERMINISTIC cannot be used with -ffast-math"
+#endif
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD != 0
+#error "MATH_DETERMINISTIC requires FLT_EVAL_METHOD == 0 (SSE2 or newer, no x87)"
+#endif
+#endif
+
 #define PI 3.14159265358979323846264f
 #define DegToRad 1/180.f * PI
 #define RadToDeg 180.f / PI
 
+// Named swizzles: every combination of 2 to 4 components as a member, v.xzy() is Swizzle<0, 2, 1>().
+// Each level of the component lists has its own macro and a fixed arity so the nested expansions also work with the traditional MSVC preprocessor.
+#define MATH_SWIZZLE_COMPONENTS2_1(M, A, B, C) M(x, 0, A, B, C) M(y, 1, A, B, C)
+#define MATH_SWIZZLE_COMPONENTS2_2(M, a, ia, B, C) M(x, 0, a, ia, B, C) M(y, 1, a, ia, B, C)
+#define MATH_SWIZZLE_COMPONENTS2_3(M, b, ib, a, ia, C) M(x, 0, b, ib, a, ia, C) M(y, 1, b, ib, a, ia, C)
+#define MATH_SWIZZLE_COMPONENTS2_4(M, c, ic, b, ib, a, ia) M(x, 0, c, ic, b, ib, a, ia) M(y, 1, c, ic, b, ib, a, ia)
+#define MATH_SWIZZLE_COMPONENTS3_1(M, A, B, C) M(x, 0, A, B, C) M(y, 1, A, B, C) M(z, 2, A, B, C)
+#define MATH_SWIZZLE_COMPONENTS3_2(M, a, ia, B, C) M(x, 0, a, ia, B, C) M(y, 1, a, ia, B, C) M(z, 2, a, ia, B, C)
+#define MATH_SWIZZLE_COMPONENTS3_3(M, b, ib, a, ia, C) M(x, 0, b, ib, a, ia, C) M(y, 1, b, ib, a, ia, C) M(z, 2, b, ib, a, ia, C)
+#define MATH_SWIZZLE_COMPONENTS3_4(M, c, ic, b, ib, a, ia) M(x, 0, c, ic, b, ib, a, ia) M(y, 1, c, ic, b, ib, a, ia) M(z, 2, c, ic, b, ib, a, ia)
+#define MATH_SWIZZLE_COMPONENTS4_1(M, A, B, C) M(x, 0, A, B, C) M(y, 1, A, B, C) M(z, 2, A, B, C) M(w, 3, A, B, C)
+#define MATH_SWIZZLE_COMPONENTS4_2(M, a, ia, B, C) M(x, 0, a, ia, B, C) M(y, 1, a, ia, B, C) M(z, 2, a, ia, B, C) M(w, 3, a, ia, B, C)
+#define MATH_SWIZZLE_COMPONENTS4_3(M, b, ib, a, ia, C) M(x, 0, b, ib, a, ia, C) M(y, 1, b, ib, a, ia, C) M(z, 2, b, ib, a, ia, C) M(w, 3, b, ib, a, ia, C)
+#define MATH_SWIZZLE_COMPONENTS4_4(M, c, ic, b, ib, a, ia) M(x, 0, c, ic, b, ib, a, ia) M(y, 1, c, ic, b, ib, a, ia) M(z, 2, c, ic, b, ib, a, ia) M(w, 3, c, ic, b, ib, a, ia)
+
+#define MATH_SWIZZLE2_B(b, ib, a, ia, L3, L4) inline constexpr Vec2<T> a##b() const { return Self().template Swizzle<ia, ib>(); }
+#define MATH_SWIZZLE2_A(a, ia, L2, L3, L4) L2(MATH_SWIZZLE2_B, a, ia, L3, L4)
+#define MATH_SWIZZLE3_C(c, ic, b, ib, a, ia, L4) inline constexpr Vec3<T> a##b##c() const { return Self().template Swizzle<ia, ib, ic>(); }
+#define MATH_SWIZZLE3_B(b, ib, a, ia, L3, L4) L3(MATH_SWIZZLE3_C, b, ib, a, ia, L4)
+#define MATH_SWIZZLE3_A(a, ia, L2, L3, L4) L2(MATH_SWIZZLE3_B, a, ia, L3, L4)
+#define MATH_SWIZZLE4_D(d, id, c, ic, b, ib, a, ia) inline constexpr Vec4<T> a##b##c##d() const { return Self().template Swizzle<ia, ib, ic, id>(); }
+#define MATH_SWIZZLE4_C(c, ic, b, ib, a, ia, L4) L4(MATH_SWIZZLE4_D, c, ic, b, ib, a, ia)
+#define MATH_SWIZZLE4_B(b, ib, a, ia, L3, L4) L3(MATH_SWIZZLE4_C, b, ib, a, ia, L4)
+#define MATH_SWIZZLE4_A(a, ia, L2, L3, L4) L2(MATH_SWIZZLE4_B, a, ia, L3, L4)
+
+#define MATH_SWIZZLES(L) \
+	L##_1(MATH_SWIZZLE2_A, L##_2, L##_3, L##_4) \
+	L##_1(MATH_SWIZZLE3_A, L##_2, L##_3, L##_4) \
+	L##_1(MATH_SWIZZLE4_A, L##_2, L##_3, L##_4)
+
 #ifdef MATH_GLM_EXTENSION
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
@@ -16,311 +81,466 @@
 namespace GALAXY::Math
 {
 	template<typename T>
-	inline bool AlmostEqual(T a, T b, float diff = 1e-5f);
+	inline constexpr bool AlmostEqual(T a, T b, float diff = 1e-5f);
 
 	template<typename T>
-	class Vec3;
-	template<typename T>
-	class Vec4;
-	class Quat;
+	inline constexpr T Pi = static_cast<T>(3.14159265358979323846264L);
 
+	// Angle conversions in the precision of T, the DegToRad and RadToDeg macros are float
 	template<typename T>
-	class Vec2
-	{
-	public:
-		T x = 0, y = 0;
+	inline constexpr T ToRadians(T degrees);
+	template<typename T>
+	inline constexpr T ToDegrees(T radians);
 
-		inline constexpr Vec2() : x(0), y(0) {}
+	// Scalar functions used across the library, they forward to Deterministic with MATH_DETERMINISTIC and to the std otherwise.
+	template<typename T>
+	inline constexpr T Sin(T x);
+	template<typename T>
+	inline constexpr T Cos(T x);
+	template<typename T>
+	inline constexpr T Tan(T x);
+	template<typename T>
+	inline T Asin(T x);
+	template<typename T>
+	inline T Acos(T x);
+	template<typename T>
+	inline constexpr T Atan(T x);
+	template<typename T>
+	inline constexpr T Atan2(T y, T x);
+	template<typename T>
+	inline T Sqrt(T x);
 
-		explicit inline constexpr Vec2(T _xy) : x(_xy), y(_xy) {}
+	// Portable implementations (fdlibm kernels) evaluated in double with a fixed operation order.
+	// Sqrt stays the IEEE 754 correctly rounded square root, which is already exact everywhere.
+	namespace Deterministic
+	{
+		inline constexpr double Sin(double x);
+		inline constexpr double Cos(double x);
+		inline constexpr double Tan(double x);
+		inline double Asin(double x);
+		inline double Acos(double x);
+		inline constexpr double Atan(double x);
+		inline constexpr double Atan2(double y, double x);
+		inline double Sqrt(double x);
+	}
+
+	template<typename T, size_t N>
+	class VecN;
+	// The fixed size vectors are VecN, x, y, z and w name their components
+	template<typename T>
+	using Vec2 = VecN<T, 2>;
+	template<typename T>
+	using Vec3 = VecN<T, 3>;
+	template<typename T>
+	using Vec4 = VecN<T, 4>;
+	template<typename T>
+	class Mat4T;
+	template<typename T>
+	class QuatT;
 
-		inline constexpr Vec2(T _x, T _y) : x(_x), y(_y) {}
+	// Vector type of N components, the scalar itself for one
+	template<typename T, size_t N>
+	struct VecOf { typedef VecN<T, N> Type; };
 
-		template<typename U>
-		inline constexpr Vec2(const Vec3<U>& a);
+	template<typename T>
+	struct VecOf<T, 1> { typedef T Type; };
 
-		template<typename U>
-		inline constexpr Vec2(const Vec2<U>& a);
+	// Component I of a vector by reference
+	template<size_t I, typename V>
+	inline constexpr auto& SwizzleComponent(V& vector);
 
-		inline constexpr Vec2(const std::string& str);
+	// Writable swizzle: reads and writes go straight to the components of the viewed vector, nothing is copied
+	// v.View<2, 0>() = Vec2f(1, 2) sets z to 1 and x to 2
+	template<typename V, size_t... I>
+	class SwizzleView
+	{
+	public:
+		typedef std::remove_cvref_t<decltype(std::declval<V&>()[0])> T;
+		typedef typename VecOf<T, sizeof...(I)>::Type Value;
 
-		template<typename U>
-		inline constexpr Vec2 operator=(const Vec2<U>& a);
-		template<typename U>
-		inline constexpr Vec2 operator=(const Vec3<U>& a);
+		explicit inline constexpr SwizzleView(V& _vector) : vector(_vector) {}
 
-		template<typename U>
-		inline constexpr Vec2 operator+(const Vec2<U>& a) const;
-		template<typename U>
-		inline constexpr Vec2 operator-(const Vec2<U>& a) const;
-		inline constexpr Vec2 operator-(void) const;
-		template<typename U>
-		inline constexpr Vec2 operator*(const U& a) const;
-		template<typename U>
-		inline constexpr Vec2 operator*(const Vec2<U>& a) const;
-		template<typename U>
-		inline constexpr Vec2 operator/(const U& a) const;
+		inline constexpr operator Value() const;
 
-		template<typename U>
-		inline void operator+=(const Vec2<U>& a);
-		template<typename U>
-		inline void operator-=(const Vec2<U>& a);
-		template<typename U>
-		inline void operator*=(const Vec2<U>& a);
-		template<typename U>
-		inline void operator*=(const U& a);
-		template<typename U>
-		inline void operator/=(const U& a);
+		inline constexpr SwizzleView& operator=(const Value& value);
 
-		template<typename U>
-		inline constexpr bool operator==(const Vec2<U>& b) const;
-		template<typename U>
-		inline constexpr bool operator==(const Vec3<U>& b) const;
-		template<typename U>
-		inline constexpr bool operator!=(const Vec2<U>& b) const;
-		template<typename U>
-		inline constexpr bool operator!=(const Vec3<U>& b) const;
+		inline constexpr SwizzleView& operator=(const SwizzleView& view);
 
-		inline T& operator[](const size_t a);
+		inline constexpr SwizzleView& operator+=(const Value& value);
 
-		inline T LengthSquared() const;
+		inline constexpr SwizzleView& operator-=(const Value& value);
 
-		inline T Length() const;
+		inline constexpr SwizzleView& operator*=(T value);
 
-		inline T Dot(const Vec2& a) const;
+	private:
+		// Component K of the value, the scalar itself when the view has one component
+		template<size_t K>
+		static inline constexpr T Element(const Value& value);
 
-		inline Vec2 Cross(const Vec2& a) const;
+		template<typename Function, size_t... K>
+		inline constexpr void ForEach(const Value& value, Function function, std::index_sequence<K...>);
 
-		inline Vec2 Ortho() const;
+		static inline constexpr bool Distinct();
 
-		inline void Normalize();
+		V& vector;
+	};
 
-		inline Vec2 GetNormalize() const;
+	typedef Mat4T<float> Mat4;
+	typedef QuatT<float> Quat;
 
-		inline void Print(int precision = 6) const;
+	// IEEE 754 half precision storage type, arithmetic happens in float.
+	class Half
+	{
+	public:
+		uint16_t bits = 0;
 
-		inline std::string ToString(int precision = 6) const;
+		inline constexpr Half() {}
 
-		inline Vec2<float> ToVec2f() const;
+		template<typename U> requires std::is_arithmetic_v<U>
+		inline constexpr Half(U value) : bits(FromFloat(static_cast<float>(value))) {}
 
-		inline Vec2<int> ToVec2i() const;
+		inline constexpr operator float() const { return ToFloat(bits); }
 
-		inline T* Data() const;
+		static inline constexpr Half FromBits(uint16_t bits);
 
-#ifdef MATH_GLM_EXTENSION
-		inline glm::vec2 ToGlm() const { return glm::vec2(x, y); }
+		// Round to nearest even, same result as F16C.
+		static inline constexpr uint16_t FromFloat(float value);
 
-		inline bool operator==(const glm::vec2& b) const { return x == b.x && y == b.y; }
-#endif
+		static inline constexpr float ToFloat(uint16_t bits);
 	};
 
-	typedef Vec2<float> Vec2f;
-	typedef Vec2<double> Vec2d;
-	typedef Vec2<int> Vec2i;
-
-	template<typename T>
-	class Vec3
+	// Signed 16.16 fixed point number, arithmetic stays in fixed point.
+	// Conversions and every operator saturate to the representable range, NaN converts to 0
+	// and dividing by zero gives the saturated value of the dividend's sign.
+	class Fixed16_16
 	{
 	public:
-		T x = 0, y = 0, z = 0;
+		int32_t raw = 0;
 
-		inline constexpr Vec3() : x(0), y(0), z(0) {}
+		static constexpr int32_t One = 1 << 16;
 
-		inline constexpr Vec3(T _x, T _y, T _z) : x(_x), y(_y), z(_z) {}
+		inline constexpr Fixed16_16() {}
 
-		explicit inline constexpr Vec3(T xyz) : x(xyz), y(xyz), z(xyz) {}
+		template<typename U> requires std::is_arithmetic_v<U>
+		inline constexpr Fixed16_16(U value);
 
-		inline constexpr Vec3(const std::string& str);
+		template<typename U> requires std::is_arithmetic_v<U>
+		explicit inline constexpr operator U() const;
 
-		template<typename U>
-		inline constexpr Vec3(const Vec2<U>& xy, T _z = 0);
+		static inline constexpr Fixed16_16 FromRaw(int32_t raw);
 
-		template<typename U>
-		inline constexpr Vec3(const Vec3<U>& a);
+		// Clamps a wide raw value into int32_t
+		static inline constexpr Fixed16_16 Saturate(int64_t raw);
 
-		template<typename U>
-		inline constexpr Vec3(const Vec4<U>& a);
+		inline constexpr Fixed16_16 operator-() const { return Saturate(-static_cast<int64_t>(raw)); }
 
-		inline constexpr Vec3 operator+(const Vec3& b) const;
-		inline constexpr Vec3 operator-(const Vec3& b) const;
-		inline constexpr Vec3 operator-(void) const;
-		template<typename U>
-		inline constexpr Vec3 operator*(const Vec3<U>& b) const;
-		template<typename U>
-		inline constexpr Vec3 operator*(const U& b) const;
-		template<typename U>
-		inline constexpr Vec3 operator/(const U& b) const;
+		inline constexpr Fixed16_16& operator+=(Fixed16_16 b) { return *this = *this + b; }
+		inline constexpr Fixed16_16& operator-=(Fixed16_16 b) { return *this = *this - b; }
+		inline constexpr Fixed16_16& operator*=(Fixed16_16 b) { return *this = *this * b; }
+		inline constexpr Fixed16_16& operator/=(Fixed16_16 b) { return *this = *this / b; }
 
-		inline void operator+=(const Vec3& b);
-		inline void operator-=(const Vec3& b);
-		inline void operator*=(const Vec3& b);
-		template<typename U>
-		inline void operator*=(const U& b);
-		template<typename U>
-		inline void operator/=(const U& b);
-
-		template<typename U>
-		inline constexpr bool operator==(const Vec3<U>& b) const;
-		template<typename U>
-		inline constexpr bool operator!=(const Vec3<U>& b) const;
+		friend inline constexpr Fixed16_16 operator+(Fixed16_16 a, Fixed16_16 b) { return Saturate(static_cast<int64_t>(a.raw) + b.raw); }
+		friend inline constexpr Fixed16_16 operator-(Fixed16_16 a, Fixed16_16 b) { return Saturate(static_cast<int64_t>(a.raw) - b.raw); }
+		friend inline constexpr Fixed16_16 operator*(Fixed16_16 a, Fixed16_16 b) { return Saturate((static_cast<int64_t>(a.raw) * b.raw) >> 16); }
+		friend inline constexpr Fixed16_16 operator/(Fixed16_16 a, Fixed16_16 b) { return Saturate(b.raw != 0 ? (static_cast<int64_t>(a.raw) << 16) / b.raw : static_cast<int64_t>(a.raw) << 32); }
 
-		inline T& operator[](const size_t a);
-		inline const T& operator[](const size_t a) const;
+		friend inline constexpr bool operator==(Fixed16_16 a, Fixed16_16 b) { return a.raw == b.raw; }
+		friend inline constexpr auto operator<=>(Fixed16_16 a, Fixed16_16 b) { return a.raw <=> b.raw; }
 
-		static inline constexpr Vec3 Right() { return { 1, 0, 0 }; }
-		static inline constexpr Vec3 Up() { return { 0, 1, 0 }; }
-		static inline constexpr Vec3 Forward() { return { 0, 0, -1 }; }
+		friend inline std::ostream& operator<<(std::ostream& os, Fixed16_16 value);
+		friend inline std::istream& operator>>(std::istream& is, Fixed16_16& value);
+	};
 
-		static inline constexpr Vec3 Left() { return { -1, 0, 0 }; }
-		static inline constexpr Vec3 Down() { return { 0, -1, 0 }; }
-		static inline constexpr Vec3 Back() { return { 0, 0, 1 }; }
+#pragma region VecN
+	// Components of a VecN: x, y, z and w for 2 to 4 components, an array for the other sizes
+	template<typename T, size_t N>
+	struct VecComponents
+	{
+		T data[N] = {};
+	};
 
-		static inline constexpr Vec3 Zero() { return { 0, 0, 0 }; }
-		static inline constexpr Vec3 One() { return { 1, 1, 1 }; }
+	template<typename T>
+	struct VecComponents<T, 2>
+	{
+		T x = 0, y = 0;
 
-		inline T LengthSquared() const;
+		// Named components in index order, for the constant evaluated subscript
+		static constexpr T VecComponents::* components[] = { &VecComponents::x, &VecComponents::y };
 
-		inline T Length() const;
+		MATH_SWIZZLES(MATH_SWIZZLE_COMPONENTS2)
 
-		inline T Dot(const Vec3& a) const;
+	private:
+		inline constexpr const VecN<T, 2>& Self() const { return static_cast<const VecN<T, 2>&>(*this); }
+	};
 
-		inline Vec3 Cross(const Vec3& a) const;
+	template<typename T>
+	struct VecComponents<T, 3>
+	{
+		T x = 0, y = 0, z = 0;
 
-		inline T Distance(const Vec3& a) const;
+		static constexpr T VecComponents::* components[] = { &VecComponents::x, &VecComponents::y, &VecComponents::z };
 
-		inline Vec3 Lerp(const Vec3& a, float t) const;
+		MATH_SWIZZLES(MATH_SWIZZLE_COMPONENTS3)
 
-		inline void Normalize();
+	private:
+		inline constexpr const VecN<T, 3>& Self() const { return static_cast<const VecN<T, 3>&>(*this); }
+	};
 
-		inline Vec3 GetNormalize() const;
+	template<typename T>
+	struct VecComponents<T, 4>
+	{
+		T x = 0, y = 0, z = 0, w = 0;
 
-		inline void Print(int precision = 6) const;
+		static constexpr T VecComponents::* components[] = { &VecComponents::x, &VecComponents::y, &VecComponents::z, &VecComponents::w };
 
-		inline std::string ToString(int precision = 6) const;
+		MATH_SWIZZLES(MATH_SWIZZLE_COMPONENTS4)
 
-		inline Quat ToQuaternion() const;
+	private:
+		inline constexpr const VecN<T, 4>& Self() const { return static_cast<const VecN<T, 4>&>(*this); }
+	};
 
-		inline T* Data() const;
+	// Vector of any size, every operation is a fold over the components so it unrolls at compile time.
+	// Vec2, Vec3 and Vec4 are this class, the operations below are written once for every size.
+	// Float vectors of 3 and 4 components use SSE for the component wise operations and the dot product.
+	// Operations between two component types compute in their common type and convert to T, comparisons convert the other vector to T.
+	template<typename T, size_t N>
+	class VecN : public VecComponents<T, N>
+	{
+	public:
+		static_assert(N > 0, "A vector needs at least one component");
 
-#ifdef MATH_GLM_EXTENSION
-		inline glm::vec3 ToGlm() const { return glm::vec3(x, y, z); }
+		inline constexpr VecN() = default;
 
-		inline bool operator==(const glm::vec3& b) const { return AlmostEqual(x, b.x) && AlmostEqual(y, b.y) && AlmostEqual(z, b.z); }
-#endif
-	};
+		explicit inline constexpr VecN(T value);
 
-	typedef Vec3<float> Vec3f;
-	typedef Vec3<int> Vec3i;
-	typedef Vec3<double> Vec3d;
+		template<typename... Args> requires (N > 1 && sizeof...(Args) == N && (std::is_convertible_v<Args, T> && ...))
+		inline constexpr VecN(Args... args) : VecComponents<T, N>{ static_cast<T>(args)... } {}
 
-#pragma region Vec4
-	template<typename T>
-	class Vec4 {
-	public:
-		T x = 0, y = 0, z = 0, w = 0;
+		template<typename U>
+		inline constexpr VecN(const VecN<U, N>& a);
 
-		inline constexpr Vec4() : x(0), y(0), z(0), w(0) {}
+		// Components separated by one character, "1, 2, 3"
+		inline VecN(const std::string& str);
 
-		inline constexpr Vec4(T _x, T _y, T _z, T _w) : x(_x), y(_y), z(_z), w(_w) {}
+		// Components of a smaller vector followed by the given ones
+		template<typename U>
+		inline constexpr VecN(const VecN<U, 2>& xy, T _z = 0) requires (N == 3);
 
-		explicit inline constexpr Vec4(T xyzw) : x(xyzw), y(xyzw), z(xyzw), w(xyzw) {}
+		template<typename U>
+		inline constexpr VecN(const VecN<U, 2>& xy, T _z = 0, T _w = 0) requires (N == 4);
 
 		template<typename U>
-		inline constexpr Vec4(const Vec2<U>& xy, T _z = 0, T _w = 0);
+		inline constexpr VecN(const VecN<U, 3>& xyz, T _w = 0) requires (N == 4);
 
+		// First components of the vector one size larger
 		template<typename U>
-		inline constexpr Vec4(const Vec3<U>& xyz, T _w = 0);
+		inline constexpr VecN(const VecN<U, N + 1>& a) requires (N == 2 || N == 3);
 
+		// Sets x, y and z, w is kept
 		template<typename U>
-		inline constexpr Vec4(const Vec4<U>& a);
+		inline constexpr VecN& operator=(const VecN<U, 3>& xyz) requires (N == 4);
+
+		// Out of range indices give the first component
+		inline constexpr T& operator[](size_t i);
+
+		inline constexpr const T& operator[](size_t i) const;
+
+		inline constexpr VecN operator+(const VecN& b) const;
+		template<typename U> requires (!std::is_same_v<U, T>)
+		inline constexpr VecN operator+(const VecN<U, N>& b) const;
+
+		inline constexpr VecN operator-(const VecN& b) const;
+		template<typename U> requires (!std::is_same_v<U, T>)
+		inline constexpr VecN operator-(const VecN<U, N>& b) const;
 
-		inline constexpr Vec4(const std::string& str);
+		inline constexpr VecN operator-() const;
+
+		inline constexpr VecN operator*(const VecN& b) const;
+		template<typename U> requires (!std::is_same_v<U, T>)
+		inline constexpr VecN operator*(const VecN<U, N>& b) const;
+
+		inline constexpr VecN operator*(T b) const;
+		template<typename U> requires (!std::is_same_v<U, T>)
+		inline constexpr VecN operator*(const U& b) const;
+
+		inline constexpr VecN operator/(T b) const;
+		template<typename U> requires (!std::is_same_v<U, T>)
+		inline constexpr VecN operator/(const U& b) const;
 
 		template<typename U>
-		inline constexpr Vec4 operator=(const Vec3<U>& b);
+		inline constexpr void operator+=(const VecN<U, N>& b);
 
-		inline constexpr Vec4 operator+(const Vec4& b) const;
-		inline constexpr Vec4 operator-(const Vec4& b) const;
-		inline constexpr Vec4 operator-(void) const;
 		template<typename U>
-		inline constexpr Vec4 operator*(const Vec4<U>& b) const;
+		inline constexpr void operator-=(const VecN<U, N>& b);
+
 		template<typename U>
-		inline constexpr Vec4 operator*(const U& b) const;
+		inline constexpr void operator*=(const VecN<U, N>& b);
+
 		template<typename U>
-		inline constexpr Vec4 operator/(const U& b) const;
+		inline constexpr void operator*=(const U& b);
 
-		inline void operator+=(const Vec4& b);
-		inline void operator-=(const Vec4& b);
-		inline void operator*=(const Vec4& b);
 		template<typename U>
-		inline void operator*=(const U& b);
+		inline constexpr void operator/=(const U& b);
+
 		template<typename U>
-		inline void operator/=(const U& b);
+		inline constexpr bool operator==(const VecN<U, N>& b) const;
 
 		template<typename U>
-		inline bool operator==(const Vec4<U>& b) const;
+		inline constexpr bool operator!=(const VecN<U, N>& b) const;
+
+		// Compares x and y only
 		template<typename U>
-		inline bool operator!=(const Vec4<U>& b) const;
+		inline constexpr bool operator==(const VecN<U, 3>& b) const requires (N == 2);
 
-		inline constexpr T& operator[](const size_t a);
-		inline const T& operator[](const size_t a) const;
+		template<typename U>
+		inline constexpr bool operator!=(const VecN<U, 3>& b) const requires (N == 2);
 
-		friend inline std::ostream& operator<<(std::ostream& os, const Vec4<T>& vec)
+		friend inline std::ostream& operator<<(std::ostream& os, const VecN& vec)
 		{
-			os << vec.x << " " << vec.y << " " << vec.z << " " << vec.w;
+			os << vec[0];
+			for (size_t i = 1; i < N; i++)
+				os << " " << vec[i];
 			return os;
 		}
 
-		static inline constexpr Vec4 Right() { return { 1, 0, 0, 0 }; }
-		static inline constexpr Vec4 Up() { return { 0, 1, 0, 0 }; }
-		static inline constexpr Vec4 Forward() { return { 0, 0, 1, 0 }; }
-		static inline constexpr Vec4 Homogeneous() { return { 0, 0, 0, 1 }; }
+		// Summed in component order, so SIMD and scalar builds round the same way
+		inline constexpr T Dot(const VecN& b) const;
 
-		static inline constexpr Vec4 Left() { return { -1, 0, 0, 0 }; }
-		static inline constexpr Vec4 Down() { return { 0, -1, 0, 0 }; }
-		static inline constexpr Vec4 Back() { return { 0, 0, -1, 0 }; }
+		inline constexpr T LengthSquared() const;
 
-		static inline constexpr Vec4 Zero() { return { 0, 0, 0, 0 }; }
-		static inline constexpr Vec4 One() { return { 1, 1, 1, 1 }; }
+		inline T Length() const;
 
-		inline T LengthSquared() const;
+		inline T Distance(const VecN& b) const;
 
-		inline T Length() const;
+		inline VecN GetNormalize() const;
 
-		inline T Dot(const Vec4& a) const;
+		inline void Normalize();
 
-		inline T Distance(const Vec4& a) const;
+		// t is clamped to [0, 1]
+		inline VecN Lerp(const VecN& b, float t) const;
 
-		inline void Homogenize();
+		inline constexpr VecN Min(const VecN& b) const;
 
-		inline Vec4 GetHomogenize() const;
+		inline constexpr VecN Max(const VecN& b) const;
 
-		inline void Normalize();
+		inline VecN Cross(const VecN& b) const requires (N == 3);
 
-		inline Vec4 GetNormalize() const;
+		// Products of the crossed components, x * b.y and y * b.x
+		inline VecN Cross(const VecN& b) const requires (N == 2);
 
-		inline void Print(int precision = 6) const;
+		// Rotated a quarter turn counterclockwise
+		inline VecN Ortho() const requires (N == 2);
+
+		// x, y and z divided by w, w becomes 0
+		inline VecN GetHomogenize() const requires (N == 4);
+
+		inline void Homogenize() requires (N == 4);
 
-		inline Vec3<T> ToVector3() const;
+		inline VecN<T, 3> ToVector3() const requires (N == 4);
+
+		// Euler angles in degrees to a rotation
+		inline QuatT<std::conditional_t<std::is_floating_point_v<T>, T, float>> ToQuaternion() const requires (N == 3);
+
+		inline VecN<float, 2> ToVec2f() const requires (N == 2);
+
+		inline VecN<int, 2> ToVec2i() const requires (N == 2);
+
+		inline void Print(int precision = 6) const;
 
 		inline std::string ToString(int precision = 6) const;
 
-		T* Data() const;
+		inline T* Data() const;
+
+		// Components I... in that order, a single shuffle for the SSE vectors; MATH_SWIZZLES names them for Vec2, Vec3 and Vec4
+		template<size_t... I>
+		inline constexpr typename VecOf<T, sizeof...(I)>::Type Swizzle() const;
+
+		// Writable view of the components I..., which must all differ to be assigned
+		template<size_t... I>
+		inline constexpr SwizzleView<VecN, I...> View();
+
+		static inline constexpr VecN Zero() { return VecN(); }
+
+		static inline constexpr VecN One() { return VecN(static_cast<T>(1)); }
+
+		// Unit vector along axis
+		static inline constexpr VecN Axis(size_t axis);
+
+		// Directions of a frame looking down -z, w is 0
+		static inline constexpr VecN Right() requires (N == 3 || N == 4) { return Axis(0); }
+		static inline constexpr VecN Up() requires (N == 3 || N == 4) { return Axis(1); }
+		static inline constexpr VecN Forward() requires (N == 3 || N == 4) { return Generate([](size_t i) { return i == 2 ? -1 : 0; }); }
+
+		static inline constexpr VecN Left() requires (N == 3 || N == 4) { return Generate([](size_t i) { return i == 0 ? -1 : 0; }); }
+		static inline constexpr VecN Down() requires (N == 3 || N == 4) { return Generate([](size_t i) { return i == 1 ? -1 : 0; }); }
+		static inline constexpr VecN Back() requires (N == 3 || N == 4) { return Axis(2); }
+
+		static inline constexpr VecN Homogeneous() requires (N == 4) { return Axis(3); }
+
+		// Vector whose component i is generator(i)
+		template<typename Function>
+		static inline constexpr VecN Generate(Function generator);
 
 #ifdef MATH_GLM_EXTENSION
-		inline glm::vec4 ToGlm() const { return glm::vec4(x, y, z, w); }
+		inline glm::vec<N, float> ToGlm() const requires (N >= 2 && N <= 4);
+
+		inline bool operator==(const glm::vec<N, float>& b) const requires (N >= 2 && N <= 4);
+#endif
+
+	private:
+		template<typename Function, size_t... I>
+		static inline constexpr VecN Generate(Function generator, std::index_sequence<I...>);
+
+		template<typename Function, size_t... I>
+		static inline constexpr T Fold(Function term, std::index_sequence<I...>);
 
-		inline bool operator==(const glm::vec4& b) const { return AlmostEqual(x, b.x) && AlmostEqual(y, b.y) && AlmostEqual(z, b.z) && AlmostEqual(w, b.w); }
+		template<typename Function>
+		static inline constexpr T Fold(Function term);
+
+		// True when the operation runs on an SSE register
+		static constexpr bool simd =
+#if defined(MATH_SSE)
+			std::is_same_v<T, float> && (N == 3 || N == 4);
+#else
+			false;
 #endif
 	};
 
+	template<typename T, typename... U>
+	VecN(T, U...) -> VecN<T, 1 + sizeof...(U)>;
+
+	typedef Vec2<float> Vec2f;
+	typedef Vec2<double> Vec2d;
+	typedef Vec2<int> Vec2i;
+	typedef Vec2<Half> Vec2h;
+
+	typedef Vec3<float> Vec3f;
+	typedef Vec3<int> Vec3i;
+	typedef Vec3<double> Vec3d;
+	typedef Vec3<Half> Vec3h;
 
 	typedef Vec4<float> Vec4f;
 	typedef Vec4<int> Vec4i;
 	typedef Vec4<double> Vec4d;
+	typedef Vec4<Half> Vec4h;
 #pragma endregion
 
-	class Mat4
+	// Flat conversions of count scalars, using F16C / SSE when available.
+	inline void ConvertBatch(const float* input, Half* output, size_t count);
+	inline void ConvertBatch(const Half* input, float* output, size_t count);
+	inline void ConvertBatch(const float* input, Fixed16_16* output, size_t count);
+	inline void ConvertBatch(const Fixed16_16* input, float* output, size_t count);
+
+	// Converts vector streams to and from their compact storage types, output must be at least as large as input.
+	inline void ConvertBatch(std::span<const Vec3f> input, std::span<Vec3h> output);
+	inline void ConvertBatch(std::span<const Vec3h> input, std::span<Vec3f> output);
+	inline void ConvertBatch(std::span<const Vec4f> input, std::span<Vec4h> output);
+	inline void ConvertBatch(std::span<const Vec4h> input, std::span<Vec4f> output);
+	inline void ConvertBatch(std::span<const Vec3f> input, std::span<Vec3<Fixed16_16>> output);
+	inline void ConvertBatch(std::span<const Vec3<Fixed16_16>> input, std::span<Vec3f> output);
+
+	template<typename T>
+	class Mat4T
 	{
 	public:
 		/* data of the matrix : content[y][x]
@@ -333,75 +553,79 @@ namespace GALAXY::Math
 		 *
 		*/
 
-		Vec4f content[4];
+		Vec4<T> content[4];
 
-		inline constexpr Mat4() {}
+		inline constexpr Mat4T() {}
 
-		inline constexpr Mat4(float diagonal);
+		inline constexpr Mat4T(T diagonal);
 
-		inline constexpr Mat4(Vec4f m0, Vec4f m1, Vec4f m2, Vec4f m3);
+		inline constexpr Mat4T(Vec4<T> m0, Vec4<T> m1, Vec4<T> m2, Vec4<T> m3);
 
-		inline constexpr Mat4(const float* data);
+		inline constexpr Mat4T(const float* data);
 
-		inline constexpr Mat4(const double* data);
+		inline constexpr Mat4T(const double* data);
 
-		inline constexpr Mat4 operator*(const Mat4& a) const;
+		// Explicit, converting between precisions may round
+		template<typename U>
+		explicit inline constexpr Mat4T(const Mat4T<U>& a);
+
+		inline constexpr Mat4T operator*(const Mat4T& a) const;
 
 		template<typename U>
 		inline constexpr Vec4<U> operator*(const Vec4<U>& a) const;
 
-		inline constexpr Mat4 operator+(const Mat4& a) const;
+		inline constexpr Mat4T operator+(const Mat4T& a) const;
 
-		inline constexpr Vec4f& operator[](size_t i);
+		inline constexpr Vec4<T>& operator[](size_t i);
 
-		inline constexpr bool operator==(const Mat4& b) const;
+		inline constexpr bool operator==(const Mat4T& b) const;
 
-		static constexpr Mat4 Identity() { return { 1.f }; }
+		static constexpr Mat4T Identity() { return { 1 }; }
 
-		static inline Mat4 CreateProjectionMatrix(float _fov, float _aspect, float _near, float _far);
+		static inline Mat4T CreateProjectionMatrix(T _fov, T _aspect, T _near, T _far);
 
-		static inline Mat4 CreateOrthographicMatrix(float _left, float _right, float _bottom, float _top, float _near, float _far);
+		static inline Mat4T CreateOrthographicMatrix(T _left, T _right, T _bottom, T _top, T _near, T _far);
 		
-		static inline Mat4 CreateViewMatrix(const Vec3f position, const Quat& rotation);
+		static inline Mat4T CreateViewMatrix(const Vec3<T> position, const QuatT<T>& rotation);
 
 		template<typename U>
-		static inline Mat4 CreateTranslationMatrix(const Vec3<U>& translation);
+		static inline Mat4T CreateTranslationMatrix(const Vec3<U>& translation);
 
 		template<typename U>
-		static inline Mat4 CreateRotationMatrix(const Vec3<U>& rotation);
-		static inline Mat4 CreateRotationMatrix(const Quat& rotation);
+		static inline Mat4T CreateRotationMatrix(const Vec3<U>& rotation);
+		static inline Mat4T CreateRotationMatrix(const QuatT<T>& rotation);
 
 		template<typename U>
-		static inline Mat4 CreateScaleMatrix(const Vec3<U>& scale);
+		static inline Mat4T CreateScaleMatrix(const Vec3<U>& scale);
 
 		template<typename U>
-		static inline Mat4 CreateTransformMatrix(const Vec3<U>& position, const Vec3<U>& rotation, const Vec3<U>& scale);
+		static inline Mat4T CreateTransformMatrix(const Vec3<U>& position, const Vec3<U>& rotation, const Vec3<U>& scale);
 		template<typename U>
-		static inline Mat4 CreateTransformMatrix(const Vec3<U>& position, const Quat& rotation, const Vec3<U>& scale);
+		static inline Mat4T CreateTransformMatrix(const Vec3<U>& position, const QuatT<T>& rotation, const Vec3<U>& scale);
 
-		inline void DecomposeTransformMatrix(Vec3f& position, Quat& rotation, Vec3f& scale) const;
+		inline void DecomposeTransformMatrix(Vec3<T>& position, QuatT<T>& rotation, Vec3<T>& scale) const;
 
-		inline Vec3f GetTranslation() const;
+		inline Vec3<T> GetTranslation() const;
 
-		inline Quat GetRotation() const;
+		inline QuatT<T> GetRotation() const;
 
-		inline Vec3f GetScale() const;
+		inline Vec3<T> GetScale() const;
 
-		inline Mat4 CreateInverseMatrix() const;
+		inline Mat4T CreateInverseMatrix() const;
 
-		inline Mat4 CreateAdjMatrix() const;
+		inline Mat4T CreateAdjMatrix() const;
 
-		inline Mat4 GetCofactor(int p, int q, int n) const;
+		inline Mat4T GetCofactor(int p, int q, int n) const;
 
-		inline float GetDeterminant(float n) const;
+		inline T GetDeterminant(int n) const;
 
-		inline Mat4 GetTranspose() const;
+		inline Mat4T GetTranspose() const;
 
 		inline void Print() const;
 
 		inline std::string ToString() const;
 
-		inline Mat4 ToRotationMatrix() const;
+		inline Mat4T ToRotationMatrix() const;
 
 		// Transforms a position by this matrix, without a perspective divide. (fast)
 		template<typename U>
@@ -411,10 +635,10 @@ namespace GALAXY::Math
 		template<typename U>
 		inline Vec3<U> MultiplyVector(Vec3<U> vector);		
 
-		inline float* Data() const;
+		inline T* Data() const;
 
 #ifdef MATH_GLM_EXTENSION
-		inline Mat4(const glm::mat4& mat);
+		inline Mat4T(const glm::mat4& mat);
 
 		inline glm::mat4 ToGlm() const;
 
@@ -422,81 +646,102 @@ namespace GALAXY::Math
 #endif
 	};
 
-	class Quat
+	typedef Mat4T<float> Mat4f;
+	typedef Mat4T<double> Mat4d;
+
+	// Rebases double precision world matrices around cameraPosition and converts them to float in a single pass,
+	// so far away objects keep their precision once they reach the renderer.
+	inline void RebaseToCamera(std::span<const Mat4d> world, const Vec3d& cameraPosition, std::span<Mat4f> output);
+
+	template<typename T>
+	class QuatT
 	{
 	public:
-		float x;
-		float y;
-		float z;
-		float w;
+		T x;
+		T y;
+		T z;
+		T w;
 
-		inline constexpr Quat() : x(0), y(0), z(0), w(1) {}
+		inline constexpr QuatT() : x(0), y(0), z(0), w(1) {}
 
-		inline constexpr Quat(float a) : x(a), y(a), z(a), w(a) {}
+		inline constexpr QuatT(T a) : x(a), y(a), z(a), w(a) {}
 
-		inline constexpr Quat(float a, float b, float c, float d = 1) : x(a), y(b), z(c), w(d) {}
+		inline constexpr QuatT(T a, T b, T c, T d = 1) : x(a), y(b), z(c), w(d) {}
 
-		inline Quat(const std::string& str);
+		inline QuatT(const std::string& str);
 
 		template<typename U>
-		inline constexpr Quat(const Vec3<U>& a) : x(a.x), y(a.y), z(a.z), w(1.f) {}
+		inline constexpr QuatT(const Vec3<U>& a) : x(a.x), y(a.y), z(a.z), w(1) {}
 
 		template<typename U>
-		inline constexpr Quat(const Vec4<U>& a) : x(a.x), y(a.y), z(a.z), w(a.w) {}
+		inline constexpr QuatT(const Vec4<U>& a) : x(a.x), y(a.y), z(a.z), w(a.w) {}
 
-		inline constexpr Quat operator+(const Quat& a) const;
+		template<typename U>
+		explicit inline constexpr QuatT(const QuatT<U>& a) : x(static_cast<T>(a.x)), y(static_cast<T>(a.y)), z(static_cast<T>(a.z)), w(static_cast<T>(a.w)) {}
+
+		inline constexpr QuatT operator+(const QuatT& a) const;
 
-		inline constexpr Quat operator-(const Quat& a) const;
+		inline constexpr QuatT operator-(const QuatT& a) const;
 
-		inline constexpr Quat operator*(const Quat& a) const;
+		inline constexpr QuatT operator*(const QuatT& a) const;
 
-		inline constexpr Quat operator*(float a) const;
+		inline constexpr QuatT operator*(T a) const;
 
 		template<typename U>
 		inline constexpr Vec3<U> operator*(const Vec3<U>& a) const;
 
-		inline void operator*=(const Quat& a);
+		// Below this batch size, Rotate uses operator* instead of building the rotation basis.
+		static constexpr size_t RotateBasisThreshold = 4;
+
+		// Rotates every vector of input into output, input and output can be the same span.
+		// Only min(input.size(), output.size()) vectors are rotated, the rest of the longer span is left alone.
+		inline void Rotate(std::span<const Vec3<T>> input, std::span<Vec3<T>> output) const;
 
-		inline void operator*=(float a);
+		inline void operator*=(const QuatT& a);
 
-		inline bool operator==(const Quat& a) const;
-		inline bool operator!=(const Quat& a) const;
+		inline void operator*=(T a);
 
-		inline float& operator[](const size_t index);
+		inline bool operator==(const QuatT& a) const;
+		inline bool operator!=(const QuatT& a) const;
 
-		static inline constexpr Quat Identity() { return Quat(0, 0, 0, 1); }
+		inline T& operator[](const size_t index);
+
+		static inline constexpr QuatT Identity() { return QuatT(0, 0, 0, 1); }
 
 		template<typename U>
-		static inline constexpr Quat AngleAxis(float angle, Vec3<U> axis);
+		static inline constexpr QuatT AngleAxis(T angle, Vec3<U> axis);
 
 		template<typename U>
-		static inline constexpr Quat FromEuler(const Vec3<U>& euler);
+		static inline constexpr QuatT FromEuler(const Vec3<U>& euler);
 
 		template<typename U>
-		static inline Quat LookRotation(Vec3<U> forward, Vec3<U> up);
+		static inline QuatT LookRotation(Vec3<U> forward, Vec3<U> up);
 
-		static inline Quat SLerp(const Quat& a, const Quat& b, float time);
+		static inline QuatT SLerp(const QuatT& a, const QuatT& b, T time);
 
 		inline void Inverse();
 
-		inline Quat GetInverse() const;
+		inline QuatT GetInverse() const;
 
 		inline void Normalize();
 
-		inline Quat GetNormalize() const;
+		inline QuatT GetNormalize() const;
 
 		inline void Conjugate();
 
-		inline Quat GetConjugate() const;
+		inline QuatT GetConjugate() const;
 
-		inline float Dot(const Quat& a) const;
+		inline T Dot(const QuatT& a) const;
 
 		template<typename U>
 		inline Vec3<U> ToEuler() const;
 
-		inline Vec3f ToEuler() const;
+		inline Vec3<T> ToEuler() const;
+
+		inline Mat4T<T> ToRotationMatrix() const;
 
-		inline Mat4 ToRotationMatrix() const;
+		// Axes of the rotation matrix, rotating v is then xAxis * v.x + yAxis * v.y + zAxis * v.z.
+		inline constexpr void GetBasis(Vec3<T>& xAxis, Vec3<T>& yAxis, Vec3<T>& zAxis) const;
 
 		inline void Print() const;
 
@@ -509,6 +754,8 @@ namespace GALAXY::Math
 #endif
 	};
 
+	typedef QuatT<float> Quatf;
+	typedef QuatT<double> Quatd;
 }
 
 using namespace GALAXY::Math;
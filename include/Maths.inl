@@ -5,6 +5,8 @@
 #include <cfloat>
 #include <algorithm>
 #include <type_traits>
+#include <bit>
+#include <limits>
 
 #include "Maths.h"
 
@@ -12,714 +14,1357 @@ namespace GALAXY::Math {
 #pragma region Math Functions
 
 	template<typename T>
-	bool AlmostEqual(T a, T b, float diff /*= 1e-5f*/)
+	inline constexpr bool AlmostEqual(T a, T b, float diff /*= 1e-5f*/)
 	{
-		T absoluteDiff = std::abs(a - b);
+		// Written without std::abs so storage types like Fixed16_16 compare too
+		T absoluteDiff = a > b ? a - b : b - a;
 		return absoluteDiff <= diff;
 	}
 
-#pragma endregion
-
-#pragma region Vec2
 	template<typename T>
-	template<typename U>
-	inline constexpr Vec2<T>::Vec2(const Vec2<U>& a)
+	inline constexpr T ToRadians(T degrees)
 	{
-		x = static_cast<T>(a.x);
-		y = static_cast<T>(a.y);
+		return degrees / static_cast<T>(180) * Pi<T>;
 	}
 
 	template<typename T>
-	template<typename U>
-	inline constexpr Vec2<T>::Vec2(const Vec3<U>& a)
+	inline constexpr T ToDegrees(T radians)
 	{
-		x = static_cast<T>(a.x);
-		y = static_cast<T>(a.y);
+		return radians * static_cast<T>(180) / Pi<T>;
 	}
 
 	template<typename T>
-	inline constexpr Vec2<T>::Vec2(const std::string& str)
+	inline constexpr T Sin(T x)
 	{
-		std::istringstream ss(str);
-
-		char discard;
-		ss >> this->x >> discard >> this->y;
+#ifdef MATH_DETERMINISTIC
+		return static_cast<T>(Deterministic::Sin(static_cast<double>(x)));
+#else
+		return static_cast<T>(std::sin(x));
+#endif
 	}
 
 	template<typename T>
-	template<typename U>
-	inline constexpr Vec2<T> Vec2<T>::operator=(const Vec2<U>& a)
+	inline constexpr T Cos(T x)
 	{
-		x = static_cast<T>(a.x);
-		y = static_cast<T>(a.y);
-		return *this;
+#ifdef MATH_DETERMINISTIC
+		return static_cast<T>(Deterministic::Cos(static_cast<double>(x)));
+#else
+		return static_cast<T>(std::cos(x));
+#endif
 	}
 
 	template<typename T>
-	template<typename U>
-	inline constexpr Vec2<T> Vec2<T>::operator=(const Vec3<U>& a)
+	inline constexpr T Tan(T x)
 	{
-		return Vec2(a);
+#ifdef MATH_DETERMINISTIC
+		return static_cast<T>(Deterministic::Tan(static_cast<double>(x)));
+#else
+		return static_cast<T>(std::tan(x));
+#endif
 	}
 
 	template<typename T>
-	template<typename U>
-	inline constexpr Vec2<T> Vec2<T>::operator+(const Vec2<U>& a) const
+	inline T Asin(T x)
 	{
-		return { static_cast<T>(x + a.x), static_cast<T>(y + a.y) };
+#ifdef MATH_DETERMINISTIC
+		return static_cast<T>(Deterministic::Asin(static_cast<double>(x)));
+#else
+		return static_cast<T>(std::asin(x));
+#endif
 	}
 
 	template<typename T>
-	template<typename U>
-	inline void Vec2<T>::operator+=(const Vec2<U>& a)
+	inline T Acos(T x)
 	{
-		*this = operator+(a);
+#ifdef MATH_DETERMINISTIC
+		return static_cast<T>(Deterministic::Acos(static_cast<double>(x)));
+#else
+		return static_cast<T>(std::acos(x));
+#endif
 	}
 
 	template<typename T>
-	template<typename U>
-	inline constexpr Vec2<T> Vec2<T>::operator-(const Vec2<U>& a) const
+	inline constexpr T Atan(T x)
 	{
-		return { static_cast<T>(x - a.x), static_cast<T>(y - a.y) };
+#ifdef MATH_DETERMINISTIC
+		return static_cast<T>(Deterministic::Atan(static_cast<double>(x)));
+#else
+		return static_cast<T>(std::atan(x));
+#endif
 	}
 
 	template<typename T>
-	template<typename U>
-	inline void Vec2<T>::operator-=(const Vec2<U>& a)
+	inline constexpr T Atan2(T y, T x)
 	{
-		*this = operator-(a);
+#ifdef MATH_DETERMINISTIC
+		return static_cast<T>(Deterministic::Atan2(static_cast<double>(y), static_cast<double>(x)));
+#else
+		return static_cast<T>(std::atan2(y, x));
+#endif
 	}
 
 	template<typename T>
-	inline constexpr Vec2<T> Vec2<T>::operator-(void) const
+	inline T Sqrt(T x)
 	{
-		return { -x, -y };
+		return static_cast<T>(std::sqrt(x));
 	}
 
-	template<typename T>
-	template<typename U>
-	inline constexpr Vec2<T> Vec2<T>::operator*(const U& a) const
+#pragma endregion
+
+#pragma region Deterministic
+	namespace Deterministic
 	{
-		return { static_cast<T>(x * a), static_cast<T>(y * a) };
+		// Clang contracts within expressions by default, the kernels below must keep their rounding steps.
+#if defined(__clang__)
+#define MATH_STRICT_FP _Pragma("clang fp contract(off)")
+#else
+#define MATH_STRICT_FP
+#endif
+
+		inline constexpr double KernelSin(double x, double y)
+		{
+			MATH_STRICT_FP
+			constexpr double S1 = -1.66666666666666324348e-01;
+			constexpr double S2 = 8.33333333332248946124e-03;
+			constexpr double S3 = -1.98412698298579493134e-04;
+			constexpr double S4 = 2.75573137070700676789e-06;
+			constexpr double S5 = -2.50507602534068634195e-08;
+			constexpr double S6 = 1.58969099521155010221e-10;
+
+			double z = x * x;
+			double w = z * z;
+			double r = S2 + z * (S3 + z * S4) + z * w * (S5 + z * S6);
+			double v = z * x;
+			return x - ((z * (0.5 * y - v * r) - y) - v * S1);
+		}
+
+		inline constexpr double KernelCos(double x, double y)
+		{
+			MATH_STRICT_FP
+			constexpr double C1 = 4.16666666666666019037e-02;
+			constexpr double C2 = -1.38888888888741095749e-03;
+			constexpr double C3 = 2.48015872894767294178e-05;
+			constexpr double C4 = -2.75573143513906633035e-07;
+			constexpr double C5 = 2.08757232129817482790e-09;
+			constexpr double C6 = -1.13596475577881948265e-11;
+
+			double z = x * x;
+			double w = z * z;
+			double r = z * (C1 + z * (C2 + z * C3)) + w * w * (C4 + z * (C5 + z * C6));
+			double hz = 0.5 * z;
+			w = 1.0 - hz;
+			return w + (((1.0 - w) - hz) + (z * r - x * y));
+		}
+
+		// Cody-Waite reduction of x to y0 + y1 in [-pi/4, pi/4], returns the quadrant.
+		// Exact while |x| < 2^20 * pi/2, past that it loses accuracy but stays deterministic.
+		inline constexpr int ReducePiOver2(double x, double& y0, double& y1)
+		{
+			MATH_STRICT_FP
+			constexpr double invPiOver2 = 6.36619772367581382433e-01;
+			constexpr double piOver2_1 = 1.57079632673412561417e+00;
+			constexpr double piOver2_2 = 6.07710050630396597660e-11;
+			constexpr double piOver2_2t = 2.02226624879595063154e-21;
+			constexpr double piOver2_3 = 2.02226624871116645580e-21;
+			constexpr double piOver2_3t = 8.47842766036889956997e-32;
+
+			double fn = x * invPiOver2;
+			const int64_t n = static_cast<int64_t>(fn + (fn >= 0.0 ? 0.5 : -0.5));
+			fn = static_cast<double>(n);
+
+			double r = x - fn * piOver2_1;
+			double t = r;
+			double w = fn * piOver2_2;
+			r = t - w;
+			w = fn * piOver2_2t - ((t - r) - w);
+			t = r;
+			w = fn * piOver2_3;
+			r = t - w;
+			w = fn * piOver2_3t - ((t - r) - w);
+
+			y0 = r - w;
+			y1 = (r - y0) - w;
+			return static_cast<int>(n & 3);
+		}
+
+		// Past 2^52 consecutive doubles are whole integers apart and the reduction above has no phase left to recover.
+		inline constexpr bool IsTrigDomain(double x)
+		{
+			return x > -4503599627370496.0 && x < 4503599627370496.0;
+		}
+
+		inline constexpr double Sin(double x)
+		{
+			if (!IsTrigDomain(x))
+				return x == x ? (x - x) / (x - x) : x;
+			if (x > -0.785398163397448279 && x < 0.785398163397448279)
+				return KernelSin(x, 0.0);
+
+			double y0 = 0.0, y1 = 0.0;
+			switch (ReducePiOver2(x, y0, y1))
+			{
+			case 0: return KernelSin(y0, y1);
+			case 1: return KernelCos(y0, y1);
+			case 2: return -KernelSin(y0, y1);
+			default: return -KernelCos(y0, y1);
+			}
+		}
+
+		inline constexpr double Cos(double x)
+		{
+			if (!IsTrigDomain(x))
+				return x == x ? (x - x) / (x - x) : x;
+			if (x > -0.785398163397448279 && x < 0.785398163397448279)
+				return KernelCos(x, 0.0);
+
+			double y0 = 0.0, y1 = 0.0;
+			switch (ReducePiOver2(x, y0, y1))
+			{
+			case 0: return KernelCos(y0, y1);
+			case 1: return -KernelSin(y0, y1);
+			case 2: return -KernelCos(y0, y1);
+			default: return KernelSin(y0, y1);
+			}
+		}
+
+		inline constexpr double Tan(double x)
+		{
+			if (!IsTrigDomain(x))
+				return x == x ? (x - x) / (x - x) : x;
+
+			double y0 = x, y1 = 0.0;
+			int quadrant = 0;
+			if (!(x > -0.785398163397448279 && x < 0.785398163397448279))
+				quadrant = ReducePiOver2(x, y0, y1);
+			if (quadrant & 1)
+				return -KernelCos(y0, y1) / KernelSin(y0, y1);
+			return KernelSin(y0, y1) / KernelCos(y0, y1);
+		}
+
+		inline constexpr double Atan(double x)
+		{
+			MATH_STRICT_FP
+			constexpr double atanHi[] = { 4.63647609000806093515e-01, 7.85398163397448278999e-01, 9.82793723247329054082e-01, 1.57079632679489655800e+00 };
+			constexpr double atanLo[] = { 2.26987774529616870924e-17, 3.06161699786838301793e-17, 1.39033110312309984516e-17, 6.12323399573676603587e-17 };
+			constexpr double aT[] = {
+				3.33333333333329318027e-01, -1.99999999998764832476e-01, 1.42857142725034663711e-01,
+				-1.11111104054623557880e-01, 9.09088713343650656196e-02, -7.69187620504482999495e-02,
+				6.66107313738753120669e-02, -5.83357013379057348645e-02, 4.97687799461593236017e-02,
+				-3.65315727442169155270e-02, 1.62858201153657823623e-02 };
+
+			if (x != x)
+				return x;
+			const bool negative = x < 0.0;
+			double ax = negative ? -x : x;
+			if (ax >= 7.37869762948382064640e+19) // 2^66, atan is pi/2 to double precision
+				return negative ? -(atanHi[3] + atanLo[3]) : atanHi[3] + atanLo[3];
+
+			int id = -1;
+			if (ax < 0.4375)
+			{
+				if (ax < 7.45058059692382812500e-09) // 2^-27
+					return x;
+			}
+			else if (ax < 1.1875)
+			{
+				if (ax < 0.6875)
+				{
+					id = 0;
+					x = (2.0 * ax - 1.0) / (2.0 + ax);
+				}
+				else
+				{
+					id = 1;
+					x = (ax - 1.0) / (ax + 1.0);
+				}
+			}
+			else if (ax < 2.4375)
+			{
+				id = 2;
+				x = (ax - 1.5) / (1.0 + 1.5 * ax);
+			}
+			else
+			{
+				id = 3;
+				x = -1.0 / ax;
+			}
+
+			double z = x * x;
+			double w = z * z;
+			double s1 = z * (aT[0] + w * (aT[2] + w * (aT[4] + w * (aT[6] + w * (aT[8] + w * aT[10])))));
+			double s2 = w * (aT[1] + w * (aT[3] + w * (aT[5] + w * (aT[7] + w * aT[9]))));
+			if (id < 0)
+				return x - x * (s1 + s2);
+
+			z = atanHi[id] - ((x * (s1 + s2) - atanLo[id]) - x);
+			return negative ? -z : z;
+		}
+
+		inline constexpr double Atan2(double y, double x)
+		{
+			MATH_STRICT_FP
+			constexpr double pi = 3.1415926535897931160E+00;
+			constexpr double piLo = 1.2246467991473531772E-16;
+			constexpr double piOver2 = 1.5707963267948965580E+00;
+			constexpr double piOver4 = 7.8539816339744827900E-01;
+			constexpr double infinity = std::numeric_limits<double>::infinity();
+			auto withSign = [](double value, bool negative) { return negative ? -value : value; };
+
+			if (x != x || y != y)
+				return x + y;
+			const bool yNegative = (std::bit_cast<uint64_t>(y) >> 63) != 0;
+			if (y == 0.0)
+			{
+				if (x > 0.0 || (x == 0.0 && (std::bit_cast<uint64_t>(x) >> 63) == 0))
+					return y;
+				return withSign(pi, yNegative);
+			}
+			if (x == 0.0)
+				return withSign(piOver2, yNegative);
+			if (x == infinity || x == -infinity)
+			{
+				if (y == infinity || y == -infinity)
+					return withSign(x > 0.0 ? piOver4 : 3.0 * piOver4, yNegative);
+				return withSign(x > 0.0 ? 0.0 : pi, yNegative);
+			}
+			if (y == infinity || y == -infinity)
+				return withSign(piOver2, yNegative);
+
+			double ratio = y / x;
+			double z = Atan(ratio < 0.0 ? -ratio : ratio);
+			if (x > 0.0)
+				return withSign(z, yNegative);
+			return withSign(pi - (z - piLo), yNegative);
+		}
+
+		inline double Sqrt(double x)
+		{
+			return std::sqrt(x);
+		}
+
+		inline double Asin(double x)
+		{
+			return Atan2(x, Sqrt((1.0 - x) * (1.0 + x)));
+		}
+
+		inline double Acos(double x)
+		{
+			return Atan2(Sqrt((1.0 - x) * (1.0 + x)), x);
+		}
+#undef MATH_STRICT_FP
 	}
 
-	template<typename T>
-	template<typename U>
-	inline constexpr Vec2<T> Vec2<T>::operator*(const Vec2<U>& a) const
+#pragma endregion
+
+#pragma region Scalar Types
+	inline constexpr Half Half::FromBits(uint16_t bits)
 	{
-		return { static_cast<T>(x * a.x), static_cast<T>(y * a.y) };
+		Half half;
+		half.bits = bits;
+		return half;
 	}
 
-	template<typename T>
-	template<typename U>
-	inline void Vec2<T>::operator*=(const Vec2<U>& a)
+	inline constexpr uint16_t Half::FromFloat(float value)
 	{
-		*this = operator*(a);
+		constexpr uint32_t infinity = 255u << 23;
+		constexpr uint32_t halfMax = (127u + 16u) << 23;
+		constexpr uint32_t denormalMagic = ((127u - 15u) + (23u - 10u) + 1u) << 23;
+
+		uint32_t f = std::bit_cast<uint32_t>(value);
+		const uint32_t sign = f & 0x80000000u;
+		f ^= sign;
+
+		uint32_t result;
+		if (f >= halfMax)
+		{
+			// Inf stays Inf, NaN becomes a quiet NaN
+			result = f > infinity ? 0x7e00u : 0x7c00u;
+		}
+		else if (f < (113u << 23))
+		{
+			// Denormal or zero: the float addition aligns and rounds the 10 mantissa bits
+			float aligned = std::bit_cast<float>(f) + std::bit_cast<float>(denormalMagic);
+			result = std::bit_cast<uint32_t>(aligned) - denormalMagic;
+		}
+		else
+		{
+			const uint32_t mantissaOdd = (f >> 13) & 1u;
+			f += ((15u - 127u) << 23) + 0xfffu;
+			f += mantissaOdd;
+			result = f >> 13;
+		}
+		return static_cast<uint16_t>(result | (sign >> 16));
 	}
 
-	template<typename T>
-	template<typename U>
-	inline void Vec2<T>::operator*=(const U& a)
+	inline constexpr float Half::ToFloat(uint16_t bits)
 	{
-		*this = operator*(a);
+		constexpr uint32_t shiftedExponent = 0x7c00u << 13;
+
+		uint32_t f = (bits & 0x7fffu) << 13;
+		const uint32_t exponent = shiftedExponent & f;
+		f += (127u - 15u) << 23;
+
+		if (exponent == shiftedExponent)
+		{
+			// Inf or NaN
+			f += (128u - 16u) << 23;
+		}
+		else if (exponent == 0)
+		{
+			// Zero or denormal, renormalize
+			f += 1u << 23;
+			f = std::bit_cast<uint32_t>(std::bit_cast<float>(f) - std::bit_cast<float>(113u << 23));
+		}
+		return std::bit_cast<float>(f | (static_cast<uint32_t>(bits & 0x8000u) << 16));
 	}
 
-	template<typename T>
-	template<typename U>
-	inline constexpr Vec2<T> Vec2<T>::operator/(const U& a) const
+	template<typename U> requires std::is_arithmetic_v<U>
+	inline constexpr Fixed16_16::Fixed16_16(U value)
 	{
-		return { x / a, y / a };
+		if constexpr (std::is_integral_v<U>)
+		{
+			if (std::is_signed_v<U> ? static_cast<int64_t>(value) > 32767 : static_cast<uint64_t>(value) > 32767u)
+				raw = INT32_MAX;
+			else if (std::is_signed_v<U> && static_cast<int64_t>(value) < -32768)
+				raw = INT32_MIN;
+			else
+				raw = static_cast<int32_t>(value) * One;
+		}
+		else
+		{
+			// Round to nearest even, same as the SSE conversion, which the batch conversion also saturates
+			double scaled = static_cast<double>(value) * One;
+			if (scaled != scaled)
+			{
+				raw = 0;
+				return;
+			}
+			if (scaled >= 2147483648.0 || scaled <= -2147483648.0)
+			{
+				raw = scaled > 0.0 ? INT32_MAX : INT32_MIN;
+				return;
+			}
+			int64_t truncated = static_cast<int64_t>(scaled);
+			double fraction = scaled - static_cast<double>(truncated);
+			if (fraction > 0.5 || (fraction == 0.5 && (truncated & 1)))
+				truncated++;
+			else if (fraction < -0.5 || (fraction == -0.5 && (truncated & 1)))
+				truncated--;
+			raw = Saturate(truncated).raw;
+		}
 	}
 
-	template<typename T>
-	template<typename U>
-	inline void Vec2<T>::operator/=(const U& a)
+	template<typename U> requires std::is_arithmetic_v<U>
+	inline constexpr Fixed16_16::operator U() const
 	{
-		*this = operator/(a);
+		if constexpr (std::is_integral_v<U>)
+			return static_cast<U>(raw / One);
+		else
+			return static_cast<U>(raw) / static_cast<U>(One);
 	}
 
-	template<typename T>
-	template<typename U>
-	inline constexpr bool Vec2<T>::operator==(const Vec2<U>& a) const
+	inline constexpr Fixed16_16 Fixed16_16::FromRaw(int32_t raw)
 	{
-		// "this" vector has the authority for the type comparison
-		return AlmostEqual(x, static_cast<T>(a.x)) && AlmostEqual(y, static_cast<T>(a.y));
+		Fixed16_16 value;
+		value.raw = raw;
+		return value;
 	}
 
-	template<typename T>
-	template<typename U>
-	inline constexpr bool Vec2<T>::operator==(const Vec3<U>& b) const
+	inline constexpr Fixed16_16 Fixed16_16::Saturate(int64_t raw)
 	{
-		// "this" vector has the authority for the type comparison
-		return AlmostEqual(x, static_cast<T>(b.x)) && AlmostEqual(y, static_cast<T>(b.y));
+		return FromRaw(static_cast<int32_t>(std::clamp<int64_t>(raw, INT32_MIN, INT32_MAX)));
 	}
 
-	template<typename T>
-	template<typename U>
-	bool constexpr Vec2<T>::operator!=(const Vec2<U>& a) const
+	inline std::ostream& operator<<(std::ostream& os, Fixed16_16 value)
 	{
-		// "this" vector has the authority for the type comparison
-		return !AlmostEqual(x, static_cast<T>(a.x)) || !AlmostEqual(y, static_cast<T>(a.y));
+		return os << static_cast<double>(value);
 	}
 
-	template<typename T>
-	template<typename U>
-	inline constexpr bool Vec2<T>::operator!=(const Vec3<U>& b) const
+	inline std::istream& operator>>(std::istream& is, Fixed16_16& value)
 	{
-		return !AlmostEqual(x, static_cast<T>(b.x)) || !AlmostEqual(y, static_cast<T>(b.y));
+		double read = 0;
+		is >> read;
+		value = read;
+		return is;
 	}
+#pragma endregion
 
-	template<typename T>
-	inline T& Vec2<T>::operator[](const size_t a)
+#pragma region SIMD
+	namespace Simd
 	{
-		if (a >= 2)
-			// Return first value of the vector if not valid index
-			return this->x;
-		return *((&x) + a);
+		static_assert(sizeof(Vec3f) == 3 * sizeof(float), "Batch kernels expect tightly packed Vec3f");
+
+#ifdef MATH_SSE
+		// Loads the components of a VecN of 3 or 4 floats without reading past them, the fourth lane of 3 is zero
+		template<size_t N>
+		inline __m128 LoadVecN(const float* data)
+		{
+			if constexpr (N == 4)
+				return _mm_loadu_ps(data);
+			else
+				// Through a may alias type, a double load may be moved above the float stores it reads
+				return _mm_movelh_ps(_mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(data))), _mm_load_ss(data + 2));
+		}
+
+		template<size_t N>
+		inline void StoreVecN(float* data, __m128 value)
+		{
+			if constexpr (N == 4)
+				_mm_storeu_ps(data, value);
+			else
+			{
+				_mm_storel_pi(reinterpret_cast<__m64*>(data), value);
+				_mm_store_ss(data + 2, _mm_movehl_ps(value, value));
+			}
+		}
+
+		template<int Lane>
+		inline float GetLane(__m128 value)
+		{
+			return _mm_cvtss_f32(_mm_shuffle_ps(value, value, _MM_SHUFFLE(Lane, Lane, Lane, Lane)));
+		}
+
+		// Loads 4 packed Vec3f (12 floats) and transposes them to x, y and z lanes.
+		inline void LoadVec3x4(const float* data, __m128& x, __m128& y, __m128& z)
+		{
+			__m128 m0 = _mm_loadu_ps(data);
+			__m128 m1 = _mm_loadu_ps(data + 4);
+			__m128 m2 = _mm_loadu_ps(data + 8);
+			__m128 xy = _mm_shuffle_ps(m1, m2, _MM_SHUFFLE(2, 1, 3, 2));
+			__m128 yz = _mm_shuffle_ps(m0, m1, _MM_SHUFFLE(1, 0, 2, 1));
+			x = _mm_shuffle_ps(m0, xy, _MM_SHUFFLE(2, 0, 3, 0));
+			y = _mm_shuffle_ps(yz, xy, _MM_SHUFFLE(3, 1, 2, 0));
+			z = _mm_shuffle_ps(yz, m2, _MM_SHUFFLE(3, 0, 3, 1));
+		}
+
+		// Inverse of LoadVec3x4.
+		inline void StoreVec3x4(float* data, __m128 x, __m128 y, __m128 z)
+		{
+			__m128 xy = _mm_shuffle_ps(x, y, _MM_SHUFFLE(2, 0, 2, 0));
+			__m128 yz = _mm_shuffle_ps(y, z, _MM_SHUFFLE(3, 1, 3, 1));
+			__m128 zx = _mm_shuffle_ps(z, x, _MM_SHUFFLE(3, 1, 2, 0));
+			_mm_storeu_ps(data, _mm_shuffle_ps(xy, zx, _MM_SHUFFLE(2, 0, 2, 0)));
+			_mm_storeu_ps(data + 4, _mm_shuffle_ps(yz, xy, _MM_SHUFFLE(3, 1, 2, 0)));
+			_mm_storeu_ps(data + 8, _mm_shuffle_ps(zx, yz, _MM_SHUFFLE(3, 1, 3, 1)));
+		}
+#endif
+
+#ifdef MATH_AVX
+		// Same as LoadVec3x4 for 8 packed Vec3f, vectors 0-3 land in the low half and 4-7 in the high half.
+		inline void LoadVec3x8(const float* data, __m256& x, __m256& y, __m256& z)
+		{
+			__m256 m03 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(data)), _mm_loadu_ps(data + 12), 1);
+			__m256 m14 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(data + 4)), _mm_loadu_ps(data + 16), 1);
+			__m256 m25 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(data + 8)), _mm_loadu_ps(data + 20), 1);
+			__m256 xy = _mm256_shuffle_ps(m14, m25, _MM_SHUFFLE(2, 1, 3, 2));
+			__m256 yz = _mm256_shuffle_ps(m03, m14, _MM_SHUFFLE(1, 0, 2, 1));
+			x = _mm256_shuffle_ps(m03, xy, _MM_SHUFFLE(2, 0, 3, 0));
+			y = _mm256_shuffle_ps(yz, xy, _MM_SHUFFLE(3, 1, 2, 0));
+			z = _mm256_shuffle_ps(yz, m25, _MM_SHUFFLE(3, 0, 3, 1));
+		}
+
+		// Inverse of LoadVec3x8.
+		inline void StoreVec3x8(float* data, __m256 x, __m256 y, __m256 z)
+		{
+			__m256 xy = _mm256_shuffle_ps(x, y, _MM_SHUFFLE(2, 0, 2, 0));
+			__m256 yz = _mm256_shuffle_ps(y, z, _MM_SHUFFLE(3, 1, 3, 1));
+			__m256 zx = _mm256_shuffle_ps(z, x, _MM_SHUFFLE(3, 1, 2, 0));
+			__m256 r03 = _mm256_shuffle_ps(xy, zx, _MM_SHUFFLE(2, 0, 2, 0));
+			__m256 r14 = _mm256_shuffle_ps(yz, xy, _MM_SHUFFLE(3, 1, 2, 0));
+			__m256 r25 = _mm256_shuffle_ps(zx, yz, _MM_SHUFFLE(3, 1, 3, 1));
+			_mm_storeu_ps(data, _mm256_castps256_ps128(r03));
+			_mm_storeu_ps(data + 4, _mm256_castps256_ps128(r14));
+			_mm_storeu_ps(data + 8, _mm256_castps256_ps128(r25));
+			_mm_storeu_ps(data + 12, _mm256_extractf128_ps(r03, 1));
+			_mm_storeu_ps(data + 16, _mm256_extractf128_ps(r14, 1));
+			_mm_storeu_ps(data + 20, _mm256_extractf128_ps(r25, 1));
+		}
+
+		// result = a * b for column-major 4x4 double matrices, same operation order as the scalar Mat4T::operator*.
+		inline void MultiplyMat4d(const double* a, const double* b, double* result)
+		{
+			const __m256d a0 = _mm256_loadu_pd(a);
+			const __m256d a1 = _mm256_loadu_pd(a + 4);
+			const __m256d a2 = _mm256_loadu_pd(a + 8);
+			const __m256d a3 = _mm256_loadu_pd(a + 12);
+			for (size_t i = 0; i < 4; i++)
+			{
+				const double* column = b + i * 4;
+				__m256d sum = _mm256_mul_pd(a0, _mm256_broadcast_sd(column));
+				sum = _mm256_add_pd(sum, _mm256_mul_pd(a1, _mm256_broadcast_sd(column + 1)));
+				sum = _mm256_add_pd(sum, _mm256_mul_pd(a2, _mm256_broadcast_sd(column + 2)));
+				sum = _mm256_add_pd(sum, _mm256_mul_pd(a3, _mm256_broadcast_sd(column + 3)));
+				_mm256_storeu_pd(result + i * 4, sum);
+			}
+		}
+
+		// result = m * v for a column-major 4x4 double matrix.
+		inline void TransformVec4d(const double* m, const double* v, double* result)
+		{
+			__m256d add0 = _mm256_add_pd(_mm256_mul_pd(_mm256_loadu_pd(m), _mm256_broadcast_sd(v)),
+				_mm256_mul_pd(_mm256_loadu_pd(m + 4), _mm256_broadcast_sd(v + 1)));
+			__m256d add1 = _mm256_add_pd(_mm256_mul_pd(_mm256_loadu_pd(m + 8), _mm256_broadcast_sd(v + 2)),
+				_mm256_mul_pd(_mm256_loadu_pd(m + 12), _mm256_broadcast_sd(v + 3)));
+			_mm256_storeu_pd(result, _mm256_add_pd(add0, add1));
+		}
+#endif
 	}
+#pragma endregion
 
-	template<typename T>
-	inline T Vec2<T>::LengthSquared() const
+#pragma region Swizzle
+	template<size_t I, typename V>
+	inline constexpr auto& SwizzleComponent(V& vector)
 	{
-		return x * x + y * y;
+		return vector[I];
 	}
 
-	template<typename T>
-	inline T Vec2<T>::Length() const
+	template<typename V, size_t... I>
+	inline constexpr SwizzleView<V, I...>::operator Value() const
 	{
-		return static_cast<T>(std::sqrt(LengthSquared()));
+		return Value{ SwizzleComponent<I>(vector)... };
 	}
 
-	template<typename T>
-	inline T Vec2<T>::Dot(const Vec2& a) const
+	template<typename V, size_t... I>
+	inline constexpr SwizzleView<V, I...>& SwizzleView<V, I...>::operator=(const Value& value)
 	{
-		return a.x * x + a.y * y;
+		static_assert(Distinct(), "A swizzle that repeats a component cannot be assigned");
+		// Copied first, the value may read the components being written
+		const Value copy = value;
+		ForEach(copy, [](T& component, T element) { component = element; }, std::make_index_sequence<sizeof...(I)>{});
+		return *this;
 	}
 
-	template<typename T>
-	inline Vec2<T> Vec2<T>::Cross(const Vec2& a) const
+	template<typename V, size_t... I>
+	inline constexpr SwizzleView<V, I...>& SwizzleView<V, I...>::operator=(const SwizzleView& view)
 	{
-		return { x * a.y, y * a.x };
+		return *this = static_cast<Value>(view);
 	}
 
-	template<typename T>
-	inline Vec2<T> Vec2<T>::Ortho() const
+	template<typename V, size_t... I>
+	inline constexpr SwizzleView<V, I...>& SwizzleView<V, I...>::operator+=(const Value& value)
 	{
-		return { -y, x };
+		static_assert(Distinct(), "A swizzle that repeats a component cannot be assigned");
+		const Value copy = value;
+		ForEach(copy, [](T& component, T element) { component = static_cast<T>(component + element); }, std::make_index_sequence<sizeof...(I)>{});
+		return *this;
 	}
 
-	template<typename T>
-	void Math::Vec2<T>::Normalize()
+	template<typename V, size_t... I>
+	inline constexpr SwizzleView<V, I...>& SwizzleView<V, I...>::operator-=(const Value& value)
 	{
-		*this = GetNormalize();
+		static_assert(Distinct(), "A swizzle that repeats a component cannot be assigned");
+		const Value copy = value;
+		ForEach(copy, [](T& component, T element) { component = static_cast<T>(component - element); }, std::make_index_sequence<sizeof...(I)>{});
+		return *this;
 	}
 
-	template<typename T>
-	inline Vec2<T> Math::Vec2<T>::GetNormalize() const
+	template<typename V, size_t... I>
+	inline constexpr SwizzleView<V, I...>& SwizzleView<V, I...>::operator*=(T value)
 	{
-		T len = Length();
-		if (len != 0)
-			return { x / len, y / len };
-		return {};
+		static_assert(Distinct(), "A swizzle that repeats a component cannot be assigned");
+		((SwizzleComponent<I>(vector) = static_cast<T>(SwizzleComponent<I>(vector) * value)), ...);
+		return *this;
 	}
 
-	template<typename T>
-	inline void Vec2<T>::Print(int precision /*= 6*/) const
+	template<typename V, size_t... I>
+	template<size_t K>
+	inline constexpr typename SwizzleView<V, I...>::T SwizzleView<V, I...>::Element(const Value& value)
 	{
-		std::cout << std::fixed << std::setprecision(precision);
-		std::cout << x << ", " << y << std::endl;
+		if constexpr (sizeof...(I) == 1)
+			return value;
+		else
+			return SwizzleComponent<K>(value);
 	}
 
-	template<typename T>
-	inline std::string Vec2<T>::ToString(int precision /*= 6*/) const
+	template<typename V, size_t... I>
+	template<typename Function, size_t... K>
+	inline constexpr void SwizzleView<V, I...>::ForEach(const Value& value, Function function, std::index_sequence<K...>)
 	{
-		std::ostringstream oss;
-		oss << std::fixed << std::setprecision(precision);
-
-		oss << x << ", " << y;
-
-		return oss.str();
+		(function(SwizzleComponent<I>(vector), Element<K>(value)), ...);
 	}
 
-	template<typename T>
-	inline Vec2<float> Vec2<T>::ToVec2f() const
+	template<typename V, size_t... I>
+	inline constexpr bool SwizzleView<V, I...>::Distinct()
 	{
-		return Vec2f{ static_cast<float>(x), static_cast<float>(y) };
+		constexpr size_t indices[] = { I... };
+		for (size_t i = 0; i < sizeof...(I); i++)
+			for (size_t j = i + 1; j < sizeof...(I); j++)
+				if (indices[i] == indices[j])
+					return false;
+		return true;
 	}
+#pragma endregion
 
-	template<typename T>
-	inline Vec2<int> Vec2<T>::ToVec2i() const
+#pragma region VecN
+	template<typename T, size_t N>
+	inline constexpr VecN<T, N>::VecN(T value)
 	{
-		return Vec2i{ static_cast<int>(x), static_cast<int>(y) };
+		for (size_t i = 0; i < N; i++)
+			(*this)[i] = value;
 	}
 
-	template<typename T>
-	inline T* Vec2<T>::Data() const
+	template<typename T, size_t N>
+	template<typename U>
+	inline constexpr VecN<T, N>::VecN(const VecN<U, N>& a) : VecN(Generate([&](size_t i) { return a[i]; }))
 	{
-		return const_cast<T*>(reinterpret_cast<const T*>(this));
 	}
 
-#pragma endregion
-
-#pragma region Vec3
-
-	template<typename T>
-	inline constexpr Vec3<T>::Vec3(const std::string& str)
+	template<typename T, size_t N>
+	inline VecN<T, N>::VecN(const std::string& str)
 	{
 		std::istringstream ss(str);
 
 		char discard;
-		ss >> this->x >> discard >> this->y >> discard >> this->z;
+		ss >> (*this)[0];
+		for (size_t i = 1; i < N; i++)
+			ss >> discard >> (*this)[i];
 	}
 
-	template<typename T>
+	template<typename T, size_t N>
 	template<typename U>
-	inline constexpr Vec3<T>::Vec3(const Vec2<U>& xy, T _z)
+	inline constexpr VecN<T, N>::VecN(const VecN<U, 2>& xy, T _z /*= 0*/) requires (N == 3)
+		: VecN(static_cast<T>(xy.x), static_cast<T>(xy.y), _z)
 	{
-		x = static_cast<T>(xy.x);
-		y = static_cast<T>(xy.y);
-		z = _z;
 	}
 
-	template<typename T>
+	template<typename T, size_t N>
 	template<typename U>
-	inline constexpr Vec3<T>::Vec3(const Vec3<U>& a)
+	inline constexpr VecN<T, N>::VecN(const VecN<U, 2>& xy, T _z /*= 0*/, T _w /*= 0*/) requires (N == 4)
+		: VecN(static_cast<T>(xy.x), static_cast<T>(xy.y), _z, _w)
 	{
-		x = static_cast<T>(a.x);
-		y = static_cast<T>(a.y);
-		z = static_cast<T>(a.z);
 	}
 
-	template<typename T>
+	template<typename T, size_t N>
 	template<typename U>
-	inline constexpr Vec3<T>::Vec3(const Vec4<U>& a)
+	inline constexpr VecN<T, N>::VecN(const VecN<U, 3>& xyz, T _w /*= 0*/) requires (N == 4)
+		: VecN(static_cast<T>(xyz.x), static_cast<T>(xyz.y), static_cast<T>(xyz.z), _w)
 	{
-		x = static_cast<T>(a.x);
-		y = static_cast<T>(a.y);
-		z = static_cast<T>(a.z);
 	}
 
-	template<typename T>
+	template<typename T, size_t N>
 	template<typename U>
-	inline constexpr Vec3<T> Vec3<T>::operator*(const U& b) const
+	inline constexpr VecN<T, N>::VecN(const VecN<U, N + 1>& a) requires (N == 2 || N == 3)
+		: VecN(Generate([&](size_t i) { return a[i]; }))
 	{
-		return { static_cast<T>(x * b), static_cast<T>(y * b), static_cast<T>(z * b) };
 	}
 
-	template<typename T>
+	template<typename T, size_t N>
 	template<typename U>
-	inline constexpr Vec3<T> Vec3<T>::operator/(const U& b) const
+	inline constexpr VecN<T, N>& VecN<T, N>::operator=(const VecN<U, 3>& xyz) requires (N == 4)
 	{
-		return { x / b, y / b, z / b };
+		this->x = static_cast<T>(xyz.x);
+		this->y = static_cast<T>(xyz.y);
+		this->z = static_cast<T>(xyz.z);
+		return *this;
 	}
 
-	template<typename T>
-	template<typename U>
-	inline void Vec3<T>::operator*=(const U& b)
+	template<typename T, size_t N>
+	inline constexpr T& VecN<T, N>::operator[](size_t i)
 	{
-		*this = operator*(b);
+		return const_cast<T&>(static_cast<const VecN&>(*this)[i]);
 	}
 
-	template<typename T>
-	template<typename U>
-	inline void Vec3<T>::operator/=(const U& b)
+	template<typename T, size_t N>
+	inline constexpr const T& VecN<T, N>::operator[](size_t i) const
 	{
-		*this = operator/(b);
+		if (i >= N)
+			i = 0;
+		if constexpr (N > 4)
+			return this->data[i];
+		else if (std::is_constant_evaluated())
+			return this->*VecComponents<T, N>::components[i];
+		else
+			return *((&this->x) + i);
 	}
 
-	template<typename T>
-	inline constexpr Vec3<T> Vec3<T>::operator+(const Vec3& b) const
+	template<typename T, size_t N>
+	template<typename Function, size_t... I>
+	inline constexpr VecN<T, N> VecN<T, N>::Generate(Function generator, std::index_sequence<I...>)
 	{
-		return { x + b.x, y + b.y, z + b.z };
+		return VecN(static_cast<T>(generator(I))...);
 	}
 
-	template<typename T>
-	inline void Vec3<T>::operator+=(const Vec3& b)
+	template<typename T, size_t N>
+	template<typename Function>
+	inline constexpr VecN<T, N> VecN<T, N>::Generate(Function generator)
 	{
-		*this = operator+(b);
+		return Generate(generator, std::make_index_sequence<N>());
 	}
 
-	template<typename T>
-	inline constexpr Vec3<T> Vec3<T>::operator-(const Vec3& b) const
+	template<typename T, size_t N>
+	template<typename Function, size_t... I>
+	inline constexpr T VecN<T, N>::Fold(Function term, std::index_sequence<I...>)
 	{
-		return { x - b.x, y - b.y, z - b.z };
+		// Left fold: ((t0 + t1) + t2) + ...
+		return (... + term(I));
 	}
 
-	template<typename T>
-	inline constexpr Vec3<T> Vec3<T>::operator-(void) const
+	template<typename T, size_t N>
+	template<typename Function>
+	inline constexpr T VecN<T, N>::Fold(Function term)
 	{
-		return { -x, -y, -z };
+		return Fold(term, std::make_index_sequence<N>());
 	}
 
-	template<typename T>
-	inline void Vec3<T>::operator-=(const Vec3& b)
+	template<typename T, size_t N>
+	inline constexpr VecN<T, N> VecN<T, N>::operator+(const VecN& b) const
 	{
-		*this = operator-(b);
+		MATH_INSTRUMENT_SCOPE(Instrument::VecSiteName<N>("VecN::operator+(VecN)"));
+#if defined(MATH_SSE)
+		if constexpr (simd)
+		{
+			if (!std::is_constant_evaluated())
+			{
+				VecN result;
+				Simd::StoreVecN<N>(result.Data(), _mm_add_ps(Simd::LoadVecN<N>(Data()), Simd::LoadVecN<N>(b.Data())));
+				return result;
+			}
+		}
+#endif
+		return Generate([&](size_t i) { return (*this)[i] + b[i]; });
 	}
 
-	template<typename T>
-	template<typename U>
-	inline constexpr Vec3<T> Vec3<T>::operator*(const Vec3<U>& b) const
+	template<typename T, size_t N>
+	template<typename U> requires (!std::is_same_v<U, T>)
+	inline constexpr VecN<T, N> VecN<T, N>::operator+(const VecN<U, N>& b) const
 	{
-		return { static_cast<T>(x * b.x), static_cast<T>(y * b.y), static_cast<T>(z * b.z) };
+		MATH_INSTRUMENT_SCOPE(Instrument::VecSiteName<N>("VecN::operator+(VecN)"));
+		return Generate([&](size_t i) { return (*this)[i] + b[i]; });
 	}
 
-	template<typename T>
-	inline void Vec3<T>::operator*=(const Vec3& b)
+	template<typename T, size_t N>
+	inline constexpr VecN<T, N> VecN<T, N>::operator-(const VecN& b) const
 	{
-		*this = operator*(b);
+		MATH_INSTRUMENT_SCOPE(Instrument::VecSiteName<N>("VecN::operator-(VecN)"));
+#if defined(MATH_SSE)
+		if constexpr (simd)
+		{
+			if (!std::is_constant_evaluated())
+			{
+				VecN result;
+				Simd::StoreVecN<N>(result.Data(), _mm_sub_ps(Simd::LoadVecN<N>(Data()), Simd::LoadVecN<N>(b.Data())));
+				return result;
+			}
+		}
+#endif
+		return Generate([&](size_t i) { return (*this)[i] - b[i]; });
 	}
 
-	template<typename T>
-	template<typename U>
-	inline constexpr bool Vec3<T>::operator==(const Vec3<U>& a) const
+	template<typename T, size_t N>
+	template<typename U> requires (!std::is_same_v<U, T>)
+	inline constexpr VecN<T, N> VecN<T, N>::operator-(const VecN<U, N>& b) const
 	{
-		return AlmostEqual(x, static_cast<T>(a.x)) && AlmostEqual(y, static_cast<T>(a.y)) && AlmostEqual(z, static_cast<T>(a.z));
+		MATH_INSTRUMENT_SCOPE(Instrument::VecSiteName<N>("VecN::operator-(VecN)"));
+		return Generate([&](size_t i) { return (*this)[i] - b[i]; });
 	}
 
-	template<typename T>
-	template<typename U>
-	inline constexpr bool Vec3<T>::operator!=(const Vec3<U>& a) const
+	template<typename T, size_t N>
+	inline constexpr VecN<T, N> VecN<T, N>::operator-() const
 	{
-		return !AlmostEqual(x, static_cast<T>(a.x)) || !AlmostEqual(y, static_cast<T>(a.y)) || !AlmostEqual(z, static_cast<T>(a.z));
+		MATH_INSTRUMENT_SCOPE(Instrument::VecSiteName<N>("VecN::operator-()"));
+		return Generate([&](size_t i) { return -(*this)[i]; });
 	}
 
-	template<typename T>
-	inline T& Vec3<T>::operator[](const size_t a)
+	template<typename T, size_t N>
+	inline constexpr VecN<T, N> VecN<T, N>::operator*(const VecN& b) const
 	{
-		if (a >= 3)
-			return x;
-		return *((&x) + a);
+		MATH_INSTRUMENT_SCOPE(Instrument::VecSiteName<N>("VecN::operator*(VecN)"));
+#if defined(MATH_SSE)
+		if constexpr (simd)
+		{
+			if (!std::is_constant_evaluated())
+			{
+				VecN result;
+				Simd::StoreVecN<N>(result.Data(), _mm_mul_ps(Simd::LoadVecN<N>(Data()), Simd::LoadVecN<N>(b.Data())));
+				return result;
+			}
+		}
+#endif
+		return Generate([&](size_t i) { return (*this)[i] * b[i]; });
 	}
 
-	template<typename T>
-	inline const T& Vec3<T>::operator[](const size_t a) const
+	template<typename T, size_t N>
+	template<typename U> requires (!std::is_same_v<U, T>)
+	inline constexpr VecN<T, N> VecN<T, N>::operator*(const VecN<U, N>& b) const
 	{
-		return *((&x) + a);
+		MATH_INSTRUMENT_SCOPE(Instrument::VecSiteName<N>("VecN::operator*(VecN)"));
+		return Generate([&](size_t i) { return (*this)[i] * b[i]; });
 	}
 
-	template<typename T>
-	inline T Vec3<T>::LengthSquared() const
+	template<typename T, size_t N>
+	inline constexpr VecN<T, N> VecN<T, N>::operator*(T b) const
 	{
-		return x * x + y * y + z * z;
+		MATH_INSTRUMENT_SCOPE(Instrument::VecSiteName<N>("VecN::operator*(T)"));
+#if defined(MATH_SSE)
+		if constexpr (simd)
+		{
+			if (!std::is_constant_evaluated())
+			{
+				VecN result;
+				Simd::StoreVecN<N>(result.Data(), _mm_mul_ps(Simd::LoadVecN<N>(Data()), _mm_set1_ps(b)));
+				return result;
+			}
+		}
+#endif
+		return Generate([&](size_t i) { return (*this)[i] * b; });
 	}
 
-	template<typename T>
-	inline T Vec3<T>::Length() const
+	template<typename T, size_t N>
+	template<typename U> requires (!std::is_same_v<U, T>)
+	inline constexpr VecN<T, N> VecN<T, N>::operator*(const U& b) const
 	{
-		return std::sqrt(LengthSquared());
+		MATH_INSTRUMENT_SCOPE(Instrument::VecSiteName<N>("VecN::operator*(T)"));
+		return Generate([&](size_t i) { return (*this)[i] * b; });
 	}
 
-	template<typename T>
-	inline T Vec3<T>::Dot(const Vec3& a) const
+	template<typename T, size_t N>
+	inline constexpr VecN<T, N> VecN<T, N>::operator/(T b) const
 	{
-		return x * a.x + y * a.y + z * a.z;
+		MATH_INSTRUMENT_SCOPE(Instrument::VecSiteName<N>("VecN::operator/(T)"));
+		return Generate([&](size_t i) { return (*this)[i] / b; });
 	}
 
-	template<typename T>
-	inline Vec3<T> Vec3<T>::Cross(const Vec3& a) const
+	template<typename T, size_t N>
+	template<typename U> requires (!std::is_same_v<U, T>)
+	inline constexpr VecN<T, N> VecN<T, N>::operator/(const U& b) const
 	{
-		return { (y * a.z) - (z * a.y), (z * a.x) - (x * a.z), (x * a.y) - (y * a.x) };
+		MATH_INSTRUMENT_SCOPE(Instrument::VecSiteName<N>("VecN::operator/(T)"));
+		return Generate([&](size_t i) { return (*this)[i] / b; });
 	}
 
-	template<typename T>
-	inline Vec3<T> Vec3<T>::GetNormalize() const
+	template<typename T, size_t N>
+	template<typename U>
+	inline constexpr void VecN<T, N>::operator+=(const VecN<U, N>& b)
 	{
-		T len = Length();
-		if (len != 0)
-			return { x / len, y / len, z / len };
-		return {};
+		MATH_INSTRUMENT_SCOPE(Instrument::VecSiteName<N>("VecN::operator+=(VecN)"));
+		for (size_t i = 0; i < N; i++)
+			(*this)[i] = static_cast<T>((*this)[i] + b[i]);
 	}
 
-	template<typename T>
-	inline void Vec3<T>::Normalize()
+	template<typename T, size_t N>
+	template<typename U>
+	inline constexpr void VecN<T, N>::operator-=(const VecN<U, N>& b)
 	{
-		*this = GetNormalize();
+		MATH_INSTRUMENT_SCOPE(Instrument::VecSiteName<N>("VecN::operator-=(VecN)"));
+		for (size_t i = 0; i < N; i++)
+			(*this)[i] = static_cast<T>((*this)[i] - b[i]);
 	}
 
-	template<typename T>
-	inline T Vec3<T>::Distance(const Vec3& a) const
+	template<typename T, size_t N>
+	template<typename U>
+	inline constexpr void VecN<T, N>::operator*=(const VecN<U, N>& b)
 	{
-		T i = a.x - x;
-		T j = a.y - y;
-		T h = a.z - z;
-		return std::sqrt(i * i + j * j + h * h);
+		MATH_INSTRUMENT_SCOPE(Instrument::VecSiteName<N>("VecN::operator*=(VecN)"));
+		for (size_t i = 0; i < N; i++)
+			(*this)[i] = static_cast<T>((*this)[i] * b[i]);
 	}
 
-	template<typename T>
-	inline Vec3<T> Vec3<T>::Lerp(const Vec3& b, float t) const
+	template<typename T, size_t N>
+	template<typename U>
+	inline constexpr void VecN<T, N>::operator*=(const U& b)
 	{
-		if (t < 0)
-			return *this;
-		else if (t >= 1)
-			return b;
-		return (*this) * (1 - t) + b * t;
+		MATH_INSTRUMENT_SCOPE(Instrument::VecSiteName<N>("VecN::operator*=(T)"));
+		for (size_t i = 0; i < N; i++)
+			(*this)[i] = static_cast<T>((*this)[i] * b);
 	}
 
-	template<typename T>
-	inline void Vec3<T>::Print(int precision /*= 6*/) const
+	template<typename T, size_t N>
+	template<typename U>
+	inline constexpr void VecN<T, N>::operator/=(const U& b)
 	{
-		std::cout << std::fixed << std::setprecision(precision);
-		std::cout << x << ", " << y << ", " << z << std::endl;
+		MATH_INSTRUMENT_SCOPE(Instrument::VecSiteName<N>("VecN::operator/=(T)"));
+		for (size_t i = 0; i < N; i++)
+			(*this)[i] = static_cast<T>((*this)[i] / b);
 	}
 
-	template<typename T>
-	inline std::string Vec3<T>::ToString(int precision /*= 6*/) const
+	template<typename T, size_t N>
+	template<typename U>
+	inline constexpr bool VecN<T, N>::operator==(const VecN<U, N>& b) const
 	{
-		std::ostringstream oss;
-		oss << std::fixed << std::setprecision(precision);
-		oss << x << ", " << y << ", " << z;
-		return oss.str();
+		MATH_INSTRUMENT_SCOPE(Instrument::VecSiteName<N>("VecN::operator==(VecN)"));
+		// "this" vector has the authority for the type comparison
+		return [&]<size_t... I>(std::index_sequence<I...>) { return (AlmostEqual((*this)[I], static_cast<T>(b[I])) && ...); }(std::make_index_sequence<N>());
 	}
 
-	template<typename T>
-	inline Quat Vec3<T>::ToQuaternion() const
+	template<typename T, size_t N>
+	template<typename U>
+	inline constexpr bool VecN<T, N>::operator!=(const VecN<U, N>& b) const
 	{
-		Quat result;
-		Vec3<T> eulerAngle = *this * DegToRad;
+		return !(*this == b);
+	}
 
-		Vec3<T> c;
-		c.x = std::cos(eulerAngle.x * T(0.5));
-		c.y = std::cos(eulerAngle.y * T(0.5));
-		c.z = std::cos(eulerAngle.z * T(0.5));
+	template<typename T, size_t N>
+	template<typename U>
+	inline constexpr bool VecN<T, N>::operator==(const VecN<U, 3>& b) const requires (N == 2)
+	{
+		MATH_INSTRUMENT_SCOPE("Vec2::operator==(Vec3)");
+		return AlmostEqual(this->x, static_cast<T>(b.x)) && AlmostEqual(this->y, static_cast<T>(b.y));
+	}
 
-		Vec3<T> s;
-		s.x = std::sin(eulerAngle.x * T(0.5));
-		s.y = std::sin(eulerAngle.y * T(0.5));
-		s.z = std::sin(eulerAngle.z * T(0.5));
+	template<typename T, size_t N>
+	template<typename U>
+	inline constexpr bool VecN<T, N>::operator!=(const VecN<U, 3>& b) const requires (N == 2)
+	{
+		return !(*this == b);
+	}
 
-		result.w = c.x * c.y * c.z + s.x * s.y * s.z;
-		result.x = s.x * c.y * c.z - c.x * s.y * s.z;
-		result.y = c.x * s.y * c.z + s.x * c.y * s.z;
-		result.z = c.x * c.y * s.z - s.x * s.y * c.z;
-		return result;
+	template<typename T, size_t N>
+	inline constexpr T VecN<T, N>::Dot(const VecN& b) const
+	{
+		MATH_INSTRUMENT_SCOPE(Instrument::VecSiteName<N>("VecN::Dot(VecN)"));
+#if defined(MATH_SSE)
+		if constexpr (simd)
+		{
+			if (!std::is_constant_evaluated())
+			{
+				// Products in parallel, then added in the same order as the fold
+				const __m128 products = _mm_mul_ps(Simd::LoadVecN<N>(Data()), Simd::LoadVecN<N>(b.Data()));
+				float sum = _mm_cvtss_f32(products) + Simd::GetLane<1>(products);
+				sum += Simd::GetLane<2>(products);
+				if constexpr (N == 4)
+					sum += Simd::GetLane<3>(products);
+				return sum;
+			}
+		}
+#endif
+		return Fold([&](size_t i) { return (*this)[i] * b[i]; });
 	}
 
-
-	template<typename T>
-	inline T* Vec3<T>::Data() const
+	template<typename T, size_t N>
+	inline constexpr T VecN<T, N>::LengthSquared() const
 	{
-		return const_cast<T*>(reinterpret_cast<const T*>(this));
+		MATH_INSTRUMENT_SCOPE(Instrument::VecSiteName<N>("VecN::LengthSquared()"));
+		return Dot(*this);
 	}
 
-#pragma endregion
-
-#pragma region Vec4
-	template<typename T>
-	inline constexpr Vec4<T>::Vec4(const std::string& str)
+	template<typename T, size_t N>
+	inline T VecN<T, N>::Length() const
 	{
-		std::istringstream ss(str);
+		MATH_INSTRUMENT_SCOPE(Instrument::VecSiteName<N>("VecN::Length()"));
+		return static_cast<T>(Sqrt(LengthSquared()));
+	}
 
-		char discard;
-		ss >> this->x >> discard >> this->y >> discard >> this->z >> discard >> this->w;
+	template<typename T, size_t N>
+	inline T VecN<T, N>::Distance(const VecN& b) const
+	{
+		MATH_INSTRUMENT_SCOPE(Instrument::VecSiteName<N>("VecN::Distance(VecN)"));
+		return (b - *this).Length();
 	}
 
-	template<typename T>
-	template<typename U>
-	inline constexpr Vec4<T>::Vec4(const Vec2<U>& xy, T _z /*= 0*/, T _w /*= 0*/)
+	template<typename T, size_t N>
+	inline VecN<T, N> VecN<T, N>::GetNormalize() const
 	{
-		x = static_cast<T>(xy.x);
-		y = static_cast<T>(xy.y);
-		z = _z;
-		w = _w;
+		MATH_INSTRUMENT_SCOPE(Instrument::VecSiteName<N>("VecN::GetNormalize()"));
+		T len = Length();
+		if (len != 0)
+			return *this / len;
+		return {};
 	}
 
-	template<typename T>
-	template<typename U>
-	inline constexpr Vec4<T>::Vec4(const Vec3<U>& xyz, T _w /*= 0*/)
+	template<typename T, size_t N>
+	inline void VecN<T, N>::Normalize()
 	{
-		x = static_cast<T>(xyz.x);
-		y = static_cast<T>(xyz.y);
-		z = static_cast<T>(xyz.z);
-		w = _w;
+		MATH_INSTRUMENT_SCOPE(Instrument::VecSiteName<N>("VecN::Normalize()"));
+		*this = GetNormalize();
 	}
 
-	template<typename T>
-	template<typename U>
-	inline constexpr Vec4<T>::Vec4(const Vec4<U>& a)
+	template<typename T, size_t N>
+	inline VecN<T, N> VecN<T, N>::Lerp(const VecN& b, float t) const
 	{
-		x = static_cast<T>(a.x);
-		y = static_cast<T>(a.y);
-		z = static_cast<T>(a.z);
-		w = static_cast<T>(a.w);
+		MATH_INSTRUMENT_SCOPE(Instrument::VecSiteName<N>("VecN::Lerp(VecN, float)"));
+		if (t < 0)
+			return *this;
+		else if (t >= 1)
+			return b;
+		return (*this) * (1 - t) + b * t;
 	}
 
-	template<typename T>
-	template<typename U>
-	inline constexpr Vec4<T> Vec4<T>::operator=(const Vec3<U>& b)
+	template<typename T, size_t N>
+	inline constexpr VecN<T, N> VecN<T, N>::Min(const VecN& b) const
 	{
-		this->x = static_cast<T>(b.x);
-		this->y = static_cast<T>(b.y);
-		this->z = static_cast<T>(b.z);
-		return *this;
+		return Generate([&](size_t i) { return (*this)[i] < b[i] ? (*this)[i] : b[i]; });
 	}
 
-	template<typename T>
-	inline constexpr Vec4<T> Vec4<T>::operator+(const Vec4& b) const {
-		return { x + b.x, y + b.y, z + b.z, w + b.w };
+	template<typename T, size_t N>
+	inline constexpr VecN<T, N> VecN<T, N>::Max(const VecN& b) const
+	{
+		return Generate([&](size_t i) { return (*this)[i] > b[i] ? (*this)[i] : b[i]; });
 	}
 
-	template<typename T>
-	inline constexpr Vec4<T> Vec4<T>::operator-(const Vec4& b) const {
-		return { x - b.x, y - b.y, z - b.z, w - b.w };
+	template<typename T, size_t N>
+	inline VecN<T, N> VecN<T, N>::Cross(const VecN& b) const requires (N == 3)
+	{
+		MATH_INSTRUMENT_SCOPE("Vec3::Cross(Vec3)");
+		return { (this->y * b.z) - (this->z * b.y), (this->z * b.x) - (this->x * b.z), (this->x * b.y) - (this->y * b.x) };
 	}
 
-	template<typename T>
-	inline constexpr Vec4<T> Vec4<T>::operator-(void) const {
-		return { -x, -y, -z, -w };
+	template<typename T, size_t N>
+	inline VecN<T, N> VecN<T, N>::Cross(const VecN& b) const requires (N == 2)
+	{
+		MATH_INSTRUMENT_SCOPE("Vec2::Cross(Vec2)");
+		return { this->x * b.y, this->y * b.x };
 	}
 
-	template<typename T>
-	template<typename U>
-	inline constexpr Vec4<T> Vec4<T>::operator*(const Vec4<U>& b) const {
-		return Vec4(x * b.x, y * b.y, z * b.z, w * b.w);
+	template<typename T, size_t N>
+	inline VecN<T, N> VecN<T, N>::Ortho() const requires (N == 2)
+	{
+		MATH_INSTRUMENT_SCOPE("Vec2::Ortho()");
+		return { -this->y, this->x };
 	}
 
-	template<typename T>
-	template<typename U>
-	inline constexpr Vec4<T> Vec4<T>::operator*(const U& b) const {
-		return { x * b, y * b, z * b, w * b };
+	template<typename T, size_t N>
+	inline VecN<T, N> VecN<T, N>::GetHomogenize() const requires (N == 4)
+	{
+		MATH_INSTRUMENT_SCOPE("Vec4::GetHomogenize()");
+		return { ToVector3() / this->w };
 	}
 
-	template<typename T>
-	template<typename U>
-	inline constexpr Vec4<T> Vec4<T>::operator/(const U& b) const {
-		return { x / b, y / b, z / b, w / b };
+	template<typename T, size_t N>
+	inline void VecN<T, N>::Homogenize() requires (N == 4)
+	{
+		MATH_INSTRUMENT_SCOPE("Vec4::Homogenize()");
+		*this = GetHomogenize();
 	}
 
-	template<typename T>
-	inline void Vec4<T>::operator+=(const Vec4& b) {
-		*this = operator+(b);
+	template<typename T, size_t N>
+	inline VecN<T, 3> VecN<T, N>::ToVector3() const requires (N == 4)
+	{
+		MATH_INSTRUMENT_SCOPE("Vec4::ToVector3()");
+		return { this->x, this->y, this->z };
 	}
 
-	template<typename T>
-	inline void Vec4<T>::operator-=(const Vec4& b) {
-		*this = operator-(b);
+	template<typename T, size_t N>
+	inline QuatT<std::conditional_t<std::is_floating_point_v<T>, T, float>> VecN<T, N>::ToQuaternion() const requires (N == 3)
+	{
+		MATH_INSTRUMENT_SCOPE("Vec3::ToQuaternion()");
+		QuatT<std::conditional_t<std::is_floating_point_v<T>, T, float>> result;
+		Vec3<T> eulerAngle(ToRadians(this->x), ToRadians(this->y), ToRadians(this->z));
+
+		Vec3<T> c;
+		c.x = Cos(eulerAngle.x * T(0.5));
+		c.y = Cos(eulerAngle.y * T(0.5));
+		c.z = Cos(eulerAngle.z * T(0.5));
+
+		Vec3<T> s;
+		s.x = Sin(eulerAngle.x * T(0.5));
+		s.y = Sin(eulerAngle.y * T(0.5));
+		s.z = Sin(eulerAngle.z * T(0.5));
+
+		result.w = c.x * c.y * c.z + s.x * s.y * s.z;
+		result.x = s.x * c.y * c.z - c.x * s.y * s.z;
+		result.y = c.x * s.y * c.z + s.x * c.y * s.z;
+		result.z = c.x * c.y * s.z - s.x * s.y * c.z;
+		return result;
 	}
 
-	template<typename T>
-	inline void Vec4<T>::operator*=(const Vec4& b) {
-		*this = operator*(b);
+	template<typename T, size_t N>
+	inline VecN<float, 2> VecN<T, N>::ToVec2f() const requires (N == 2)
+	{
+		MATH_INSTRUMENT_SCOPE("Vec2::ToVec2f()");
+		return Vec2f{ static_cast<float>(this->x), static_cast<float>(this->y) };
 	}
 
-	template<typename T>
-	template<typename U>
-	inline void Vec4<T>::operator*=(const U& b) {
-		*this = operator*(b);
+	template<typename T, size_t N>
+	inline VecN<int, 2> VecN<T, N>::ToVec2i() const requires (N == 2)
+	{
+		MATH_INSTRUMENT_SCOPE("Vec2::ToVec2i()");
+		return Vec2i{ static_cast<int>(this->x), static_cast<int>(this->y) };
 	}
 
-	template<typename T>
-	template<typename U>
-	inline void Vec4<T>::operator/=(const U& b) {
-		*this = operator/(b);
+	template<typename T, size_t N>
+	inline void VecN<T, N>::Print(int precision /*= 6*/) const
+	{
+		std::cout << std::fixed << std::setprecision(precision);
+		std::cout << ToString(precision) << std::endl;
 	}
 
-	template<typename T>
-	template<typename U>
-	inline bool Vec4<T>::operator==(const Vec4<U>& b) const {
-		return AlmostEqual(x, static_cast<T>(b.x)) && AlmostEqual(y, static_cast<T>(b.y))
-			&& AlmostEqual(z, static_cast<T>(b.z)) && AlmostEqual(w, static_cast<T>(b.w));
+	template<typename T, size_t N>
+	inline std::string VecN<T, N>::ToString(int precision /*= 6*/) const
+	{
+		std::ostringstream oss;
+		oss << std::fixed << std::setprecision(precision);
+		oss << (*this)[0];
+		for (size_t i = 1; i < N; i++)
+			oss << ", " << (*this)[i];
+		return oss.str();
 	}
 
-	template<typename T>
-	template<typename U>
-	inline bool Vec4<T>::operator!=(const Vec4<U>& b) const {
-		return !AlmostEqual(x, static_cast<T>(b.x)) || !AlmostEqual(y, static_cast<T>(b.y))
-			|| !AlmostEqual(z, static_cast<T>(b.z)) || !AlmostEqual(w, static_cast<T>(b.w));
+	template<typename T, size_t N>
+	inline T* VecN<T, N>::Data() const
+	{
+		return const_cast<T*>(reinterpret_cast<const T*>(this));
 	}
 
-	template<typename T>
-	inline constexpr T& Vec4<T>::operator[](const size_t a) {
-		if (a >= 4)
-			return x;
-		return *((&x) + a);
+	template<typename T, size_t N>
+	template<size_t... I>
+	inline constexpr typename VecOf<T, sizeof...(I)>::Type VecN<T, N>::Swizzle() const
+	{
+		static_assert(((I < N) && ...), "Swizzle index out of range");
+		constexpr size_t K = sizeof...(I);
+#if defined(MATH_SSE)
+		if constexpr (simd && (K == 3 || K == 4))
+		{
+			if (!std::is_constant_evaluated())
+			{
+				// The fourth lane of a 3 component result is never stored
+				constexpr size_t lanes[] = { I..., 0 };
+				constexpr int mask = _MM_SHUFFLE(lanes[3], lanes[2], lanes[1], lanes[0]);
+				const __m128 value = Simd::LoadVecN<N>(Data());
+				VecN<T, K> result;
+				Simd::StoreVecN<K>(result.Data(), _mm_shuffle_ps(value, value, mask));
+				return result;
+			}
+		}
+#endif
+		return typename VecOf<T, K>::Type((*this)[I]...);
 	}
 
-	template<typename T>
-	inline const T& Vec4<T>::operator[](const size_t a) const {
-		if (a >= 4)
-			return x;
-		return *((&x) + a);
+	template<typename T, size_t N>
+	template<size_t... I>
+	inline constexpr SwizzleView<VecN<T, N>, I...> VecN<T, N>::View()
+	{
+		static_assert(((I < N) && ...), "Swizzle index out of range");
+		return SwizzleView<VecN, I...>(*this);
 	}
 
-	template<typename T>
-	inline T Vec4<T>::LengthSquared() const {
-		return (x * x + y * y + z * z + w * w);
+	template<typename T, size_t N>
+	inline constexpr VecN<T, N> VecN<T, N>::Axis(size_t axis)
+	{
+		return Generate([&](size_t i) { return i == axis ? 1 : 0; });
 	}
 
-	template<typename T>
-	inline T Vec4<T>::Length() const {
-		return std::sqrt(LengthSquared());
+#ifdef MATH_GLM_EXTENSION
+	template<typename T, size_t N>
+	inline glm::vec<N, float> VecN<T, N>::ToGlm() const requires (N >= 2 && N <= 4)
+	{
+		return [&]<size_t... I>(std::index_sequence<I...>) { return glm::vec<N, float>(static_cast<float>((*this)[I])...); }(std::make_index_sequence<N>());
 	}
 
-	template<typename T>
-	inline T Vec4<T>::Dot(const Vec4& a) const {
-		return (x * a.x + y * a.y + z * a.z + w * a.w);
+	template<typename T, size_t N>
+	inline bool VecN<T, N>::operator==(const glm::vec<N, float>& b) const requires (N >= 2 && N <= 4)
+	{
+		return [&]<size_t... I>(std::index_sequence<I...>) { return (AlmostEqual(static_cast<float>((*this)[I]), b[I]) && ...); }(std::make_index_sequence<N>());
 	}
+#endif
+#pragma endregion
 
-	template<typename T>
-	inline T Vec4<T>::Distance(const Vec4& a) const {
-		return (a - *this).Length();
+#pragma region Batch Conversions
+	inline void ConvertBatch(const float* input, Half* output, size_t count)
+	{
+		MATH_INSTRUMENT_SCOPE("ConvertBatch(float, Half, size_t)");
+		MATH_INSTRUMENT_ITEMS(count);
+		static_assert(sizeof(Half) == sizeof(uint16_t));
+		size_t i = 0;
+#if defined(MATH_F16C)
+		for (; i + 8 <= count; i += 8)
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), _mm256_cvtps_ph(_mm256_loadu_ps(input + i), _MM_FROUND_TO_NEAREST_INT));
+#endif
+		for (; i < count; i++)
+			output[i] = input[i];
 	}
 
-	template<typename T>
-	Vec4<T> Vec4<T>::GetHomogenize() const
+	inline void ConvertBatch(const Half* input, float* output, size_t count)
 	{
-		return { ToVector3() / w };
+		MATH_INSTRUMENT_SCOPE("ConvertBatch(Half, float, size_t)");
+		MATH_INSTRUMENT_ITEMS(count);
+		size_t i = 0;
+#if defined(MATH_F16C)
+		for (; i + 8 <= count; i += 8)
+			_mm256_storeu_ps(output + i, _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i))));
+#endif
+		for (; i < count; i++)
+			output[i] = input[i];
 	}
 
-	template<typename T>
-	void Vec4<T>::Homogenize()
+	inline void ConvertBatch(const float* input, Fixed16_16* output, size_t count)
 	{
-		*this = GetHomogenize();
+		MATH_INSTRUMENT_SCOPE("ConvertBatch(float, Fixed16_16, size_t)");
+		MATH_INSTRUMENT_ITEMS(count);
+		static_assert(sizeof(Fixed16_16) == sizeof(int32_t));
+		size_t i = 0;
+		// Out of range lanes convert to INT32_MIN: flipping every bit of the ones above the range gives INT32_MAX, and NaN lanes are cleared
+#if defined(MATH_AVX)
+		const __m256 scale8 = _mm256_set1_ps(static_cast<float>(Fixed16_16::One));
+		const __m256 limit8 = _mm256_set1_ps(2147483648.f);
+		for (; i + 8 <= count; i += 8)
+		{
+			const __m256 scaled = _mm256_mul_ps(_mm256_loadu_ps(input + i), scale8);
+			__m256 converted = _mm256_castsi256_ps(_mm256_cvtps_epi32(scaled));
+			converted = _mm256_xor_ps(converted, _mm256_cmp_ps(scaled, limit8, _CMP_GE_OQ));
+			converted = _mm256_and_ps(converted, _mm256_cmp_ps(scaled, scaled, _CMP_ORD_Q));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(output + i), _mm256_castps_si256(converted));
+		}
+#endif
+#if defined(MATH_SSE)
+		const __m128 scale4 = _mm_set1_ps(static_cast<float>(Fixed16_16::One));
+		const __m128 limit4 = _mm_set1_ps(2147483648.f);
+		for (; i + 4 <= count; i += 4)
+		{
+			const __m128 scaled = _mm_mul_ps(_mm_loadu_ps(input + i), scale4);
+			__m128 converted = _mm_castsi128_ps(_mm_cvtps_epi32(scaled));
+			converted = _mm_xor_ps(converted, _mm_cmpge_ps(scaled, limit4));
+			converted = _mm_and_ps(converted, _mm_cmpord_ps(scaled, scaled));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), _mm_castps_si128(converted));
+		}
+#endif
+		for (; i < count; i++)
+			output[i] = input[i];
 	}
 
-	template<typename T>
-	inline void Vec4<T>::Normalize()
+	inline void ConvertBatch(const Fixed16_16* input, float* output, size_t count)
 	{
-		*this = GetNormalize();
+		MATH_INSTRUMENT_SCOPE("ConvertBatch(Fixed16_16, float, size_t)");
+		MATH_INSTRUMENT_ITEMS(count);
+		size_t i = 0;
+#if defined(MATH_AVX)
+		const __m256 scale8 = _mm256_set1_ps(1.f / Fixed16_16::One);
+		for (; i + 8 <= count; i += 8)
+			_mm256_storeu_ps(output + i, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i))), scale8));
+#endif
+#if defined(MATH_SSE)
+		const __m128 scale4 = _mm_set1_ps(1.f / Fixed16_16::One);
+		for (; i + 4 <= count; i += 4)
+			_mm_storeu_ps(output + i, _mm_mul_ps(_mm_cvtepi32_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i))), scale4));
+#endif
+		for (; i < count; i++)
+			output[i] = static_cast<float>(input[i]);
 	}
 
-	template<typename T>
-	inline Vec4<T> Vec4<T>::GetNormalize() const {
-		T len = Length();
-		if (len != 0)
-			return operator/(len);
-		return {};
+	// Vectors are tightly packed, so a stream of them is converted as one flat scalar array
+	inline void ConvertBatch(std::span<const Vec3f> input, std::span<Vec3h> output)
+	{
+		ConvertBatch(reinterpret_cast<const float*>(input.data()), reinterpret_cast<Half*>(output.data()), std::min(input.size(), output.size()) * 3);
 	}
 
-	template<typename T>
-	void Vec4<T>::Print(int precision /*= 6*/) const
+	inline void ConvertBatch(std::span<const Vec3h> input, std::span<Vec3f> output)
 	{
-		std::cout << std::fixed << std::setprecision(precision);
-		std::cout << x << ", " << y << ", " << z << ", " << w << std::endl;
+		ConvertBatch(reinterpret_cast<const Half*>(input.data()), reinterpret_cast<float*>(output.data()), std::min(input.size(), output.size()) * 3);
 	}
 
-	template<typename T>
-	Vec3<T> Vec4<T>::ToVector3() const
+	inline void ConvertBatch(std::span<const Vec4f> input, std::span<Vec4h> output)
 	{
-		return { x, y, z };
+		ConvertBatch(reinterpret_cast<const float*>(input.data()), reinterpret_cast<Half*>(output.data()), std::min(input.size(), output.size()) * 4);
 	}
 
-	template<typename T>
-	std::string Vec4<T>::ToString(int precision /*= 6*/) const
+	inline void ConvertBatch(std::span<const Vec4h> input, std::span<Vec4f> output)
 	{
-		std::ostringstream oss;
-		oss << std::fixed << std::setprecision(precision);
-		oss << x << ", " << y << ", " << z << ", " << w;
-		return oss.str();
+		ConvertBatch(reinterpret_cast<const Half*>(input.data()), reinterpret_cast<float*>(output.data()), std::min(input.size(), output.size()) * 4);
 	}
 
-	template<typename T>
-	T* Vec4<T>::Data() const
+	inline void ConvertBatch(std::span<const Vec3f> input, std::span<Vec3<Fixed16_16>> output)
 	{
-		return const_cast<T*>(reinterpret_cast<const T*>(this));
+		ConvertBatch(reinterpret_cast<const float*>(input.data()), reinterpret_cast<Fixed16_16*>(output.data()), std::min(input.size(), output.size()) * 3);
 	}
 
+	inline void ConvertBatch(std::span<const Vec3<Fixed16_16>> input, std::span<Vec3f> output)
+	{
+		ConvertBatch(reinterpret_cast<const Fixed16_16*>(input.data()), reinterpret_cast<float*>(output.data()), std::min(input.size(), output.size()) * 3);
+	}
 #pragma endregion
 
-#pragma  region Mat4
-	inline constexpr Mat4::Mat4(float diagonal)
+#pragma  region Mat4T<T>
+	template<typename T>
+	inline constexpr Mat4T<T>::Mat4T(T diagonal)
 	{
 		content[0][0] = 1;
 		content[1][1] = 1;
@@ -727,7 +1372,8 @@ namespace GALAXY::Math {
 		content[3][3] = 1;
 	}
 
-	inline constexpr Mat4::Mat4(Vec4f m0, Vec4f m1, Vec4f m2, Vec4f m3)
+	template<typename T>
+	inline constexpr Mat4T<T>::Mat4T(Vec4<T> m0, Vec4<T> m1, Vec4<T> m2, Vec4<T> m3)
 	{
 		content[0] = m0;
 		content[1] = m1;
@@ -736,7 +1382,8 @@ namespace GALAXY::Math {
 	}
 
 
-	inline constexpr Mat4::Mat4(const float* data)
+	template<typename T>
+	inline constexpr Mat4T<T>::Mat4T(const float* data)
 	{
 		for (size_t i = 0; i < 4; ++i) {
 			for (size_t j = 0; j < 4; ++j) {
@@ -745,28 +1392,50 @@ namespace GALAXY::Math {
 		}
 	}
 
-	inline constexpr Mat4::Mat4(const double* data)
+	template<typename T>
+	inline constexpr Mat4T<T>::Mat4T(const double* data)
 	{
 		for (size_t i = 0; i < 4; ++i) {
 			for (size_t j = 0; j < 4; ++j) {
-				content[i][j] = static_cast<float>(data[i * 4 + j]);
+				content[i][j] = static_cast<T>(data[i * 4 + j]);
 			}
 		}
 	}
 
-	inline constexpr Mat4 Mat4::operator*(const Mat4& a) const
+	template<typename T>
+	template<typename U>
+	inline constexpr Mat4T<T>::Mat4T(const Mat4T<U>& a)
+	{
+		for (size_t i = 0; i < 4; ++i)
+			content[i] = a.content[i];
+	}
+
+	template<typename T>
+	inline constexpr Mat4T<T> Mat4T<T>::operator*(const Mat4T<T>& a) const
 	{
-		Vec4f SrcA0 = this->content[0];
-		Vec4f SrcA1 = this->content[1];
-		Vec4f SrcA2 = this->content[2];
-		Vec4f SrcA3 = this->content[3];
+		MATH_INSTRUMENT_SCOPE("Mat4::operator*(Mat4)");
+#ifdef MATH_AVX
+		if constexpr (std::is_same_v<T, double>)
+		{
+			if (!std::is_constant_evaluated())
+			{
+				Mat4T<T> Result;
+				Simd::MultiplyMat4d(Data(), a.Data(), Result.Data());
+				return Result;
+			}
+		}
+#endif
+		Vec4<T> SrcA0 = this->content[0];
+		Vec4<T> SrcA1 = this->content[1];
+		Vec4<T> SrcA2 = this->content[2];
+		Vec4<T> SrcA3 = this->content[3];
 
-		Vec4f SrcB0 = a.content[0];
-		Vec4f SrcB1 = a.content[1];
-		Vec4f SrcB2 = a.content[2];
-		Vec4f SrcB3 = a.content[3];
+		Vec4<T> SrcB0 = a.content[0];
+		Vec4<T> SrcB1 = a.content[1];
+		Vec4<T> SrcB2 = a.content[2];
+		Vec4<T> SrcB3 = a.content[3];
 
-		Mat4 Result;
+		Mat4T<T> Result;
 		Result[0] = SrcA0 * SrcB0[0] + SrcA1 * SrcB0[1] + SrcA2 * SrcB0[2] + SrcA3 * SrcB0[3];
 		Result[1] = SrcA0 * SrcB1[0] + SrcA1 * SrcB1[1] + SrcA2 * SrcB1[2] + SrcA3 * SrcB1[3];
 		Result[2] = SrcA0 * SrcB2[0] + SrcA1 * SrcB2[1] + SrcA2 * SrcB2[2] + SrcA3 * SrcB2[3];
@@ -774,26 +1443,41 @@ namespace GALAXY::Math {
 		return Result;
 	}
 
+	template<typename T>
 	template<typename U>
-	inline constexpr Vec4<U> Mat4::operator*(const Vec4<U>& a) const
-	{
-		Vec4f Mov0(a[0]);
-		Vec4f Mov1(a[1]);
-		Vec4f Mul0 = content[0] * Mov0;
-		Vec4f Mul1 = content[1] * Mov1;
-		Vec4f Add0 = Mul0 + Mul1;
-		Vec4f Mov2(a[2]);
-		Vec4f Mov3(a[3]);
-		Vec4f Mul2 = content[2] * Mov2;
-		Vec4f Mul3 = content[3] * Mov3;
-		Vec4f Add1 = Mul2 + Mul3;
-		Vec4f Add2 = Add0 + Add1;
+	inline constexpr Vec4<U> Mat4T<T>::operator*(const Vec4<U>& a) const
+	{
+		MATH_INSTRUMENT_SCOPE("Mat4::operator*(Vec4)");
+#ifdef MATH_AVX
+		if constexpr (std::is_same_v<T, double> && std::is_same_v<U, double>)
+		{
+			if (!std::is_constant_evaluated())
+			{
+				Vec4<U> Result;
+				Simd::TransformVec4d(Data(), a.Data(), Result.Data());
+				return Result;
+			}
+		}
+#endif
+		Vec4<T> Mov0(a[0]);
+		Vec4<T> Mov1(a[1]);
+		Vec4<T> Mul0 = content[0] * Mov0;
+		Vec4<T> Mul1 = content[1] * Mov1;
+		Vec4<T> Add0 = Mul0 + Mul1;
+		Vec4<T> Mov2(a[2]);
+		Vec4<T> Mov3(a[3]);
+		Vec4<T> Mul2 = content[2] * Mov2;
+		Vec4<T> Mul3 = content[3] * Mov3;
+		Vec4<T> Add1 = Mul2 + Mul3;
+		Vec4<T> Add2 = Add0 + Add1;
 		return Add2;
 	}
 
-	inline constexpr Mat4 Mat4::operator+(const Mat4& a) const
+	template<typename T>
+	inline constexpr Mat4T<T> Mat4T<T>::operator+(const Mat4T<T>& a) const
 	{
-		Mat4 tmp;
+		MATH_INSTRUMENT_SCOPE("Mat4::operator+(Mat4)");
+		Mat4T<T> tmp;
 		for (size_t j = 0; j < 4; j++)
 		{
 			tmp.content[j] = content[j] + a.content[j];
@@ -801,13 +1485,16 @@ namespace GALAXY::Math {
 		return tmp;
 	}
 
-	inline constexpr Vec4f& Mat4::operator[](const size_t i)
+	template<typename T>
+	inline constexpr Vec4<T>& Mat4T<T>::operator[](const size_t i)
 	{
 		return content[i];
 	}
 
-	inline constexpr bool Mat4::operator==(const Mat4& b) const
+	template<typename T>
+	inline constexpr bool Mat4T<T>::operator==(const Mat4T<T>& b) const
 	{
+		MATH_INSTRUMENT_SCOPE("Mat4::operator==(Mat4)");
 		for (int i = 0; i < 4; i++)
 		{
 			for (int j = 0; j < 4; j++)
@@ -819,11 +1506,13 @@ namespace GALAXY::Math {
 		return true;
 	}
 
-	inline Mat4 Mat4::CreateProjectionMatrix(float _fov, float _aspect, float _near, float _far)
+	template<typename T>
+	inline Mat4T<T> Mat4T<T>::CreateProjectionMatrix(T _fov, T _aspect, T _near, T _far)
 	{
-		float tanHalfFov = std::tan(_fov * DegToRad * 0.5f);
+		MATH_INSTRUMENT_SCOPE("Mat4::CreateProjectionMatrix(T, T, T, T)");
+		T tanHalfFov = Tan(ToRadians(_fov) * static_cast<T>(0.5));
 
-		Mat4 projectionMatrix = Mat4();
+		Mat4T<T> projectionMatrix = Mat4T<T>();
 		projectionMatrix[0][0] = 1.0f / (_aspect * tanHalfFov);
 		projectionMatrix[1][1] = 1.0f / tanHalfFov;
 		projectionMatrix[2][2] = -(_far + _near) / (_far - _near);
@@ -834,9 +1523,11 @@ namespace GALAXY::Math {
 		return projectionMatrix;
 	}
 
-	inline Mat4 Mat4::CreateOrthographicMatrix(float _left, float _right, float _bottom, float _top, float _near,float _far)
+	template<typename T>
+	inline Mat4T<T> Mat4T<T>::CreateOrthographicMatrix(T _left, T _right, T _bottom, T _top, T _near,T _far)
 	{
-		Mat4 orthographicMatrix = Mat4();
+		MATH_INSTRUMENT_SCOPE("Mat4::CreateOrthographicMatrix(T, T, T, T, T, T)");
+		Mat4T<T> orthographicMatrix = Mat4T<T>();
 		orthographicMatrix[0][0] = 2.0f / (_right - _left);
 		orthographicMatrix[1][1] = 2.0f / (_top - _bottom);
 		orthographicMatrix[2][2] = -2.0f / (_far - _near);
@@ -847,40 +1538,48 @@ namespace GALAXY::Math {
 		return orthographicMatrix;
 	}
 
-	inline Mat4 Mat4::CreateViewMatrix(const Vec3f position, const Quat& rotation)
+	template<typename T>
+	inline Mat4T<T> Mat4T<T>::CreateViewMatrix(const Vec3<T> position, const QuatT<T>& rotation)
 	{
-		Mat4 out = Mat4::CreateTransformMatrix(position, rotation, Vec3f(1, 1, -1));
+		MATH_INSTRUMENT_SCOPE("Mat4::CreateViewMatrix(Vec3, Quat)");
+		Mat4T<T> out = Mat4T<T>::CreateTransformMatrix(position, rotation, Vec3<T>(1, 1, -1));
 		out = out.CreateInverseMatrix();
 		return out;
 	}
 
+	template<typename T>
 	template<typename U>
-	inline Mat4 Mat4::CreateTranslationMatrix(const Vec3<U>& translation)
+	inline Mat4T<T> Mat4T<T>::CreateTranslationMatrix(const Vec3<U>& translation)
 	{
-		Mat4 out(1);
+		MATH_INSTRUMENT_SCOPE("Mat4::CreateTranslationMatrix(Vec3)");
+		Mat4T<T> out(1);
 		out[3] = translation;
 		return out;
 	}
 
-	inline Mat4 Mat4::CreateRotationMatrix(const Quat& rotation)
+	template<typename T>
+	inline Mat4T<T> Mat4T<T>::CreateRotationMatrix(const QuatT<T>& rotation)
 	{
+		MATH_INSTRUMENT_SCOPE("Mat4::CreateRotationMatrix(Quat)");
 		return rotation.ToRotationMatrix();
 	}
 
+	template<typename T>
 	template<typename U>
-	inline Mat4 Mat4::CreateRotationMatrix(const Vec3<U>& rotation)
-	{
-		float t1 = rotation.x * DegToRad;
-		float t2 = rotation.y * DegToRad;
-		float t3 = rotation.z * DegToRad;
-		float c1 = std::cos(-t1);
-		float c2 = std::cos(-t2);
-		float c3 = std::cos(-t3);
-		float s1 = std::sin(-t1);
-		float s2 = std::sin(-t2);
-		float s3 = std::sin(-t3);
-
-		Mat4 Result;
+	inline Mat4T<T> Mat4T<T>::CreateRotationMatrix(const Vec3<U>& rotation)
+	{
+		MATH_INSTRUMENT_SCOPE("Mat4::CreateRotationMatrix(Vec3)");
+		T t1 = ToRadians(static_cast<T>(rotation.x));
+		T t2 = ToRadians(static_cast<T>(rotation.y));
+		T t3 = ToRadians(static_cast<T>(rotation.z));
+		T c1 = Cos(-t1);
+		T c2 = Cos(-t2);
+		T c3 = Cos(-t3);
+		T s1 = Sin(-t1);
+		T s2 = Sin(-t2);
+		T s3 = Sin(-t3);
+
+		Mat4T<T> Result;
 		Result[0][0] = c2 * c3;
 		Result[0][1] = -c1 * s3 + s1 * s2 * c3;
 		Result[0][2] = s1 * s3 + c1 * s2 * c3;
@@ -900,24 +1599,30 @@ namespace GALAXY::Math {
 		return Result;
 	}
 
+	template<typename T>
 	template<typename U>
-	inline Mat4 Mat4::CreateScaleMatrix(const Vec3<U>& scale)
+	inline Mat4T<T> Mat4T<T>::CreateScaleMatrix(const Vec3<U>& scale)
 	{
-		Mat4 out(1);
+		MATH_INSTRUMENT_SCOPE("Mat4::CreateScaleMatrix(Vec3)");
+		Mat4T<T> out(1);
 		for (size_t i = 0; i < 3; i++)
 			out[i][i] = scale[i];
 		return out;
 	}
 
+	template<typename T>
 	template<typename U>
-	inline Mat4 Mat4::CreateTransformMatrix(const Vec3<U>& position, const Vec3<U>& rotation, const Vec3<U>& scale)
+	inline Mat4T<T> Mat4T<T>::CreateTransformMatrix(const Vec3<U>& position, const Vec3<U>& rotation, const Vec3<U>& scale)
 	{
+		MATH_INSTRUMENT_SCOPE("Mat4::CreateTransformMatrix(Vec3, Vec3, Vec3)");
 		return CreateTranslationMatrix(position) * CreateRotationMatrix(rotation) * CreateScaleMatrix(scale);
 	}
 
+	template<typename T>
 	template<typename U>
-	inline Mat4 Mat4::CreateTransformMatrix(const Vec3<U>& position, const Quat& rotation, const Vec3<U>& scale)
+	inline Mat4T<T> Mat4T<T>::CreateTransformMatrix(const Vec3<U>& position, const QuatT<T>& rotation, const Vec3<U>& scale)
 	{
+		MATH_INSTRUMENT_SCOPE("Mat4::CreateTransformMatrix(Vec3, Quat, Vec3)");
 		return CreateTranslationMatrix(position) * rotation.ToRotationMatrix() * CreateScaleMatrix(scale);
 	}
 	/*
@@ -929,10 +1634,12 @@ namespace GALAXY::Math {
 	}
 	*/
 
-	inline void Mat4::DecomposeTransformMatrix(Vec3f& translation, Quat& rotation, Vec3f& scale) const
+	template<typename T>
+	inline void Mat4T<T>::DecomposeTransformMatrix(Vec3<T>& translation, QuatT<T>& rotation, Vec3<T>& scale) const
 	{
-		Vec4f Perspective;
-		Mat4 LocalMatrix(*this);
+		MATH_INSTRUMENT_SCOPE("Mat4::DecomposeTransformMatrix(Vec3, Quat, Vec3)");
+		Vec4<T> Perspective;
+		Mat4T<T> LocalMatrix(*this);
 
 		for (size_t i = 0; i < 4; ++i)
 			for (size_t j = 0; j < 4; ++j)
@@ -940,15 +1647,15 @@ namespace GALAXY::Math {
 
 		// perspectiveMatrix is used to solve for perspective, but it also provides
 		// an easy way to test for singularity of the upper 3x3 component.
-		Mat4 PerspectiveMatrix(LocalMatrix);
+		Mat4T<T> PerspectiveMatrix(LocalMatrix);
 
 		for (size_t i = 0; i < 3; i++)
 			PerspectiveMatrix[i][3] = 0.f;
 		PerspectiveMatrix[3][3] = 1.f;
 
-		auto epsilonNotEqual = [](float a, float b) -> bool
+		auto epsilonNotEqual = [](T a, T b) -> bool
 			{
-				return std::abs(a - b) >= std::numeric_limits<float>::epsilon();
+				return std::abs(a - b) >= std::numeric_limits<T>::epsilon();
 			};
 
 		// First, isolate perspective.  This is the messiest.
@@ -959,7 +1666,7 @@ namespace GALAXY::Math {
 			)
 		{
 			// rightHandSide is the right hand side of the equation.
-			Vec4f RightHandSide;
+			Vec4<T> RightHandSide;
 			RightHandSide[0] = LocalMatrix[0][3];
 			RightHandSide[1] = LocalMatrix[1][3];
 			RightHandSide[2] = LocalMatrix[2][3];
@@ -968,8 +1675,8 @@ namespace GALAXY::Math {
 			// Solve the equation by inverting PerspectiveMatrix and multiplying
 			// rightHandSide by the inverse.  (This is the easiest way, not
 			// necessarily the best.)
-			Mat4 InversePerspectiveMatrix = PerspectiveMatrix.CreateInverseMatrix();//   inverse(PerspectiveMatrix, inversePerspectiveMatrix);
-			Mat4 TransposedInversePerspectiveMatrix = InversePerspectiveMatrix.GetTranspose();//   transposeMatrix4(inversePerspectiveMatrix, transposedInversePerspectiveMatrix);
+			Mat4T<T> InversePerspectiveMatrix = PerspectiveMatrix.CreateInverseMatrix();//   inverse(PerspectiveMatrix, inversePerspectiveMatrix);
+			Mat4T<T> TransposedInversePerspectiveMatrix = InversePerspectiveMatrix.GetTranspose();//   transposeMatrix4(inversePerspectiveMatrix, transposedInversePerspectiveMatrix);
 
 			Perspective = TransposedInversePerspectiveMatrix * RightHandSide;
 			//  v4MulPointByMatrix(rightHandSide, transposedInversePerspectiveMatrix, perspectivePoint);
@@ -981,28 +1688,28 @@ namespace GALAXY::Math {
 		else
 		{
 			// No perspective.
-			Perspective = Vec4f(0, 0, 0, 1);
+			Perspective = Vec4<T>(0, 0, 0, 1);
 		}
 
 		(void)(Perspective);
 
 		// Next take care of translation (easy).
-		translation = Vec3f(LocalMatrix[3]);
-		LocalMatrix[3] = Vec4f(0, 0, 0, LocalMatrix[3].w);
+		translation = Vec3<T>(LocalMatrix[3]);
+		LocalMatrix[3] = Vec4<T>(0, 0, 0, LocalMatrix[3].w);
 
-		Vec3f Row[3], Pdum3, Skew;
+		Vec3<T> Row[3], Pdum3, Skew;
 
 		// Now get scale and shear.
 		for (size_t i = 0; i < 3; ++i)
 			for (size_t j = 0; j < 3; ++j)
 				Row[i][j] = LocalMatrix[i][j];
 
-		auto scaleVector = [](Vec3f v, float s)->Vec3f
+		auto scaleVector = [](Vec3<T> v, T s)->Vec3<T>
 			{
 				return v * s / v.Length();
 			};
 
-		auto combine = [](Vec3f a, Vec3f b, float ascl, float bscl)->Vec3f
+		auto combine = [](Vec3<T> a, Vec3<T> b, T ascl, T bscl)->Vec3<T>
 			{
 				return a * ascl + b * bscl;
 			};
@@ -1069,10 +1776,10 @@ namespace GALAXY::Math {
 		// }
 
 		int i, j, k = 0;
-		float root, trace = Row[0].x + Row[1].y + Row[2].z;
+		T root, trace = Row[0].x + Row[1].y + Row[2].z;
 		if (trace > 0.f)
 		{
-			root = std::sqrt(trace + 1.f);
+			root = Sqrt(trace + 1.f);
 			rotation.w = 0.5f * root;
 			root = 0.5f / root;
 			rotation.x = root * (Row[1].z - Row[2].y);
@@ -1088,7 +1795,7 @@ namespace GALAXY::Math {
 			j = Next[i];
 			k = Next[j];
 
-			root = std::sqrt(Row[i][i] - Row[j][j] - Row[k][k] + 1.0f);
+			root = Sqrt(Row[i][i] - Row[j][j] - Row[k][k] + 1.0f);
 
 			rotation[i] = 0.5f * root;
 			root = 0.5f / root;
@@ -1100,93 +1807,103 @@ namespace GALAXY::Math {
 		rotation.Conjugate();
 	}
 
-	inline Vec3f Mat4::GetTranslation() const
+	template<typename T>
+	inline Vec3<T> Mat4T<T>::GetTranslation() const
 	{
-		return content[3];
+		MATH_INSTRUMENT_SCOPE("Mat4::GetTranslation()");
+		return content[3].xyz();
 	}
 
-	inline Vec3f Mat4::GetScale() const
+	template<typename T>
+	inline Vec3<T> Mat4T<T>::GetScale() const
 	{
+		MATH_INSTRUMENT_SCOPE("Mat4::GetScale()");
 		// World Scale equal length of columns of the model matrix.
-		float x = Vec3f(content[0][0], content[0][1], content[0][2]).Length();
-		float y = Vec3f(content[1][0], content[1][1], content[1][2]).Length();
-		float z = Vec3f(content[2][0], content[2][1], content[2][2]).Length();
+		T x = Vec3<T>(content[0][0], content[0][1], content[0][2]).Length();
+		T y = Vec3<T>(content[1][0], content[1][1], content[1][2]).Length();
+		T z = Vec3<T>(content[2][0], content[2][1], content[2][2]).Length();
 		return { x, y, z };
 	}
 
-	inline Quat Mat4::GetRotation() const
+	template<typename T>
+	inline QuatT<T> Mat4T<T>::GetRotation() const
 	{
+		MATH_INSTRUMENT_SCOPE("Mat4::GetRotation()");
 		// !! Work only with rotation matrix
-		Mat4 temp = ToRotationMatrix();
+		Mat4T<T> temp = ToRotationMatrix();
 
 		// Extracting the rotation from the matrix
-		float trace = temp.content[0][0] + temp.content[1][1] + temp.content[2][2];
+		T trace = temp.content[0][0] + temp.content[1][1] + temp.content[2][2];
 
 		if (trace > 0)
 		{
-			float s = 0.5f / std::sqrt(trace + 1.0f);
-			float w = 0.25f / s;
-			float x = (temp.content[1][2] - temp.content[2][1]) * s;
-			float y = (temp.content[2][0] - temp.content[0][2]) * s;
-			float z = (temp.content[0][1] - temp.content[1][0]) * s;
-			return Quat(x, y, z, w).GetInverse();
+			T s = 0.5f / Sqrt(trace + 1.0f);
+			T w = 0.25f / s;
+			T x = (temp.content[1][2] - temp.content[2][1]) * s;
+			T y = (temp.content[2][0] - temp.content[0][2]) * s;
+			T z = (temp.content[0][1] - temp.content[1][0]) * s;
+			return QuatT<T>(x, y, z, w).GetInverse();
 		}
 		else if (temp.content[0][0] > temp.content[1][1] && temp.content[0][0] > temp.content[2][2])
 		{
-			float s = 2.0f * std::sqrt(1.0f + temp.content[0][0] - temp.content[1][1] - temp.content[2][2]);
-			float x = 0.25f * s;
-			float w = (temp.content[1][2] - temp.content[2][1]) / s;
-			float y = (temp.content[1][0] + temp.content[0][1]) / s;
-			float z = (temp.content[2][0] + temp.content[0][2]) / s;
-			return Quat(x, y, z, w).GetInverse();
+			T s = 2.0f * Sqrt(1.0f + temp.content[0][0] - temp.content[1][1] - temp.content[2][2]);
+			T x = 0.25f * s;
+			T w = (temp.content[1][2] - temp.content[2][1]) / s;
+			T y = (temp.content[1][0] + temp.content[0][1]) / s;
+			T z = (temp.content[2][0] + temp.content[0][2]) / s;
+			return QuatT<T>(x, y, z, w).GetInverse();
 		}
 		else if (temp.content[1][1] > temp.content[2][2])
 		{
-			float s = 2.0f * std::sqrt(1.0f + temp.content[1][1] - temp.content[0][0] - temp.content[2][2]);
-			float y = 0.25f * s;
-			float w = (temp.content[2][0] - temp.content[0][2]) / s;
-			float x = (temp.content[1][0] + temp.content[0][1]) / s;
-			float z = (temp.content[2][1] + temp.content[1][2]) / s;
-			return Quat(x, y, z, w).GetInverse();
+			T s = 2.0f * Sqrt(1.0f + temp.content[1][1] - temp.content[0][0] - temp.content[2][2]);
+			T y = 0.25f * s;
+			T w = (temp.content[2][0] - temp.content[0][2]) / s;
+			T x = (temp.content[1][0] + temp.content[0][1]) / s;
+			T z = (temp.content[2][1] + temp.content[1][2]) / s;
+			return QuatT<T>(x, y, z, w).GetInverse();
 		}
 		else
 		{
-			float s = 2.0f * std::sqrt(1.0f + temp.content[2][2] - temp.content[0][0] - temp.content[1][1]);
-			float w = (temp.content[0][1] - temp.content[1][0]) / s;
-			float x = (temp.content[2][0] + temp.content[0][2]) / s;
-			float y = (temp.content[2][1] + temp.content[1][2]) / s;
-			float z = 0.25f * s;
-			return Quat(x, y, z, w).GetInverse();
+			T s = 2.0f * Sqrt(1.0f + temp.content[2][2] - temp.content[0][0] - temp.content[1][1]);
+			T w = (temp.content[0][1] - temp.content[1][0]) / s;
+			T x = (temp.content[2][0] + temp.content[0][2]) / s;
+			T y = (temp.content[2][1] + temp.content[1][2]) / s;
+			T z = 0.25f * s;
+			return QuatT<T>(x, y, z, w).GetInverse();
 		}
 	}
 
-	inline Mat4 Mat4::CreateInverseMatrix() const
+	template<typename T>
+	inline Mat4T<T> Mat4T<T>::CreateInverseMatrix() const
 	{
+		MATH_INSTRUMENT_SCOPE("Mat4::CreateInverseMatrix()");
 		// Find determinant of matrix
-		Mat4 inverse;
-		float det = GetDeterminant(4);
+		Mat4T<T> inverse;
+		T det = GetDeterminant(4);
 		if (det == 0)
 		{
 			std::cout << "ERROR with Inverse Matrix" << std::endl;
-			return Mat4::Identity();
+			return Mat4T<T>::Identity();
 		}
 
 		// Find adjoint
-		Mat4 adj = CreateAdjMatrix();
+		Mat4T<T> adj = CreateAdjMatrix();
 
 		// Find Inverse using formula "inverse(A) = adj(A)/det(A)"
 		for (int i = 0; i < 4; i++)
 			for (int j = 0; j < 4; j++)
-				inverse.content[i][j] = adj.content[i][j] / float(det);
+				inverse.content[i][j] = adj.content[i][j] / T(det);
 
 		return inverse;
 	}
 
-	inline Mat4 Mat4::CreateAdjMatrix() const
+	template<typename T>
+	inline Mat4T<T> Mat4T<T>::CreateAdjMatrix() const
 	{
+		MATH_INSTRUMENT_SCOPE("Mat4::CreateAdjMatrix()");
 		// temp is used to store cofactors of matrix
-		Mat4 temp;
-		Mat4 adj;
+		Mat4T<T> temp;
+		Mat4T<T> adj;
 		int sign = 1;
 
 		for (int i = 0; i < 4; i++)
@@ -1202,15 +1919,17 @@ namespace GALAXY::Math {
 
 				// Interchanging rows and columns to get the
 				// transpose of the cofactor matrix
-				adj.content[j][i] = (float)((sign) * (temp.GetDeterminant(3)));
+				adj.content[j][i] = (T)((sign) * (temp.GetDeterminant(3)));
 			}
 		}
 		return adj;
 	}
 
-	inline Mat4 Mat4::GetCofactor(int p, int q, int n) const
+	template<typename T>
+	inline Mat4T<T> Mat4T<T>::GetCofactor(int p, int q, int n) const
 	{
-		Mat4 mat;
+		MATH_INSTRUMENT_SCOPE("Mat4::GetCofactor(int, int, int)");
+		Mat4T<T> mat;
 		int i = 0, j = 0;
 		// Looping for each element of the matrix
 		for (int row = 0; row < n; row++)
@@ -1236,16 +1955,18 @@ namespace GALAXY::Math {
 		return mat;
 	}
 
-	inline float Mat4::GetDeterminant(float n) const
+	template<typename T>
+	inline T Mat4T<T>::GetDeterminant(int n) const
 	{
+		MATH_INSTRUMENT_SCOPE("Mat4::GetDeterminant(int)");
 		if (n == 2)
 		{
-			float result = content[0][0] * content[1][1] - content[1][0] * content[0][1];
+			T result = content[0][0] * content[1][1] - content[1][0] * content[0][1];
 			return result;
 		}
 		else if (n == 3)
 		{
-			float result = content[0][0] * content[1][1] * content[2][2]
+			T result = content[0][0] * content[1][1] * content[2][2]
 				- content[0][0] * content[2][1] * content[1][2]
 				+ content[1][0] * content[2][1] * content[0][2]
 				- content[1][0] * content[0][1] * content[2][2]
@@ -1255,7 +1976,7 @@ namespace GALAXY::Math {
 		}
 		else if (n == 4)
 		{
-			float result = content[0][0] * (content[1][1] * content[2][2] * content[3][3] // a(fkp
+			T result = content[0][0] * (content[1][1] * content[2][2] * content[3][3] // a(fkp
 				- content[1][1] * content[3][2] * content[2][3] //flo
 				- content[2][1] * content[1][2] * content[3][3] //gjp
 				+ content[2][1] * content[3][2] * content[1][3] //gln
@@ -1287,10 +2008,12 @@ namespace GALAXY::Math {
 		else return 0.0f;
 	}
 
-	inline Mat4 Mat4::GetTranspose() const
+	template<typename T>
+	inline Mat4T<T> Mat4T<T>::GetTranspose() const
 	{
-		Mat4 transpose = *this;
-		float temp;
+		MATH_INSTRUMENT_SCOPE("Mat4::GetTranspose()");
+		Mat4T<T> transpose = *this;
+		T temp;
 
 		for (int i = 0; i < 4; i++) {
 			for (int j = i + 1; j < 4; j++) {
@@ -1302,9 +2025,11 @@ namespace GALAXY::Math {
 		return transpose;
 	}
 
+	template<typename T>
 	template<typename U>
-	inline Vec3<U> Mat4::MultiplyPoint3x4(Vec3<U> point)
+	inline Vec3<U> Mat4T<T>::MultiplyPoint3x4(Vec3<U> point)
 	{
+		MATH_INSTRUMENT_SCOPE("Mat4::MultiplyPoint3x4(Vec3)");
 		Vec3<U> res;
 		res.x = content[0][0] * point.x + content[0][1] * point.y + content[0][2] * point.z + content[0][3];
 		res.y = content[1][0] * point.x + content[1][1] * point.y + content[1][2] * point.z + content[1][3];
@@ -1312,9 +2037,11 @@ namespace GALAXY::Math {
 		return res;
 	}
 
+	template<typename T>
 	template<typename U>
-	inline Vec3<U> Mat4::MultiplyVector(Vec3<U> vector)
+	inline Vec3<U> Mat4T<T>::MultiplyVector(Vec3<U> vector)
 	{
+		MATH_INSTRUMENT_SCOPE("Mat4::MultiplyVector(Vec3)");
 		Vec3<U> res;
 		res.x = content[0][0] * vector.x + content[0][1] * vector.y + content[0][2] * vector.z;
 		res.y = content[1][0] * vector.x + content[1][1] * vector.y + content[1][2] * vector.z;
@@ -1322,12 +2049,14 @@ namespace GALAXY::Math {
 		return res;
 	}
 
-	inline float* Mat4::Data() const
+	template<typename T>
+	inline T* Mat4T<T>::Data() const
 	{
-		return const_cast<float*>(reinterpret_cast<const float*>(this));
+		return const_cast<T*>(reinterpret_cast<const T*>(this));
 	}
 
-	inline void Mat4::Print() const
+	template<typename T>
+	inline void Mat4T<T>::Print() const
 	{
 		for (int j = 0; j < 4; j++)
 		{
@@ -1341,7 +2070,8 @@ namespace GALAXY::Math {
 		printf("\n");
 	}
 
-	inline std::string Math::Mat4::ToString() const
+	template<typename T>
+	inline std::string Mat4T<T>::ToString() const
 	{
 		std::string print;
 		for (int j = 0; j < 4; j++)
@@ -1357,20 +2087,23 @@ namespace GALAXY::Math {
 		return print;
 	}
 
-	inline Mat4 Mat4::ToRotationMatrix() const
+	template<typename T>
+	inline Mat4T<T> Mat4T<T>::ToRotationMatrix() const
 	{		
+		MATH_INSTRUMENT_SCOPE("Mat4::ToRotationMatrix()");
 		// Convert to rotation Matrix
-		Vec3f scale = GetScale();
-		return Mat4(
-			Vec4f(Vec3f(content[0]) / scale[0], 0),
-			Vec4f(Vec3f(content[1]) / scale[1], 0),
-			Vec4f(Vec3f(content[2]) / scale[2], 0),
-			Vec4f(0));
+		Vec3<T> scale = GetScale();
+		return Mat4T<T>(
+			Vec4<T>(Vec3<T>(content[0]) / scale[0], 0),
+			Vec4<T>(Vec3<T>(content[1]) / scale[1], 0),
+			Vec4<T>(Vec3<T>(content[2]) / scale[2], 0),
+			Vec4<T>(0));
 	}
 
 #ifdef MATH_GLM_EXTENSION
 
-	Mat4::Mat4(const glm::mat4& mat)
+	template<typename T>
+	inline Mat4T<T>::Mat4T(const glm::mat4& mat)
 	{
 		for (int i = 0; i < 4; i++)
 		{
@@ -1381,7 +2114,8 @@ namespace GALAXY::Math {
 		}
 	}
 
-	glm::mat4 Mat4::ToGlm() const
+	template<typename T>
+	inline glm::mat4 Mat4T<T>::ToGlm() const
 	{
 		auto mat = glm::mat4();
 		for (int i = 0; i < 4; i++)
@@ -1394,7 +2128,8 @@ namespace GALAXY::Math {
 		return mat;
 	}
 
-	inline bool Mat4::operator==(const glm::mat4& b) const
+	template<typename T>
+	inline bool Mat4T<T>::operator==(const glm::mat4& b) const
 	{
 		for (int i = 0; i < 4; i++)
 		{
@@ -1407,11 +2142,55 @@ namespace GALAXY::Math {
 		return true;
 	}
 #endif
+
+	inline void RebaseToCamera(std::span<const Mat4d> world, const Vec3d& cameraPosition, std::span<Mat4f> output)
+	{
+		MATH_INSTRUMENT_SCOPE("RebaseToCamera(span, Vec3d, span)");
+		const size_t count = std::min(world.size(), output.size());
+		MATH_INSTRUMENT_ITEMS(count);
+		size_t i = 0;
+#if defined(MATH_AVX)
+		const __m256d origin = _mm256_setr_pd(cameraPosition.x, cameraPosition.y, cameraPosition.z, 0.0);
+		for (; i < count; i++)
+		{
+			const double* in = world[i].Data();
+			float* out = output[i].Data();
+			_mm_storeu_ps(out, _mm256_cvtpd_ps(_mm256_loadu_pd(in)));
+			_mm_storeu_ps(out + 4, _mm256_cvtpd_ps(_mm256_loadu_pd(in + 4)));
+			_mm_storeu_ps(out + 8, _mm256_cvtpd_ps(_mm256_loadu_pd(in + 8)));
+			_mm_storeu_ps(out + 12, _mm256_cvtpd_ps(_mm256_sub_pd(_mm256_loadu_pd(in + 12), origin)));
+		}
+#elif defined(MATH_SSE)
+		const __m128d originXY = _mm_setr_pd(cameraPosition.x, cameraPosition.y);
+		const __m128d originZW = _mm_setr_pd(cameraPosition.z, 0.0);
+		for (; i < count; i++)
+		{
+			const double* in = world[i].Data();
+			float* out = output[i].Data();
+			for (size_t row = 0; row < 3; row++)
+			{
+				__m128 low = _mm_cvtpd_ps(_mm_loadu_pd(in + row * 4));
+				__m128 high = _mm_cvtpd_ps(_mm_loadu_pd(in + row * 4 + 2));
+				_mm_storeu_ps(out + row * 4, _mm_movelh_ps(low, high));
+			}
+			__m128 low = _mm_cvtpd_ps(_mm_sub_pd(_mm_loadu_pd(in + 12), originXY));
+			__m128 high = _mm_cvtpd_ps(_mm_sub_pd(_mm_loadu_pd(in + 14), originZW));
+			_mm_storeu_ps(out + 12, _mm_movelh_ps(low, high));
+		}
+#endif
+		for (; i < count; i++)
+		{
+			Mat4d local = world[i];
+			local[3] = local[3] - Vec4d(cameraPosition, 0);
+			output[i] = Mat4f(local);
+		}
+	}
 #pragma  endregion
 
 #pragma region Quaternion
 
-	inline Quat::Quat(const std::string& str)
+	template<typename T>
+	inline QuatT<T>::QuatT(const std::string& str)
 	{
 		std::istringstream ss(str);
 
@@ -1419,130 +2198,194 @@ namespace GALAXY::Math {
 		ss >> this->x >> discard >> this->y >> discard >> this->z >> discard >> this->w;
 	}
 
-	inline constexpr Quat Quat::operator+(const Quat& a) const
+	template<typename T>
+	inline constexpr QuatT<T> QuatT<T>::operator+(const QuatT<T>& a) const
 	{
-		return Quat(x + a.x, y + a.y, z + a.z, w + a.w);
+		MATH_INSTRUMENT_SCOPE("Quat::operator+(Quat)");
+		return QuatT<T>(x + a.x, y + a.y, z + a.z, w + a.w);
 	}
 
-	inline constexpr Quat Quat::operator-(const Quat& a) const
+	template<typename T>
+	inline constexpr QuatT<T> QuatT<T>::operator-(const QuatT<T>& a) const
 	{
-		return Quat(x - a.x, y - a.y, z - a.z, w - a.w);
+		MATH_INSTRUMENT_SCOPE("Quat::operator-(Quat)");
+		return QuatT<T>(x - a.x, y - a.y, z - a.z, w - a.w);
 	}
 
-	inline constexpr Quat Quat::operator*(const Quat& a) const
+	template<typename T>
+	inline constexpr QuatT<T> QuatT<T>::operator*(const QuatT<T>& a) const
 	{
-		return Quat(
+		MATH_INSTRUMENT_SCOPE("Quat::operator*(Quat)");
+		return QuatT<T>(
 			w * a.x + x * a.w + y * a.z - z * a.y,
 			w * a.y + y * a.w + z * a.x - x * a.z,
 			w * a.z + z * a.w + x * a.y - y * a.x,
 			w * a.w - x * a.x - y * a.y - z * a.z);
 	}
 
-	inline constexpr Quat Quat::operator*(float a) const
+	template<typename T>
+	inline constexpr QuatT<T> QuatT<T>::operator*(T a) const
 	{
-		return Quat(this->x * a, this->y * a, this->z * a, this->w * a);
+		MATH_INSTRUMENT_SCOPE("Quat::operator*(T)");
+		return QuatT<T>(this->x * a, this->y * a, this->z * a, this->w * a);
 	}
+	template<typename T>
 	template<typename U>
-	inline constexpr Vec3<U> Quat::operator*(const Vec3<U>& v) const
-	{
-#if 0
-		Vec3<U> vector;
-		float ax = x * 2.f;
-		float ay = y * 2.f;
-		float az = z * 2.f;
-		float xx = x * ax;
-		float yy = y * ay;
-		float zz = z * az;
-		float xy = x * ay;
-		float xz = x * az;
-		float yz = y * az;
-		float wx = w * ax;
-		float wy = w * ay;
-		float wz = w * az;
-		return { (1.f - (yy + zz)) * a.x + (xy - wz) * a.y + (xz + wy) * a.z ,
-				(xy + wz) * a.x + (1.f - (xx + zz)) * a.y + (yz - wx) * a.z ,
-				(xz - wy) * a.x + (yz + wx) * a.y + (1.f - (xx + yy)) * a.z
-};
-#else
-		Quat q = *this;
-		Vec3f const QuatVector(q.x, q.y, q.z);
-		Vec3f const uv(QuatVector.Cross(v));
-		Vec3f const uuv(QuatVector.Cross(uv));
+	inline constexpr Vec3<U> QuatT<T>::operator*(const Vec3<U>& v) const
+	{
+		MATH_INSTRUMENT_BATCHABLE("Quat::operator*(Vec3)", "Quat::Rotate(span, span)");
+		QuatT<T> q = *this;
+		Vec3<T> const QuatVector(q.x, q.y, q.z);
+		Vec3<T> const uv(QuatVector.Cross(v));
+		Vec3<T> const uuv(QuatVector.Cross(uv));
 		return v + ((uv * q.w) + uuv) * static_cast<U>(2);
-#endif
+	}
+
+	template<typename T>
+	inline void QuatT<T>::Rotate(std::span<const Vec3<T>> input, std::span<Vec3<T>> output) const
+	{
+		MATH_INSTRUMENT_SCOPE("Quat::Rotate(span, span)");
+		const size_t count = std::min(input.size(), output.size());
+		MATH_INSTRUMENT_ITEMS(count);
+		if (count < RotateBasisThreshold)
+		{
+			for (size_t i = 0; i < count; i++)
+				output[i] = *this * input[i];
+			return;
+		}
+
+		// Build the basis once, each vector then costs 9 mul and 6 add instead of two cross products.
+		Vec3<T> xAxis, yAxis, zAxis;
+		GetBasis(xAxis, yAxis, zAxis);
 
+		size_t i = 0;
+		if constexpr (std::is_same_v<T, float>)
+		{
+#ifdef MATH_AVX
+			{
+				const __m256 m00 = _mm256_set1_ps(xAxis.x), m01 = _mm256_set1_ps(xAxis.y), m02 = _mm256_set1_ps(xAxis.z);
+				const __m256 m10 = _mm256_set1_ps(yAxis.x), m11 = _mm256_set1_ps(yAxis.y), m12 = _mm256_set1_ps(yAxis.z);
+				const __m256 m20 = _mm256_set1_ps(zAxis.x), m21 = _mm256_set1_ps(zAxis.y), m22 = _mm256_set1_ps(zAxis.z);
+				for (; i + 8 <= count; i += 8)
+				{
+					__m256 vx, vy, vz;
+					Simd::LoadVec3x8(input[i].Data(), vx, vy, vz);
+					__m256 rx = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m00, vx), _mm256_mul_ps(m10, vy)), _mm256_mul_ps(m20, vz));
+					__m256 ry = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m01, vx), _mm256_mul_ps(m11, vy)), _mm256_mul_ps(m21, vz));
+					__m256 rz = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m02, vx), _mm256_mul_ps(m12, vy)), _mm256_mul_ps(m22, vz));
+					Simd::StoreVec3x8(output[i].Data(), rx, ry, rz);
+				}
+			}
+#endif
+#ifdef MATH_SSE
+			{
+				const __m128 m00 = _mm_set1_ps(xAxis.x), m01 = _mm_set1_ps(xAxis.y), m02 = _mm_set1_ps(xAxis.z);
+				const __m128 m10 = _mm_set1_ps(yAxis.x), m11 = _mm_set1_ps(yAxis.y), m12 = _mm_set1_ps(yAxis.z);
+				const __m128 m20 = _mm_set1_ps(zAxis.x), m21 = _mm_set1_ps(zAxis.y), m22 = _mm_set1_ps(zAxis.z);
+				for (; i + 4 <= count; i += 4)
+				{
+					__m128 vx, vy, vz;
+					Simd::LoadVec3x4(input[i].Data(), vx, vy, vz);
+					__m128 rx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m00, vx), _mm_mul_ps(m10, vy)), _mm_mul_ps(m20, vz));
+					__m128 ry = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m01, vx), _mm_mul_ps(m11, vy)), _mm_mul_ps(m21, vz));
+					__m128 rz = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m02, vx), _mm_mul_ps(m12, vy)), _mm_mul_ps(m22, vz));
+					Simd::StoreVec3x4(output[i].Data(), rx, ry, rz);
+				}
+			}
+#endif
+		}
+		for (; i < count; i++)
+		{
+			const Vec3<T> v = input[i];
+			output[i] = xAxis * v.x + yAxis * v.y + zAxis * v.z;
+		}
 	}
 
-	inline void Quat::operator*=(const Quat& a)
+	template<typename T>
+	inline void QuatT<T>::operator*=(const QuatT<T>& a)
 	{
+		MATH_INSTRUMENT_SCOPE("Quat::operator*=(Quat)");
 		*this = operator*(a);
 	}
 
-	inline void Quat::operator*=(float a)
+	template<typename T>
+	inline void QuatT<T>::operator*=(T a)
 	{
+		MATH_INSTRUMENT_SCOPE("Quat::operator*=(T)");
 		*this = operator*(a);
 	}
 
-	inline bool Quat::operator==(const Quat& a) const
+	template<typename T>
+	inline bool QuatT<T>::operator==(const QuatT<T>& a) const
 	{
+		MATH_INSTRUMENT_SCOPE("Quat::operator==(Quat)");
 		return AlmostEqual(x, a.x) && AlmostEqual(y, a.y)
 			&& AlmostEqual(z, a.z) && AlmostEqual(w, a.w);
 	}
 
-	inline bool Quat::operator!=(const Quat& a) const
+	template<typename T>
+	inline bool QuatT<T>::operator!=(const QuatT<T>& a) const
 	{
+		MATH_INSTRUMENT_SCOPE("Quat::operator!=(Quat)");
 		return	!AlmostEqual(x, a.x) || !AlmostEqual(y, a.y)
 			|| !AlmostEqual(z, a.z) || !AlmostEqual(w, a.w);
 	}
 
-	inline float& Quat::operator[](const size_t index)
+	template<typename T>
+	inline T& QuatT<T>::operator[](const size_t index)
 	{
 		if (index >= 4)
 			return x;
 		return *((&x) + index);
 	}
 
+	template<typename T>
 	template<typename U>
-	inline constexpr Quat Quat::AngleAxis(float angle, Vec3<U> axis)
+	inline constexpr QuatT<T> QuatT<T>::AngleAxis(T angle, Vec3<U> axis)
 	{
-		float rad = angle * DegToRad;
+		MATH_INSTRUMENT_SCOPE("Quat::AngleAxis(T, Vec3)");
+		T rad = ToRadians(angle);
 		axis.Normalize();
-		Quat q;
-		q.w = std::cos(rad / 2);
-		q.x = std::sin(rad / 2) * axis.x;
-		q.y = std::sin(rad / 2) * axis.y;
-		q.z = std::sin(rad / 2) * axis.z;
+		QuatT<T> q;
+		q.w = Cos(rad / 2);
+		q.x = Sin(rad / 2) * axis.x;
+		q.y = Sin(rad / 2) * axis.y;
+		q.z = Sin(rad / 2) * axis.z;
 		return q;
 	}
 
+	template<typename T>
 	template<typename U>
-	inline constexpr Quat Quat::FromEuler(const Vec3<U>& euler)
+	inline constexpr QuatT<T> QuatT<T>::FromEuler(const Vec3<U>& euler)
 	{
+		MATH_INSTRUMENT_SCOPE("Quat::FromEuler(Vec3)");
 		return euler.ToQuaternion();
 	}
 
+	template<typename T>
 	template<typename U>
-	Quat Quat::LookRotation(Vec3<U> forward, Vec3<U> up)
+	inline QuatT<T> QuatT<T>::LookRotation(Vec3<U> forward, Vec3<U> up)
 	{
+		MATH_INSTRUMENT_SCOPE("Quat::LookRotation(Vec3, Vec3)");
 		forward.Normalize();
 		Vec3<U>  vector = forward.GetNormalize();
 		Vec3<U>  vector2 = up.Cross(vector).GetNormalize();
 		Vec3<U>  vector3 = vector.Cross(vector2);
-		float m00 = vector2.x;
-		float m01 = vector2.y;
-		float m02 = vector2.z;
-		float m10 = vector3.x;
-		float m11 = vector3.y;
-		float m12 = vector3.z;
-		float m20 = vector.x;
-		float m21 = vector.y;
-		float m22 = vector.z;
-
-		float num8 = (m00 + m11) + m22;
-		Quat quaternion;
+		T m00 = vector2.x;
+		T m01 = vector2.y;
+		T m02 = vector2.z;
+		T m10 = vector3.x;
+		T m11 = vector3.y;
+		T m12 = vector3.z;
+		T m20 = vector.x;
+		T m21 = vector.y;
+		T m22 = vector.z;
+
+		T num8 = (m00 + m11) + m22;
+		QuatT<T> quaternion;
 		if (num8 > 0.f)
 		{
-			float num = std::sqrt(num8 + 1.f);
+			T num = Sqrt(num8 + 1.f);
 			quaternion.w = num * 0.5f;
 			num = 0.5f / num;
 			quaternion.x = (m12 - m21) * num;
@@ -1552,8 +2395,8 @@ namespace GALAXY::Math {
 		}
 		if ((m00 >= m11) && (m00 >= m22))
 		{
-			float num7 = std::sqrt(((1.f + m00) - m11) - m22);
-			float num4 = 0.5f / num7;
+			T num7 = Sqrt(((1.f + m00) - m11) - m22);
+			T num4 = 0.5f / num7;
 			quaternion.x = 0.5f * num7;
 			quaternion.y = (m01 + m10) * num4;
 			quaternion.z = (m02 + m20) * num4;
@@ -1562,40 +2405,42 @@ namespace GALAXY::Math {
 		}
 		if (m11 > m22)
 		{
-			float num6 = std::sqrt(((1.f + m11) - m00) - m22);
-			float num3 = 0.5f / num6;
+			T num6 = Sqrt(((1.f + m11) - m00) - m22);
+			T num3 = 0.5f / num6;
 			quaternion.x = (m10 + m01) * num3;
 			quaternion.y = 0.5f * num6;
 			quaternion.z = (m21 + m12) * num3;
 			quaternion.w = (m20 - m02) * num3;
 			return quaternion;
 		}
-		float num5 = (float)sqrtf(((1.f + m22) - m00) - m11);
-		float num2 = 0.5f / num5;
+		T num5 = Sqrt(((1.f + m22) - m00) - m11);
+		T num2 = 0.5f / num5;
 		return { (m20 + m02) * num2 , (m21 + m12) * num2, 0.5f * num5,(m01 - m10) * num2 };
 	}
 
 
-	inline Quat Quat::SLerp(const Quat& a, const Quat& b, float time)
+	template<typename T>
+	inline QuatT<T> QuatT<T>::SLerp(const QuatT<T>& a, const QuatT<T>& b, T time)
 	{
+		MATH_INSTRUMENT_SCOPE("Quat::SLerp(Quat, Quat, T)");
 		if (time < 0.0f)
 			return a;
 		else if (time >= 1.0f)
 			return b;
-		float d = a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
-		float s0, s1;
-		float sd = (float)((d > 0.0f) - (d < 0.0f));
+		T d = a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+		T s0, s1;
+		T sd = (T)((d > 0.0f) - (d < 0.0f));
 
-		d = fabs(d);
+		d = std::abs(d);
 
 		if (d < 0.9995f)
 		{
-			float s = std::sqrt(1.0f - d * d);
-			float a = std::atan2(s, d);
-			float c = std::cos(time * a);
+			T s = Sqrt(1.0f - d * d);
+			T a = Atan2(s, d);
+			T c = Cos(time * a);
 
 
-			s1 = std::sqrt(1.0f - c * c) / s;
+			s1 = Sqrt(1.0f - c * c) / s;
 			s0 = c - d * s1;
 		}
 		else
@@ -1607,96 +2452,115 @@ namespace GALAXY::Math {
 		return a * s0 + b * sd * s1;
 	}
 
-	inline void Quat::Inverse()
+	template<typename T>
+	inline void QuatT<T>::Inverse()
 	{
+		MATH_INSTRUMENT_SCOPE("Quat::Inverse()");
 		*this = GetInverse();
 	}
-	inline Quat Quat::GetInverse() const
+	template<typename T>
+	inline QuatT<T> QuatT<T>::GetInverse() const
 	{
-		float d = w * w + x * x + y * y + z * z;
+		MATH_INSTRUMENT_SCOPE("Quat::GetInverse()");
+		T d = w * w + x * x + y * y + z * z;
 		if (x == 0 && y == 0 && z == 0 && w == 0)
 			return *this;
 		else
-			return Quat(-x / d, -y / d, -z / d, w / d);
+			return QuatT<T>(-x / d, -y / d, -z / d, w / d);
 	}
-	inline void Quat::Normalize()
+	template<typename T>
+	inline void QuatT<T>::Normalize()
 	{
+		MATH_INSTRUMENT_SCOPE("Quat::Normalize()");
 		*this = GetNormalize();
 	}
-	inline Quat Quat::GetNormalize() const
+	template<typename T>
+	inline QuatT<T> QuatT<T>::GetNormalize() const
 	{
-		float mag = std::sqrt(Dot(*this));
+		MATH_INSTRUMENT_SCOPE("Quat::GetNormalize()");
+		T mag = Sqrt(Dot(*this));
 
-		if (mag < FLT_MIN)
-			return Quat::Identity();
+		if (mag < std::numeric_limits<T>::min())
+			return QuatT<T>::Identity();
 		else
-			return Quat(x / mag, y / mag, z / mag, w / mag);
+			return QuatT<T>(x / mag, y / mag, z / mag, w / mag);
 	}
 
-	inline void Quat::Conjugate()
+	template<typename T>
+	inline void QuatT<T>::Conjugate()
 	{
+		MATH_INSTRUMENT_SCOPE("Quat::Conjugate()");
 		*this = GetConjugate();
 	}
 
-	inline Quat Quat::GetConjugate() const
+	template<typename T>
+	inline QuatT<T> QuatT<T>::GetConjugate() const
 	{
-		return Quat(-x, -y, -z, w);
+		MATH_INSTRUMENT_SCOPE("Quat::GetConjugate()");
+		return QuatT<T>(-x, -y, -z, w);
 	}
 
-	inline float Quat::Dot(const Quat& a) const
+	template<typename T>
+	inline T QuatT<T>::Dot(const QuatT<T>& a) const
 	{
+		MATH_INSTRUMENT_SCOPE("Quat::Dot(Quat)");
 		return x * a.x + y * a.y + z * a.z + w * a.w;
 	}
 
-	inline Vec3f Quat::ToEuler() const
+	template<typename T>
+	inline Vec3<T> QuatT<T>::ToEuler() const
 	{
-		return ToEuler<float>();
+		return ToEuler<T>();
 	}
 
+	template<typename T>
 	template<typename U>
-	inline Vec3<U> Quat::ToEuler() const
+	inline Vec3<U> QuatT<T>::ToEuler() const
 	{
+		MATH_INSTRUMENT_SCOPE("Quat::ToEuler()");
 		U pitch;
-		Quat q = *this;
+		QuatT<T> q = *this;
 		U y = static_cast<U>(2) * (q.y * q.z + q.w * q.x);
 		U x = q.w * q.w - q.x * q.x - q.y * q.y + q.z * q.z;
 
 		U epsilon = std::numeric_limits<U>::epsilon();
 		if (std::abs(x) < epsilon && std::abs(y) < epsilon) {
 			// Avoid atan2(0,0) - handle singularity
-			pitch = static_cast<U>(2) * std::atan2(q.x, q.w);
+			pitch = static_cast<U>(2) * Atan2(q.x, q.w);
 		}
 		else
 		{
-			pitch = std::atan2(y, x);
+			pitch = Atan2(y, x);
 		}
 
 
-		U yaw = std::asin(std::clamp(static_cast<U>(-2) * (q.x * q.z - q.w * q.y), static_cast<U>(-1), static_cast<U>(1)));
+		U yaw = Asin(std::clamp(static_cast<U>(-2) * (q.x * q.z - q.w * q.y), static_cast<U>(-1), static_cast<U>(1)));
 
-		U roll = static_cast<U>(std::atan2(static_cast<U>(2) * (q.x * q.y + q.w * q.z), q.w * q.w + q.x * q.x - q.y * q.y - q.z * q.z));
+		U roll = static_cast<U>(Atan2(static_cast<U>(2) * (q.x * q.y + q.w * q.z), q.w * q.w + q.x * q.x - q.y * q.y - q.z * q.z));
 
-		return Vec3<U>(pitch, yaw, roll) * RadToDeg;
+		return Vec3<U>(ToDegrees(pitch), ToDegrees(yaw), ToDegrees(roll));
 	}
 
-	inline Mat4 Quat::ToRotationMatrix() const
+	template<typename T>
+	inline Mat4T<T> QuatT<T>::ToRotationMatrix() const
 	{
+		MATH_INSTRUMENT_SCOPE("Quat::ToRotationMatrix()");
 		// Precalculate coordinate products
-		float _x = x * 2.0F;
-		float _y = y * 2.0F;
-		float _z = z * 2.0F;
-		float xx = x * _x;
-		float yy = y * _y;
-		float zz = z * _z;
-		float xy = x * _y;
-		float xz = x * _z;
-		float yz = y * _z;
-		float wx = w * _x;
-		float wy = w * _y;
-		float wz = w * _z;
+		T _x = x * 2.0F;
+		T _y = y * 2.0F;
+		T _z = z * 2.0F;
+		T xx = x * _x;
+		T yy = y * _y;
+		T zz = z * _z;
+		T xy = x * _y;
+		T xz = x * _z;
+		T yz = y * _z;
+		T wx = w * _x;
+		T wy = w * _y;
+		T wz = w * _z;
 
 		// Calculate 3x3 matrix from orthonormal basis
-		Mat4 m;
+		Mat4T<T> m;
 		m[0][0] = 1.0f - (yy + zz);
 		m[0][1] = xy + wz;
 		m[0][2] = xz - wy;
@@ -1720,11 +2584,35 @@ namespace GALAXY::Math {
 		return m;
 	}
 
-	inline void Quat::Print() const
+	template<typename T>
+	inline constexpr void QuatT<T>::GetBasis(Vec3<T>& xAxis, Vec3<T>& yAxis, Vec3<T>& zAxis) const
+	{
+		MATH_INSTRUMENT_SCOPE("Quat::GetBasis(Vec3, Vec3, Vec3)");
+		T _x = x * 2.0F;
+		T _y = y * 2.0F;
+		T _z = z * 2.0F;
+		T xx = x * _x;
+		T yy = y * _y;
+		T zz = z * _z;
+		T xy = x * _y;
+		T xz = x * _z;
+		T yz = y * _z;
+		T wx = w * _x;
+		T wy = w * _y;
+		T wz = w * _z;
+
+		xAxis = { 1.0f - (yy + zz), xy + wz, xz - wy };
+		yAxis = { xy - wz, 1.0f - (xx + zz), yz + wx };
+		zAxis = { xz + wy, yz - wx, 1.0f - (xx + yy) };
+	}
+
+	template<typename T>
+	inline void QuatT<T>::Print() const
 	{
 		printf("Quaternion { %f, %f, %f, %f}\n", x, y, z, w);
 	}
-	inline std::string Quat::ToString(int precision) const
+	template<typename T>
+	inline std::string QuatT<T>::ToString(int precision) const
 	{
 		std::ostringstream oss;
 		oss << std::fixed << std::setprecision(precision);
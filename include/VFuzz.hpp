@@ -0,0 +1,268 @@
+//-----------------------------------------------------------------------------
+// VFuzz : randomized differential testing for VTest
+//
+// A property draws its inputs from a Random, runs the function under test and
+// its reference, and returns the error in ULPs. Cases are spread over every
+// hardware thread, each case has its own random stream so the worst one can be
+// replayed alone to print the inputs that produced it.
+//-----------------------------------------------------------------------------
+
+#pragma once
+#include "VTest.hpp"
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <limits>
+#include <cmath>
+#include <cfloat>
+#include <cstdint>
+
+// Checks a property inside a TEST, the result line carries the worst error instead of the property source
+#define FUZZ(name, cases, bound, ...) do \
+{ \
+    const VFuzz::Result fuzzResult = VFuzz::Check(name, cases, bound, __VA_ARGS__); \
+    RegisterResult(testName, lastId, {fuzzResult.passed, std::string(fuzzResult.passed ? "       Test passed: " : "       Test failed: ") + fuzzResult.Summary()}); \
+} while (false)
+
+namespace VFuzz
+{
+    constexpr double Skip = -1.0; // returned by a property when the drawn input is outside its domain
+
+    class Random
+    {
+    public:
+        explicit Random(uint64_t _seed): state(_seed) {}
+
+        uint64_t Next()
+        {
+            // splitmix64
+            uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            return z ^ (z >> 31);
+        }
+
+        bool Chance(double probability) { return static_cast<double>(Next() >> 11) * 0x1.0p-53 < probability; }
+
+        int Int(int min, int max) { return Trace(min + static_cast<int>(Next() % static_cast<uint64_t>(max - min + 1))); }
+
+        float Uniform(float min, float max)
+        {
+            const float t = static_cast<float>(Next() >> 40) * 0x1.0p-24f;
+            return Trace(min + (max - min) * t);
+        }
+
+        // Finite value up to magnitude, biased toward the inputs that break numeric code:
+        // signed zeros, denormals, exact powers of two, values one ULP away from integers, tiny and full scale values
+        float Float(float magnitude)
+        {
+            const uint64_t bits = Next();
+            const float sign = (bits & 1) ? -1.f : 1.f;
+            switch ((bits >> 1) % 16)
+            {
+            case 0:
+                return Trace(sign * 0.f);
+            case 1:
+                return Trace(sign * static_cast<float>((bits >> 8) % (1u << 23)) * std::numeric_limits<float>::denorm_min());
+            case 2:
+                return Trace(sign * std::ldexp(1.f, -static_cast<int>((bits >> 8) % 24)) * magnitude);
+            case 3:
+            {
+                const float integer = std::round(magnitude * static_cast<float>((bits >> 8) % 1024) / 1024.f);
+                return Trace(sign * std::nextafter(integer, (bits & 2) ? magnitude : -magnitude));
+            }
+            default:
+            {
+                // log-uniform scale so small values are as common as large ones
+                const float scale = std::ldexp(magnitude, -static_cast<int>((bits >> 8) % 20));
+                return Trace(sign * scale * static_cast<float>(bits >> 40) * 0x1.0p-24f);
+            }
+            }
+        }
+
+        std::string* trace = nullptr; // records every drawn value when the worst case is replayed
+
+    private:
+        template<typename T>
+        T Trace(T value)
+        {
+            if (trace)
+            {
+                std::ostringstream oss;
+                oss << std::setprecision(9) << value;
+                *trace += (trace->empty() ? "" : ", ") + oss.str();
+            }
+            return value;
+        }
+
+        uint64_t state;
+    };
+
+    // Distance between two adjacent floats around value
+    inline double UlpOf(double value)
+    {
+        value = std::abs(value);
+        if (value < FLT_MIN)
+            return std::numeric_limits<float>::denorm_min();
+        int exponent = 0;
+        std::frexp(value, &exponent);
+        return std::ldexp(1.0, exponent - 24);
+    }
+
+    // Largest component error in ULPs of the largest reference component, so
+    // results that cancel to near zero are measured against the magnitude they came from
+    template<size_t N>
+    inline double ScaledUlps(const float (&result)[N], const float (&reference)[N])
+    {
+        double scale = 0.0;
+        for (size_t i = 0; i < N; i++)
+        {
+            if (std::isfinite(reference[i]))
+                scale = std::max(scale, static_cast<double>(std::abs(reference[i])));
+        }
+
+        double worst = 0.0;
+        for (size_t i = 0; i < N; i++)
+        {
+            if (result[i] == reference[i] || (std::isnan(result[i]) && std::isnan(reference[i])))
+                continue;
+            if (!std::isfinite(result[i]) || !std::isfinite(reference[i]))
+                return std::numeric_limits<double>::infinity();
+            worst = std::max(worst, std::abs(static_cast<double>(result[i]) - static_cast<double>(reference[i])) / UlpOf(scale));
+        }
+        return worst;
+    }
+
+    struct Result
+    {
+        std::string name;
+        uint64_t cases = 0; // cases inside the property domain
+        double worstUlps = 0.0;
+        double meanUlps = 0.0;
+        double bound = 0.0; // negative when the function is only reported
+        std::string worstInput;
+        bool passed = true;
+
+        std::string Summary() const
+        {
+            std::ostringstream oss;
+            oss << name << " worst " << worstUlps << " ULPs";
+            if (bound >= 0.0)
+                oss << " (bound " << bound << ")";
+            if (!worstInput.empty())
+                oss << " from " << worstInput;
+            return oss.str();
+        }
+    };
+
+    std::mutex reportMutex;
+    std::vector<Result> report = {};
+    uint64_t seed = 0x5EED5EED5EED5EEDull;
+    double caseScale = 1.0; // multiplies every case count, to trade run time for coverage
+
+    inline uint64_t CaseSeed(uint64_t index) { return seed ^ (index * 0xD1B54A32D192ED03ull); }
+
+    // Runs cases of property on every hardware thread and keeps the worst error.
+    // A negative bound reports the function without failing on it.
+    template<typename Property>
+    Result Check(const std::string& name, uint64_t cases, double bound, Property property)
+    {
+        cases = std::max<uint64_t>(1, static_cast<uint64_t>(static_cast<double>(cases) * caseScale));
+        constexpr uint64_t chunk = 4096;
+
+        std::atomic<uint64_t> next = 0;
+        std::mutex mutex;
+        double worst = 0.0, sum = 0.0;
+        uint64_t worstIndex = 0, counted = 0;
+
+        auto worker = [&]()
+        {
+            double localWorst = 0.0, localSum = 0.0;
+            uint64_t localWorstIndex = 0, localCounted = 0;
+            for (uint64_t begin = next.fetch_add(chunk); begin < cases; begin = next.fetch_add(chunk))
+            {
+                const uint64_t end = std::min(cases, begin + chunk);
+                for (uint64_t i = begin; i < end; i++)
+                {
+                    Random random(CaseSeed(i));
+                    const double error = property(random);
+                    if (error < 0.0)
+                        continue;
+                    localCounted++;
+                    localSum += std::isfinite(error) ? error : 0.0;
+                    if (error > localWorst || (std::isnan(error) && !std::isnan(localWorst)))
+                    {
+                        localWorst = std::isnan(error) ? std::numeric_limits<double>::infinity() : error;
+                        localWorstIndex = i;
+                    }
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            sum += localSum;
+            counted += localCounted;
+            if (localWorst > worst)
+            {
+                worst = localWorst;
+                worstIndex = localWorstIndex;
+            }
+        };
+
+        const unsigned threadCount = std::max(1u, std::min<unsigned>(std::thread::hardware_concurrency(), static_cast<unsigned>((cases + chunk - 1) / chunk)));
+        std::vector<std::thread> threads;
+        for (unsigned t = 1; t < threadCount; t++)
+            threads.emplace_back(worker);
+        worker();
+        for (auto& thread : threads)
+            thread.join();
+
+        Result result;
+        result.name = name;
+        result.cases = counted;
+        result.worstUlps = worst;
+        result.meanUlps = counted > 0 ? sum / static_cast<double>(counted) : 0.0;
+        result.bound = bound;
+        result.passed = bound < 0.0 || worst <= bound;
+        if (worst > 0.0)
+        {
+            // Replay the worst case alone, recording what it drew
+            Random random(CaseSeed(worstIndex));
+            random.trace = &result.worstInput;
+            property(random);
+        }
+
+        std::lock_guard<std::mutex> lock(reportMutex);
+        report.push_back(result);
+        return result;
+    }
+
+    inline void PrintReport(std::ostream& os = std::cout)
+    {
+        std::lock_guard<std::mutex> lock(reportMutex);
+        if (report.empty())
+            return;
+
+        std::vector<Result> sorted = report;
+        std::sort(sorted.begin(), sorted.end(), [](const Result& a, const Result& b) { return a.name < b.name; });
+
+        os << "Differential error against reference (ULPs):\n";
+        os << std::left << std::setw(34) << "   Function" << std::right << std::setw(10) << "Cases" << std::setw(12) << "Mean" << std::setw(12) << "Worst" << std::setw(10) << "Bound" << "   Worst input\n";
+        for (const auto& result : sorted)
+        {
+            std::ostringstream bound;
+            if (result.bound < 0.0)
+                bound << "-";
+            else
+                bound << result.bound;
+            os << (result.passed ? "   " : " ! ") << std::left << std::setw(31) << result.name << std::right << std::setw(10) << result.cases
+                << std::fixed << std::setprecision(2) << std::setw(12) << result.meanUlps << std::setw(12) << result.worstUlps << std::defaultfloat
+                << std::setw(10) << bound.str() << "   " << result.worstInput << "\n";
+        }
+    }
+}
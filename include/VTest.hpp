@@ -29,15 +29,22 @@
 
 #pragma once
 #include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
 #include <vector>
 #include <functional>
 #include <string>
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <cmath>
 
 #include <chrono>
 #include <thread>
 
 #define TEST(name) \
-    []() {testName = #name;lastId++;}();\
+    []() {testName = #name;lastId++;testStart = std::chrono::steady_clock::now();}();\
 
 #define NAMESPACE(name) \
     for (NameSpaceGuard nameSpaceGuard(#name); nameSpaceGuard.isActive(); nameSpaceGuard.setInactive()) \
@@ -53,6 +60,24 @@
     } TestRegistrerInstance_##name; \
     void Test_##name()
 
+// Benchmark suites share the tree, NAMESPACE and REQUIRE of VTEST but run alone on the main thread
+#define VBENCH(name) \
+    void Bench_##name(); \
+    struct BenchRegistrer_##name \
+    { \
+        BenchRegistrer_##name() \
+        { \
+            RegisterVBench(#name, Bench_##name); \
+        } \
+    } BenchRegistrerInstance_##name; \
+    void Bench_##name()
+
+// The body is the measured operation, items is how many operations one pass of it performs
+#define BENCHMARK_N(name, items) \
+    for (BenchmarkState benchmarkState(#name, items); benchmarkState.KeepRunning(); )
+
+#define BENCHMARK(name) BENCHMARK_N(name, 1)
+
 
 
 //-----------------------------------------------------------------------------
@@ -99,28 +124,39 @@ constexpr const char* RED = "\033[38;2;242;96;103m";
 constexpr const char* GREEN = "\033[38;2;74;255;120m";
 constexpr const char* BLUE = "\033[38;2;44;158;243m";
 constexpr const char* PURPLE = "\033[38;2;170;142;214m";
+constexpr const char* GREY = "\033[38;2;128;128;128m";
 constexpr const char* DEFAULT = "\033[0m";
 
+#ifdef _WIN32
+extern "C" __declspec(dllimport) int __stdcall SetConsoleOutputCP(unsigned int codePage);
+#endif
+
 struct Entry;
 struct VTest;
 Entry& GetEntryToPush(Entry& inEntry);
+Entry& GetEntryById(Entry& inEntry, int id);
+bool MatchesFilter(const std::string& path);
 
 std::vector<VTest> VTests = {};
 
 //-----------------------------------------------------------------------------
 // Used to correctly register the Entry
+// Each VTest runs on a single worker thread, so this state is per thread
 //-----------------------------------------------------------------------------
 
-int lastId = 0;
-int lastNamespaceId = 0;
-std::string testName = "";
+thread_local VTest* currentVTest = nullptr;
+thread_local int lastId = 0;
+thread_local int lastNamespaceId = 0;
+thread_local std::string testName = "";
+thread_local std::string namespacePath = "";
+thread_local std::chrono::steady_clock::time_point testStart = {};
 
 //-----------------------------------------------------------------------------
 // Used to keep track of test results
 //-----------------------------------------------------------------------------
 
-int passed = 0;
-int failed = 0;
+std::atomic<int> passed = 0;
+std::atomic<int> failed = 0;
 
 //-----------------------------------------------------------------------------
 
@@ -133,7 +169,21 @@ enum EntryType
 {
     ERROR,
     NAMESPACE,
-    TEST
+    TEST,
+    BENCH
+};
+struct BenchmarkStats
+{
+    double nsPerOp = 0.0; // median of the samples
+    double opsPerSecond = 0.0;
+    double mean = 0.0;
+    double stddev = 0.0;
+    double p10 = 0.0;
+    double p90 = 0.0;
+    double p99 = 0.0;
+    double baseline = 0.0; // 0 when there is no baseline for this benchmark
+    size_t iterations = 0; // per sample
+    size_t samples = 0;
 };
 struct Entry
 {
@@ -145,25 +195,69 @@ struct Entry
     //related to TEST
     std::vector<testResult> results = {};
     bool asError = false;
+
+    double duration = 0.0; // wall-clock seconds, up to the last check for a TEST
+
+    //related to BENCH
+    BenchmarkStats stats = {};
 };
 struct VTest
 {
     std::function<void()> function;
     Entry entry;
+    double duration = 0.0;
+    bool benchmark = false;
+};
+struct RunOptions
+{
+    std::vector<std::string> filters = {}; // VTest or VTest/Namespace/... paths, empty runs everything
+    unsigned threads = 0; // 0 uses every hardware thread
+    int slowest = 5; // number of slowest tests reported
+    std::string junitPath = "";
+    std::string jsonPath = "";
+
+    // Benchmarks, opt-in so a plain run only tests
+    bool runBenchmarks = false;
+    bool skipTests = false;
+    double warmupTime = 0.02; // seconds spent running before the first sample
+    double sampleTime = 0.002; // target duration of a single sample
+    int samples = 25;
+    std::string baselinePath = ""; // fail benchmarks slower than this baseline
+    std::string saveBaselinePath = "";
+    double regressionThreshold = 0.10; // allowed slowdown over the baseline
 };
+
+thread_local Entry errorEntry; // an error entry to be used in case of error
+thread_local Entry* lastTestEntry = &errorEntry; // Ref to the last test entry so it could be updated
+
 class NameSpaceGuard
 {
 public:
     NameSpaceGuard(const char* _name): active(true)
     {
+        prePath = namespacePath;
+        namespacePath += std::string("/") + _name;
+        if (!MatchesFilter(currentVTest->entry.name + namespacePath))
+        {
+            active = false;
+            return;
+        }
+
         lastId++;
-        GetEntryToPush(VTests.back().entry).subEntry.push_back({NAMESPACE, _name, lastId, {}});
+        GetEntryToPush(currentVTest->entry).subEntry.push_back({NAMESPACE, _name, lastId, {}});
+        lastTestEntry = &errorEntry; // the push may have moved the previous test entry
         preId = lastNamespaceId;
         lastNamespaceId = lastId;
+        id = lastId;
+        start = std::chrono::steady_clock::now();
     }
 
     ~NameSpaceGuard()
     {
+        namespacePath = prePath;
+        if (id == -1)
+            return;
+        GetEntryById(currentVTest->entry, id).duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
         lastNamespaceId= preId;
     }
 
@@ -173,10 +267,11 @@ public:
 private:
 	bool active;
     int preId = 0;
+    int id = -1;
+    std::string prePath;
+    std::chrono::steady_clock::time_point start;
 };
 
-Entry errorEntry; // an error entry to be used in case of error
-Entry* lastTestEntry = &errorEntry; // Ref to the last test entry so it could be updated
 Entry& GetEntryToPush(Entry& inEntry)
 {
     if(inEntry.id == lastNamespaceId)
@@ -192,23 +287,45 @@ Entry& GetEntryToPush(Entry& inEntry)
     return errorEntry;
 }
 
-//-------------------------------------------------------------
-// Working but not used. Could be useful if fully integrated
-//-------------------------------------------------------------
-// Entry& GetEntryById(Entry& inEntry, int id)
-// {
-//     if(inEntry.id == id)
-//         return inEntry;
-//
-//     for(auto& i : inEntry.subEntry)
-//     {
-//         Entry& outEntry = GetEntryById(i,id);
-//         if(outEntry.type != ERROR)
-//             return outEntry;
-//     }
-//
-//     return errorEntry;
-// }
+Entry& GetEntryById(Entry& inEntry, int id)
+{
+    if(inEntry.id == id)
+        return inEntry;
+
+    for(auto& i : inEntry.subEntry)
+    {
+        Entry& outEntry = GetEntryById(i,id);
+        if(outEntry.type != ERROR)
+            return outEntry;
+    }
+
+    return errorEntry;
+}
+
+//-----------------------------------------------------------------------------
+// Filters select whole VTests or namespaces by path, "MATH_TEST/Quaternion" runs that
+// namespace and the code of the ones above it, the bodies of its siblings are skipped
+//-----------------------------------------------------------------------------
+
+std::vector<std::string> testFilters = {};
+
+bool MatchesFilter(const std::string& path)
+{
+    if (testFilters.empty())
+        return true;
+
+    for (const auto& filter : testFilters)
+    {
+        const size_t length = std::min(path.size(), filter.size());
+        if (path.compare(0, length, filter, 0, length) != 0)
+            continue;
+        // "Vector" must not select "Vector_2", the shorter path has to end on a separator
+        const std::string& longer = path.size() > filter.size() ? path : filter;
+        if (path.size() == filter.size() || longer[length] == '/')
+            return true;
+    }
+    return false;
+}
 
 void RegisterResult(const std::string& _testName, const int& _id, testResult _results)
 {
@@ -217,9 +334,11 @@ void RegisterResult(const std::string& _testName, const int& _id, testResult _re
     else
         failed++;
 
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - testStart).count();
     if (lastTestEntry->id == _id)
     {
         lastTestEntry->results.push_back(_results);
+        lastTestEntry->duration = elapsed;
         if (!lastTestEntry->asError)
             lastTestEntry->asError = !_results.result;
         return;
@@ -227,8 +346,8 @@ void RegisterResult(const std::string& _testName, const int& _id, testResult _re
      
     std::vector<testResult> temp;
     temp.push_back(_results);
-    Entry& newEntry = GetEntryToPush(VTests.back().entry);
-    newEntry.subEntry.push_back({ TEST, _testName, _id,{},temp,!_results.result});
+    Entry& newEntry = GetEntryToPush(currentVTest->entry);
+    newEntry.subEntry.push_back({ TEST, _testName, _id,{},temp,!_results.result, elapsed});
     lastTestEntry = &newEntry.subEntry.back();
 }
 
@@ -237,6 +356,196 @@ void RegisterVTest(const char* name ,const std::function<void()>& function)
     VTests.insert(VTests.begin(), {function, {NAMESPACE, name, lastId, {}}});
 }
 
+void RegisterVBench(const char* name ,const std::function<void()>& function)
+{
+    VTests.insert(VTests.begin(), {function, {NAMESPACE, name, lastId, {}}, 0.0, true});
+}
+
+//-----------------------------------------------------------------------------
+// Benchmarks
+//-----------------------------------------------------------------------------
+
+RunOptions benchmarkOptions = {};
+std::map<std::string, double> benchmarkBaseline = {}; // ns/op by benchmark path
+std::map<std::string, double> benchmarkResults = {};
+const volatile void* benchmarkSink = nullptr;
+
+// Keeps the compiler from discarding a value that is never read
+template<typename T>
+inline void DoNotOptimize(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "m"(value) : "memory");
+#else
+    benchmarkSink = &value;
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+}
+
+// Forces pending stores to memory, for benchmarks writing through pointers
+inline void ClobberMemory()
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : : "memory");
+#else
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+}
+
+class BenchmarkState
+{
+public:
+    BenchmarkState(const char* _name, size_t _items): name(_name), items(_items) {}
+
+    // Only a decrement on the hot path, the clock is read once per batch
+    bool KeepRunning()
+    {
+        if (remaining != 0)
+        {
+            remaining--;
+            return true;
+        }
+        return NextBatch();
+    }
+
+private:
+    bool NextBatch()
+    {
+        const auto now = std::chrono::steady_clock::now();
+        if (started)
+        {
+            const double elapsed = std::chrono::duration<double>(now - batchStart).count();
+            if (measuring)
+            {
+                samples.push_back(elapsed * 1e9 / (static_cast<double>(iterations) * static_cast<double>(items)));
+                if (samples.size() >= static_cast<size_t>(benchmarkOptions.samples))
+                {
+                    Finish();
+                    return false;
+                }
+            }
+            else
+            {
+                // Warmup doubles as calibration: grow the batch until one lasts a sample
+                warmup += elapsed;
+                if (elapsed < benchmarkOptions.sampleTime)
+                {
+                    const double scale = elapsed > 0.0 ? benchmarkOptions.sampleTime / elapsed : 10.0;
+                    iterations = static_cast<size_t>(static_cast<double>(iterations) * std::clamp(scale * 1.2, 2.0, 10.0));
+                }
+                else if (warmup >= benchmarkOptions.warmupTime)
+                    measuring = true;
+            }
+        }
+        started = true;
+        remaining = iterations - 1;
+        batchStart = std::chrono::steady_clock::now();
+        return true;
+    }
+
+    void Finish()
+    {
+        std::vector<double> sorted = samples;
+        std::sort(sorted.begin(), sorted.end());
+        auto percentile = [&sorted](double p) { return sorted[static_cast<size_t>(p * static_cast<double>(sorted.size() - 1) + 0.5)]; };
+
+        BenchmarkStats stats;
+        stats.nsPerOp = percentile(0.5);
+        stats.opsPerSecond = 1e9 / stats.nsPerOp;
+        for (double sample : samples)
+            stats.mean += sample;
+        stats.mean /= static_cast<double>(samples.size());
+        for (double sample : samples)
+            stats.stddev += (sample - stats.mean) * (sample - stats.mean);
+        stats.stddev = std::sqrt(stats.stddev / static_cast<double>(samples.size()));
+        stats.p10 = percentile(0.1);
+        stats.p90 = percentile(0.9);
+        stats.p99 = percentile(0.99);
+        stats.iterations = iterations;
+        stats.samples = samples.size();
+
+        const std::string path = currentVTest->entry.name + namespacePath + "/" + name;
+        benchmarkResults[path] = stats.nsPerOp;
+
+        Entry entry = { BENCH, name, ++lastId, {}, {}, false, static_cast<double>(iterations * samples.size()) * stats.mean * static_cast<double>(items) * 1e-9, stats };
+        auto baseline = benchmarkBaseline.find(path);
+        if (baseline != benchmarkBaseline.end())
+        {
+            entry.stats.baseline = baseline->second;
+            const bool regressed = stats.nsPerOp > baseline->second * (1.0 + benchmarkOptions.regressionThreshold);
+            std::ostringstream oss;
+            oss << std::fixed << std::setprecision(2) << "       " << (regressed ? "Benchmark regressed: " : "Benchmark within baseline: ")
+                << stats.nsPerOp << " ns/op against " << baseline->second << " ns/op";
+            entry.results.push_back({ !regressed, oss.str() });
+            entry.asError = regressed;
+            if (regressed)
+                failed++;
+            else
+                passed++;
+        }
+        GetEntryToPush(currentVTest->entry).subEntry.push_back(entry);
+        lastTestEntry = &errorEntry;
+    }
+
+    std::string name;
+    size_t items;
+    size_t iterations = 1;
+    size_t remaining = 0;
+    bool started = false;
+    bool measuring = false;
+    double warmup = 0.0;
+    std::vector<double> samples;
+    std::chrono::steady_clock::time_point batchStart;
+};
+
+// Baseline files hold one "<path>\t<ns per op>" line per benchmark
+void LoadBaseline(const std::string& filePath)
+{
+    std::ifstream file(filePath);
+    std::string line;
+    while (std::getline(file, line))
+    {
+        const size_t tab = line.rfind('\t');
+        if (tab != std::string::npos)
+            benchmarkBaseline[line.substr(0, tab)] = std::stod(line.substr(tab + 1));
+    }
+}
+
+void SaveBaseline(const std::string& filePath)
+{
+    std::ofstream file(filePath);
+    file << std::setprecision(6);
+    for (const auto& [path, nsPerOp] : benchmarkResults)
+        file << path << '\t' << nsPerOp << '\n';
+}
+
+std::string FormatRate(double opsPerSecond)
+{
+    const char* units[] = { "", "K", "M", "G" };
+    int unit = 0;
+    while (opsPerSecond >= 1000.0 && unit < 3)
+    {
+        opsPerSecond /= 1000.0;
+        unit++;
+    }
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(2) << opsPerSecond << ' ' << units[unit] << "op/s";
+    return oss.str();
+}
+
+std::string FormatDuration(double seconds)
+{
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(2);
+    if (seconds >= 1.0)
+        oss << seconds << " s";
+    else if (seconds >= 1e-3)
+        oss << seconds * 1e3 << " ms";
+    else
+        oss << seconds * 1e6 << " us";
+    return oss.str();
+}
+
 void Draw(Entry entry, std::vector<int> lastLineAt = {}, int recurrence = 0)
 {
     if(recurrence == 0) // Draw the origin of execution
@@ -259,6 +568,8 @@ void Draw(Entry entry, std::vector<int> lastLineAt = {}, int recurrence = 0)
         std::cout << "\xe2\x94\x83" << PURPLE << entry.name << DEFAULT << extraSpace << "\xe2\x94\x83" << std::endl;
         std::cout << "\xe2\x94\x97\xe2\x94\x81\xe2\x94\x81\xe2\x94\xaf"<< hor <<"\xe2\x94\x9b\n";
     }
+    if (entry.subEntry.empty())
+        return;
 
     std::string tab = "";
     for (int i = 0; i < recurrence; i++)
@@ -279,9 +590,29 @@ void Draw(Entry entry, std::vector<int> lastLineAt = {}, int recurrence = 0)
         else
             caseTab = "   \xe2\x94\x9c\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80"; // "    ├───"
 
-        if (subEntry.type == NAMESPACE)
+        const std::string duration = std::string(" ") + GREY + FormatDuration(subEntry.duration) + DEFAULT;
+        if (subEntry.type == BENCH)
         {
-            std::cout << tab << caseTab << '[' << BLUE << subEntry.name << DEFAULT << "]\n";
+            const BenchmarkStats& stats = subEntry.stats;
+            std::ostringstream oss;
+            oss << std::fixed << std::setprecision(2) << stats.nsPerOp << " ns/op, " << FormatRate(stats.opsPerSecond)
+                << GREY << " \xc2\xb1" << (stats.mean > 0.0 ? 100.0 * stats.stddev / stats.mean : 0.0) << "% p10 " << stats.p10 << " p90 " << stats.p90 << " p99 " << stats.p99;
+            if (stats.baseline > 0.0)
+                oss << " baseline " << stats.baseline << " (" << std::showpos << 100.0 * (stats.nsPerOp / stats.baseline - 1.0) << std::noshowpos << "%)";
+            oss << DEFAULT;
+
+            const char* status = subEntry.asError ? RED : PURPLE;
+            std::cout << tab << caseTab << "[" << status << "BENCH" << DEFAULT << "] " << subEntry.name << ": " << oss.str() << "\n";
+            if (subEntry.asError)
+            {
+                caseTab = subEntry.id == lastEntry.id ? "       " : "   \xe2\x94\x82   "; // "    │   "
+                for (const auto& r : subEntry.results)
+                    std::cout << tab << caseTab << RED << r.expression << DEFAULT << "\n";
+            }
+        }
+        else if (subEntry.type == NAMESPACE)
+        {
+            std::cout << tab << caseTab << '[' << BLUE << subEntry.name << DEFAULT << "]" << duration << "\n";
 
             if (subEntry.id == lastEntry.id)
                 lastLineAt.push_back(recurrence);
@@ -292,7 +623,7 @@ void Draw(Entry entry, std::vector<int> lastLineAt = {}, int recurrence = 0)
         {
             if (subEntry.asError)
             {
-                std::cout << tab << caseTab << "[" << RED << "FAIL" << DEFAULT << "] " << subEntry.name << "\n";
+                std::cout << tab << caseTab << "[" << RED << "FAIL" << DEFAULT << "] " << subEntry.name << duration << "\n";
 
                 caseTab = subEntry.id == lastEntry.id ? "       " : "   \xe2\x94\x82   "; // "    │   "
                 for (const auto& r : subEntry.results)
@@ -303,45 +634,312 @@ void Draw(Entry entry, std::vector<int> lastLineAt = {}, int recurrence = 0)
             }
             else
             {
-                std::cout << tab << caseTab << "[" << GREEN << "PASS" << DEFAULT << "] " << subEntry.name << "\n";
+                std::cout << tab << caseTab << "[" << GREEN << "PASS" << DEFAULT << "] " << subEntry.name << duration << "\n";
             }
         }
     }
 }
 
-template<typename... Args>
-void runTests(Args... names) {
-    std::system("chcp 65001");
-    std::this_thread::sleep_for(std::chrono::milliseconds(20));
-    std::cout << "#############################################################################################\n";
-    for (int v = VTests.size()-1; v > -1; v--)
+//-----------------------------------------------------------------------------
+// Reports
+//-----------------------------------------------------------------------------
+
+struct TestRecord
+{
+    std::string suite;
+    std::string path; // namespaces from the suite down to the test, separated by '/'
+    std::string name;
+    double duration;
+    std::vector<std::string> failures;
+    bool benchmark = false;
+    BenchmarkStats stats = {};
+};
+
+void CollectTests(const Entry& entry, const std::string& suite, const std::string& path, std::vector<TestRecord>& records)
+{
+    for (const auto& subEntry : entry.subEntry)
+    {
+        if (subEntry.type == NAMESPACE)
+        {
+            CollectTests(subEntry, suite, path + "/" + subEntry.name, records);
+            continue;
+        }
+
+        TestRecord record = { suite, path, subEntry.name, subEntry.duration, {}, subEntry.type == BENCH, subEntry.stats };
+        for (const auto& r : subEntry.results)
+        {
+            if (!r.result)
+                record.failures.push_back(r.expression.substr(r.expression.find_first_not_of(' ')));
+        }
+        records.push_back(record);
+    }
+}
+
+std::string EscapeXml(const std::string& text)
+{
+    std::string out;
+    for (char c : text)
+    {
+        switch (c)
+        {
+        case '&': out += "&amp;"; break;
+        case '<': out += "&lt;"; break;
+        case '>': out += "&gt;"; break;
+        case '"': out += "&quot;"; break;
+        case '\'': out += "&apos;"; break;
+        default: out += c;
+        }
+    }
+    return out;
+}
+
+std::string EscapeJson(const std::string& text)
+{
+    std::string out;
+    for (char c : text)
     {
-        bool shouldContinue = true;
-        if(sizeof...(names) > 0)
+        switch (c)
         {
-            for (const auto& name : std::initializer_list<std::string>{names...})
+        case '"': out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n"; break;
+        case '\t': out += "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20)
             {
-                shouldContinue = false;
-                if(VTests[v].entry.name == name)
-                {
-                    shouldContinue = true;
-                    break;
-                }
+                char buffer[8];
+                std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+                out += buffer;
             }
+            else
+                out += c;
+        }
+    }
+    return out;
+}
+
+void WriteJUnit(const std::string& filePath, const std::vector<VTest*>& suites, const std::vector<TestRecord>& records, double duration)
+{
+    std::ofstream file(filePath);
+    file << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+    file << "<testsuites tests=\"" << records.size() << "\" failures=\"" << std::count_if(records.begin(), records.end(), [](const TestRecord& r) { return !r.failures.empty(); })
+        << "\" time=\"" << duration << "\">\n";
+    for (const VTest* suite : suites)
+    {
+        std::vector<const TestRecord*> suiteRecords;
+        for (const auto& record : records)
+        {
+            if (record.suite == suite->entry.name)
+                suiteRecords.push_back(&record);
         }
-        if(shouldContinue)
+        file << "  <testsuite name=\"" << EscapeXml(suite->entry.name) << "\" tests=\"" << suiteRecords.size() << "\" failures=\""
+            << std::count_if(suiteRecords.begin(), suiteRecords.end(), [](const TestRecord* r) { return !r->failures.empty(); }) << "\" time=\"" << suite->duration << "\">\n";
+        for (const TestRecord* record : suiteRecords)
         {
-            VTests[v].function();
-            Draw(VTests[v].entry);
-            
-
-            lastId = 0;
-            lastNamespaceId = 0;
-            testName = "";
-            lastTestEntry = &errorEntry;
+            std::string className = record->suite + record->path;
+            std::replace(className.begin(), className.end(), '/', '.');
+            file << "    <testcase classname=\"" << EscapeXml(className) << "\" name=\"" << EscapeXml(record->name) << "\" time=\"" << record->duration << "\"";
+            if (record->failures.empty())
+            {
+                file << "/>\n";
+                continue;
+            }
+            file << ">\n";
+            for (const auto& failure : record->failures)
+                file << "      <failure message=\"" << EscapeXml(failure) << "\"/>\n";
+            file << "    </testcase>\n";
         }
-        VTests.pop_back();
+        file << "  </testsuite>\n";
+    }
+    file << "</testsuites>\n";
+}
+
+void WriteJson(const std::string& filePath, const std::vector<TestRecord>& records, double duration)
+{
+    std::ofstream file(filePath);
+    file << "{\n  \"passed\": " << passed << ",\n  \"failed\": " << failed << ",\n  \"duration\": " << duration << ",\n  \"tests\": [";
+    bool first = true;
+    for (const TestRecord& record : records)
+    {
+        if (record.benchmark)
+            continue;
+        file << (first ? "\n" : ",\n") << "    { \"suite\": \"" << EscapeJson(record.suite) << "\", \"path\": \"" << EscapeJson(record.path)
+            << "\", \"name\": \"" << EscapeJson(record.name) << "\", \"duration\": " << record.duration << ", \"failures\": [";
+        for (size_t f = 0; f < record.failures.size(); f++)
+            file << (f == 0 ? "" : ", ") << '"' << EscapeJson(record.failures[f]) << '"';
+        file << "] }";
+        first = false;
+    }
+    file << "\n  ],\n  \"benchmarks\": [";
+    first = true;
+    for (const TestRecord& record : records)
+    {
+        if (!record.benchmark)
+            continue;
+        const BenchmarkStats& stats = record.stats;
+        file << (first ? "\n" : ",\n") << "    { \"suite\": \"" << EscapeJson(record.suite) << "\", \"path\": \"" << EscapeJson(record.path)
+            << "\", \"name\": \"" << EscapeJson(record.name) << "\", \"nsPerOp\": " << stats.nsPerOp << ", \"opsPerSecond\": " << stats.opsPerSecond
+            << ", \"mean\": " << stats.mean << ", \"stddev\": " << stats.stddev << ", \"p10\": " << stats.p10 << ", \"p90\": " << stats.p90 << ", \"p99\": " << stats.p99
+            << ", \"baseline\": " << stats.baseline << ", \"iterations\": " << stats.iterations << ", \"samples\": " << stats.samples << ", \"regressed\": " << (record.failures.empty() ? "false" : "true") << " }";
+        first = false;
+    }
+    file << "\n  ]\n}\n";
+}
+
+//-----------------------------------------------------------------------------
+// Runner
+//-----------------------------------------------------------------------------
+
+// --filter=<path> (repeatable, bare arguments are filters too), --threads=<n>, --slowest=<n>, --junit=<file>, --json=<file>
+// --bench, --bench-only, --bench-samples=<n>, --baseline=<file>, --save-baseline=<file>, --regression=<fraction>
+RunOptions ParseRunOptions(int argc, char** argv)
+{
+    RunOptions options;
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string argument = argv[i];
+        auto value = [&argument](const char* prefix) { return argument.substr(std::string(prefix).size()); };
+
+        if (argument.rfind("--filter=", 0) == 0)
+            options.filters.push_back(value("--filter="));
+        else if (argument.rfind("--threads=", 0) == 0)
+            options.threads = static_cast<unsigned>(std::stoul(value("--threads=")));
+        else if (argument.rfind("--slowest=", 0) == 0)
+            options.slowest = std::stoi(value("--slowest="));
+        else if (argument.rfind("--junit=", 0) == 0)
+            options.junitPath = value("--junit=");
+        else if (argument.rfind("--json=", 0) == 0)
+            options.jsonPath = value("--json=");
+        else if (argument == "--bench")
+            options.runBenchmarks = true;
+        else if (argument == "--no-bench")
+            options.runBenchmarks = false;
+        else if (argument == "--bench-only")
+        {
+            options.runBenchmarks = true;
+            options.skipTests = true;
+        }
+        else if (argument.rfind("--bench-samples=", 0) == 0)
+            options.samples = std::max(1, std::stoi(value("--bench-samples=")));
+        else if (argument.rfind("--baseline=", 0) == 0)
+            options.baselinePath = value("--baseline=");
+        else if (argument.rfind("--save-baseline=", 0) == 0)
+            options.saveBaselinePath = value("--save-baseline=");
+        else if (argument.rfind("--regression=", 0) == 0)
+            options.regressionThreshold = std::stod(value("--regression="));
+        else if (argument.rfind("--", 0) != 0)
+            options.filters.push_back(argument);
+    }
+    return options;
+}
+
+// Runs the selected VTests on a pool of threads, returns the number of failed checks
+int runTests(const RunOptions& options)
+{
+#ifdef _WIN32
+    SetConsoleOutputCP(65001); // UTF-8 for the tree drawing
+#endif
+    const auto runStart = std::chrono::steady_clock::now();
+    testFilters = options.filters;
+
+    benchmarkOptions = options;
+    if (!options.baselinePath.empty())
+        LoadBaseline(options.baselinePath);
+
+    std::vector<VTest*> selected, tests, benchmarks;
+    for (int v = VTests.size()-1; v > -1; v--)
+    {
+        VTest& vtest = VTests[v];
+        if (!MatchesFilter(vtest.entry.name) || (vtest.benchmark ? !options.runBenchmarks : options.skipTests))
+            continue;
+        selected.push_back(&vtest);
+        (vtest.benchmark ? benchmarks : tests).push_back(&vtest);
+    }
+
+    auto run = [](VTest* vtest)
+    {
+        currentVTest = vtest;
+        lastId = 0;
+        lastNamespaceId = 0;
+        testName = "";
+        namespacePath = "";
+        lastTestEntry = &errorEntry;
+
+        const auto start = std::chrono::steady_clock::now();
+        try
+        {
+            currentVTest->function();
+        }
+        catch (const std::exception& error)
+        {
+            RegisterResult(testName, lastId, {false, std::string("       Uncaught exception: ") + error.what()});
+        }
+        currentVTest->duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    std::atomic<size_t> next = 0;
+    auto worker = [&tests, &next, &run]()
+    {
+        for (size_t i = next++; i < tests.size(); i = next++)
+            run(tests[i]);
+    };
+
+    unsigned threadCount = options.threads != 0 ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+    threadCount = std::max(1u, std::min<unsigned>(threadCount, static_cast<unsigned>(tests.size())));
+    std::vector<std::thread> threads;
+    for (unsigned t = 1; t < threadCount; t++)
+        threads.emplace_back(worker);
+    worker();
+    for (auto& thread : threads)
+        thread.join();
+
+    // Benchmarks run one at a time once the pool is idle, so they do not share the machine
+    for (VTest* vtest : benchmarks)
+        run(vtest);
+    const double duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - runStart).count();
+
+    std::cout << "#############################################################################################\n";
+    std::vector<TestRecord> records;
+    for (const VTest* vtest : selected)
+    {
+        Draw(vtest->entry);
+        CollectTests(vtest->entry, vtest->entry.name, "", records);
     }
     std::cout << "#############################################################################################\n";
+
+    if (options.slowest > 0)
+    {
+        std::vector<const TestRecord*> slowest;
+        for (const auto& record : records)
+        {
+            if (!record.benchmark)
+                slowest.push_back(&record);
+        }
+        const size_t count = std::min(slowest.size(), static_cast<size_t>(options.slowest));
+        std::partial_sort(slowest.begin(), slowest.begin() + count, slowest.end(), [](const TestRecord* a, const TestRecord* b) { return a->duration > b->duration; });
+
+        if (count > 0)
+            std::cout << "Slowest tests:\n";
+        for (size_t i = 0; i < count; i++)
+            std::cout << "   " << std::setw(10) << FormatDuration(slowest[i]->duration) << "   " << slowest[i]->suite << slowest[i]->path << '/' << slowest[i]->name << "\n";
+    }
     std::cout << "Tests run: " << passed + failed << ", Passed: " << passed << ", Failed: " << failed << std::endl;
-}
\ No newline at end of file
+    std::cout << "Ran " << tests.size() << " VTest(s) on " << threadCount << " thread(s) and " << benchmarks.size() << " VBench(es) in " << FormatDuration(duration) << std::endl;
+
+    if (!options.junitPath.empty())
+        WriteJUnit(options.junitPath, selected, records, duration);
+    if (!options.jsonPath.empty())
+        WriteJson(options.jsonPath, records, duration);
+    if (!options.saveBaselinePath.empty())
+        SaveBaseline(options.saveBaselinePath);
+
+    VTests.clear();
+    return failed;
+}
+
+template<typename... Args>
+int runTests(Args... names) {
+    RunOptions options;
+    (options.filters.push_back(names), ...);
+    return runTests(options);
+}
@@ -1,11 +1,29 @@
 #include "include/VTest.hpp"
+#include "include/VFuzz.hpp"
 
 #define GLM_ENABLE_EXPERIMENTAL
 #define MATH_GLM_EXTENSION
 #include "Maths.h"
+#include "MathArray.h"
+#include "MathExpression.h"
+#include "MathVecN.h"
+#include "MathRandom.h"
+#include "MathSpline.h"
+#include "MathAnimation.h"
+#include "MathBVH.h"
+#include "MathSpatialHash.h"
+#include "MathSpaceCurve.h"
+#include "MathCollision.h"
+#include "MathSolver.h"
+#include "MathCamera.h"
 using namespace GALAXY::Math;
 
 #include <assert.h>
+#include <cstring>
+#include <numeric>
+#include <random>
+#include <set>
+#include <thread>
 
 #include <glm/gtx/matrix_decompose.hpp>
 
@@ -337,6 +355,46 @@ VTEST(MATH_TEST)
 
 			REQUIRE(quat1.ToString() == std::string("1.000000, 2.000000, 3.000000, 4.000000"));
 		}
+		TEST(Batch Rotation)
+		{
+			Quat rotation = Vec3f(32.5f, -63.21f, 17.93f).ToQuaternion();
+
+			Vec3f xAxis, yAxis, zAxis;
+			rotation.GetBasis(xAxis, yAxis, zAxis);
+			Mat4 rotationMatrix = rotation.ToRotationMatrix();
+			REQUIRE(xAxis == Vec3f(rotationMatrix[0]));
+			REQUIRE(yAxis == Vec3f(rotationMatrix[1]));
+			REQUIRE(zAxis == Vec3f(rotationMatrix[2]));
+
+			// Sizes cover the cross product path, the SIMD blocks and their scalar tails
+			for (size_t count : { 1, 3, 4, 8, 13, 37 })
+			{
+				std::vector<Vec3f> input(count);
+				for (size_t i = 0; i < count; i++)
+					input[i] = Vec3f(i * 1.5f - 7.f, 3.25f - i, i * 0.75f);
+
+				std::vector<Vec3f> output(count);
+				rotation.Rotate(input, output);
+
+				bool same = true, sameGlm = true;
+				for (size_t i = 0; i < count; i++)
+				{
+					same &= output[i] == rotation * input[i];
+					sameGlm &= output[i] == rotation.ToGlm() * input[i].ToGlm();
+				}
+				REQUIRE(same);
+				REQUIRE(sameGlm);
+
+				rotation.Rotate(input, input);
+				REQUIRE(input == output);
+			}
+
+			// A shorter output rotates only as many vectors as it holds
+			const Vec3f three[] = { Vec3f(1, 0, 0), Vec3f(0, 1, 0), Vec3f(0, 0, 1) };
+			Vec3f two[2];
+			rotation.Rotate(three, two);
+			REQUIRE(two[1] == rotation * three[1]);
+		}
 	}
 #pragma endregion
 
@@ -508,11 +566,3581 @@ VTEST(MATH_TEST)
 			REQUIRE(matrix2[3] == Vec4f(9.4f, 4.7f, 1.8f, 6.2f));
 		}
 	}
-}
+#pragma endregion
 
-int main() {
-	system("cls");   // used to clear and enable color on Windows
-	runTests();
+#pragma region Double Precision Tests
+	NAMESPACE(Double_Precision)
+	{
+		double values[16] = { 2.5,	10.35,	147.3,	10.35,
+							5.6,	72.36,	69.69,	5.75,
+							78.0,	14.0,	3.25,	10.5,
+							7.8,	32.6,	71.0,	6.78 };
+		Mat4d matrix = Mat4d(values);
+		Mat4d matrix2 = Mat4d(Mat4(values).GetTranspose());
+
+		TEST(Constructors)
+		{
+			COMPARE(matrix[0][1], 10.35);
+			REQUIRE(Mat4f(matrix) == Mat4(values));
+			REQUIRE(Quatd(Quat(1, 2, 3, 4)) == Quatd(1, 2, 3, 4));
+			// Narrowing is spelled out
+			REQUIRE((!std::is_convertible_v<Mat4d, Mat4f> && !std::is_convertible_v<Quatd, Quat>));
+			REQUIRE((std::is_constructible_v<Mat4f, Mat4d> && std::is_constructible_v<Quat, Quatd>));
+		}
+		TEST(Angles)
+		{
+			// Converted in double, the float constants would leave an error near 1e-8
+			REQUIRE(std::abs(ToRadians(180.0) - 3.14159265358979323846) < 1e-15);
+			REQUIRE(std::abs(ToDegrees(ToRadians(37.25)) - 37.25) < 1e-13);
+			REQUIRE(std::abs(Mat4d::CreateProjectionMatrix(60.0, 1.0, 0.1, 100.0)[1][1] - std::sqrt(3.0)) < 1e-14);
+			REQUIRE(std::abs(Quatd::AngleAxis(90.0, Vec3d(0, 0, 1)).w - std::sqrt(0.5)) < 1e-15);
+		}
+		TEST(Arithmetic Operators)
+		{
+			// Reference computed the same way as the scalar path
+			Mat4d expected;
+			for (int i = 0; i < 4; i++)
+				for (int j = 0; j < 4; j++)
+					expected[i][j] = matrix[0][j] * matrix2[i][0] + matrix[1][j] * matrix2[i][1] + matrix[2][j] * matrix2[i][2] + matrix[3][j] * matrix2[i][3];
+			REQUIRE(matrix * matrix2 == expected);
+
+			Vec4d vec4Value = Vec4d(5, 6, 3.2, 14);
+			Vec4d expectedVec4 = (matrix[0] * vec4Value.x + matrix[1] * vec4Value.y) + (matrix[2] * vec4Value.z + matrix[3] * vec4Value.w);
+			REQUIRE(matrix * vec4Value == expectedVec4);
+		}
+		TEST(Methods)
+		{
+			Vec3d euler(32.5, -63.21, 17.93);
+			Quatd rotation = Quatd::FromEuler(euler);
+			REQUIRE(Quat(rotation) == Quat::FromEuler(Vec3f(euler)));
+			REQUIRE(Quatd::FromEuler(rotation.ToEuler()).ToRotationMatrix() == rotation.ToRotationMatrix());
+
+			Vec3d position(1.0e7 + 0.25, -2.0e7 + 0.5, 3.0e7 + 0.125);
+			Mat4d transform = Mat4d::CreateTransformMatrix(position, rotation, Vec3d(1, 2, 3));
+			REQUIRE(transform.GetTranslation() == position);
+			REQUIRE(transform.GetScale() == Vec3d(1, 2, 3));
+
+			Vec3d translation, scale;
+			Quatd decomposedRotation;
+			transform.DecomposeTransformMatrix(translation, decomposedRotation, scale);
+			REQUIRE(translation == position);
+			REQUIRE(decomposedRotation == rotation.GetConjugate());
+		}
+		TEST(Camera Relative Conversion)
+		{
+			Vec3d camera(1.0e7, -2.0e7, 3.0e7);
+			Quatd rotation = Quatd::AngleAxis(40.0, Vec3d(0, 1, 0));
+
+			std::vector<Mat4d> world;
+			for (int i = 0; i < 5; i++)
+				world.push_back(Mat4d::CreateTransformMatrix(camera + Vec3d(i * 0.25, 0.5, -0.125), rotation, Vec3d(1 + i)));
+
+			std::vector<Mat4f> render(world.size());
+			RebaseToCamera(world, camera, render);
+
+			bool same = true;
+			for (size_t i = 0; i < world.size(); i++)
+			{
+				// Plain float conversion loses the sub-meter offset, the rebased matrix keeps it exactly
+				same &= render[i].GetTranslation() == Vec3f(i * 0.25f, 0.5f, -0.125f);
+				same &= Vec3f(render[i][0]) == Vec3f(world[i][0]) && Vec3f(render[i][2]) == Vec3f(world[i][2]);
+				same &= render[i][3].w == 1.f;
+			}
+			REQUIRE(same);
+			REQUIRE(Mat4f(world[1]).GetTranslation() - Vec3f(camera) != Vec3f(0.25f, 0.5f, -0.125f));
+		}
+	}
+#pragma endregion
+
+#pragma region Compact Types Tests
+	NAMESPACE(Compact_Types)
+	{
+		TEST(Half Conversion)
+		{
+			COMPARE(Half(1.f).bits, 0x3c00);
+			COMPARE(Half(-2.f).bits, 0xc000);
+			COMPARE(Half(0.1f).bits, 0x2e66);
+			COMPARE(Half(65504.f).bits, 0x7bff);
+			COMPARE(Half(65520.f).bits, 0x7c00);
+			COMPARE(Half(1e-7f).bits, 0x0002);
+			COMPARE(static_cast<float>(Half::FromBits(0x0001)), 5.9604645e-8f);
+
+			// Every non NaN half survives a round trip through float
+			bool roundTrip = true;
+			for (uint32_t bits = 0; bits < 0x10000; bits++)
+			{
+				if ((bits & 0x7c00) == 0x7c00 && (bits & 0x03ff) != 0)
+					continue;
+				roundTrip &= Half(Half::ToFloat(static_cast<uint16_t>(bits))).bits == bits;
+			}
+			REQUIRE(roundTrip);
+		}
+		TEST(Fixed Point Arithmetic)
+		{
+			COMPARE(Fixed16_16(1.5f).raw, 98304);
+			COMPARE(Fixed16_16(-3).raw, -196608);
+			COMPARE(static_cast<float>(Fixed16_16(1.5f) * Fixed16_16(-2.25f)), -3.375f);
+			COMPARE(static_cast<float>(Fixed16_16(7) / Fixed16_16(2)), 3.5f);
+			COMPARE(static_cast<int>(Fixed16_16(-2.75f)), -2);
+			REQUIRE(Fixed16_16(0.25f) < Fixed16_16(0.5f));
+
+			// Out of range values saturate, NaN converts to 0
+			COMPARE(Fixed16_16(40000.f).raw, INT32_MAX);
+			COMPARE(Fixed16_16(-1e30).raw, INT32_MIN);
+			COMPARE(Fixed16_16(std::numeric_limits<float>::infinity()).raw, INT32_MAX);
+			COMPARE(Fixed16_16(std::numeric_limits<double>::quiet_NaN()).raw, 0);
+			COMPARE(Fixed16_16(32767.99999).raw, INT32_MAX);
+			COMPARE(Fixed16_16(-32768.f).raw, INT32_MIN);
+			COMPARE(Fixed16_16(100000).raw, INT32_MAX);
+			COMPARE(Fixed16_16(-100000LL).raw, INT32_MIN);
+			COMPARE(Fixed16_16(UINT64_MAX).raw, INT32_MAX);
+
+			// Products and quotients too, dividing by zero gives the saturated value of the dividend's sign
+			COMPARE((Fixed16_16(300) * Fixed16_16(300)).raw, INT32_MAX);
+			COMPARE((Fixed16_16(30000) / Fixed16_16(0.5f)).raw, INT32_MAX);
+			COMPARE((Fixed16_16(3) / Fixed16_16()).raw, INT32_MAX);
+			COMPARE((Fixed16_16(-3) / Fixed16_16()).raw, INT32_MIN);
+			COMPARE((Fixed16_16() / Fixed16_16()).raw, 0);
+
+			// Sums, differences and negation as well, up to the edges of the range
+			const Fixed16_16 highest = Fixed16_16::FromRaw(INT32_MAX), lowest = Fixed16_16::FromRaw(INT32_MIN);
+			COMPARE((highest + Fixed16_16::FromRaw(1)).raw, INT32_MAX);
+			COMPARE((lowest - Fixed16_16::FromRaw(1)).raw, INT32_MIN);
+			COMPARE((lowest + lowest).raw, INT32_MIN);
+			COMPARE((highest - lowest).raw, INT32_MAX);
+			COMPARE((highest + lowest).raw, -1);
+			COMPARE((-lowest).raw, INT32_MAX);
+			COMPARE((-highest).raw, -INT32_MAX);
+			Fixed16_16 accumulated = Fixed16_16(30000);
+			accumulated += Fixed16_16(30000);
+			COMPARE(accumulated.raw, INT32_MAX);
+			accumulated -= highest;
+			COMPARE(accumulated.raw, 0);
+			accumulated -= highest;
+			accumulated -= Fixed16_16(1);
+			COMPARE(accumulated.raw, INT32_MIN);
+			static_assert((-Fixed16_16::FromRaw(INT32_MIN)).raw == INT32_MAX && (Fixed16_16::FromRaw(INT32_MAX) + Fixed16_16::FromRaw(INT32_MAX)).raw == INT32_MAX);
+		}
+		TEST(Vector Operators)
+		{
+			Vec3h half(1, 2.5f, -3);
+			REQUIRE(half + Vec3h(0.5f) == Vec3f(1.5f, 3.f, -2.5f));
+			REQUIRE(half * 2 == Vec3f(2, 5, -6));
+			REQUIRE(Vec4h(Vec4f(1, 2, 3, 4)) / 2 == Vec4f(0.5f, 1, 1.5f, 2));
+			REQUIRE(Vec2h(0.75f, 8).ToVec2f() == Vec2f(0.75f, 8));
+			REQUIRE(Vec2h(0.75f, 8).ToVec2i() == Vec2i(0, 8));
+			REQUIRE(half.ToString(2) == std::string("1.00, 2.50, -3.00"));
+
+			Vec3<Fixed16_16> fixed(1.5f, -2, 0.25f);
+			REQUIRE(fixed * 2 == Vec3f(3, -4, 0.5f));
+			REQUIRE(fixed - Vec3<Fixed16_16>(0.5f) == Vec3f(1, -2.5f, -0.25f));
+			REQUIRE(Vec3f(fixed) == Vec3f(1.5f, -2, 0.25f));
+			COMPARE(static_cast<float>(fixed.Dot(fixed)), 6.3125f);
+		}
+		TEST(Batch Conversion)
+		{
+			// 29 vectors so the SIMD blocks and their scalar tails both run
+			std::vector<Vec3f> positions;
+			for (int i = 0; i < 29; i++)
+				positions.push_back(Vec3f(i * 0.37f - 5.f, 1000.f / (i + 1), -i * 3.3f));
+
+			std::vector<Vec3h> halfPositions(positions.size());
+			ConvertBatch(positions, halfPositions);
+			std::vector<Vec3f> fromHalf(positions.size());
+			ConvertBatch(halfPositions, fromHalf);
+
+			std::vector<Vec3<Fixed16_16>> fixedPositions(positions.size());
+			ConvertBatch(positions, fixedPositions);
+			std::vector<Vec3f> fromFixed(positions.size());
+			ConvertBatch(fixedPositions, fromFixed);
+
+			bool sameAsScalar = true;
+			for (size_t i = 0; i < positions.size(); i++)
+			{
+				for (size_t c = 0; c < 3; c++)
+				{
+					sameAsScalar &= halfPositions[i][c].bits == Half(positions[i][c]).bits;
+					sameAsScalar &= fromHalf[i][c] == static_cast<float>(halfPositions[i][c]);
+					sameAsScalar &= fixedPositions[i][c] == Fixed16_16(positions[i][c]);
+					sameAsScalar &= fromFixed[i][c] == static_cast<float>(fixedPositions[i][c]);
+					sameAsScalar &= std::abs(fromHalf[i][c] - positions[i][c]) <= std::abs(positions[i][c]) / 1024.f;
+				}
+			}
+			REQUIRE(sameAsScalar);
+
+			// The batch saturates and clears NaN like the scalar conversion, in the SIMD blocks and the tail
+			const float nan = std::numeric_limits<float>::quiet_NaN(), infinity = std::numeric_limits<float>::infinity();
+			const float extremes[11] = { 40000.f, -40000.f, nan, infinity, -infinity, 32767.998f, -32768.f, 1.5f, nan, 1e30f, -1e30f };
+			Fixed16_16 fixedExtremes[11];
+			ConvertBatch(extremes, fixedExtremes, 11);
+			bool saturated = true;
+			for (size_t i = 0; i < 11; i++)
+				saturated &= fixedExtremes[i] == Fixed16_16(extremes[i]);
+			REQUIRE(saturated);
+
+			std::vector<Vec4f> colors(11, Vec4f(0.25f, 0.5f, 0.75f, 1.f));
+			std::vector<Vec4h> halfColors(colors.size());
+			ConvertBatch(colors, halfColors);
+			std::vector<Vec4f> fromHalfColors(colors.size());
+			ConvertBatch(halfColors, fromHalfColors);
+			REQUIRE(fromHalfColors == colors);
+		}
+	}
+#pragma endregion
+
+#pragma region Math Array Tests
+	NAMESPACE(Math_Array)
+	{
+		auto isAligned = [](const void* pointer, size_t alignment) { return reinterpret_cast<uintptr_t>(pointer) % alignment == 0; };
+
+		TEST(Aligned Storage)
+		{
+			MathArray<Vec3f> positions(37, Vec3f(1, 2, 3));
+			REQUIRE(isAligned(positions.data(), 64));
+			MathArray<Mat4, AlignedAllocator<Mat4, 32>> matrices(5, Mat4::Identity());
+			REQUIRE(isAligned(matrices.data(), 32));
+
+			// Batch APIs take the arrays directly through std::span
+			MathArray<Vec3f> rotated(positions.size());
+			Quat rotation = Quat::AngleAxis(90.f, Vec3f(0, 1, 0));
+			rotation.Rotate(positions, rotated);
+			REQUIRE(rotated[36] == rotation * positions[36]);
+		}
+		TEST(Frame Arena)
+		{
+			FrameArena arena(1024);
+			void* firstAllocation = arena.Allocate(100, 64);
+			REQUIRE(isAligned(firstAllocation, 64));
+			REQUIRE(isAligned(arena.Allocate(3, 32), 32));
+			REQUIRE(arena.GetUsedSize() == 131);
+
+			// Bigger than a block: the arena grows, then keeps the block for the next frame
+			arena.Allocate(4000, 64);
+			size_t capacity = arena.GetCapacity();
+			REQUIRE(capacity > 4000);
+
+			arena.Reset();
+			COMPARE(arena.GetUsedSize(), 0);
+			REQUIRE(arena.Allocate(100, 64) == firstAllocation);
+			arena.Allocate(4000, 64);
+			COMPARE(arena.GetCapacity(), capacity);
+
+			// Alignments past the 64 bytes of a block hold in new blocks too
+			FrameArena small(256);
+			bool aligned = true;
+			for (int i = 0; i < 64; i++)
+				aligned &= isAligned(small.Allocate(200, 256), 256);
+			REQUIRE(aligned);
+		}
+		TEST(Frame Array)
+		{
+			FrameArena arena;
+			{
+				FrameArray<Vec3f> positions{ ArenaAllocator<Vec3f>(arena) };
+				positions.reserve(100);
+				for (int i = 0; i < 100; i++)
+					positions.push_back(Vec3f(i * 0.5f, 1, -i * 0.25f));
+				REQUIRE(isAligned(positions.data(), 64));
+
+				FrameArray<Vec3h> compact(positions.size(), Vec3h(), ArenaAllocator<Vec3h>(arena));
+				ConvertBatch(positions, compact);
+				REQUIRE(compact[99] == positions[99]);
+			}
+			size_t used = arena.GetUsedSize();
+			arena.Reset();
+			FrameArray<Vec3f> nextFrame(100, Vec3f(), ArenaAllocator<Vec3f>(arena));
+			REQUIRE(arena.GetUsedSize() <= used);
+
+			FrameArray<Vec4f> threadArray(8);
+			REQUIRE(threadArray.get_allocator().arena == &FrameArena::ThreadLocal());
+		}
+	}
+#pragma endregion
+
+#pragma region Generic Vector Tests
+	NAMESPACE(Generic_Vectors)
+	{
+		TEST(VecN)
+		{
+			constexpr VecN<float, 4> a(1, 2, 3, 4);
+			constexpr VecN<float, 4> b(0.5f, -1, 2, 8);
+			static_assert(a.Dot(b) == 36.5f);
+			static_assert((a + b) * 2.f == VecN<float, 4>(3, 2, 10, 24));
+			static_assert(VecN<float, 4>::Axis(2) == VecN<float, 4>(0, 0, 1, 0));
+			// Vec2, Vec3 and Vec4 are VecN, the named components are its components
+			static_assert(std::is_same_v<Vec4f, VecN<float, 4>> && sizeof(Vec3f) == 3 * sizeof(float));
+			static_assert(a.w == 4.f && (a - b).Swizzle<3, 0>() == Vec2f(-4, 0.5f));
+
+			// The SIMD dot product adds in component order like the constant evaluated fold
+			constexpr VecN<float, 3> c(0.1f, 0.7f, 1.3f), d(-2.9f, 0.33f, 1.7f);
+			constexpr float constantDot = c.Dot(d);
+			volatile float x = 0.1f;
+			REQUIRE((VecN<float, 3>(x, 0.7f, 1.3f).Dot(d) == constantDot));
+
+			VecN<double, 5> e(1.0, 2.0, 2.0, 4.0, 0.0);
+			COMPARE(e.Length(), 5.0);
+			REQUIRE((e.GetNormalize() == VecN<double, 5>(0.2, 0.4, 0.4, 0.8, 0.0)));
+			REQUIRE((e.Min(VecN<double, 5>(1.5)) == VecN<double, 5>(1.0, 1.5, 1.5, 1.5, 0.0)));
+
+			VecN<float, 3> f = Vec3f(1, 2, 3);
+			f += VecN<float, 3>(1.f);
+			f *= 2.f;
+			REQUIRE((f == Vec3f(4, 6, 8)));
+		}
+
+		TEST(Mat)
+		{
+			Mat4 transform = Mat4::CreateTransformMatrix(Vec3f(1, 2, 3), Vec3f(30, 45, 60), Vec3f(1, 2, 1));
+			Mat4 view = Mat4::CreateTransformMatrix(Vec3f(-4, 0, 2), Vec3f(10, -20, 5), Vec3f(1, 1, 1));
+			Mat<float, 4, 4> generic(transform);
+			REQUIRE((generic * Mat<float, 4, 4>(view)).ToMat4() == transform * view);
+			REQUIRE(generic * Vec4f(1, 2, 3, 1) == transform * Vec4f(1, 2, 3, 1));
+			REQUIRE(generic.GetTranspose().ToMat4() == transform.GetTranspose());
+
+			// Non square products
+			Mat<float, 2, 3> left;
+			left[0] = VecN<float, 2>(1, 4);
+			left[1] = VecN<float, 2>(2, 5);
+			left[2] = VecN<float, 2>(3, 6);
+			Mat<float, 2, 2> product = left * left.GetTranspose();
+			REQUIRE((product[0] == VecN<float, 2>(14, 32)));
+			REQUIRE((product[1] == VecN<float, 2>(32, 77)));
+			static_assert(Mat3f::Identity() * VecN<float, 3>(1, 2, 3) == VecN<float, 3>(1, 2, 3));
+		}
+
+		TEST(Consistency)
+		{
+			// Vec4 compares in constant expressions like Vec2 and Vec3, and points the same way as Vec3
+			static_assert(Vec4f(1, 2, 3, 4) == Vec4f(1, 2, 3, 4));
+			static_assert(Vec4f::Forward() == Vec4f(Vec3f::Forward(), 0));
+			static_assert(Vec4f::Back() == Vec4f(Vec3f::Back(), 0));
+		}
+	}
+#pragma endregion
+
+#pragma region Swizzle Tests
+	NAMESPACE(Swizzle)
+	{
+		TEST(Named)
+		{
+			constexpr Vec4f v(1, 2, 3, 4);
+			static_assert(v.xzy() == Vec3f(1, 3, 2));
+			static_assert(v.ww() == Vec2f(4, 4));
+			static_assert(v.wzyx() == Vec4f(4, 3, 2, 1));
+			static_assert(Vec2f(5, 6).yxyx() == Vec4f(6, 5, 6, 5));
+			static_assert(Vec3f(1, 2, 3).Swizzle<2>() == 3.f);
+			REQUIRE(Vec3i(7, 8, 9).zzx() == Vec3i(9, 9, 7));
+
+			Mat4 transform = Mat4::CreateTransformMatrix(Vec3f(1, 2, 3), Vec3f(30, 45, 60), Vec3f(1, 2, 1));
+			REQUIRE(transform.GetTranslation() == Vec3f(1, 2, 3));
+		}
+
+		TEST(Views)
+		{
+			Vec4f v(1, 2, 3, 4);
+			v.View<0, 2>() = Vec2f(10, 30);
+			REQUIRE(v == Vec4f(10, 2, 30, 4));
+
+			// Both sides read the same components, the value is read before anything is written
+			v.View<0, 1>() = v.View<1, 0>();
+			REQUIRE(v == Vec4f(2, 10, 30, 4));
+
+			v.View<3, 2, 1>() += Vec3f(1, 2, 3);
+			REQUIRE(v == Vec4f(2, 13, 32, 5));
+			v.View<1>() -= 3.f;
+			v.View<0, 3>() *= 2.f;
+			REQUIRE(v == Vec4f(4, 10, 32, 10));
+			REQUIRE(static_cast<Vec2f>(v.View<3, 0>()) == Vec2f(10, 4));
+		}
+
+		TEST(VecN)
+		{
+			const VecN<float, 4> a(1, 2, 3, 4);
+			volatile float x = 5.f;
+			const VecN<float, 3> b(x, 6, 7);
+			REQUIRE((a.Swizzle<3, 2, 1, 0>() == VecN<float, 4>(4, 3, 2, 1)));
+			REQUIRE((a.Swizzle<3, 0, 0>() == VecN<float, 3>(4, 1, 1)));
+			REQUIRE((b.Swizzle<2, 1, 0, 2>() == VecN<float, 4>(7, 6, 5, 7)));
+			REQUIRE((b.Swizzle<1, 2>() == VecN<float, 2>(6, 7)));
+			static_assert(VecN<float, 3>(1, 2, 3).Swizzle<2, 0, 1>() == VecN<float, 3>(3, 1, 2));
+		}
+	}
+#pragma endregion
+
+#pragma region Random Tests
+	NAMESPACE(Random_Generation)
+	{
+		TEST(Streams)
+		{
+			// The batch and the one at a time interfaces read the same sequence
+			Random a(42), b(42), c(42, 1);
+			std::vector<float> batch(37);
+			a.Uniform(batch);
+			bool same = true, sameStream = true;
+			for (float value : batch)
+			{
+				same &= value == b.NextFloat();
+				sameStream &= value == c.NextFloat();
+			}
+			REQUIRE(same);
+			REQUIRE(!sameStream);
+
+			// Seed and stream are not interchangeable
+			Random swappedA(3, 5), swappedB(5, 3);
+			REQUIRE(swappedA.NextUInt() != swappedB.NextUInt());
+
+			// Golden sequence, the output for a seed and stream must not change across versions and platforms
+			Random golden(42, 7);
+			std::vector<uint32_t> sequence(10);
+			for (uint32_t& value : sequence)
+				value = golden.NextUInt();
+			const std::vector<uint32_t> expected = { 0x77D3F532u, 0xD35A587Bu, 0x84479566u, 0x6AEE6E15u, 0xA201D262u, 0xC83C1A33u, 0xDF6A7C4Bu, 0x51B8B868u, 0x63162366u, 0x177305ACu };
+			REQUIRE(sequence == expected);
+
+			// Every thread draws from its own stream
+			float first = Random::ForThread().NextFloat(), other = 0;
+			std::thread thread([&] { other = Random::ForThread().NextFloat(); });
+			thread.join();
+			REQUIRE(first != other);
+		}
+
+		TEST(Shapes)
+		{
+			Random random(7);
+			std::vector<float> uniform(4096);
+			random.Uniform(uniform);
+			double mean = 0;
+			bool inRange = true;
+			for (float u : uniform)
+			{
+				mean += u;
+				inRange &= u >= 0.f && u < 1.f;
+			}
+			REQUIRE(inRange);
+			REQUIRE(std::abs(mean / uniform.size() - 0.5) < 0.02);
+
+			std::vector<Vec3f> sphere(1000), ball(1000), box(1000);
+			std::vector<Vec2f> disk(1000);
+			std::vector<Quat> rotations(1000);
+			random.OnSphere(sphere);
+			random.InSphere(ball);
+			random.InDisk(disk);
+			random.InBox<Vec3f>(box, Vec3f(-1, 2, 3), Vec3f(1, 4, 3.5f));
+			random.Rotation(rotations);
+			bool valid = true;
+			Vec3f center;
+			for (size_t i = 0; i < 1000; i++)
+			{
+				valid &= AlmostEqual(sphere[i].Length(), 1.f, 1e-5f) && ball[i].Length() < 1.f && disk[i].Length() < 1.f;
+				valid &= box[i].x >= -1 && box[i].x < 1 && box[i].y >= 2 && box[i].y < 4 && box[i].z >= 3 && box[i].z < 3.5f;
+				valid &= AlmostEqual(rotations[i].Dot(rotations[i]), 1.f, 1e-5f);
+				center += sphere[i];
+			}
+			REQUIRE(valid);
+			REQUIRE(center.Length() / 1000.f < 0.1f);
+			REQUIRE(AlmostEqual(random.OnSphere().Length(), 1.f, 1e-5f));
+			REQUIRE(random.InSphere().Length() < 1.f);
+		}
+	}
+#pragma endregion
+
+#pragma region Spline Tests
+	NAMESPACE(Splines)
+	{
+		TEST(Segments)
+		{
+			constexpr CubicCurve<Vec2f> bezier = CubicCurve<Vec2f>::Bezier(Vec2f(0, 0), Vec2f(0, 2), Vec2f(2, 2), Vec2f(2, 0));
+			static_assert(bezier.Evaluate(0) == Vec2f(0, 0) && bezier.Evaluate(1) == Vec2f(2, 0));
+			static_assert(bezier.Evaluate(0.5f) == Vec2f(1, 1.5f));
+
+			const Vec3f p0(1, 2, 3), m0(0, 4, 0), p1(-2, 0, 5), m1(1, 1, 1);
+			const CubicCurve<Vec3f> hermite = CubicCurve<Vec3f>::Hermite(p0, m0, p1, m1);
+			REQUIRE(hermite.Evaluate(0) == p0 && hermite.Evaluate(1) == p1);
+			REQUIRE(hermite.Derivative(0) == m0 && hermite.Derivative(1) == m1);
+
+			// Forward differencing follows the polynomial
+			std::vector<Vec3f> samples(1000);
+			hermite.Sample(samples);
+			bool close = true;
+			for (size_t i = 0; i < samples.size(); i++)
+				close &= (samples[i] - hermite.Evaluate(i / 999.f)).Length() < 1e-4f;
+			REQUIRE(close);
+
+			// The batches stop at the shortest span
+			const std::vector<float> times = { 0.f, 1.f };
+			const std::vector<CubicCurve<Vec3f>> curves(3, hermite);
+			std::vector<Vec3f> evaluated(4, Vec3f(7)), each(4, Vec3f(7));
+			hermite.Evaluate(times, evaluated);
+			CubicCurve<Vec3f>::EvaluateEach(curves, times, each);
+			REQUIRE(evaluated[0] == p0 && evaluated[1] == p1 && evaluated[2] == Vec3f(7));
+			REQUIRE(each[0] == p0 && each[1] == p1 && each[2] == Vec3f(7));
+		}
+
+		TEST(Splines)
+		{
+			const std::vector<Vec3f> points = { Vec3f(0, 0, 0), Vec3f(1, 2, 0), Vec3f(3, 2, 1), Vec3f(4, 0, 1), Vec3f(6, -1, 0) };
+			const Spline<Vec3f> spline = Spline<Vec3f>::CatmullRom(points);
+			REQUIRE(spline.GetSegmentCount() == 4);
+			bool through = true;
+			for (size_t i = 0; i < points.size(); i++)
+				through &= spline.Evaluate(static_cast<float>(i)) == points[i];
+			REQUIRE(through);
+
+			std::vector<Vec3f> sampled(101), evaluated(101);
+			std::vector<float> parameters(101);
+			for (size_t i = 0; i < parameters.size(); i++)
+				parameters[i] = i * 0.04f;
+			spline.Sample(sampled);
+			spline.Evaluate(parameters, evaluated);
+			bool same = true;
+			for (size_t i = 0; i < sampled.size(); i++)
+				same &= (sampled[i] - evaluated[i]).Length() < 1e-4f;
+			REQUIRE(same);
+
+			const Spline<Vec2f> bezier = Spline<Vec2f>::Bezier(std::vector<Vec2f>{ Vec2f(0, 0), Vec2f(1, 1), Vec2f(2, 1), Vec2f(3, 0), Vec2f(4, -1), Vec2f(5, -1), Vec2f(6, 0) });
+			REQUIRE(bezier.GetSegmentCount() == 2);
+			REQUIRE(bezier.Evaluate(1) == Vec2f(3, 0));
+			REQUIRE(bezier.Evaluate(2) == Vec2f(6, 0));
+
+			// Too few points give an empty spline, which evaluates to zero
+			const Spline<Vec3f> empty = Spline<Vec3f>::Bezier(std::vector<Vec3f>{ Vec3f(1, 2, 3) });
+			REQUIRE(empty.GetSegmentCount() == 0);
+			REQUIRE(empty.Evaluate(0.5f) == Vec3f());
+			REQUIRE(empty.Derivative(0.5f) == Vec3f());
+			std::vector<Vec3f> emptySamples(3, Vec3f(1)), emptyEvaluated(3, Vec3f(1));
+			empty.Sample(emptySamples);
+			empty.Evaluate(std::vector<float>{ 0.f, 1.f, 2.f }, emptyEvaluated);
+			REQUIRE(emptySamples == std::vector<Vec3f>(3) && emptyEvaluated == std::vector<Vec3f>(3));
+		}
+
+		TEST(Arc Length)
+		{
+			// Evenly spaced points on a line: the length is exact and the motion already uniform
+			const std::vector<Vec3f> line = { Vec3f(0, 0, 0), Vec3f(1, 0, 0), Vec3f(2, 0, 0), Vec3f(3, 0, 0) };
+			const ArcLengthTable lineTable(Spline<Vec3f>::CatmullRom(line));
+			COMPARE(lineTable.GetLength(), 3.f);
+			REQUIRE(AlmostEqual(lineTable.GetParameter(1.5f), 1.5f, 1e-3f));
+
+			const std::vector<Vec3f> points = { Vec3f(0, 0, 0), Vec3f(1, 4, 0), Vec3f(4, 5, 1), Vec3f(6, 0, 2) };
+			const Spline<Vec3f> spline = Spline<Vec3f>::CatmullRom(points);
+			const ArcLengthTable table(spline, 64);
+			std::vector<float> parameters(200);
+			std::vector<Vec3f> positions(200);
+			table.GetParameters(parameters);
+			spline.Evaluate(parameters, positions);
+			const float spacing = table.GetLength() / 199.f;
+			bool uniform = true;
+			for (size_t i = 1; i < positions.size(); i++)
+				uniform &= std::abs((positions[i] - positions[i - 1]).Length() - spacing) < spacing * 0.02f;
+			REQUIRE(uniform);
+			REQUIRE(AlmostEqual(table.GetParameter(table.GetLength()), 3.f));
+		}
+
+		TEST(Squad)
+		{
+			const std::vector<Quat> keys = { Quat::Identity(), Quat::AngleAxis(90.f, Vec3f(0, 1, 0)),
+				Quat::AngleAxis(120.f, Vec3f(1, 1, 0).GetNormalize()) * -1.f, Quat::AngleAxis(30.f, Vec3f(0, 0, 1)) };
+			const SquadSpline<float> squad(keys);
+			REQUIRE(squad.GetSegmentCount() == 3);
+			REQUIRE(squad.Evaluate(0) == keys[0]);
+			REQUIRE(squad.Evaluate(1) == keys[1]);
+			// The third key was negated, the spline goes through the same rotation
+			REQUIRE(squad.Evaluate(2) == keys[2] * -1.f);
+
+			std::vector<float> parameters(61);
+			std::vector<Quat> rotations(61);
+			for (size_t i = 0; i < parameters.size(); i++)
+				parameters[i] = i * 0.05f;
+			squad.Evaluate(parameters, rotations);
+			bool unit = true, smooth = true;
+			for (size_t i = 0; i < rotations.size(); i++)
+			{
+				unit &= AlmostEqual(rotations[i].Dot(rotations[i]), 1.f, 1e-4f);
+				smooth &= i == 0 || rotations[i].Dot(rotations[i - 1]) > 0.98f;
+			}
+			REQUIRE(unit);
+			REQUIRE(smooth);
+		}
+	}
+#pragma endregion
+
+#pragma region Animation Tests
+	NAMESPACE(Animation)
+	{
+		// 11 tracks so the last SIMD pack is partial, keys at different times per track
+		AnimationClip clip;
+		for (size_t track = 0; track < 11; track++)
+		{
+			std::vector<Keyframe> keys;
+			for (size_t k = 0; k < 5 + track; k++)
+			{
+				Keyframe key;
+				key.time = k * (0.5f + track * 0.1f);
+				key.translation = Vec3f(float(k), float(track), k * 0.5f);
+				key.rotation = Quat::AngleAxis(k * 40.f + track * 5.f, Vec3f(track * 0.1f, 1, 0.3f).GetNormalize());
+				key.scale = Vec3f(1.f + k * 0.1f);
+				keys.push_back(key);
+			}
+			std::reverse(keys.begin(), keys.end());
+			clip.AddTrack(keys);
+		}
+
+		TEST(Keys)
+		{
+			REQUIRE(clip.GetTrackCount() == 11);
+			AnimationSampler sampler(clip);
+			TransformSoA pose;
+			bool exact = true;
+			for (size_t track = 0; track < clip.GetTrackCount(); track++)
+			{
+				const Keyframe& key = clip.GetTrack(track)[2];
+				sampler.Sample(key.time, pose);
+				exact &= pose.translation.Get(track) == key.translation && pose.GetRotation(track) == key.rotation && pose.scale.Get(track) == key.scale;
+			}
+			REQUIRE(exact);
+
+			// Before the first key and after the last one the track holds
+			sampler.Sample(-1.f, pose);
+			REQUIRE(pose.translation.Get(10) == clip.GetTrack(10)[0].translation);
+			sampler.Sample(100.f, pose);
+			REQUIRE(pose.translation.Get(10) == clip.GetTrack(10).back().translation);
+			REQUIRE(pose.GetMatrix(3) == Mat4::CreateTransformMatrix(pose.translation.Get(3), pose.GetRotation(3), pose.scale.Get(3)));
+		}
+
+		TEST(Blend)
+		{
+			AnimationSampler sampler(clip);
+			TransformSoA nlerp, slerp;
+			const float time = 1.3f;
+			sampler.Sample(time, nlerp, Interpolation::NLerp);
+			sampler.Sample(time, slerp, Interpolation::SLerp);
+			bool linear = true, normalized = true, spherical = true;
+			for (size_t track = 0; track < clip.GetTrackCount(); track++)
+			{
+				const std::span<const Keyframe> keys = clip.GetTrack(track);
+				size_t k = 0;
+				while (keys[k + 1].time <= time)
+					k++;
+				const float t = (time - keys[k].time) / (keys[k + 1].time - keys[k].time);
+				linear &= nlerp.translation.Get(track) == keys[k].translation.Lerp(keys[k + 1].translation, t);
+				normalized &= nlerp.GetRotation(track) == (keys[k].rotation * (1 - t) + keys[k + 1].rotation * t).GetNormalize();
+				spherical &= std::abs(slerp.GetRotation(track).Dot(Quat::SLerp(keys[k].rotation, keys[k + 1].rotation, t))) > 0.99999f;
+			}
+			REQUIRE(linear);
+			REQUIRE(normalized);
+			REQUIRE(spherical);
+		}
+
+		TEST(Cursors)
+		{
+			// Playing forward, jumping back and sampling fresh all agree
+			AnimationSampler playing(clip);
+			TransformSoA played, fresh;
+			bool same = true;
+			for (float time : { 0.f, 0.1f, 0.7f, 0.75f, 2.9f, 0.2f, 3.4f, 3.4f, 1.1f })
+			{
+				playing.Sample(time, played);
+				AnimationSampler(clip).Sample(time, fresh);
+				for (size_t track = 0; track < clip.GetTrackCount(); track++)
+					same &= played.translation.Get(track) == fresh.translation.Get(track) && played.GetRotation(track) == fresh.GetRotation(track);
+			}
+			REQUIRE(same);
+
+			// Tracks added after the sampler exists, past the end of its first block
+			AnimationClip grown = clip;
+			AnimationSampler growing(grown);
+			growing.Sample(1.f, played);
+			for (size_t track = 0; track < 60; track++)
+				grown.AddTrack(clip.GetTrack(track % clip.GetTrackCount()));
+			bool grownSame = true;
+			for (float time : { 1.5f, 0.3f })
+			{
+				growing.Sample(time, played);
+				AnimationSampler(grown).Sample(time, fresh);
+				grownSame &= played.GetSize() == grown.GetTrackCount();
+				for (size_t track = 0; track < grown.GetTrackCount(); track++)
+					grownSame &= played.translation.Get(track) == fresh.translation.Get(track) && played.GetRotation(track) == fresh.GetRotation(track);
+			}
+			REQUIRE(grownSame);
+		}
+	}
+#pragma endregion
+
+#pragma region BVH Tests
+	NAMESPACE(BVH)
+	{
+		// Small triangles spread in a ball and rays through it, checked against testing every primitive
+		Random random(5);
+		std::vector<Triangle> triangles(3000);
+		std::vector<AABB> boxes(triangles.size());
+		for (size_t i = 0; i < triangles.size(); i++)
+		{
+			const Vec3f center = random.InSphere() * 20.f;
+			triangles[i] = { center + random.InSphere(), center + random.InSphere(), center + random.InSphere() };
+			boxes[i] = AABB(center - Vec3f(0.3f), center + Vec3f(0.3f));
+		}
+		std::vector<Ray> rays(500);
+		for (Ray& ray : rays)
+		{
+			ray.origin = random.OnSphere() * 30.f;
+			ray.direction = random.InSphere() * 10.f - ray.origin;
+		}
+		rays[0].direction = Vec3f(0, 0, 1);
+		rays[1].tMax = 5.f;
+		auto closest = [](const Ray& ray, auto& primitives)
+		{
+			RayHit hit;
+			for (size_t i = 0; i < primitives.size(); i++)
+			{
+				float t = 0.f, u, v;
+				bool intersects;
+				if constexpr (std::is_same_v<std::decay_t<decltype(primitives[i])>, Triangle>)
+					intersects = IntersectRay(ray, primitives[i], t, u, v);
+				else
+					intersects = IntersectRay(ray, primitives[i], t);
+				if (intersects && t < hit.t)
+				{
+					hit.t = t;
+					hit.primitive = static_cast<uint32_t>(i);
+				}
+			}
+			return hit;
+		};
+		auto matches = [&](const auto& bvh, auto& primitives)
+		{
+			bool same = true;
+			size_t hits = 0;
+			for (const Ray& ray : rays)
+			{
+				const RayHit expected = closest(ray, primitives);
+				RayHit hit;
+				same &= bvh.Intersect(ray, hit) == (expected.primitive != RayHit::None);
+				same &= hit.primitive == expected.primitive && AlmostEqual(hit.t, expected.t, 1e-4f);
+				same &= bvh.Occluded(ray) == (expected.primitive != RayHit::None);
+				hits += expected.primitive != RayHit::None;
+			}
+			return same && hits > 50;
+		};
+
+		TEST(Closest Hit)
+		{
+			BVH4 bvh4(triangles);
+			BVH8 bvh8(triangles);
+			REQUIRE(bvh4.GetPrimitiveCount() == triangles.size());
+			REQUIRE(matches(bvh4, triangles));
+			REQUIRE(matches(bvh8, triangles));
+			REQUIRE(matches(BVH8(boxes), boxes));
+
+			std::vector<RayHit> hits(rays.size());
+			bvh8.Intersect(rays, hits);
+			bool same = true;
+			for (size_t i = 0; i < rays.size(); i++)
+				same &= hits[i].primitive == closest(rays[i], triangles).primitive;
+			REQUIRE(same);
+		}
+
+		TEST(Overlap)
+		{
+			BVH8 bvh(boxes);
+			bool same = true;
+			for (size_t query = 0; query < 50; query++)
+			{
+				const Vec3f center = random.InSphere() * 20.f;
+				const AABB box(center - Vec3f(2.f), center + Vec3f(2.f + query * 0.1f));
+				std::vector<uint32_t> found, expected;
+				bvh.Overlap(box, found);
+				for (size_t i = 0; i < boxes.size(); i++)
+				{
+					if (boxes[i].Overlaps(box))
+						expected.push_back(static_cast<uint32_t>(i));
+				}
+				std::sort(found.begin(), found.end());
+				same &= found == expected;
+			}
+			REQUIRE(same);
+			std::vector<uint32_t> all;
+			bvh.Overlap(AABB(Vec3f(-FLT_MAX), Vec3f(FLT_MAX)), all);
+			REQUIRE(all.size() == boxes.size());
+		}
+
+		TEST(Degenerate)
+		{
+			// Identical primitives can only be split by count, no primitive and a single one still answer queries
+			std::vector<Triangle> stacked(1000, Triangle{ Vec3f(0, 0, 0), Vec3f(1, 0, 0), Vec3f(0, 1, 0) });
+			BVH4 bvh(stacked);
+			RayHit hit;
+			REQUIRE(bvh.Intersect(Ray{ Vec3f(0.2f, 0.2f, 5.f), Vec3f(0, 0, -1) }, hit));
+			REQUIRE(AlmostEqual(hit.t, 5.f) && AlmostEqual(hit.u, 0.2f) && AlmostEqual(hit.v, 0.2f));
+			REQUIRE(BVH4(std::span(stacked.data(), 1)).Occluded(Ray{ Vec3f(0.2f, 0.2f, 5.f), Vec3f(0, 0, -1) }));
+			BVH8 empty((std::span<const Triangle>()));
+			REQUIRE(!empty.Intersect(rays[2], hit) && !empty.Occluded(rays[2]) && empty.GetNodeCount() == 0);
+		}
+
+		TEST(Signed Zero Direction)
+		{
+			// A -0 component is parallel to its axis like +0, the ray still enters the box it starts in front of
+			const AABB box(Vec3f(-1.f), Vec3f(1.f));
+			const Ray ray{ Vec3f(-5, 0, 0), Vec3f(1, -0.f, 0) };
+			float t = 0.f;
+			REQUIRE(IntersectRay(ray, box, t));
+			RayHit hit4, hit8;
+			REQUIRE(BVH4(std::span(&box, 1)).Intersect(ray, hit4) && BVH4(std::span(&box, 1)).Occluded(ray));
+			REQUIRE(BVH8(std::span(&box, 1)).Intersect(ray, hit8) && BVH8(std::span(&box, 1)).Occluded(ray));
+			REQUIRE(AlmostEqual(hit4.t, 4.f) && AlmostEqual(hit8.t, 4.f));
+			REQUIRE(BVH4(std::span(&box, 1)).Occluded(Ray{ Vec3f(0, 5, 0), Vec3f(-0.f, -1, -0.f) }));
+		}
+
+		TEST(Parallel Build)
+		{
+			// Subtrees built on the workers give the same tree as a build on one thread
+			std::vector<Triangle> many(50000);
+			for (Triangle& triangle : many)
+			{
+				const Vec3f center = random.InSphere() * 50.f;
+				triangle = { center + random.InSphere(), center + random.InSphere(), center + random.InSphere() };
+			}
+			SetWorkerCount(1);
+			BVH8 serial(many);
+			SetWorkerCount(4);
+			BVH8 parallel(many);
+			SetWorkerCount(0);
+			REQUIRE(parallel.GetNodeCount() == serial.GetNodeCount());
+			bool same = true;
+			for (size_t i = 0; i < serial.GetNodeCount(); i++)
+				same &= std::memcmp(&serial.GetNodes()[i], &parallel.GetNodes()[i], sizeof(BVH8::Node)) == 0;
+			for (const Ray& ray : rays)
+			{
+				RayHit a, b;
+				serial.Intersect(ray, a);
+				parallel.Intersect(ray, b);
+				same &= a.primitive == b.primitive && a.t == b.t;
+			}
+			REQUIRE(same);
+		}
+	}
+#pragma endregion
+
+#pragma region Spatial Hash Tests
+	NAMESPACE(Spatial_Hash)
+	{
+		Random random(21);
+		std::vector<Vec3f> points(5000);
+		random.InBox<Vec3f>(points, Vec3f(-10.f), Vec3f(10.f));
+		SpatialHash hash(1.f);
+		hash.Build(points);
+		auto bruteRadius = [&](const Vec3f& center, float radius)
+		{
+			std::vector<uint32_t> result;
+			for (size_t i = 0; i < points.size(); i++)
+			{
+				if ((points[i] - center).LengthSquared() <= radius * radius)
+					result.push_back(static_cast<uint32_t>(i));
+			}
+			return result;
+		};
+
+		TEST(Radius)
+		{
+			REQUIRE(hash.GetPointCount() == points.size());
+			bool same = true;
+			for (size_t query = 0; query < 200; query++)
+			{
+				const Vec3f center = random.InBox(Vec3f(-12.f), Vec3f(12.f));
+				const float radius = 0.3f + query * 0.02f;
+				std::vector<uint32_t> found;
+				hash.QueryRadius(center, radius, found);
+				std::sort(found.begin(), found.end());
+				same &= found == bruteRadius(center, radius);
+			}
+			REQUIRE(same);
+
+			// A radius wider than the table visits every bucket once
+			std::vector<uint32_t> all;
+			hash.QueryRadius(Vec3f(), 1000.f, all);
+			REQUIRE(all.size() == points.size());
+
+			// Cells a table width apart share a bucket, the distance test keeps them apart
+			const std::vector<Vec3f> aliased = { Vec3f(0.5f), Vec3f(0.5f + hash.GetTableSize(), 0.5f, 0.5f) };
+			SpatialHash small(1.f);
+			small.Build(aliased);
+			std::vector<uint32_t> near;
+			small.QueryRadius(Vec3f(0.5f), 0.5f, near);
+			REQUIRE(near.size() == 1 && near[0] == 0);
+
+			// NaN points and a zero cell size crowd into a few cells but stay queryable
+			const float nan = std::numeric_limits<float>::quiet_NaN();
+			const std::vector<Vec3f> odd = { Vec3f(nan, 0.f, 0.f), Vec3f(1.f), Vec3f(0.f) };
+			SpatialHash oddHash(1.f), flat(0.f);
+			oddHash.Build(odd);
+			flat.Build(odd);
+			std::vector<uint32_t> oddNear, flatNear;
+			oddHash.QueryRadius(Vec3f(1.f), 0.5f, oddNear);
+			flat.QueryRadius(Vec3f(0.f), 0.5f, flatNear);
+			REQUIRE(oddNear == std::vector<uint32_t>(1, 1) && flatNear == std::vector<uint32_t>(1, 2));
+		}
+
+		TEST(Nearest)
+		{
+			bool same = true;
+			for (size_t query = 0; query < 100; query++)
+			{
+				const Vec3f center = random.InBox(Vec3f(-12.f), Vec3f(12.f));
+				uint32_t found[8];
+				same &= hash.QueryNearest(center, FLT_MAX, found) == 8;
+				std::vector<uint32_t> order(points.size());
+				std::iota(order.begin(), order.end(), 0u);
+				std::partial_sort(order.begin(), order.begin() + 8, order.end(), [&](uint32_t a, uint32_t b) { return (points[a] - center).LengthSquared() < (points[b] - center).LengthSquared(); });
+				same &= std::equal(found, found + 8, order.begin());
+			}
+			REQUIRE(same);
+
+			// Fewer points than asked for, or none within the radius
+			SpatialHash few(1.f);
+			few.Build(std::span(points.data(), 5));
+			uint32_t found[8];
+			REQUIRE(few.QueryNearest(Vec3f(), FLT_MAX, found) == 5 && found[5] == SpatialHash::None);
+			REQUIRE(few.QueryNearest(Vec3f(100.f), 1.f, found) == 0 && found[0] == SpatialHash::None);
+
+			// A flat point set has no volume, the search then starts from the cell size even when it is zero or negative
+			std::vector<Vec3f> plane(100);
+			for (size_t i = 0; i < plane.size(); i++)
+				plane[i] = Vec3f(static_cast<float>(i % 10), static_cast<float>(i / 10), 0.f);
+			for (float cellSize : { 0.f, -1.f })
+			{
+				SpatialHash flat(cellSize);
+				flat.Build(plane);
+				REQUIRE(flat.QueryNearest(Vec3f(4.2f, 6.1f, 0.5f), FLT_MAX, found) == 8 && found[0] == 64);
+				REQUIRE(flat.QueryNearest(Vec3f(4.2f, 6.1f, 0.5f), 0.8f, found) == 1 && found[0] == 64);
+			}
+		}
+
+		TEST(Batches)
+		{
+			SetWorkerCount(4);
+			SpatialHash parallel(1.f);
+			parallel.Build(points);
+			std::vector<Vec3f> centers(1000);
+			random.InBox<Vec3f>(centers, Vec3f(-10.f), Vec3f(10.f));
+			std::vector<uint32_t> offsets, neighbours, nearest(centers.size() * 4);
+			parallel.QueryRadius(centers, 1.5f, offsets, neighbours);
+			parallel.QueryNearest(centers, 4, FLT_MAX, nearest);
+			SetWorkerCount(0);
+			bool same = true;
+			for (size_t i = 0; i < centers.size(); i++)
+			{
+				std::vector<uint32_t> found(neighbours.begin() + offsets[i], neighbours.begin() + offsets[i + 1]);
+				std::sort(found.begin(), found.end());
+				same &= found == bruteRadius(centers[i], 1.5f);
+				uint32_t expected[4];
+				hash.QueryNearest(centers[i], FLT_MAX, expected);
+				same &= std::equal(expected, expected + 4, nearest.begin() + i * 4);
+			}
+			REQUIRE(same);
+		}
+	}
+#pragma endregion
+
+#pragma region Space Curve Tests
+	NAMESPACE(Space_Curves)
+	{
+		Random random(43);
+
+		TEST(Morton)
+		{
+			// Bit k of x, y and z lands in bit 3k, 3k + 1 and 3k + 2
+			auto reference = [](uint64_t x, uint64_t y, uint64_t z, uint32_t bits)
+			{
+				uint64_t code = 0;
+				for (uint32_t k = 0; k < bits; k++)
+					code |= (x >> k & 1) << (3 * k) | (y >> k & 1) << (3 * k + 1) | (z >> k & 1) << (3 * k + 2);
+				return code;
+			};
+			bool same = true;
+			for (size_t i = 0; i < 1000; i++)
+			{
+				const uint32_t x = random.NextUInt(), y = random.NextUInt(), z = random.NextUInt();
+				same &= MortonEncode30(x, y, z) == reference(x & 0x3FF, y & 0x3FF, z & 0x3FF, 10);
+				same &= MortonEncode63(x, y, z) == reference(x & 0x1FFFFF, y & 0x1FFFFF, z & 0x1FFFFF, 21);
+				same &= MortonDecode30(MortonEncode30(x, y, z)) == Vec3i(x & 0x3FF, y & 0x3FF, z & 0x3FF);
+				same &= MortonDecode63(MortonEncode63(x, y, z)) == Vec3i(x & 0x1FFFFF, y & 0x1FFFFF, z & 0x1FFFFF);
+			}
+			REQUIRE(same);
+			REQUIRE(MortonEncode30(1023, 1023, 1023) == 0x3FFFFFFF);
+			REQUIRE(MortonEncode63(0x1FFFFF, 0x1FFFFF, 0x1FFFFF) == 0x7FFFFFFFFFFFFFFF);
+
+			// Points outside the bounds clamp to the edge cells, NaN components go to cell 0
+			const float nan = std::numeric_limits<float>::quiet_NaN(), infinity = std::numeric_limits<float>::infinity();
+			const Vec3f outside[] = { Vec3f(nan, 0.5f, 2.f), Vec3f(-infinity, infinity, nan) };
+			uint32_t outsideCodes[2];
+			MortonEncode(outside, AABB(Vec3f(0.f), Vec3f(1.f)), std::span(outsideCodes));
+			REQUIRE(outsideCodes[0] == MortonEncode30(0, 512, 1023));
+			REQUIRE(outsideCodes[1] == MortonEncode30(0, 1023, 0));
+		}
+
+		TEST(Hilbert)
+		{
+			// Every cell of an 8^3 grid once, each a step away from the one before
+			std::vector<uint32_t> codes(512);
+			std::iota(codes.begin(), codes.end(), 0u);
+			std::vector<Vec3i> cells(codes.size());
+			HilbertDecode(codes, cells);
+			bool adjacent = true;
+			std::vector<bool> seen(512, false);
+			for (size_t i = 0; i < cells.size(); i++)
+			{
+				if (i != 0)
+				{
+					const Vec3i step = cells[i] - cells[i - 1];
+					adjacent &= std::abs(step.x) + std::abs(step.y) + std::abs(step.z) == 1;
+				}
+				adjacent &= cells[i].x < 8 && cells[i].y < 8 && cells[i].z < 8;
+				seen[cells[i].x + cells[i].y * 8 + cells[i].z * 64] = true;
+			}
+			REQUIRE(adjacent);
+			REQUIRE(std::find(seen.begin(), seen.end(), false) == seen.end());
+
+			bool same = true;
+			for (size_t i = 0; i < 1000; i++)
+			{
+				const uint32_t code30 = random.NextUInt() & 0x3FFFFFFF;
+				const uint64_t code63 = (static_cast<uint64_t>(random.NextUInt()) << 32 | random.NextUInt()) & 0x7FFFFFFFFFFFFFFF;
+				const Vec3i cell30 = HilbertDecode30(code30), cell63 = HilbertDecode63(code63);
+				same &= HilbertEncode30(cell30.x, cell30.y, cell30.z) == code30;
+				same &= HilbertEncode63(cell63.x, cell63.y, cell63.z) == code63;
+				const Vec3i next = HilbertDecode63(code63 + 1) - cell63;
+				same &= code63 == 0x7FFFFFFFFFFFFFFF || std::abs(next.x) + std::abs(next.y) + std::abs(next.z) == 1;
+			}
+			REQUIRE(same);
+		}
+
+		TEST(Batches)
+		{
+			std::vector<Vec3f> points(3000);
+			random.InBox<Vec3f>(points, Vec3f(-5.f), Vec3f(5.f));
+			points[0] = Vec3f(-20.f, 0.f, 20.f);
+			const AABB bounds{ Vec3f(-5.f), Vec3f(5.f) };
+			std::vector<uint32_t> morton(points.size()), hilbert(points.size());
+			std::vector<uint64_t> morton63(points.size());
+			MortonEncode(points, bounds, std::span(morton));
+			HilbertEncode(points, bounds, std::span(hilbert));
+			MortonEncode(points, bounds, std::span(morton63));
+			bool same = true;
+			for (size_t i = 0; i < points.size(); i++)
+			{
+				const Vec3f cell = (points[i] + Vec3f(5.f)) * 102.4f;
+				const Vec3i expected(std::clamp(static_cast<int>(cell.x), 0, 1023), std::clamp(static_cast<int>(cell.y), 0, 1023), std::clamp(static_cast<int>(cell.z), 0, 1023));
+				same &= MortonDecode30(morton[i]) == expected && HilbertDecode30(hilbert[i]) == expected;
+				same &= MortonDecode63(morton63[i]) / 2048 == expected;
+			}
+			REQUIRE(same);
+			REQUIRE(MortonDecode30(morton[0]) == Vec3i(0, 512, 1023));
+		}
+
+		TEST(Radix Sort)
+		{
+			for (size_t count : { size_t(0), size_t(1), size_t(1000), size_t(200000) })
+			{
+				std::vector<uint64_t> keys(count);
+				for (uint64_t& key : keys)
+					key = static_cast<uint64_t>(random.NextUInt() & 0xFFFF) << 40 | (random.NextUInt() & 0xF);
+				std::vector<uint32_t> values(count);
+				std::iota(values.begin(), values.end(), 0u);
+				std::vector<std::pair<uint64_t, uint32_t>> expected(count);
+				for (size_t i = 0; i < count; i++)
+					expected[i] = { keys[i], values[i] };
+				std::stable_sort(expected.begin(), expected.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+				SetWorkerCount(3);
+				RadixSort(std::span(keys), std::span(values));
+				SetWorkerCount(0);
+				bool same = true;
+				for (size_t i = 0; i < count; i++)
+					same &= keys[i] == expected[i].first && values[i] == expected[i].second;
+				REQUIRE(same);
+			}
+
+			// Keys sharing their low byte skip the first pass, and a constant third byte a middle one
+			std::vector<uint32_t> small = { 0x300, 0x100, 0x200, 0x100 }, smallValues = { 0, 1, 2, 3 };
+			RadixSort(std::span(small), std::span(smallValues));
+			REQUIRE(small == std::vector<uint32_t>({ 0x100, 0x100, 0x200, 0x300 }) && smallValues == std::vector<uint32_t>({ 1, 3, 2, 0 }));
+			// Spans of different sizes sort the length of the shorter one
+			std::vector<uint32_t> longer = { 3, 1, 2, 0 }, fewer = { 0, 1, 2 };
+			RadixSort(std::span(longer), std::span(fewer));
+			REQUIRE(longer == std::vector<uint32_t>({ 1, 2, 3, 0 }) && fewer == std::vector<uint32_t>({ 1, 2, 0 }));
+			std::vector<uint32_t> skipping(200000), skippingValues(skipping.size());
+			for (uint32_t& key : skipping)
+				key = (random.NextUInt() & 0xFF) << 24 | 0x5A << 16 | (random.NextUInt() & 0xFF) << 8 | 0x42;
+			std::iota(skippingValues.begin(), skippingValues.end(), 0u);
+			std::vector<std::pair<uint32_t, uint32_t>> skippingExpected(skipping.size());
+			for (size_t i = 0; i < skipping.size(); i++)
+				skippingExpected[i] = { skipping[i], skippingValues[i] };
+			std::stable_sort(skippingExpected.begin(), skippingExpected.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+			SetWorkerCount(3);
+			RadixSort(std::span(skipping), std::span(skippingValues));
+			SetWorkerCount(0);
+			bool skippedSame = true;
+			for (size_t i = 0; i < skipping.size(); i++)
+				skippedSame &= skipping[i] == skippingExpected[i].first && skippingValues[i] == skippingExpected[i].second;
+			REQUIRE(skippedSame);
+
+			std::vector<Vec3f> points(5000);
+			random.InBox<Vec3f>(points, Vec3f(0.f), Vec3f(1.f));
+			std::vector<uint32_t> order;
+			SortAlongCurve(points, order, SpaceCurve::Hilbert);
+			std::vector<uint32_t> codes(points.size());
+			AABB bounds;
+			for (const Vec3f& point : points)
+				bounds.Grow(point);
+			HilbertEncode(points, bounds, std::span(codes));
+			bool sorted = true;
+			for (size_t i = 1; i < order.size(); i++)
+				sorted &= codes[order[i - 1]] <= codes[order[i]];
+			REQUIRE(sorted);
+			std::vector<uint32_t> fewerCodes(2);
+			HilbertEncode(points, bounds, std::span(fewerCodes));
+			REQUIRE(fewerCodes[0] == codes[0] && fewerCodes[1] == codes[1]);
+		}
+
+		TEST(Workers)
+		{
+			// Loops share the threads of the pool instead of starting their own, 20 loops of 3 workers would otherwise use 41 threads.
+			// A loop called from a task runs inline on the thread of that task
+			SetWorkerCount(3);
+			std::mutex mutex;
+			std::set<std::thread::id> threads;
+			std::atomic<size_t> moved = 0, sum = 0;
+			for (size_t repeat = 0; repeat < 20; repeat++)
+			{
+				ParallelFor(64, 1, [&](size_t, size_t)
+				{
+					const std::thread::id outer = std::this_thread::get_id();
+					{
+						std::lock_guard lock(mutex);
+						threads.insert(outer);
+					}
+					ParallelFor(100, 10, [&](size_t begin, size_t end)
+					{
+						moved += std::this_thread::get_id() != outer;
+						sum += end - begin;
+					});
+				});
+			}
+			SetWorkerCount(0);
+			REQUIRE(moved == 0 && sum == 20 * 64 * 100);
+			REQUIRE(threads.size() < 10);
+		}
+	}
+#pragma endregion
+
+#pragma region Collision Tests
+	NAMESPACE(Collision)
+	{
+		Random random(44);
+		const std::vector<Vec3f> corners = { Vec3f(-0.5f, -0.5f, -0.5f), Vec3f(0.5f, -0.5f, -0.5f), Vec3f(-0.5f, 0.5f, -0.5f), Vec3f(0.5f, 0.5f, -0.5f), Vec3f(-0.5f, -0.5f, 0.5f), Vec3f(0.5f, -0.5f, 0.5f), Vec3f(-0.5f, 0.5f, 0.5f), Vec3f(0.5f, 0.5f, 0.5f) };
+		const ConvexHull cube(corners);
+		const ConvexHull point(std::vector<Vec3f>{ Vec3f() });
+		auto close = [](float a, float b) { return std::abs(a - b) < 1e-4f; };
+
+		TEST(Convex Hull)
+		{
+			// Corners plus points inside and on the faces
+			std::vector<Vec3f> points = corners;
+			for (size_t i = 0; i < 200; i++)
+				points.push_back(random.InBox(Vec3f(-0.5f), Vec3f(0.5f)));
+			points.push_back(Vec3f(0.5f, 0.f, 0.f));
+			const ConvexHull box(points);
+			REQUIRE(box.GetVertices().size() == 8);
+			REQUIRE(box.GetTriangleCount() == 12);
+
+			// Every face faces outward, no point reaches further than the hull along its own direction,
+			// and every edge is shared by two faces. Face planes are not used for containment: rounding
+			// leaves thin slivers whose planes tilt far more than the hull surface moves
+			std::vector<Vec3f> sphere(2000);
+			random.OnSphere(sphere);
+			for (size_t i = 0; i < 1000; i++)
+				sphere.push_back(random.InSphere() * 0.9f);
+			const ConvexHull ball(sphere);
+			std::span<const Vec3f> vertices = ball.GetVertices();
+			std::span<const uint32_t> indices = ball.GetIndices();
+			bool outward = true, inside = true;
+			for (size_t t = 0; t < indices.size(); t += 3)
+				outward &= (vertices[indices[t + 1]] - vertices[indices[t]]).Cross(vertices[indices[t + 2]] - vertices[indices[t]]).Dot(vertices[indices[t]]) > 0.f;
+			for (const Vec3f& p : sphere)
+			{
+				if (p.LengthSquared() == 0.f)
+					continue;
+				const Vec3f direction = p.GetNormalize();
+				inside &= p.Dot(direction) <= vertices[ball.GetSupport(direction)].Dot(direction) + 1e-5f;
+			}
+			REQUIRE(outward);
+			REQUIRE(inside);
+			REQUIRE(vertices.size() - indices.size() / 2 + ball.GetTriangleCount() == 2);
+			REQUIRE(vertices.size() == 2000);
+
+			// Flat and collinear sets
+			std::vector<Vec3f> flat;
+			for (size_t i = 0; i < 100; i++)
+				flat.push_back(Vec3f(random.Range(-1.f, 1.f), 2.f, random.Range(-1.f, 1.f)));
+			flat.insert(flat.end(), { Vec3f(-1.f, 2.f, -1.f), Vec3f(1.f, 2.f, -1.f), Vec3f(-1.f, 2.f, 1.f), Vec3f(1.f, 2.f, 1.f) });
+			const ConvexHull square(flat);
+			REQUIRE(square.GetVertices().size() == 4 && square.GetTriangleCount() == 4);
+			const ConvexHull segment(std::vector<Vec3f>{ Vec3f(0.f), Vec3f(1.f), Vec3f(0.5f), Vec3f(2.f) });
+			REQUIRE(segment.GetVertices().size() == 2 && segment.GetTriangleCount() == 0);
+
+			// No points give an empty hull, which has no support and touches nothing
+			const ConvexHull empty{ std::span<const Vec3f>() };
+			REQUIRE(empty.IsEmpty() && empty.GetTriangleCount() == 0);
+			REQUIRE(empty.GetSupport(Vec3f(1.f, 0.f, 0.f)) == ConvexHull::None);
+			const ConvexShape nothing(empty, Vec3f(), Quat(), 1.f), solid(cube, Vec3f(), Quat());
+			ClosestPoints closest;
+			Contact contact;
+			REQUIRE(!ComputeDistance(nothing, solid, closest) && !ComputePenetration(solid, nothing, contact));
+			const std::vector<ConvexShape> shapes = { nothing, solid };
+			const std::vector<std::pair<uint32_t, uint32_t>> pairs = { { 0, 1 } };
+			std::vector<uint32_t> touching;
+			std::vector<Contact> contacts;
+			CollidePairs(shapes, pairs, touching, contacts);
+			REQUIRE(touching.empty() && contacts.empty());
+		}
+
+		TEST(Support)
+		{
+			std::vector<Vec3f> cloud(1003);
+			random.InSphere(cloud);
+			Vec3SoA<float> soa(cloud);
+			bool same = true;
+			for (size_t i = 0; i < 200; i++)
+			{
+				const Vec3f direction = random.OnSphere();
+				const auto best = std::max_element(cloud.begin(), cloud.end(), [&](const Vec3f& a, const Vec3f& b) { return a.Dot(direction) < b.Dot(direction); });
+				same &= FindSupport(soa.x, soa.y, soa.z, direction) == best - cloud.begin();
+			}
+			REQUIRE(same);
+
+			// Transformed by a rotation, and by a matrix with scale
+			const Quat rotation = Quat::AngleAxis(45.f, Vec3f(0.f, 0.f, 1.f));
+			const ConvexShape rotated(cube, Vec3f(1.f, 0.f, 0.f), rotation);
+			REQUIRE(close(rotated.GetSupport(Vec3f(1.f, 0.f, 0.f)).x, 1.f + std::sqrt(0.5f)));
+			const ConvexShape scaled(cube, Mat4::CreateTransformMatrix(Vec3f(0.f, 3.f, 0.f), Quat(), Vec3f(2.f, 4.f, 1.f)));
+			REQUIRE(close(scaled.GetSupport(Vec3f(0.f, 1.f, 0.f)).y, 5.f));
+			REQUIRE(close(scaled.GetBounds().max.x, 1.f));
+		}
+
+		TEST(Distance)
+		{
+			// Boxes apart along x, one turned about x so its closest face stays flat
+			const ConvexShape a(cube, Vec3f(), Quat());
+			const ConvexShape b(cube, Vec3f(1.75f, 0.2f, 0.f), Quat::AngleAxis(90.f, Vec3f(1.f, 0.f, 0.f)));
+			ClosestPoints result;
+			REQUIRE(ComputeDistance(a, b, result));
+			REQUIRE(close(result.distance, 0.75f));
+			REQUIRE(close(result.pointA.x, 0.5f));
+			REQUIRE(close(result.pointB.x, 1.25f));
+
+			// Spheres from a point and a radius, and a sphere against a box corner
+			const ConvexShape sphereA(point, Vec3f(0.f), Quat(), 1.f);
+			const ConvexShape sphereB(point, Vec3f(3.f, 4.f, 0.f), Quat(), 0.5f);
+			REQUIRE(ComputeDistance(sphereA, sphereB, result));
+			REQUIRE(close(result.distance, 3.5f));
+			REQUIRE((result.pointA - Vec3f(0.6f, 0.8f, 0.f)).Length() < 1e-4f);
+			const ConvexShape corner(point, Vec3f(1.5f), Quat(), 0.1f);
+			REQUIRE(ComputeDistance(a, corner, result));
+			REQUIRE(close(result.distance, std::sqrt(3.f) - 0.1f));
+
+			// Overlapping shapes have no distance
+			REQUIRE(!ComputeDistance(a, ConvexShape(cube, Vec3f(0.9f, 0.f, 0.f), Quat()), result));
+		}
+
+		TEST(Penetration)
+		{
+			const ConvexShape a(cube, Vec3f(), Quat());
+			Contact contact;
+			REQUIRE(ComputePenetration(a, ConvexShape(cube, Vec3f(0.75f, 0.1f, 0.f), Quat()), contact));
+			REQUIRE(close(contact.depth, 0.25f));
+			REQUIRE(close(contact.normal.x, 1.f));
+			REQUIRE(close(contact.pointA.x - contact.pointB.x, 0.25f));
+
+			REQUIRE(ComputePenetration(ConvexShape(point, Vec3f(), Quat(), 1.f), ConvexShape(point, Vec3f(0.f, 0.f, 1.5f), Quat(), 1.f), contact));
+			REQUIRE(close(contact.depth, 0.5f));
+			REQUIRE(close(contact.normal.z, 1.f));
+
+			// Deep overlap goes through EPA: a sphere swept box sunk into a box
+			REQUIRE(ComputePenetration(a, ConvexShape(cube, Vec3f(0.f, 0.6f, 0.f), Quat(), 0.1f), contact));
+			REQUIRE(close(contact.depth, 0.5f));
+			REQUIRE(close(contact.normal.y, 1.f));
+			REQUIRE(!ComputePenetration(a, ConvexShape(cube, Vec3f(0.f, 1.21f, 0.f), Quat(), 0.1f), contact));
+
+			// Separating along the normal by the depth leaves the shapes touching
+			bool separated = true;
+			for (size_t i = 0; i < 200; i++)
+			{
+				const ConvexShape b(cube, random.InBox(Vec3f(-1.f), Vec3f(1.f)), random.Rotation());
+				if (!ComputePenetration(a, b, contact))
+					continue;
+				ConvexShape moved = b;
+				moved.position += contact.normal * (contact.depth + 1e-3f);
+				ClosestPoints result;
+				separated &= ComputeDistance(a, moved, result) && result.distance < 2e-3f;
+			}
+			REQUIRE(separated);
+		}
+
+		TEST(Contracted Rounding)
+		{
+			// Many more random rotations: boxes meeting face to face give flat simplices and coplanar polytope faces,
+			// whose side tests are only rounding. The GalaxyMathContract target runs this with FMA contraction,
+			// under which EPA used to grow without end and GJK to find overlaps between separated boxes
+			const ConvexShape a(cube, Vec3f(), Quat());
+			size_t failures = 0, hits = 0;
+			for (size_t i = 0; i < 20000; i++)
+			{
+				const ConvexShape b(cube, random.InBox(Vec3f(-1.f), Vec3f(1.f)), random.Rotation());
+				Contact contact;
+				if (!ComputePenetration(a, b, contact))
+					continue;
+				hits++;
+				ConvexShape moved = b;
+				moved.position += contact.normal * (contact.depth + 1e-3f);
+				ClosestPoints result;
+				failures += !ComputeDistance(a, moved, result) || result.distance >= 2e-3f;
+			}
+			REQUIRE(hits > 10000);
+			REQUIRE(failures == 0);
+		}
+
+		TEST(Pairs)
+		{
+			std::vector<ConvexShape> shapes(500);
+			for (ConvexShape& shape : shapes)
+				shape = ConvexShape(cube, random.InBox(Vec3f(-4.f), Vec3f(4.f)), random.Rotation());
+			std::vector<std::pair<uint32_t, uint32_t>> pairs;
+			for (uint32_t i = 0; i < 2000; i++)
+				pairs.emplace_back(random.NextUInt() % 500, random.NextUInt() % 500);
+			std::vector<uint32_t> touching;
+			std::vector<Contact> contacts;
+			SetWorkerCount(3);
+			CollidePairs(shapes, pairs, touching, contacts);
+			SetWorkerCount(0);
+			bool same = touching.size() == contacts.size();
+			size_t next = 0;
+			for (size_t i = 0; i < pairs.size(); i++)
+			{
+				Contact contact;
+				if (!ComputePenetration(shapes[pairs[i].first], shapes[pairs[i].second], contact))
+					continue;
+				same &= next < touching.size() && touching[next] == i && contacts[next].depth == contact.depth;
+				next++;
+			}
+			REQUIRE(same && next == touching.size());
+			REQUIRE(!touching.empty());
+		}
+	}
+#pragma endregion
+
+#pragma region Geometry Query Tests
+	NAMESPACE(Geometry_Queries)
+	{
+		Random random(46);
+		auto close = [](const Vec3f& a, const Vec3f& b, float epsilon) { return (a - b).LengthSquared() <= epsilon * epsilon; };
+
+		TEST(Plane)
+		{
+			const Plane plane(Vec3f(0.f, 1.f, 0.f), Vec3f(0.f, 1.f, 1.f), Vec3f(1.f, 1.f, 0.f));
+			REQUIRE(close(plane.normal, Vec3f(0.f, 1.f, 0.f), 1e-6f));
+			REQUIRE(std::abs(plane.distance - 1.f) < 1e-6f);
+			REQUIRE(std::abs(plane.GetSignedDistance(Vec3f(3.f, 4.f, 5.f)) - 3.f) < 1e-6f);
+			REQUIRE(close(ClosestPoint(Vec3f(3.f, -4.f, 5.f), plane), Vec3f(3.f, 1.f, 5.f), 1e-6f));
+			REQUIRE(close(ClosestPoint(Vec3f(3.f, -4.f, 5.f), Plane(Vec3f(0.f, 3.f, 0.f), 3.f)), Vec3f(3.f, 1.f, 5.f), 1e-6f));
+
+			float t = 0.f;
+			REQUIRE(IntersectRay(Ray{ Vec3f(0.f, 5.f, 0.f), Vec3f(0.f, -1.f, 0.f) }, plane, t));
+			REQUIRE(std::abs(t - 4.f) < 1e-6f);
+			REQUIRE(!IntersectRay(Ray{ Vec3f(0.f, 5.f, 0.f), Vec3f(0.f, 1.f, 0.f) }, plane, t));
+			REQUIRE(!IntersectRay(Ray{ Vec3f(0.f, 5.f, 0.f), Vec3f(1.f, 0.f, 0.f) }, plane, t));
+		}
+
+		TEST(Triangle)
+		{
+			// Against the nearest of a dense set of barycentric samples
+			bool nearest = true, weights = true;
+			for (size_t i = 0; i < 200; i++)
+			{
+				const Triangle triangle = { random.InBox(Vec3f(-1.f), Vec3f(1.f)), random.InBox(Vec3f(-1.f), Vec3f(1.f)), random.InBox(Vec3f(-1.f), Vec3f(1.f)) };
+				const Vec3f point = random.InBox(Vec3f(-2.f), Vec3f(2.f));
+				float u, v;
+				const Vec3f closest = ClosestPoint(point, triangle, u, v);
+				weights &= u >= 0.f && v >= 0.f && u + v <= 1.f + 1e-5f;
+				weights &= close(triangle.a + (triangle.b - triangle.a) * u + (triangle.c - triangle.a) * v, closest, 1e-4f);
+
+				float best = FLT_MAX;
+				for (int su = 0; su <= 100; su++)
+				{
+					for (int sv = 0; su + sv <= 100; sv++)
+					{
+						const Vec3f sample = triangle.a + (triangle.b - triangle.a) * (su * 0.01f) + (triangle.c - triangle.a) * (sv * 0.01f);
+						best = std::min(best, (sample - point).LengthSquared());
+					}
+				}
+				nearest &= (closest - point).LengthSquared() <= best + 1e-5f;
+			}
+			REQUIRE(nearest);
+			REQUIRE(weights);
+
+			const Triangle flat = { Vec3f(0.f), Vec3f(1.f, 0.f, 0.f), Vec3f(0.f, 0.f, 1.f) };
+			REQUIRE(close(ClosestPoint(Vec3f(0.25f, 3.f, 0.25f), flat), Vec3f(0.25f, 0.f, 0.25f), 1e-6f));
+			REQUIRE(close(ClosestPoint(Vec3f(2.f, 1.f, 2.f), flat), Vec3f(0.5f, 0.f, 0.5f), 1e-6f));
+			REQUIRE(close(ClosestPoint(Vec3f(-1.f, 1.f, -1.f), flat), Vec3f(0.f), 1e-6f));
+			REQUIRE(std::abs(DistanceSquared(Vec3f(0.25f, -2.f, 0.25f), flat) - 4.f) < 1e-5f);
+		}
+
+		TEST(Segment And Box)
+		{
+			Vec3f onFirst, onSecond;
+			REQUIRE(std::abs(DistanceSquared({ Vec3f(-1.f, 0.f, 0.f), Vec3f(1.f, 0.f, 0.f) }, { Vec3f(0.f, 1.f, -1.f), Vec3f(0.f, 1.f, 1.f) }, onFirst, onSecond) - 1.f) < 1e-6f);
+			REQUIRE(close(onFirst, Vec3f(0.f), 1e-6f) && close(onSecond, Vec3f(0.f, 1.f, 0.f), 1e-6f));
+			// Parallel, the closest points lie where they overlap
+			REQUIRE(std::abs(DistanceSquared({ Vec3f(0.f), Vec3f(2.f, 0.f, 0.f) }, { Vec3f(1.f, 2.f, 0.f), Vec3f(3.f, 2.f, 0.f) }, onFirst, onSecond) - 4.f) < 1e-6f);
+			REQUIRE(onFirst.x >= 1.f - 1e-6f && std::abs(onFirst.x - onSecond.x) < 1e-6f);
+			// Degenerate
+			REQUIRE(std::abs(DistanceSquared({ Vec3f(0.f), Vec3f(0.f) }, { Vec3f(2.f, 1.f, 0.f), Vec3f(2.f, -1.f, 0.f) }, onFirst, onSecond) - 4.f) < 1e-6f);
+
+			const Segment segment = { Vec3f(0.f), Vec3f(0.f, 0.f, 2.f) };
+			REQUIRE(close(ClosestPoint(Vec3f(1.f, 0.f, 1.f), segment), Vec3f(0.f, 0.f, 1.f), 1e-6f));
+			REQUIRE(std::abs(DistanceSquared(Vec3f(0.f, 0.f, 5.f), segment) - 9.f) < 1e-6f);
+
+			const AABB box(Vec3f(-1.f), Vec3f(1.f));
+			REQUIRE(DistanceSquared(Vec3f(0.5f, -0.5f, 0.f), box) == 0.f);
+			REQUIRE(close(ClosestPoint(Vec3f(0.5f, -0.5f, 0.f), box), Vec3f(0.5f, -0.5f, 0.f), 0.f));
+			REQUIRE(std::abs(DistanceSquared(Vec3f(3.f, 0.f, -3.f), box) - 8.f) < 1e-6f);
+		}
+
+		TEST(Batches)
+		{
+			// 1003 triangles so the last pack is partial
+			std::vector<Triangle> triangles(1003);
+			for (Triangle& triangle : triangles)
+			{
+				const Vec3f center = random.InBox(Vec3f(-10.f), Vec3f(10.f));
+				triangle = { center + random.InSphere(), center + random.InSphere(), center + random.InSphere() };
+			}
+			const TriangleSoA soa(triangles);
+			REQUIRE(soa.GetSize() == triangles.size());
+			std::vector<float> distances(triangles.size());
+			bool same = true, found = true;
+			for (size_t i = 0; i < 20; i++)
+			{
+				const Vec3f point = random.InBox(Vec3f(-12.f), Vec3f(12.f));
+				DistanceSquared(point, soa, distances);
+				float best = FLT_MAX;
+				uint32_t bestIndex = 0;
+				for (uint32_t t = 0; t < triangles.size(); t++)
+				{
+					const float expected = DistanceSquared(point, triangles[t]);
+					same &= std::abs(distances[t] - expected) <= 1e-5f * std::max(1.f, expected);
+					if (expected < best)
+					{
+						best = expected;
+						bestIndex = t;
+					}
+				}
+				Vec3f closest;
+				const uint32_t index = FindClosest(point, soa, closest);
+				found &= index == bestIndex || std::abs(DistanceSquared(point, triangles[index]) - best) <= 1e-5f * std::max(1.f, best);
+				found &= close(closest, ClosestPoint(point, triangles[index]), 1e-5f);
+			}
+			REQUIRE(same);
+			REQUIRE(found);
+			Vec3f unused;
+			REQUIRE(FindClosest(Vec3f(), TriangleSoA(), unused) == 0xFFFFFFFF);
+
+			// An output shorter than the triangles is only written up to its size
+			std::vector<float> partial(12, -1.f);
+			DistanceSquared(Vec3f(), soa, std::span<float>(partial).first(5));
+			DistanceSquared(Vec3f(), soa, distances);
+			REQUIRE(partial[4] == distances[4] && partial[5] == -1.f);
+
+			std::vector<Vec3f> points(1001);
+			random.InBox(std::span<Vec3f>(points), Vec3f(-3.f), Vec3f(3.f));
+			const Vec3SoA<float> input(points);
+			Vec3SoA<float> output;
+			ClosestPoint(input, triangles[0], output);
+			bool projected = output.GetSize() == points.size();
+			for (size_t i = 0; i < points.size(); i++)
+				projected &= close(output.Get(i), ClosestPoint(points[i], triangles[0]), 1e-4f);
+			REQUIRE(projected);
+		}
+	}
+#pragma endregion
+
+#pragma region Solver Tests
+	NAMESPACE(Solvers)
+	{
+		Random random(48);
+		auto randomMatrix = [&]<size_t N>(std::integral_constant<size_t, N>)
+		{
+			Mat<double, N, N> m;
+			for (size_t c = 0; c < N; c++)
+				for (size_t r = 0; r < N; r++)
+					m[c][r] = random.Range(-1.f, 1.f);
+			return m;
+		};
+		auto residual = [](const auto& a, const auto& x, const auto& b) { return (a * x - b).Length(); };
+
+		TEST(LU)
+		{
+			bool solved = true;
+			for (size_t i = 0; i < 100; i++)
+			{
+				const Mat<double, 6, 6> a = randomMatrix(std::integral_constant<size_t, 6>());
+				const VecN<double, 6> b(1.0, -2.0, 3.0, 0.5, 0.0, 4.0);
+				VecN<double, 6> x;
+				solved &= Solve(a, b, x) && residual(a, x, b) < 1e-9;
+			}
+			REQUIRE(solved);
+
+			// Determinant against Mat4 and the inverse against the identity
+			const Mat4 transform = Mat4::CreateTransformMatrix(Vec3f(1, 2, 3), Vec3f(30, 45, 60), Vec3f(1, 2, 1));
+			LUDecomposition<float, 4> lu;
+			REQUIRE(DecomposeLU(Mat<float, 4, 4>(transform), lu));
+			REQUIRE(std::abs(GetDeterminant(lu) - transform.GetDeterminant(4)) < 1e-4f);
+			Mat<float, 4, 4> inverse;
+			REQUIRE(GetInverse(Mat<float, 4, 4>(transform), inverse));
+			const Mat<float, 4, 4> identity = inverse * Mat<float, 4, 4>(transform);
+			bool isIdentity = true;
+			for (size_t c = 0; c < 4; c++)
+				isIdentity &= (identity[c] - VecN<float, 4>::Axis(c)).Length() < 1e-5f;
+			REQUIRE(isIdentity);
+
+			// A zero pivot needs a row swap, a repeated row makes it singular
+			Mat3f swap;
+			swap[0] = VecN<float, 3>(0.f, 1.f, 0.f);
+			swap[1] = VecN<float, 3>(1.f, 0.f, 0.f);
+			swap[2] = VecN<float, 3>(0.f, 0.f, 2.f);
+			VecN<float, 3> x;
+			REQUIRE(Solve(swap, VecN<float, 3>(1.f, 2.f, 4.f), x));
+			REQUIRE((x == VecN<float, 3>(2.f, 1.f, 2.f)));
+			swap[2] = VecN<float, 3>(0.f, 1.f, 0.f);
+			REQUIRE(!Solve(swap, VecN<float, 3>(1.f, 2.f, 4.f), x));
+		}
+
+		TEST(Cholesky And QR)
+		{
+			bool solved = true, orthonormal = true;
+			for (size_t i = 0; i < 100; i++)
+			{
+				// M^T * M + I is symmetric positive definite
+				const Mat<double, 6, 6> m = randomMatrix(std::integral_constant<size_t, 6>());
+				const Mat<double, 6, 6> a = m.GetTranspose() * m + Mat<double, 6, 6>::Identity();
+				const VecN<double, 6> b(1.0, -2.0, 3.0, 0.5, 0.0, 4.0);
+				Mat<double, 6, 6> lower;
+				solved &= DecomposeCholesky(a, lower) && residual(a, SolveCholesky(lower, b), b) < 1e-9;
+				solved &= residual(lower * lower.GetTranspose(), VecN<double, 6>(1.0), a * VecN<double, 6>(1.0)) < 1e-9;
+
+				Mat<double, 6, 6> q, r;
+				DecomposeQR(m, q, r);
+				const Mat<double, 6, 6> product = q.GetTranspose() * q;
+				for (size_t c = 0; c < 6; c++)
+				{
+					orthonormal &= (product[c] - VecN<double, 6>::Axis(c)).Length() < 1e-9;
+					orthonormal &= (q * r[c] - m[c]).Length() < 1e-9;
+					for (size_t row = c + 1; row < 6; row++)
+						orthonormal &= r[c][row] == 0.0;
+				}
+			}
+			REQUIRE(solved);
+			REQUIRE(orthonormal);
+			Mat3f negative(-1.f);
+			Mat3f lower;
+			REQUIRE(!DecomposeCholesky(negative, lower));
+
+			// Line through points that lie on y = 2x + 1, and the normal equations for noisy ones
+			Mat<double, 5, 2> design;
+			VecN<double, 5> y, noisy;
+			for (size_t i = 0; i < 5; i++)
+			{
+				design[0][i] = static_cast<double>(i);
+				design[1][i] = 1.0;
+				y[i] = 2.0 * i + 1.0;
+				noisy[i] = y[i] + (i % 2 ? 0.1 : -0.1);
+			}
+			VecN<double, 2> line;
+			REQUIRE(SolveLeastSquares(design, y, line));
+			REQUIRE((line - VecN<double, 2>(2.0, 1.0)).Length() < 1e-12);
+			REQUIRE(SolveLeastSquares(design, noisy, line));
+			VecN<double, 2> normal;
+			REQUIRE(Solve(design.GetTranspose() * design, design.GetTranspose() * noisy, normal));
+			REQUIRE((line - normal).Length() < 1e-12);
+			design[1] = design[0] * 2.0;
+			REQUIRE(!SolveLeastSquares(design, y, line));
+		}
+
+		TEST(Symmetric Eigen Decomposition)
+		{
+			bool decomposed = true;
+			for (size_t i = 0; i < 100; i++)
+			{
+				const Mat<double, 3, 3> m = randomMatrix(std::integral_constant<size_t, 3>());
+				const Mat<double, 3, 3> a = m + m.GetTranspose();
+				VecN<double, 3> values;
+				Mat<double, 3, 3> vectors;
+				DecomposeSymmetric(a, values, vectors);
+				decomposed &= values[0] >= values[1] && values[1] >= values[2];
+				for (size_t c = 0; c < 3; c++)
+				{
+					decomposed &= std::abs(vectors[c].Length() - 1.0) < 1e-12;
+					decomposed &= (a * vectors[c] - vectors[c] * values[c]).Length() < 1e-9;
+				}
+			}
+			REQUIRE(decomposed);
+
+			// Inertia of a box is diagonal in its own axes
+			Mat3f inertia(0.f);
+			inertia[0][0] = 2.f;
+			inertia[1][1] = 5.f;
+			inertia[2][2] = 3.f;
+			VecN<float, 3> values;
+			Mat3f vectors;
+			DecomposeSymmetric(inertia, values, vectors);
+			REQUIRE((values == VecN<float, 3>(5.f, 3.f, 2.f)));
+			REQUIRE((vectors[0] == VecN<float, 3>(0.f, 1.f, 0.f)));
+		}
+
+		TEST(Polar Decomposition)
+		{
+			// Linear part rotation * stretch with a symmetric positive definite stretch: a shear Gram-Schmidt cannot see
+			auto compose = [](const Quat& rotation, const Mat3f& stretch, const Vec3f& position)
+			{
+				const Mat4 matrix = rotation.ToRotationMatrix();
+				Mat4 transform = Mat4::Identity();
+				for (size_t c = 0; c < 3; c++)
+					transform[c] = matrix * Vec4f(stretch[c][0], stretch[c][1], stretch[c][2], 0.f);
+				transform[3] = Vec4f(position, 1.f);
+				return transform;
+			};
+			auto rotationError = [](const Quat& a, const Quat& b) { return 1.f - std::abs(a.Dot(b)); };
+			float polarError = 0.f, gramSchmidtError = 0.f;
+			bool decomposed = true, stretched = true;
+			for (size_t i = 0; i < 200; i++)
+			{
+				const Quat expected = random.Rotation();
+				Mat3f m;
+				for (size_t c = 0; c < 3; c++)
+					for (size_t r = 0; r < 3; r++)
+						m[c][r] = random.Range(-0.5f, 0.5f);
+				const Mat3f stretch = m.GetTranspose() * m + Mat3f(1.f);
+				const Mat4 transform = compose(expected, stretch, random.InBox(Vec3f(-5.f), Vec3f(5.f)));
+
+				Quat rotation;
+				Mat3f polarStretch;
+				decomposed &= DecomposePolar(transform, rotation, polarStretch);
+				polarError = std::max(polarError, rotationError(rotation, expected));
+				for (size_t c = 0; c < 3; c++)
+					stretched &= (polarStretch[c] - stretch[c]).Length() < 1e-4f;
+
+				Vec3f translation, scale;
+				Quat gramSchmidt;
+				transform.DecomposeTransformMatrix(translation, gramSchmidt, scale);
+				gramSchmidtError = std::max(gramSchmidtError, rotationError(gramSchmidt, expected));
+			}
+			REQUIRE(decomposed);
+			REQUIRE(polarError < 1e-6f);
+			REQUIRE(stretched);
+			REQUIRE(gramSchmidtError > 1e-3f);
+
+			// Plain scale, noise and a mirror
+			const Quat rotation = Quat::AngleAxis(40.f, Vec3f(1.f, 2.f, 3.f).GetNormalize());
+			Quat result;
+			Mat3f stretch;
+			Mat3f scale(0.f);
+			scale[0][0] = 2.f;
+			scale[1][1] = 0.5f;
+			scale[2][2] = 3.f;
+			REQUIRE(DecomposePolar(compose(rotation, scale, Vec3f()), result, stretch));
+			REQUIRE(rotationError(result, rotation) < 1e-6f);
+			REQUIRE(std::abs(stretch[0][0] - 2.f) < 1e-5f && std::abs(stretch[1][0]) < 1e-5f);
+
+			Mat4 noisy = compose(rotation, Mat3f(1.f), Vec3f());
+			for (size_t c = 0; c < 3; c++)
+				noisy[c] = noisy[c] + Vec4f(random.InBox(Vec3f(-1e-3f), Vec3f(1e-3f)), 0.f);
+			REQUIRE(DecomposePolar(noisy, result, stretch));
+			REQUIRE(rotationError(result, rotation) < 1e-5f);
+
+			scale[0][0] = -2.f;
+			const Mat4 mirrored = compose(rotation, scale, Vec3f());
+			REQUIRE(DecomposePolar(mirrored, result, stretch));
+			REQUIRE(compose(result, stretch, Vec3f()) == mirrored);
+			REQUIRE(stretch[0].Dot(stretch[1].Cross(stretch[2])) < 0.f);
+
+			scale[0][0] = 0.f;
+			REQUIRE(!DecomposePolar(compose(rotation, scale, Vec3f()), result, stretch));
+			REQUIRE(result == Quat());
+
+			// Batch against the scalar one, with mirrored and singular transforms among them.
+			// Past two chunks of 1 << 12 transforms so three workers split them, the last pack is partial
+			std::vector<Mat4f> palette(2 * (1 << 12) + 3);
+			for (Mat4f& transform : palette)
+				transform = Mat4::CreateTransformMatrix(random.InBox(Vec3f(-5.f), Vec3f(5.f)), random.Rotation(), random.InBox(Vec3f(0.2f), Vec3f(3.f)));
+			palette[10] = mirrored;
+			palette[11] = compose(rotation, scale, Vec3f());
+			std::vector<Quat> rotations(palette.size());
+			std::vector<Mat3f> stretches(palette.size());
+			SetWorkerCount(3);
+			DecomposePolar(palette, rotations, stretches);
+			SetWorkerCount(0);
+			bool same = true;
+			for (size_t i = 0; i < palette.size(); i++)
+			{
+				DecomposePolar(palette[i], result, stretch);
+				same &= rotationError(rotations[i], result) < 1e-6f;
+				for (size_t c = 0; c < 3; c++)
+					same &= (stretches[i][c] - stretch[c]).Length() < 1e-4f;
+			}
+			REQUIRE(same);
+
+			// Spans of different sizes decompose the length of the shortest one
+			std::vector<Quat> fewer(4, Quat(0, 0, 0, 0));
+			DecomposePolar(palette, fewer, stretches);
+			REQUIRE(fewer[3] == rotations[3] && fewer[2] == rotations[2]);
+		}
+
+		TEST(Batches)
+		{
+			// Past two chunks of 1 << 14 systems so three workers split them, the last pack is partial
+			constexpr size_t count = 2 * (1 << 14) + 3;
+			std::vector<Mat<float, 4, 4>> matrices(count), symmetric(count);
+			std::vector<VecN<float, 4>> b(count), x(count), expected(count);
+			for (size_t i = 0; i < matrices.size(); i++)
+			{
+				for (size_t c = 0; c < 4; c++)
+				{
+					for (size_t r = 0; r < 4; r++)
+						matrices[i][c][r] = random.Range(-1.f, 1.f);
+					b[i][c] = random.Range(-1.f, 1.f);
+				}
+				symmetric[i] = matrices[i].GetTranspose() * matrices[i] + Mat<float, 4, 4>(1.f);
+			}
+			SetWorkerCount(3);
+			SolveBatch<float, 4>(matrices, b, x);
+			SetWorkerCount(0);
+			bool same = true;
+			for (size_t i = 0; i < matrices.size(); i++)
+			{
+				Solve(matrices[i], b[i], expected[i]);
+				same &= (x[i] - expected[i]).Length() <= 1e-3f * std::max(1.f, expected[i].Length());
+			}
+			REQUIRE(same);
+
+			SolveCholeskyBatch<float, 4>(symmetric, b, x);
+			for (size_t i = 0; i < matrices.size(); i++)
+			{
+				Mat<float, 4, 4> lower;
+				DecomposeCholesky(symmetric[i], lower);
+				same &= (x[i] - SolveCholesky(lower, b[i])).Length() < 1e-5f;
+			}
+			REQUIRE(same);
+
+			// Spans of different sizes solve the length of the shortest one
+			std::vector<VecN<float, 4>> fewer(5, VecN<float, 4>(7.f));
+			SolveBatch<float, 4>(matrices, std::span(b).first(3), fewer);
+			REQUIRE((fewer[2] - expected[2]).Length() <= 1e-3f * std::max(1.f, expected[2].Length()));
+			REQUIRE((fewer[3] == VecN<float, 4>(7.f) && fewer[4] == VecN<float, 4>(7.f)));
+		}
+	}
+#pragma endregion
+
+#pragma region Camera Tests
+	NAMESPACE(Camera)
+	{
+		Random random(49);
+		auto isIdentity = [](const Mat4& m)
+		{
+			for (size_t c = 0; c < 4; c++)
+				for (size_t r = 0; r < 4; r++)
+					if (std::abs(m.content[c][r] - (c == r ? 1.f : 0.f)) > 1e-4f)
+						return false;
+			return true;
+		};
+		// The reference view goes through a general inverse, its rounding grows with the translation
+		auto isClose = [](const Mat4& a, const Mat4& b)
+		{
+			for (size_t c = 0; c < 4; c++)
+				for (size_t r = 0; r < 4; r++)
+					if (std::abs(a.content[c][r] - b.content[c][r]) > 1e-5f * (1.f + std::abs(b.content[c][r])))
+						return false;
+			return true;
+		};
+
+		TEST(Matrices)
+		{
+			const Vec3f position(3.f, -2.f, 7.f);
+			const Quat rotation = Quat::AngleAxis(35.f, Vec3f(1.f, 2.f, 3.f).GetNormalize());
+			const Camera camera(position, rotation, 70.f, 16.f / 9.f, 0.1f, 100.f);
+			REQUIRE(camera.GetViewMatrix() == Mat4::CreateViewMatrix(position, rotation));
+			REQUIRE(camera.GetProjectionMatrix() == Mat4::CreateProjectionMatrix(70.f, 16.f / 9.f, 0.1f, 100.f));
+			REQUIRE(camera.GetViewProjectionMatrix() == Mat4::CreateProjectionMatrix(70.f, 16.f / 9.f, 0.1f, 100.f) * Mat4::CreateViewMatrix(position, rotation));
+			REQUIRE(isIdentity(camera.GetInverseViewMatrix() * camera.GetViewMatrix()));
+			REQUIRE(isIdentity(camera.GetInverseProjectionMatrix() * camera.GetProjectionMatrix()));
+			REQUIRE(isIdentity(camera.GetInverseViewProjectionMatrix() * camera.GetViewProjectionMatrix()));
+		}
+
+		TEST(Change Detection)
+		{
+			Camera camera;
+			const uint32_t version = camera.GetVersion();
+			camera.SetPosition(Vec3f());
+			camera.SetRotation(Quat());
+			camera.SetFov(60.f);
+			camera.SetClipPlanes(0.1f, 1000.f);
+			REQUIRE(camera.GetVersion() == version);
+
+			// Every change is seen by the next read, whichever matrices were read before it
+			bool same = true;
+			Vec3f position;
+			Quat rotation;
+			float fov = 60.f, aspect = 1.f;
+			for (size_t i = 0; i < 200; i++)
+			{
+				switch (random.NextUInt() % 4)
+				{
+				case 0: position = random.InBox(Vec3f(-10.f), Vec3f(10.f)); camera.SetPosition(position); break;
+				case 1: rotation = random.Rotation(); camera.SetRotation(rotation); break;
+				case 2: fov = random.Range(30.f, 100.f); camera.SetFov(fov); break;
+				default: aspect = random.Range(0.5f, 2.f); camera.SetAspect(aspect); break;
+				}
+				if (i % 3 == 0)
+					continue;
+				const Mat4 viewProjection = Mat4::CreateProjectionMatrix(fov, aspect, 0.1f, 1000.f) * Mat4::CreateViewMatrix(position, rotation);
+				same &= isClose(camera.GetViewProjectionMatrix(), viewProjection);
+				same &= isClose(camera.GetViewMatrix(), Mat4::CreateViewMatrix(position, rotation));
+			}
+			REQUIRE(same);
+			REQUIRE(camera.GetVersion() > version);
+
+			// Updated once, the camera is read from several threads at once
+			camera.SetPosition(Vec3f(1.f, 2.f, 3.f));
+			camera.Update();
+			const Mat4f expected = Mat4::CreateProjectionMatrix(fov, aspect, 0.1f, 1000.f) * Mat4::CreateViewMatrix(Vec3f(1.f, 2.f, 3.f), rotation);
+			bool readers[4] = {};
+			std::vector<std::thread> threads;
+			for (bool& reader : readers)
+				threads.emplace_back([&] { reader = isClose(camera.GetViewProjectionMatrix(), expected) && camera.GetFrustum().planes[0].normal.LengthSquared() > 0.f; });
+			for (std::thread& thread : threads)
+				thread.join();
+			REQUIRE(readers[0] && readers[1] && readers[2] && readers[3]);
+		}
+
+		TEST(Frustum)
+		{
+			// Looking down +z from the origin
+			Camera camera(Vec3f(), Quat(), 90.f, 1.f, 1.f, 100.f);
+			const Frustum& frustum = camera.GetFrustum();
+			REQUIRE(frustum.Contains(Vec3f(0.f, 0.f, 10.f)));
+			REQUIRE(frustum.Contains(Vec3f(9.f, -9.f, 10.f)));
+			REQUIRE(!frustum.Contains(Vec3f(11.f, 0.f, 10.f)));
+			REQUIRE(!frustum.Contains(Vec3f(0.f, 0.f, -10.f)));
+			REQUIRE(!frustum.Contains(Vec3f(0.f, 0.f, 0.5f)));
+			REQUIRE(!frustum.Contains(Vec3f(0.f, 0.f, 101.f)));
+			REQUIRE(std::abs(frustum.planes[Frustum::Near].GetSignedDistance(Vec3f(0.f, 0.f, 3.f)) - 2.f) < 1e-4f);
+			REQUIRE(frustum.Intersects(AABB(Vec3f(10.5f, -1.f, 9.f), Vec3f(12.f, 1.f, 11.f))));
+			REQUIRE(!frustum.Intersects(AABB(Vec3f(12.f, -1.f, 9.f), Vec3f(13.f, 1.f, 11.f))));
+			REQUIRE(!frustum.Intersects(AABB(Vec3f(-1.f, -1.f, -5.f), Vec3f(1.f, 1.f, -2.f))));
+
+			// Turned around, the frustum follows
+			camera.SetRotation(Quat::AngleAxis(180.f, Vec3f::Up()));
+			REQUIRE(!camera.GetFrustum().Contains(Vec3f(0.f, 0.f, 10.f)));
+			REQUIRE(camera.GetFrustum().Contains(Vec3f(0.f, 0.f, -10.f)));
+		}
+
+		TEST(Projections)
+		{
+			const DepthRange ranges[] = { DepthRange::NegativeOneToOne, DepthRange::ZeroToOne, DepthRange::ReverseZ };
+			const float nearDepth[] = { -1.f, 0.f, 1.f };
+			const float farDepth[] = { 1.f, 1.f, 0.f };
+			auto depthOf = [](const Mat4& projection, float distance)
+			{
+				const Vec4f clip = projection * Vec4f(0.f, 0.f, -distance, 1.f);
+				return clip.z / clip.w;
+			};
+			REQUIRE(Projection::CreatePerspective(70.f, 1.5f, 0.1f, 100.f).matrix == Mat4::CreateProjectionMatrix(70.f, 1.5f, 0.1f, 100.f));
+			REQUIRE(Projection::CreateOrthographic(-4.f, 6.f, -2.f, 3.f, 0.5f, 50.f).matrix == Mat4::CreateOrthographicMatrix(-4.f, 6.f, -2.f, 3.f, 0.5f, 50.f));
+			for (size_t i = 0; i < 3; i++)
+			{
+				const Projection perspective = Projection::CreatePerspective(70.f, 1.5f, 0.1f, 100.f, ranges[i]);
+				REQUIRE(isIdentity(perspective.inverse * perspective.matrix));
+				REQUIRE(std::abs(depthOf(perspective.matrix, 0.1f) - nearDepth[i]) < 1e-5f);
+				REQUIRE(std::abs(depthOf(perspective.matrix, 100.f) - farDepth[i]) < 1e-5f);
+
+				// The far plane goes to the end of the range, the depth gets there without passing it
+				const Projection infinite = Projection::CreatePerspective(70.f, 1.5f, 0.1f, INFINITY, ranges[i]);
+				REQUIRE(isIdentity(infinite.inverse * infinite.matrix));
+				REQUIRE(std::abs(depthOf(infinite.matrix, 0.1f) - nearDepth[i]) < 1e-5f);
+				REQUIRE(std::abs(depthOf(infinite.matrix, 1e7f) - farDepth[i]) < 1e-5f);
+				const float distant = depthOf(infinite.matrix, 1000.f);
+				REQUIRE((std::min(nearDepth[i], farDepth[i]) < distant && distant < std::max(nearDepth[i], farDepth[i])));
+
+				const Projection orthographic = Projection::CreateOrthographic(-4.f, 6.f, -2.f, 3.f, 0.5f, 50.f, ranges[i]);
+				REQUIRE(isIdentity(orthographic.inverse * orthographic.matrix));
+				REQUIRE(std::abs(depthOf(orthographic.matrix, 0.5f) - nearDepth[i]) < 1e-5f);
+				REQUIRE(std::abs(depthOf(orthographic.matrix, 50.f) - farDepth[i]) < 1e-5f);
+			}
+
+			// A reverse Z camera with no far plane still culls behind, beside and before the near plane
+			const Camera camera(Vec3f(), Quat(), 90.f, 1.f, 1.f, INFINITY, DepthRange::ReverseZ);
+			const Frustum& frustum = camera.GetFrustum();
+			REQUIRE(frustum.Contains(Vec3f(0.f, 0.f, 1e6f)));
+			REQUIRE(!frustum.Contains(Vec3f(0.f, 0.f, 0.5f)));
+			REQUIRE(!frustum.Contains(Vec3f(11.f, 0.f, 10.f)));
+			REQUIRE(!frustum.Contains(Vec3f(0.f, 0.f, -10.f)));
+			REQUIRE(isIdentity(camera.GetInverseViewProjectionMatrix() * camera.GetViewProjectionMatrix()));
+		}
+
+		TEST(Unproject)
+		{
+			const Camera camera(Vec3f(1.f, 2.f, -3.f), Quat::AngleAxis(25.f, Vec3f(0.f, 1.f, 0.2f).GetNormalize()), 60.f, 4.f / 3.f, 0.1f, 100.f, DepthRange::ZeroToOne);
+			const Mat4& viewProjection = camera.GetViewProjectionMatrix();
+			const Mat4& inverse = camera.GetInverseViewProjectionMatrix();
+
+			// World points through the projection and back, 1001 so the last pack is partial
+			std::vector<Vec3f> world(1001), ndc(world.size()), points(world.size());
+			for (size_t i = 0; i < world.size(); i++)
+			{
+				world[i] = Unproject(inverse, random.InBox(Vec3f(-1.f, -1.f, 0.f), Vec3f(1.f, 1.f, 1.f)));
+				const Vec4f clip = viewProjection * Vec4f(world[i], 1.f);
+				ndc[i] = Vec3f(clip) / clip.w;
+			}
+			Unproject(inverse, ndc, points);
+			bool same = true;
+			for (size_t i = 0; i < world.size(); i++)
+				same &= (points[i] - world[i]).Length() <= 1e-3f * std::max(1.f, world[i].Length());
+			REQUIRE(same);
+
+			// Pixel centers of an odd sized depth buffer against the scalar unproject
+			constexpr size_t width = 37, height = 23;
+			std::vector<float> depth(width * height);
+			for (float& value : depth)
+				value = random.NextFloat();
+			std::vector<Vec3f> reconstructed(depth.size());
+			UnprojectDepth(inverse, width, height, depth, reconstructed);
+			for (size_t y = 0; y < height; y++)
+			{
+				for (size_t x = 0; x < width; x++)
+				{
+					const Vec3f pixel((x + 0.5f) / width * 2.f - 1.f, 1.f - (y + 0.5f) / height * 2.f, depth[y * width + x]);
+					const Vec3f expected = Unproject(inverse, pixel);
+					same &= (reconstructed[y * width + x] - expected).Length() <= 1e-4f * std::max(1.f, expected.Length());
+				}
+			}
+			REQUIRE(same);
+
+			// Short spans stop the batches, a depth buffer short of a row leaves that row out
+			std::vector<Vec3f> fewer(3, Vec3f(7.f)), rows(depth.size(), Vec3f(7.f));
+			Unproject(inverse, ndc, std::span(fewer).first(2));
+			REQUIRE(fewer[1] == points[1] && fewer[2] == Vec3f(7.f));
+			UnprojectDepth(inverse, width, height, std::span(depth).first(depth.size() - 1), rows);
+			REQUIRE(rows[width * (height - 1) - 1] == reconstructed[width * (height - 1) - 1] && rows[width * (height - 1)] == Vec3f(7.f));
+		}
+
+		// Reference for the batch: the scalar transform, divide and tests
+		auto projectPoint = [](const Mat4& viewProjection, const Viewport& viewport, const Vec3f& point, uint8_t& flags)
+		{
+			const Vec4f clip = viewProjection * Vec4f(point, 1.f);
+			const float guard = viewport.guardBand * clip.w;
+			flags = (clip.x < -clip.w ? ClipLeft : 0) | (clip.x > clip.w ? ClipRight : 0) | (clip.y < -clip.w ? ClipBottom : 0) | (clip.y > clip.w ? ClipTop : 0)
+				| (clip.z < 0.f || clip.w <= 0.f ? ClipNear : 0) | (clip.z > clip.w ? ClipFar : 0)
+				| (std::abs(clip.x) > guard || std::abs(clip.y) > guard ? ClipGuardBand : 0);
+			return Vec3f((clip.x / clip.w + 1.f) * 0.5f * viewport.width, (1.f - clip.y / clip.w) * 0.5f * viewport.height, clip.z / clip.w);
+		};
+
+		TEST(Screen Projection)
+		{
+			const Camera camera(Vec3f(0.f, 1.f, -5.f), Quat::AngleAxis(10.f, Vec3f::Up()), 60.f, 16.f / 9.f, 0.1f, 100.f, DepthRange::ZeroToOne);
+			const Viewport viewport{ 1280.f, 720.f, DepthRange::ZeroToOne };
+			// Points all around the camera, behind it included, 1001 so the last pack is partial
+			std::vector<Vec3f> points(1001), screen(points.size());
+			std::vector<uint8_t> flags(points.size());
+			for (Vec3f& point : points)
+				point = random.InBox(Vec3f(-60.f), Vec3f(60.f));
+			points[0] = Vec3f(0.f, 1.f, -5.f);
+			ProjectToScreen(camera.GetViewProjectionMatrix(), viewport, points, screen, flags);
+
+			bool sameFlags = true, samePositions = true;
+			size_t inside = 0;
+			for (size_t i = 0; i < points.size(); i++)
+			{
+				uint8_t expectedFlags;
+				const Vec3f expected = projectPoint(camera.GetViewProjectionMatrix(), viewport, points[i], expectedFlags);
+				sameFlags &= flags[i] == expectedFlags;
+				if (flags[i] & ClipNear)
+					continue;
+				inside += (flags[i] & ClipSides) == 0;
+				// A hundredth of a pixel, scaled by how many viewports off screen the point lands. The last step adds half
+				// the viewport, which cancels near the left and top edges, so the tolerance cannot be relative to the position
+				samePositions &= std::abs(screen[i].x - expected.x) <= 1e-2f * std::max(1.f, std::abs(expected.x) / viewport.width);
+				samePositions &= std::abs(screen[i].y - expected.y) <= 1e-2f * std::max(1.f, std::abs(expected.y) / viewport.height);
+				samePositions &= std::abs(screen[i].z - expected.z) <= 1e-5f * std::max(1.f, std::abs(expected.z));
+			}
+			REQUIRE(sameFlags);
+			REQUIRE(samePositions);
+			REQUIRE(inside > 10);
+			REQUIRE((flags[0] & ClipNear));
+
+			// Just outside the right edge is still inside the guard band
+			const Camera straight(Vec3f(), Quat(), 90.f, 1.f, 1.f, 100.f);
+			const Viewport square{ 100.f, 100.f };
+			const Vec3f edge[] = { Vec3f(0.f, 0.f, 10.f), Vec3f(15.f, 0.f, 10.f), Vec3f(25.f, 0.f, 10.f), Vec3f(0.f, 0.f, 200.f) };
+			Vec3f edgeScreen[4];
+			uint8_t edgeFlags[4];
+			ProjectToScreen(straight.GetViewProjectionMatrix(), square, edge, edgeScreen, edgeFlags);
+			REQUIRE(edgeFlags[0] == 0);
+			REQUIRE(std::abs(edgeScreen[0].x - 50.f) < 1e-3f);
+			REQUIRE(std::abs(edgeScreen[0].y - 50.f) < 1e-3f);
+			REQUIRE(edgeFlags[1] == ClipRight);
+			REQUIRE(edgeFlags[2] == (ClipRight | ClipGuardBand));
+			REQUIRE(edgeFlags[3] == ClipFar);
+
+			// Spans of different sizes project the length of the shortest one
+			uint8_t fewerFlags[2] = { 0xFF, 0xFF };
+			ProjectToScreen(straight.GetViewProjectionMatrix(), square, edge, edgeScreen, std::span(fewerFlags, 1));
+			REQUIRE(fewerFlags[0] == 0 && fewerFlags[1] == 0xFF);
+		}
+
+		TEST(Tile Binning)
+		{
+			const Camera camera(Vec3f(), Quat(), 70.f, 4.f / 3.f, 0.1f, 100.f);
+			const Viewport viewport{ 640.f, 480.f };
+			std::vector<Vec3f> points(100000), screen(points.size());
+			std::vector<uint8_t> flags(points.size());
+			for (Vec3f& point : points)
+				point = random.InBox(Vec3f(-50.f, -50.f, -10.f), Vec3f(50.f, 50.f, 90.f));
+			ProjectToScreen(camera.GetViewProjectionMatrix(), viewport, points, screen, flags);
+
+			// 640 / 48 leaves a partial column, the worker count does not change the bins
+			ScreenTiles tiles, serialTiles;
+			BinToTiles(screen, flags, viewport, 48, tiles);
+			SetWorkerCount(1);
+			BinToTiles(screen, flags, viewport, 48, serialTiles);
+			SetWorkerCount(0);
+			REQUIRE(tiles.columns == 14);
+			REQUIRE(tiles.rows == 10);
+			REQUIRE(tiles.indices == serialTiles.indices);
+			REQUIRE(tiles.offsets == serialTiles.offsets);
+
+			bool inTile = true, ordered = true;
+			for (size_t tile = 0; tile < tiles.GetTileCount(); tile++)
+			{
+				const float left = static_cast<float>(tile % tiles.columns * 48), top = static_cast<float>(tile / tiles.columns * 48);
+				const std::span<const uint32_t> indices = tiles.GetTile(tile);
+				for (size_t i = 0; i < indices.size(); i++)
+				{
+					const Vec3f& point = screen[indices[i]];
+					inTile &= point.x >= left - 1e-3f && point.x <= left + 48.f + 1e-3f && point.y >= top - 1e-3f && point.y <= top + 48.f + 1e-3f;
+					ordered &= i == 0 || indices[i - 1] < indices[i];
+				}
+			}
+			REQUIRE(inTile);
+			REQUIRE(ordered);
+			REQUIRE(tiles.indices.size() == static_cast<size_t>(std::count_if(flags.begin(), flags.end(), [](uint8_t f) { return (f & ClipSides) == 0; })));
+
+			// Points that are not finite have no screen position and are left out, a tile size of 0 gives no tiles
+			const float nan = std::numeric_limits<float>::quiet_NaN(), infinity = std::numeric_limits<float>::infinity();
+			const Vec3f broken[] = { Vec3f(nan, 0.f, 10.f), Vec3f(0.f, nan, 10.f), Vec3f(infinity, 0.f, 10.f), Vec3f(0.f, 0.f, 10.f) };
+			Vec3f brokenScreen[4];
+			uint8_t brokenFlags[4];
+			ProjectToScreen(camera.GetViewProjectionMatrix(), viewport, broken, brokenScreen, brokenFlags);
+			REQUIRE((brokenFlags[0] & ClipNear) && (brokenFlags[1] & ClipNear) && (brokenFlags[2] & ClipNear) && brokenFlags[3] == 0);
+			BinToTiles(brokenScreen, brokenFlags, viewport, 48, tiles);
+			REQUIRE(tiles.indices == std::vector<uint32_t>(1, 3));
+			BinToTiles(screen, flags, viewport, 0, tiles);
+			REQUIRE(tiles.GetTileCount() == 0 && tiles.indices.empty());
+		}
+	}
+#pragma endregion
+
+#pragma region Expression Tests
+	NAMESPACE(Expression)
+	{
+		MathArray<Vec3f> a(37), b(37), c(37);
+		for (size_t i = 0; i < a.size(); i++)
+		{
+			a[i] = Vec3f(i * 0.5f, 1 - i * 0.25f, i * 0.125f);
+			b[i] = Vec3f(2.f, i * -0.75f, 3 - i * 1.5f);
+			c[i] = Vec3f(i * 0.1f, 0.5f, -1.f * i);
+		}
+		auto eager = [&](size_t i) { return a[i] + b[i] * 2.5f - c[i]; };
+
+		TEST(Array)
+		{
+			MathArray<Vec3f> result(a.size());
+			Evaluate(Lazy(a) + Lazy(b) * 2.5f - Lazy(c), result);
+			for (size_t i = 0; i < a.size(); i++)
+				REQUIRE(result[i] == eager(i));
+
+			// Constants on either side, negation, component wise vector product
+			Evaluate(-(2.f * Lazy(a)) / 4.f + Lazy(b) * Vec3f(1, 2, 3), result);
+			REQUIRE(result[5] == -(a[5] * 2.f) / 4.f + b[5] * Vec3f(1, 2, 3));
+		}
+
+		TEST(Structure Of Arrays)
+		{
+			// 37 elements: full packs then a scalar tail
+			Vec3SoA<float> sa(a), sb(b), sc(c), result(a.size());
+			Evaluate(Lazy(sa) + Lazy(sb) * 2.5f - Lazy(sc), result);
+			for (size_t i = 0; i < a.size(); i++)
+				REQUIRE(result.Get(i) == eager(i));
+
+			// Arrays of vectors and structures of arrays mix in one expression
+			Evaluate(Lazy(sa) - Lazy(c), result);
+			REQUIRE(result.Get(36) == a[36] - c[36]);
+
+			MathArray<Vec3f> interleaved(a.size());
+			result.Store(interleaved);
+			REQUIRE(interleaved[20] == a[20] - c[20]);
+		}
+
+		TEST(Aliasing)
+		{
+			MathArray<Vec3f> accumulated = a;
+			Evaluate(Lazy(accumulated) + Lazy(b), accumulated);
+			REQUIRE(accumulated[10] == a[10] + b[10]);
+
+			Vec3SoA<float> soa(a);
+			Evaluate(Lazy(soa) * 2.f - Lazy(soa), soa);
+			REQUIRE(soa.Get(30) == a[30] * 2.f - a[30]);
+		}
+
+		TEST(Compound Operators)
+		{
+			Vec3f v = a[3];
+			v += b[3];
+			v *= 2.f;
+			v -= c[3];
+			REQUIRE(v == (a[3] + b[3]) * 2.f - c[3]);
+			Vec4d d(1, 2, 3, 4);
+			d /= 2;
+			REQUIRE(d == Vec4d(0.5, 1, 1.5, 2));
+		}
+	}
+#pragma endregion
+
+#pragma region Deterministic Tests
+	NAMESPACE(Deterministic)
+	{
+		auto bits = [](double value) { return std::bit_cast<uint64_t>(value); };
+		// ULP distance, only meaningful for values of the same sign
+		auto ulps = [](double a, double b) { int64_t d = std::bit_cast<int64_t>(a) - std::bit_cast<int64_t>(b); return d < 0 ? -d : d; };
+
+		TEST(Golden Bits)
+		{
+			struct Golden { double x; uint64_t sin, cos, tan, atan2; };
+			constexpr Golden goldens[] = {
+				{ 0.5, 0x3FDEAEE8744B05F0ull, 0x3FEC1528065B7D50ull, 0x3FE17B4F5BF3474Aull, 0x40046DC09EC29433ull },
+				{ 1.0, 0x3FEAED548F090CEEull, 0x3FE14A280FB5068Cull, 0x3FF8EB245CBEE3A5ull, 0x4001B6E192EBBE44ull },
+				{ 2.5, 0x3FE326AF0DCFCAB0ull, 0xBFE9A2F7EF858B7Dull, 0xBFE7E79B4E00BB14ull, 0x3FFDCBC9EDCBD8DAull },
+				{ -3.0, 0xBFC210386DB6D55Bull, 0xBFEFAE04BE85E5D2ull, 0x3FC23EF71254B86Full, 0xBFFD0D6A1369BD34ull },
+				{ 10.0, 0xBFE1689EF5F34F53ull, 0xBFEAD9AC890C6B1Full, 0x3FE4BF5F34BE3783ull, 0x3FFA549B919F658Eull },
+				{ 100.0, 0xBFE03425B78C4DB8ull, 0x3FEB981DBF665FDFull, 0xBFE2CA74D62B5D38ull, 0x3FF940B38070588Bull },
+				{ 12345.678, 0xBFE687D5890974A5ull, 0x3FE6B94C3BBE24B8ull, 0xBFEFBA5836323A4Dull, 0x3FF9223B07B8B99Eull },
+			};
+			for (const Golden& golden : goldens)
+			{
+				COMPARE(bits(Deterministic::Sin(golden.x)), golden.sin);
+				COMPARE(bits(Deterministic::Cos(golden.x)), golden.cos);
+				COMPARE(bits(Deterministic::Tan(golden.x)), golden.tan);
+				COMPARE(bits(Deterministic::Atan2(golden.x, -0.75)), golden.atan2);
+			}
+			COMPARE(bits(Deterministic::Asin(0.3)), 0x3FD380159E14F6FFull);
+			COMPARE(bits(Deterministic::Acos(-0.7)), 0x4002C501446CD5F2ull);
+
+			// Compile time evaluation gives the same bits as the runtime one
+			constexpr double constantSin = Deterministic::Sin(2.5);
+			constexpr double constantAtan2 = Deterministic::Atan2(-3.0, -0.75);
+			COMPARE(bits(constantSin), goldens[2].sin);
+			COMPARE(bits(constantAtan2), goldens[3].atan2);
+		}
+		TEST(Accuracy)
+		{
+			int64_t worst = 0;
+			for (int i = -2000; i <= 2000; i++)
+			{
+				double x = i * 0.0173;
+				worst = std::max({ worst, ulps(Deterministic::Sin(x), std::sin(x)), ulps(Deterministic::Cos(x), std::cos(x)),
+					ulps(Deterministic::Tan(x), std::tan(x)), ulps(Deterministic::Atan2(x, 1.5), std::atan2(x, 1.5)) });
+				double v = i / 2000.0;
+				worst = std::max({ worst, ulps(Deterministic::Asin(v), std::asin(v)), ulps(Deterministic::Acos(v), std::acos(v)) });
+			}
+			REQUIRE(worst <= 4);
+			REQUIRE(Deterministic::Sin(0.0) == 0.0);
+			REQUIRE(Deterministic::Atan2(0.0, -1.0) == Deterministic::Atan2(1.0, 0.0) * 2.0);
+			REQUIRE(Deterministic::Sin(std::numeric_limits<double>::infinity()) != Deterministic::Sin(std::numeric_limits<double>::infinity()));
+		}
+#ifdef MATH_DETERMINISTIC
+		TEST(Lockstep Simulation)
+		{
+			// Same hash on every compiler, optimisation level and SIMD path
+			Quat rotation = Quat::Identity();
+			Vec3f position(1, 2, 3);
+			Vec3f axis = Vec3f(0.3f, 1, -0.2f).GetNormalize();
+			Vec3f points[16];
+			for (int i = 0; i < 16; i++)
+				points[i] = Vec3f(i * 0.5f, 1 - i * 0.25f, static_cast<float>(i));
+
+			uint32_t hash = 2166136261u;
+			for (int step = 0; step < 600; step++)
+			{
+				rotation = (rotation * Quat::AngleAxis(1.5f, axis)).GetNormalize();
+				position = rotation * position + Vec3f(0.01f, 0, -0.02f);
+				rotation.Rotate(points, points);
+				Vec3f euler = rotation.ToEuler();
+				for (float value : { position.x, position.y, position.z, euler.x, euler.y, euler.z, points[15].x, points[3].y })
+				{
+					hash ^= std::bit_cast<uint32_t>(value);
+					hash *= 16777619u;
+				}
+			}
+			COMPARE(hash, 0x2E2C3420u);
+		}
+#endif
+	}
+#pragma endregion
+
+#ifdef MATH_INSTRUMENT
+#pragma region Instrument Tests
+	NAMESPACE(Instrument)
+	{
+		// Other suites run at the same time, so counters are only checked to grow by at least the calls made here
+		auto find = [](const std::vector<Instrument::FunctionStats>& stats, const std::string& name)
+		{
+			for (const auto& s : stats)
+			{
+				if (s.name == name)
+					return s;
+			}
+			return Instrument::FunctionStats();
+		};
+
+		TEST(Counters)
+		{
+			const auto before = Instrument::Snapshot();
+			std::vector<std::thread> threads;
+			for (int t = 0; t < 4; t++)
+			{
+				threads.emplace_back([]()
+				{
+					float sum = 0;
+					for (int i = 0; i < 1000; i++)
+						sum += Vec3f(1, 2, static_cast<float>(i)).Dot(Vec3f(3, 2, 1));
+					DoNotOptimize(sum);
+				});
+			}
+			for (auto& thread : threads)
+				thread.join();
+			const auto after = Instrument::Snapshot();
+
+			REQUIRE(find(after, "Vec3::Dot(Vec3)").calls - find(before, "Vec3::Dot(Vec3)").calls >= 4000);
+			REQUIRE(find(after, "Vec3::Dot(Vec3)").sampledCalls > find(before, "Vec3::Dot(Vec3)").sampledCalls);
+		}
+
+		TEST(Batch Candidates)
+		{
+			const auto before = Instrument::Snapshot();
+			Quat rotation = Quat::AngleAxis(30.f, Vec3f(0, 1, 0));
+			std::vector<Vec3f> points(2000, Vec3f(1, 2, 3));
+			for (auto& point : points)
+				point = rotation * point;
+			rotation.Rotate(points, points);
+			const auto after = Instrument::Snapshot();
+
+			REQUIRE(find(after, "Quat::Rotate(span, span)").items - find(before, "Quat::Rotate(span, span)").items >= 2000);
+			REQUIRE(find(after, "Quat::operator*(Vec3)").batchAlternative == "Quat::Rotate(span, span)");
+			REQUIRE(Instrument::Report().find("Quat::operator*(Vec3) called") != std::string::npos);
+		}
+
+		TEST(Constant Evaluation)
+		{
+			// Scopes vanish from constant expressions
+			constexpr Vec4f sum = Vec4f(1, 2, 3, 4) + Vec4f(1, 1, 1, 1);
+			static_assert(sum.w == 5);
+			constexpr Quat product = Quat(1, 0, 0, 0) * Quat(0, 1, 0, 0);
+			REQUIRE(product.w == 0);
+		}
+	}
+#pragma endregion
+#endif
+}
+
+#pragma region Fuzz Helpers
+static Vec3f RandomVec3(VFuzz::Random& random, float magnitude)
+{
+	return Vec3f(random.Float(magnitude), random.Float(magnitude), random.Float(magnitude));
+}
+
+static Vec3f RandomDirection(VFuzz::Random& random)
+{
+	Vec3f direction;
+	do
+		direction = Vec3f(random.Uniform(-1, 1), random.Uniform(-1, 1), random.Uniform(-1, 1));
+	while (direction.LengthSquared() < 0.01f || direction.LengthSquared() > 1.f);
+	return direction.GetNormalize();
+}
+
+// Uniform rotations (Shoemake), plus near identity and half turn ones where the trigonometric paths break down
+static Quat RandomRotation(VFuzz::Random& random)
+{
+	if (random.Chance(0.1))
+		return Quat::AngleAxis(random.Uniform(-1e-3f, 1e-3f), RandomDirection(random));
+	if (random.Chance(0.05))
+	{
+		Vec3f axis = RandomDirection(random);
+		return Quat(axis.x, axis.y, axis.z, 0.f);
+	}
+
+	const float u1 = random.Uniform(0, 1), u2 = random.Uniform(0, 2 * PI), u3 = random.Uniform(0, 2 * PI);
+	const float a = std::sqrt(1.f - u1), b = std::sqrt(u1);
+	return Quat(a * std::sin(u2), a * std::cos(u2), b * std::sin(u3), b * std::cos(u3));
+}
+
+static Vec3f RandomScale(VFuzz::Random& random)
+{
+	auto axisScale = [&random]() { return std::exp2(random.Uniform(-6.f, 6.f)) * (random.Chance(0.1) ? -1.f : 1.f); };
+	return Vec3f(axisScale(), axisScale(), axisScale());
+}
+
+static Mat4 RandomTransform(VFuzz::Random& random)
+{
+	return Mat4::CreateTransformMatrix(RandomVec3(random, 1000.f), RandomRotation(random), RandomScale(random));
+}
+
+static double FuzzError(float result, float reference) { return VFuzz::ScaledUlps({ result }, { reference }); }
+static double FuzzError(const Vec3f& result, const glm::vec3& reference) { return VFuzz::ScaledUlps({ result.x, result.y, result.z }, { reference.x, reference.y, reference.z }); }
+static double FuzzError(const Vec4f& result, const glm::vec4& reference) { return VFuzz::ScaledUlps({ result.x, result.y, result.z, result.w }, { reference.x, reference.y, reference.z, reference.w }); }
+static double FuzzError(const Quat& result, const glm::quat& reference) { return VFuzz::ScaledUlps({ result.x, result.y, result.z, result.w }, { reference.x, reference.y, reference.z, reference.w }); }
+static double FuzzError(Mat4 result, const glm::mat4& reference)
+{
+	float a[16], b[16];
+	for (int i = 0; i < 16; i++)
+	{
+		a[i] = result[i / 4][i % 4];
+		b[i] = reference[i / 4][i % 4];
+	}
+	return VFuzz::ScaledUlps(a, b);
+}
+#pragma endregion
+
+VTEST(MATH_FUZZ)
+{
+	// Bounds are in ULPs of the largest reference component, see VFuzz::ScaledUlps.
+	// 200K cases per function keep a plain run short, --fuzz-scale=10 and above reach millions.
+	// Covered: the scalar functions and the Vec, Quat and Mat4 operations glm has a counterpart for.
+	// Not covered here: ToString, the swizzles, compact types and batch paths, which have their own exact tests,
+	// and CreateViewMatrix, whose convention differs from glm::lookAt
+	constexpr uint64_t cases = 200000;
+
+#pragma region Scalar Fuzz
+	NAMESPACE(Scalar)
+	{
+		// References in double, rounded once
+		TEST(Trigonometry)
+		{
+			FUZZ("Sin", cases, 2, [](VFuzz::Random& random) {
+				float x = random.Float(100.f);
+				return FuzzError(Sin(x), static_cast<float>(std::sin(static_cast<double>(x))));
+			});
+			FUZZ("Cos", cases, 2, [](VFuzz::Random& random) {
+				float x = random.Float(100.f);
+				return FuzzError(Cos(x), static_cast<float>(std::cos(static_cast<double>(x))));
+			});
+			FUZZ("Tan", cases, 2, [](VFuzz::Random& random) {
+				float x = random.Float(100.f);
+				return FuzzError(Tan(x), static_cast<float>(std::tan(static_cast<double>(x))));
+			});
+			FUZZ("Asin", cases, 2, [](VFuzz::Random& random) {
+				float x = random.Float(1.f);
+				return FuzzError(Asin(x), static_cast<float>(std::asin(static_cast<double>(x))));
+			});
+			FUZZ("Acos", cases, 2, [](VFuzz::Random& random) {
+				float x = random.Float(1.f);
+				return FuzzError(Acos(x), static_cast<float>(std::acos(static_cast<double>(x))));
+			});
+			FUZZ("Atan", cases, 2, [](VFuzz::Random& random) {
+				float x = random.Float(1e6f);
+				return FuzzError(Atan(x), static_cast<float>(std::atan(static_cast<double>(x))));
+			});
+			FUZZ("Atan2", cases, 2, [](VFuzz::Random& random) {
+				float y = random.Float(1e4f), x = random.Float(1e4f);
+				return FuzzError(Atan2(y, x), static_cast<float>(std::atan2(static_cast<double>(y), static_cast<double>(x))));
+			});
+			FUZZ("Sqrt", cases, 0, [](VFuzz::Random& random) {
+				float x = std::abs(random.Float(1e30f));
+				return FuzzError(Sqrt(x), static_cast<float>(std::sqrt(static_cast<double>(x))));
+			});
+		}
+	}
+#pragma endregion
+
+#pragma region Vector Fuzz
+	NAMESPACE(Vector)
+	{
+		TEST(Vec2)
+		{
+			FUZZ("Vec2::Dot", cases, 4, [](VFuzz::Random& random) {
+				Vec2f a(random.Float(1e4f), random.Float(1e4f)), b(random.Float(1e4f), random.Float(1e4f));
+				return FuzzError(a.Dot(b), glm::dot(a.ToGlm(), b.ToGlm()));
+			});
+			FUZZ("Vec2::Length", cases, 2, [](VFuzz::Random& random) {
+				Vec2f a(random.Float(1e15f), random.Float(1e15f));
+				return FuzzError(a.Length(), glm::length(a.ToGlm()));
+			});
+		}
+		TEST(Vec3)
+		{
+			FUZZ("Vec3::Dot", cases, 4, [](VFuzz::Random& random) {
+				Vec3f a = RandomVec3(random, 1e4f), b = RandomVec3(random, 1e4f);
+				return FuzzError(a.Dot(b), glm::dot(a.ToGlm(), b.ToGlm()));
+			});
+			FUZZ("Vec3::Cross", cases, 4, [](VFuzz::Random& random) {
+				Vec3f a = RandomVec3(random, 1e4f), b = RandomVec3(random, 1e4f);
+				return FuzzError(a.Cross(b), glm::cross(a.ToGlm(), b.ToGlm()));
+			});
+			FUZZ("Vec3::Length", cases, 2, [](VFuzz::Random& random) {
+				Vec3f a = RandomVec3(random, 1e15f);
+				return FuzzError(a.Length(), glm::length(a.ToGlm()));
+			});
+			FUZZ("Vec3::Distance", cases, 2, [](VFuzz::Random& random) {
+				Vec3f a = RandomVec3(random, 1e4f), b = RandomVec3(random, 1e4f);
+				return FuzzError(a.Distance(b), glm::distance(a.ToGlm(), b.ToGlm()));
+			});
+			FUZZ("Vec3::GetNormalize", cases, 4, [](VFuzz::Random& random) {
+				Vec3f a = RandomVec3(random, 1e4f);
+				if (a.LengthSquared() < FLT_MIN)
+					return VFuzz::Skip;
+				return FuzzError(a.GetNormalize(), glm::normalize(a.ToGlm()));
+			});
+			FUZZ("Vec3::Lerp", cases, 4, [](VFuzz::Random& random) {
+				Vec3f a = RandomVec3(random, 1e4f), b = RandomVec3(random, 1e4f);
+				float t = random.Uniform(0, 1);
+				// The result can cancel far below its inputs, so the error is measured in ULPs of the inputs against a double reference
+				const Vec3f result = a.Lerp(b, t);
+				double scale = 0.0, worst = 0.0;
+				for (int i = 0; i < 3; i++)
+				{
+					scale = std::max({ scale, static_cast<double>(std::abs(a[i])), static_cast<double>(std::abs(b[i])) });
+					const double reference = static_cast<double>(a[i]) + (static_cast<double>(b[i]) - static_cast<double>(a[i])) * static_cast<double>(t);
+					worst = std::max(worst, std::abs(static_cast<double>(result[i]) - reference));
+				}
+				return worst / VFuzz::UlpOf(scale);
+			});
+		}
+		TEST(Vec4)
+		{
+			FUZZ("Vec4::Dot", cases, 4, [](VFuzz::Random& random) {
+				Vec4f a(RandomVec3(random, 1e4f), random.Float(1e4f)), b(RandomVec3(random, 1e4f), random.Float(1e4f));
+				return FuzzError(a.Dot(b), glm::dot(a.ToGlm(), b.ToGlm()));
+			});
+			FUZZ("Vec4::Length", cases, 2, [](VFuzz::Random& random) {
+				Vec4f a(RandomVec3(random, 1e15f), random.Float(1e15f));
+				return FuzzError(a.Length(), glm::length(a.ToGlm()));
+			});
+			FUZZ("Vec4::Distance", cases, 2, [](VFuzz::Random& random) {
+				Vec4f a(RandomVec3(random, 1e4f), random.Float(1e4f)), b(RandomVec3(random, 1e4f), random.Float(1e4f));
+				return FuzzError(a.Distance(b), glm::distance(a.ToGlm(), b.ToGlm()));
+			});
+			FUZZ("Vec4::GetNormalize", cases, 4, [](VFuzz::Random& random) {
+				Vec4f a(RandomVec3(random, 1e4f), random.Float(1e4f));
+				if (a.Dot(a) < FLT_MIN)
+					return VFuzz::Skip;
+				return FuzzError(a.GetNormalize(), glm::normalize(a.ToGlm()));
+			});
+		}
+	}
+#pragma endregion
+
+#pragma region Quaternion Fuzz
+	NAMESPACE(Quaternion)
+	{
+		TEST(Products)
+		{
+			FUZZ("Quat * Quat", cases, 4, [](VFuzz::Random& random) {
+				Quat a = RandomRotation(random), b = RandomRotation(random);
+				return FuzzError(a * b, a.ToGlm() * b.ToGlm());
+			});
+			FUZZ("Quat * Vec3", cases, 8, [](VFuzz::Random& random) {
+				Quat q = RandomRotation(random);
+				Vec3f v = RandomVec3(random, 1e4f);
+				return FuzzError(q * v, q.ToGlm() * v.ToGlm());
+			});
+			FUZZ("Quat::Rotate", cases / 16, 16, [](VFuzz::Random& random) {
+				Quat q = RandomRotation(random);
+				Vec3f points[16], rotated[16];
+				for (Vec3f& point : points)
+					point = RandomVec3(random, 1e4f);
+				q.Rotate(points, rotated);
+
+				double worst = 0.0;
+				for (int i = 0; i < 16; i++)
+					worst = std::max(worst, FuzzError(rotated[i], q.ToGlm() * points[i].ToGlm()));
+				return worst;
+			});
+		}
+		TEST(Methods)
+		{
+			FUZZ("Quat::GetNormalize", cases, 4, [](VFuzz::Random& random) {
+				Quat q = RandomRotation(random) * std::exp2(random.Uniform(-20.f, 20.f));
+				return FuzzError(q.GetNormalize(), glm::normalize(q.ToGlm()));
+			});
+			FUZZ("Quat::GetConjugate", cases, 0, [](VFuzz::Random& random) {
+				Quat q = RandomRotation(random);
+				return FuzzError(q.GetConjugate(), glm::conjugate(q.ToGlm()));
+			});
+			FUZZ("Quat::Dot", cases, 4, [](VFuzz::Random& random) {
+				Quat a = RandomRotation(random), b = RandomRotation(random);
+				return FuzzError(a.Dot(b), glm::dot(a.ToGlm(), b.ToGlm()));
+			});
+			FUZZ("Quat::GetInverse", cases, 8, [](VFuzz::Random& random) {
+				Quat q = RandomRotation(random) * std::exp2(random.Uniform(-20.f, 20.f));
+				return FuzzError(q.GetInverse(), glm::inverse(q.ToGlm()));
+			});
+			FUZZ("Quat::AngleAxis", cases, 4, [](VFuzz::Random& random) {
+				float angle = random.Float(720.f);
+				Vec3f axis = RandomDirection(random);
+				return FuzzError(Quat::AngleAxis(angle, axis), glm::angleAxis(angle * DegToRad, axis.GetNormalize().ToGlm()));
+			});
+			FUZZ("Quat::FromEuler", cases, 16, [](VFuzz::Random& random) {
+				Vec3f euler = RandomVec3(random, 360.f);
+				return FuzzError(Quat::FromEuler(euler), glm::quat(DegToRad * euler.ToGlm()));
+			});
+			FUZZ("Quat::ToEuler", cases, 256, [](VFuzz::Random& random) {
+				// Angles are ill conditioned near gimbal lock, compare the rotation they rebuild instead
+				Quat q = RandomRotation(random);
+				glm::quat rebuilt = glm::quat(DegToRad * q.ToEuler().ToGlm());
+				return FuzzError(q.ToRotationMatrix(), glm::mat4(rebuilt));
+			});
+			// Reported only: above a cosine of 0.9995 SLerp switches to an unnormalized linear blend, far earlier than glm
+			FUZZ("Quat::SLerp", cases, -1, [](VFuzz::Random& random) {
+				Quat a = RandomRotation(random);
+				// Near antipodal pairs exercise the shortest path flip
+				Quat b = random.Chance(0.2) ? (a * -1.f + Quat(random.Float(1e-3f), random.Float(1e-3f), random.Float(1e-3f), random.Float(1e-3f))).GetNormalize() : RandomRotation(random);
+				float t = random.Uniform(0, 1);
+				return FuzzError(Quat::SLerp(a, b, t), glm::slerp(a.ToGlm(), b.ToGlm(), t));
+			});
+			FUZZ("Quat::ToRotationMatrix", cases, 4, [](VFuzz::Random& random) {
+				Quat q = RandomRotation(random);
+				return FuzzError(q.ToRotationMatrix(), glm::mat4(q.ToGlm()));
+			});
+		}
+	}
+#pragma endregion
+
+#pragma region Matrix 4 Fuzz
+	NAMESPACE(Matrix_4)
+	{
+		TEST(Products)
+		{
+			FUZZ("Mat4 * Mat4", cases, 8, [](VFuzz::Random& random) {
+				Mat4 a = RandomTransform(random), b = RandomTransform(random);
+				return FuzzError(a * b, a.ToGlm() * b.ToGlm());
+			});
+			FUZZ("Mat4 * Vec4", cases, 8, [](VFuzz::Random& random) {
+				Mat4 m = RandomTransform(random);
+				Vec4f v(RandomVec3(random, 1e3f), 1.f);
+				return FuzzError(m * v, m.ToGlm() * v.ToGlm());
+			});
+			FUZZ("Mat4::GetTranspose", cases, 0, [](VFuzz::Random& random) {
+				Mat4 m = RandomTransform(random);
+				return FuzzError(m.GetTranspose(), glm::transpose(m.ToGlm()));
+			});
+		}
+		TEST(Construction)
+		{
+			FUZZ("Mat4::CreateRotationMatrix", cases, 16, [](VFuzz::Random& random) {
+				Vec3f euler = RandomVec3(random, 360.f);
+				return FuzzError(Mat4::CreateRotationMatrix(euler), glm::eulerAngleXYZ(DegToRad * euler.x, DegToRad * euler.y, DegToRad * euler.z));
+			});
+			FUZZ("Mat4::CreateTransformMatrix", cases, 16, [](VFuzz::Random& random) {
+				Vec3f position = RandomVec3(random, 1e3f), scale = RandomScale(random);
+				Quat rotation = RandomRotation(random);
+				glm::mat4 reference = glm::translate(glm::mat4(1), position.ToGlm()) * glm::mat4(rotation.ToGlm()) * glm::scale(glm::mat4(1), scale.ToGlm());
+				return FuzzError(Mat4::CreateTransformMatrix(position, rotation, scale), reference);
+			});
+			FUZZ("Mat4::CreateTranslationMatrix", cases, 0, [](VFuzz::Random& random) {
+				Vec3f position = RandomVec3(random, 1e4f);
+				return FuzzError(Mat4::CreateTranslationMatrix(position), glm::translate(glm::mat4(1), position.ToGlm()));
+			});
+			FUZZ("Mat4::CreateScaleMatrix", cases, 0, [](VFuzz::Random& random) {
+				Vec3f scale = RandomScale(random);
+				return FuzzError(Mat4::CreateScaleMatrix(scale), glm::scale(glm::mat4(1), scale.ToGlm()));
+			});
+			FUZZ("Mat4::CreateOrthographicMatrix", cases, 4, [](VFuzz::Random& random) {
+				float left = random.Uniform(-1e3f, 1e3f), right = left + std::exp2(random.Uniform(-4.f, 10.f));
+				float bottom = random.Uniform(-1e3f, 1e3f), top = bottom + std::exp2(random.Uniform(-4.f, 10.f));
+				float nearPlane = random.Uniform(-100.f, 100.f), farPlane = nearPlane + std::exp2(random.Uniform(-4.f, 12.f));
+				return FuzzError(Mat4::CreateOrthographicMatrix(left, right, bottom, top, nearPlane, farPlane), glm::ortho(left, right, bottom, top, nearPlane, farPlane));
+			});
+			FUZZ("Mat4::CreateProjectionMatrix", cases, 16, [](VFuzz::Random& random) {
+				float fov = random.Uniform(10.f, 170.f), aspect = random.Uniform(0.25f, 4.f);
+				float nearPlane = std::exp2(random.Uniform(-10.f, 2.f)), farPlane = nearPlane * std::exp2(random.Uniform(1.f, 20.f));
+				return FuzzError(Mat4::CreateProjectionMatrix(fov, aspect, nearPlane, farPlane), glm::perspective(DegToRad * fov, aspect, nearPlane, farPlane));
+			});
+		}
+		// Reported only: the error follows the conditioning of the input more than the implementation
+		TEST(Inverse)
+		{
+			FUZZ("Mat4::CreateInverseMatrix", cases, -1, [](VFuzz::Random& random) {
+				Mat4 m = RandomTransform(random);
+				return FuzzError(m.CreateInverseMatrix(), glm::inverse(m.ToGlm()));
+			});
+			FUZZ("Mat4::CreateInverseMatrix singular", cases / 4, -1, [](VFuzz::Random& random) {
+				// One axis squashed to almost nothing
+				Vec3f scale = RandomScale(random);
+				scale[random.Int(0, 2)] = std::exp2(random.Uniform(-24.f, -12.f));
+				Mat4 m = Mat4::CreateTransformMatrix(RandomVec3(random, 1e3f), RandomRotation(random), scale);
+				return FuzzError(m.CreateInverseMatrix(), glm::inverse(m.ToGlm()));
+			});
+			FUZZ("Mat4::GetDeterminant", cases, -1, [](VFuzz::Random& random) {
+				Mat4 m = RandomTransform(random);
+				return FuzzError(m.GetDeterminant(4), glm::determinant(m.ToGlm()));
+			});
+		}
+	}
+#pragma endregion
+}
+
+VBENCH(MATH_BENCH)
+{
+	constexpr size_t count = 1024;
+	MathArray<Vec3f> points(count), rotated(count);
+	for (size_t i = 0; i < count; i++)
+		points[i] = Vec3f(i * 0.5f, 1 - i * 0.25f, i * 0.125f);
+	Quat rotation = Quat::AngleAxis(37.f, Vec3f(0.3f, 1, -0.2f).GetNormalize());
+
+#pragma region Scalar Functions Benchmarks
+	NAMESPACE(Scalar_Functions)
+	{
+		MathArray<double> angles(count);
+		for (size_t i = 0; i < count; i++)
+			angles[i] = i * 0.37 - 100.0;
+
+		BENCHMARK_N(std::sin, count)
+		{
+			double sum = 0.0;
+			for (double angle : angles)
+				sum += std::sin(angle);
+			DoNotOptimize(sum);
+		}
+		BENCHMARK_N(Deterministic::Sin, count)
+		{
+			double sum = 0.0;
+			for (double angle : angles)
+				sum += Deterministic::Sin(angle);
+			DoNotOptimize(sum);
+		}
+		BENCHMARK_N(std::atan2, count)
+		{
+			double sum = 0.0;
+			for (double angle : angles)
+				sum += std::atan2(angle, 1.5);
+			DoNotOptimize(sum);
+		}
+		BENCHMARK_N(Deterministic::Atan2, count)
+		{
+			double sum = 0.0;
+			for (double angle : angles)
+				sum += Deterministic::Atan2(angle, 1.5);
+			DoNotOptimize(sum);
+		}
+	}
+#pragma endregion
+
+#pragma region Simulation Benchmarks
+	NAMESPACE(Simulation)
+	{
+		// One lockstep tick of 10K entities, at 60 Hz the whole tick has 16.6 ms (compare with MATH_DETERMINISTIC builds)
+		constexpr size_t entityCount = 10000;
+		MathArray<Quat> orientations(entityCount, Quat::Identity());
+		MathArray<Vec3f> positions(entityCount, Vec3f(0.f));
+		const Vec3f axis = Vec3f(0.3f, 1, -0.2f).GetNormalize();
+		BENCHMARK_N(Entity Tick 10K, entityCount)
+		{
+			for (size_t i = 0; i < entityCount; i++)
+			{
+				orientations[i] = (orientations[i] * Quat::AngleAxis(0.5f + i * 1e-4f, axis)).GetNormalize();
+				positions[i] = orientations[i] * Vec3f(0.f, 0.f, 0.1f) + positions[i];
+			}
+			DoNotOptimize(positions[entityCount - 1]);
+		}
+	}
+#pragma endregion
+
+#pragma region Quaternion Benchmarks
+	NAMESPACE(Quaternion)
+	{
+		BENCHMARK_N(Operator Rotation, count)
+		{
+			for (size_t i = 0; i < count; i++)
+				rotated[i] = rotation * points[i];
+			ClobberMemory();
+		}
+		BENCHMARK_N(Batch Rotation, count)
+		{
+			rotation.Rotate(points, rotated);
+			ClobberMemory();
+		}
+	}
+#pragma endregion
+
+#pragma region Matrix 4 Benchmarks
+	NAMESPACE(Matrix_4)
+	{
+		Mat4 transform = Mat4::CreateTransformMatrix(Vec3f(1, 2, 3), Vec3f(30, 45, 60), Vec3f(1, 2, 1));
+		Mat4d transformd(transform);
+		Mat4 resultf;
+		Mat4d resultd;
+		BENCHMARK(Multiply Float)
+		{
+			resultf = transform * resultf;
+			DoNotOptimize(resultf);
+		}
+		BENCHMARK(Multiply Double)
+		{
+			resultd = transformd * resultd;
+			DoNotOptimize(resultd);
+		}
+		BENCHMARK(Inverse)
+		{
+			resultf = transform.CreateInverseMatrix();
+			DoNotOptimize(resultf);
+		}
+	}
+#pragma endregion
+
+#pragma region Compact Types Benchmarks
+	NAMESPACE(Compact_Types)
+	{
+		MathArray<Vec3h> compact(count);
+		BENCHMARK_N(Vec3f To Vec3h, count)
+		{
+			ConvertBatch(points, compact);
+			ClobberMemory();
+		}
+		BENCHMARK_N(Vec3h To Vec3f, count)
+		{
+			ConvertBatch(compact, rotated);
+			ClobberMemory();
+		}
+	}
+#pragma endregion
+
+#pragma region Double Precision Benchmarks
+	NAMESPACE(Double_Precision)
+	{
+		MathArray<Mat4d> world(count, Mat4d::CreateTranslationMatrix(Vec3d(1e6, 2e5, -3e6)));
+		MathArray<Mat4> relative(count);
+		BENCHMARK_N(Rebase To Camera, count)
+		{
+			RebaseToCamera(world, Vec3d(1e6 + 0.5, 2e5, -3e6), relative);
+			ClobberMemory();
+		}
+	}
+#pragma endregion
+
+#pragma region Generic Vector Benchmarks
+	NAMESPACE(Generic_Vectors)
+	{
+		MathArray<Vec4f> named(count);
+		MathArray<VecN<float, 4>> generic(count);
+		for (size_t i = 0; i < count; i++)
+		{
+			named[i] = Vec4f(points[i], 1.f);
+			generic[i] = VecN<float, 4>(named[i]);
+		}
+		const Vec4f axis = Vec4f(0.3f, 1, -0.2f, 0.5f);
+		BENCHMARK_N(Vec4 Dot, count)
+		{
+			float sum = 0;
+			for (size_t i = 0; i < count; i++)
+				sum += named[i].Dot(axis);
+			DoNotOptimize(sum);
+		}
+		BENCHMARK_N(VecN Dot, count)
+		{
+			float sum = 0;
+			const VecN<float, 4> genericAxis(axis);
+			for (size_t i = 0; i < count; i++)
+				sum += generic[i].Dot(genericAxis);
+			DoNotOptimize(sum);
+		}
+		BENCHMARK_N(Vec4 Multiply Add, count)
+		{
+			for (size_t i = 0; i < count; i++)
+				named[i] = named[i] * 0.5f + axis;
+			ClobberMemory();
+		}
+		BENCHMARK_N(VecN Multiply Add, count)
+		{
+			const VecN<float, 4> genericAxis(axis);
+			for (size_t i = 0; i < count; i++)
+				generic[i] = generic[i] * 0.5f + genericAxis;
+			ClobberMemory();
+		}
+	}
+#pragma endregion
+
+#pragma region Random Benchmarks
+	NAMESPACE(Random_Generation)
+	{
+		Random random;
+		std::mt19937 twister;
+		std::uniform_real_distribution<float> distribution(-1.f, 1.f);
+		MathArray<Vec3f> directions(count);
+		MathArray<Quat> rotations(count);
+		BENCHMARK_N(mt19937 OnSphere, count)
+		{
+			for (size_t i = 0; i < count; i++)
+			{
+				Vec3f p;
+				do
+					p = Vec3f(distribution(twister), distribution(twister), distribution(twister));
+				while (p.LengthSquared() > 1.f || p.LengthSquared() < 1e-6f);
+				directions[i] = p.GetNormalize();
+			}
+			ClobberMemory();
+		}
+		BENCHMARK_N(Random OnSphere, count)
+		{
+			for (size_t i = 0; i < count; i++)
+				directions[i] = random.OnSphere();
+			ClobberMemory();
+		}
+		BENCHMARK_N(Random OnSphere Batch, count)
+		{
+			random.OnSphere(directions);
+			ClobberMemory();
+		}
+		BENCHMARK_N(Random InSphere Batch, count)
+		{
+			random.InSphere(directions);
+			ClobberMemory();
+		}
+		BENCHMARK_N(Random Rotation Batch, count)
+		{
+			random.Rotation(rotations);
+			ClobberMemory();
+		}
+	}
+#pragma endregion
+
+#pragma region Spline Benchmarks
+	NAMESPACE(Splines)
+	{
+		// 10K independent camera and animation curves, each at its own time
+		constexpr size_t curveCount = 10000;
+		Random random(3);
+		std::vector<CubicCurve<Vec3f>> curves(curveCount);
+		std::vector<float> times(curveCount);
+		std::vector<Vec3f> curvePoints(curveCount);
+		for (size_t i = 0; i < curveCount; i++)
+		{
+			curves[i] = CubicCurve<Vec3f>::CatmullRom(random.InSphere(), random.InSphere(), random.InSphere(), random.InSphere());
+			times[i] = random.NextFloat();
+		}
+		BENCHMARK_N(Evaluate Each 10K Curves, curveCount)
+		{
+			CubicCurve<Vec3f>::EvaluateEach(curves, times, curvePoints);
+			ClobberMemory();
+		}
+
+		const Spline<Vec3f> spline = Spline<Vec3f>::CatmullRom(std::span<const Vec3f>(points.data(), 16));
+		std::vector<float> parameters(count);
+		MathArray<Vec3f> sampled(count);
+		for (size_t i = 0; i < count; i++)
+			parameters[i] = i * 15.f / (count - 1);
+		BENCHMARK_N(Spline Evaluate, count)
+		{
+			spline.Evaluate(parameters, sampled);
+			ClobberMemory();
+		}
+		BENCHMARK_N(Spline Sample, count)
+		{
+			spline.Sample(sampled);
+			ClobberMemory();
+		}
+
+		const ArcLengthTable table(spline);
+		BENCHMARK_N(Arc Length Parameters, count)
+		{
+			table.GetParameters(parameters);
+			ClobberMemory();
+		}
+
+		std::vector<Quat> keys(16);
+		random.Rotation(keys);
+		const SquadSpline<float> squad(keys);
+		std::vector<Quat> rotations(count);
+		BENCHMARK_N(Squad Evaluate, count)
+		{
+			squad.Evaluate(parameters, rotations);
+			ClobberMemory();
+		}
+	}
+#pragma endregion
+
+#pragma region Animation Benchmarks
+	NAMESPACE(Animation)
+	{
+		// 100 characters of 100 bones playing one 2 second clip at 30 keys per second, each at its own time
+		constexpr size_t characters = 100, bones = 100, keyCount = 61;
+		Random random(11);
+		AnimationClip clip;
+		for (size_t bone = 0; bone < bones; bone++)
+		{
+			std::vector<Keyframe> keys(keyCount);
+			for (size_t k = 0; k < keyCount; k++)
+			{
+				keys[k].time = k / 30.f;
+				keys[k].translation = random.InSphere();
+				keys[k].rotation = random.Rotation();
+				keys[k].scale = Vec3f(1.f);
+			}
+			clip.AddTrack(keys);
+		}
+		std::vector<AnimationSampler> samplers(characters, AnimationSampler(clip));
+		std::vector<TransformSoA> poses(characters, TransformSoA(bones));
+		std::vector<std::vector<Keyframe>> scalarPoses(characters, std::vector<Keyframe>(bones));
+		std::vector<Mat4> matrices(bones);
+		float time = 0.f;
+		auto characterTime = [&](size_t character) { return std::fmod(time + character * 0.013f, 2.f); };
+
+		BENCHMARK_N(Scalar Search And SLerp, characters * bones)
+		{
+			time += 1.f / 60.f;
+			for (size_t character = 0; character < characters; character++)
+			{
+				const float t = characterTime(character);
+				for (size_t bone = 0; bone < bones; bone++)
+				{
+					const std::span<const Keyframe> keys = clip.GetTrack(bone);
+					size_t k = std::upper_bound(keys.begin(), keys.end(), t, [](float a, const Keyframe& b) { return a < b.time; }) - keys.begin() - 1;
+					k = std::min(k, keys.size() - 2);
+					const float w = (t - keys[k].time) / (keys[k + 1].time - keys[k].time);
+					Keyframe& pose = scalarPoses[character][bone];
+					pose.translation = keys[k].translation.Lerp(keys[k + 1].translation, w);
+					pose.rotation = Quat::SLerp(keys[k].rotation, keys[k + 1].rotation, w);
+					pose.scale = keys[k].scale.Lerp(keys[k + 1].scale, w);
+				}
+			}
+			ClobberMemory();
+		}
+		BENCHMARK_N(Sampler NLerp, characters * bones)
+		{
+			time += 1.f / 60.f;
+			for (size_t character = 0; character < characters; character++)
+				samplers[character].Sample(characterTime(character), poses[character], Interpolation::NLerp);
+			ClobberMemory();
+		}
+		BENCHMARK_N(Sampler SLerp, characters * bones)
+		{
+			time += 1.f / 60.f;
+			for (size_t character = 0; character < characters; character++)
+				samplers[character].Sample(characterTime(character), poses[character], Interpolation::SLerp);
+			ClobberMemory();
+		}
+		BENCHMARK_N(Local Matrices, bones)
+		{
+			poses[0].GetMatrices(matrices);
+			ClobberMemory();
+		}
+	}
+#pragma endregion
+
+#pragma region BVH Benchmarks
+	NAMESPACE(BVH)
+	{
+		// 200K small triangles in a ball, rays from a surrounding sphere towards its center
+		Random random(9);
+		std::vector<Triangle> triangles(200000);
+		for (Triangle& triangle : triangles)
+		{
+			const Vec3f center = random.InSphere() * 100.f;
+			triangle = { center + random.InSphere(), center + random.InSphere(), center + random.InSphere() };
+		}
+		std::vector<Ray> rays(4096);
+		for (Ray& ray : rays)
+		{
+			ray.origin = random.OnSphere() * 150.f;
+			ray.direction = random.InSphere() * 50.f - ray.origin;
+		}
+		std::vector<RayHit> hits(rays.size());
+		BVH4 bvh4(triangles);
+		BVH8 bvh8(triangles);
+
+		BENCHMARK_N(Build BVH8, triangles.size())
+		{
+			BVH8 bvh(triangles);
+			DoNotOptimize(bvh.GetNodeCount());
+		}
+		BENCHMARK_N(Closest Hit BVH4, rays.size())
+		{
+			for (size_t i = 0; i < rays.size(); i++)
+				bvh4.Intersect(rays[i], hits[i]);
+			ClobberMemory();
+		}
+		BENCHMARK_N(Closest Hit BVH8, rays.size())
+		{
+			for (size_t i = 0; i < rays.size(); i++)
+				bvh8.Intersect(rays[i], hits[i]);
+			ClobberMemory();
+		}
+		BENCHMARK_N(Any Hit BVH8, rays.size())
+		{
+			size_t occluded = 0;
+			for (const Ray& ray : rays)
+				occluded += bvh8.Occluded(ray);
+			DoNotOptimize(occluded);
+		}
+		std::vector<uint32_t> found;
+		BENCHMARK(Overlap BVH8)
+		{
+			found.clear();
+			bvh8.Overlap(AABB(Vec3f(-5.f), Vec3f(5.f)), found);
+			DoNotOptimize(found.size());
+		}
+	}
+#pragma endregion
+
+#pragma region Spatial Hash Benchmarks
+	NAMESPACE(Spatial_Hash)
+	{
+		// 1M points moving in a 100^3 box, one point per cell, rebuilt every frame
+		Random random(17);
+		std::vector<Vec3f> points(1000000), velocities(points.size());
+		random.InBox<Vec3f>(points, Vec3f(0.f), Vec3f(100.f));
+		random.InSphere(velocities);
+		std::vector<Vec3f> centers(10000);
+		random.InBox<Vec3f>(centers, Vec3f(0.f), Vec3f(100.f));
+		SpatialHash hash(1.f);
+		hash.Build(points);
+		std::vector<uint32_t> offsets, neighbours, nearest(centers.size() * 8);
+
+		BENCHMARK_N(Move And Rebuild 1M, points.size())
+		{
+			for (size_t i = 0; i < points.size(); i++)
+				points[i] += velocities[i] * 0.016f;
+			hash.Build(points);
+		}
+		BENCHMARK_N(Radius Queries, centers.size())
+		{
+			hash.QueryRadius(centers, 1.f, offsets, neighbours);
+			DoNotOptimize(neighbours.size());
+		}
+		BENCHMARK_N(Nearest 8, centers.size())
+		{
+			hash.QueryNearest(centers, 8, FLT_MAX, nearest);
+			ClobberMemory();
+		}
+
+		// The distance loop over every point it replaces, on 10K points at the same density
+		std::vector<Vec3f> few(points.begin(), points.begin() + 10000);
+		for (Vec3f& point : few)
+			point = point * 0.2154f;
+		SpatialHash fewHash(1.f);
+		fewHash.Build(few);
+		BENCHMARK_N(Brute Force Radius 10K, 100)
+		{
+			size_t found = 0;
+			for (size_t q = 0; q < 100; q++)
+			{
+				for (const Vec3f& point : few)
+					found += point.Distance(few[q]) <= 1.f;
+			}
+			DoNotOptimize(found);
+		}
+		BENCHMARK_N(Hash Radius 10K, 100)
+		{
+			size_t found = 0;
+			for (size_t q = 0; q < 100; q++)
+				fewHash.ForEachInRadius(few[q], 1.f, [&](uint32_t, float) { found++; });
+			DoNotOptimize(found);
+		}
+	}
+#pragma endregion
+
+#pragma region Space Curve Benchmarks
+	NAMESPACE(Space_Curves)
+	{
+		Random random(44);
+		std::vector<Vec3f> points(1000000);
+		random.InBox<Vec3f>(points, Vec3f(0.f), Vec3f(100.f));
+		const AABB bounds{ Vec3f(0.f), Vec3f(100.f) };
+		std::vector<uint32_t> codes(points.size()), order(points.size());
+		std::vector<uint64_t> codes63(points.size());
+
+		BENCHMARK_N(Morton 30 1M, points.size())
+		{
+			MortonEncode(points, bounds, std::span(codes));
+			ClobberMemory();
+		}
+		BENCHMARK_N(Morton 63 1M, points.size())
+		{
+			MortonEncode(points, bounds, std::span(codes63));
+			ClobberMemory();
+		}
+		BENCHMARK_N(Hilbert 30 1M, points.size())
+		{
+			HilbertEncode(points, bounds, std::span(codes));
+			ClobberMemory();
+		}
+
+		// Sorting the indices by key, against std::sort of key and index pairs
+		MortonEncode(points, bounds, std::span(codes));
+		std::vector<uint32_t> keys(codes.size());
+		BENCHMARK_N(Radix Sort 1M, points.size())
+		{
+			std::copy(codes.begin(), codes.end(), keys.begin());
+			std::iota(order.begin(), order.end(), 0u);
+			RadixSort(std::span(keys), std::span(order));
+			ClobberMemory();
+		}
+		std::vector<std::pair<uint32_t, uint32_t>> pairs(codes.size());
+		BENCHMARK_N(std::sort 1M, points.size())
+		{
+			for (size_t i = 0; i < codes.size(); i++)
+				pairs[i] = { codes[i], static_cast<uint32_t>(i) };
+			std::sort(pairs.begin(), pairs.end());
+			ClobberMemory();
+		}
+
+		// Building a hash over points in random order, then in Morton order
+		std::vector<Vec3f> sorted(points.size());
+		SortAlongCurve(points, order);
+		for (size_t i = 0; i < order.size(); i++)
+			sorted[i] = points[order[i]];
+		SpatialHash hash(1.f);
+		BENCHMARK_N(Hash Build Random Order, points.size())
+		{
+			hash.Build(points);
+		}
+		BENCHMARK_N(Hash Build Morton Order, sorted.size())
+		{
+			hash.Build(sorted);
+		}
+	}
+#pragma endregion
+
+#pragma region Collision Benchmarks
+	NAMESPACE(Collision)
+	{
+		Random random(45);
+		std::vector<Vec3f> cloud(10000);
+		random.InSphere(cloud);
+		BENCHMARK_N(Quickhull 10K, cloud.size())
+		{
+			ConvexHull hull(cloud);
+			DoNotOptimize(hull.GetTriangleCount());
+		}
+
+		// Support search over a 1000 vertex hull, SIMD against the plain loop
+		std::vector<Vec3f> sphere(1000);
+		random.OnSphere(sphere);
+		const ConvexHull ball(sphere);
+		std::vector<Vec3f> directions(1000);
+		random.OnSphere(directions);
+		BENCHMARK_N(Support 1000 Vertices, directions.size())
+		{
+			uint32_t sum = 0;
+			for (const Vec3f& direction : directions)
+				sum += ball.GetSupport(direction);
+			DoNotOptimize(sum);
+		}
+		BENCHMARK_N(Support 1000 Vertices Scalar, directions.size())
+		{
+			uint32_t sum = 0;
+			std::span<const Vec3f> vertices = ball.GetVertices();
+			for (const Vec3f& direction : directions)
+			{
+				float best = -FLT_MAX;
+				uint32_t index = 0;
+				for (uint32_t i = 0; i < vertices.size(); i++)
+				{
+					const float dot = vertices[i].Dot(direction);
+					if (dot > best)
+					{
+						best = dot;
+						index = i;
+					}
+				}
+				sum += index;
+			}
+			DoNotOptimize(sum);
+		}
+
+		// 10K boxes and 32 vertex rocks in a field, the pairs of neighbours about half of which touch
+		const std::vector<Vec3f> corners = { Vec3f(-0.5f, -0.5f, -0.5f), Vec3f(0.5f, -0.5f, -0.5f), Vec3f(-0.5f, 0.5f, -0.5f), Vec3f(0.5f, 0.5f, -0.5f), Vec3f(-0.5f, -0.5f, 0.5f), Vec3f(0.5f, -0.5f, 0.5f), Vec3f(-0.5f, 0.5f, 0.5f), Vec3f(0.5f, 0.5f, 0.5f) };
+		const ConvexHull cube(corners);
+		std::vector<Vec3f> rockPoints(32);
+		random.OnSphere(rockPoints);
+		for (Vec3f& p : rockPoints)
+			p = p * 0.6f;
+		const ConvexHull rock(rockPoints);
+		std::vector<ConvexShape> shapes(10000);
+		for (size_t i = 0; i < shapes.size(); i++)
+			shapes[i] = ConvexShape(i % 2 ? rock : cube, random.InBox(Vec3f(0.f), Vec3f(20.f)), random.Rotation());
+		std::vector<std::pair<uint32_t, uint32_t>> pairs;
+		for (uint32_t i = 0; i < shapes.size(); i++)
+		{
+			for (uint32_t k = 0; k < 4; k++)
+			{
+				const uint32_t other = random.NextUInt() % shapes.size();
+				shapes[other].position = shapes[i].position + random.InSphere() * 1.3f;
+				pairs.emplace_back(i, other);
+			}
+		}
+		std::vector<uint32_t> touching;
+		std::vector<Contact> contacts;
+		BENCHMARK_N(GJK Distance Pairs, pairs.size())
+		{
+			size_t separated = 0;
+			for (const auto& pair : pairs)
+			{
+				ClosestPoints result;
+				separated += ComputeDistance(shapes[pair.first], shapes[pair.second], result);
+			}
+			DoNotOptimize(separated);
+		}
+		BENCHMARK_N(Collide Pairs, pairs.size())
+		{
+			CollidePairs(shapes, pairs, touching, contacts);
+			DoNotOptimize(contacts.size());
+		}
+	}
+#pragma endregion
+
+#pragma region Geometry Query Benchmarks
+	NAMESPACE(Geometry_Queries)
+	{
+		Random random(47);
+		std::vector<Triangle> triangles(10000);
+		for (Triangle& triangle : triangles)
+		{
+			const Vec3f center = random.InBox(Vec3f(-10.f), Vec3f(10.f));
+			triangle = { center + random.InSphere(), center + random.InSphere(), center + random.InSphere() };
+		}
+		const TriangleSoA soa(triangles);
+		std::vector<float> distances(triangles.size());
+		const Vec3f query(1.f, 2.f, 3.f);
+		BENCHMARK_N(Point To 10K Triangles Scalar, triangles.size())
+		{
+			for (size_t i = 0; i < triangles.size(); i++)
+				distances[i] = DistanceSquared(query, triangles[i]);
+			DoNotOptimize(distances.data());
+		}
+		BENCHMARK_N(Point To 10K Triangles SoA, triangles.size())
+		{
+			DistanceSquared(query, soa, distances);
+			DoNotOptimize(distances.data());
+		}
+		BENCHMARK_N(Find Closest Of 10K Triangles, triangles.size())
+		{
+			Vec3f closest;
+			DoNotOptimize(FindClosest(query, soa, closest));
+		}
+
+		// 100K points against one triangle
+		std::vector<Vec3f> points(100000);
+		random.InBox(std::span<Vec3f>(points), Vec3f(-3.f), Vec3f(3.f));
+		const Vec3SoA<float> input(points);
+		Vec3SoA<float> output;
+		std::vector<Vec3f> closest(points.size());
+		BENCHMARK_N(Closest Point 100K Scalar, points.size())
+		{
+			for (size_t i = 0; i < points.size(); i++)
+				closest[i] = ClosestPoint(points[i], triangles[0]);
+			DoNotOptimize(closest.data());
+		}
+		BENCHMARK_N(Closest Point 100K SoA, points.size())
+		{
+			ClosestPoint(input, triangles[0], output);
+			DoNotOptimize(output.x.data());
+		}
+	}
+#pragma endregion
+
+#pragma region Solver Benchmarks
+	NAMESPACE(Solvers)
+	{
+		// 10K independent 3x3 and 6x6 systems, one at a time against lanes
+		Random random(49);
+		auto makeSystems = [&]<size_t N>(std::vector<Mat<float, N, N>>& matrices, std::vector<VecN<float, N>>& b, std::vector<VecN<float, N>>& x)
+		{
+			matrices.resize(10000);
+			b.resize(matrices.size());
+			x.resize(matrices.size());
+			for (size_t i = 0; i < matrices.size(); i++)
+			{
+				for (size_t c = 0; c < N; c++)
+				{
+					for (size_t r = 0; r < N; r++)
+						matrices[i][c][r] = random.Range(-1.f, 1.f);
+					b[i][c] = random.Range(-1.f, 1.f);
+				}
+			}
+		};
+		std::vector<Mat3f> matrices3;
+		std::vector<VecN<float, 3>> b3, x3;
+		makeSystems(matrices3, b3, x3);
+		std::vector<Mat<float, 6, 6>> matrices6;
+		std::vector<VecN<float, 6>> b6, x6;
+		makeSystems(matrices6, b6, x6);
+
+		BENCHMARK_N(Solve 3x3 Scalar, matrices3.size())
+		{
+			for (size_t i = 0; i < matrices3.size(); i++)
+				Solve(matrices3[i], b3[i], x3[i]);
+			DoNotOptimize(x3.data());
+		}
+		BENCHMARK_N(Solve 3x3 Batch, matrices3.size())
+		{
+			SolveBatch<float, 3>(matrices3, b3, x3);
+			DoNotOptimize(x3.data());
+		}
+		BENCHMARK_N(Solve 6x6 Scalar, matrices6.size())
+		{
+			for (size_t i = 0; i < matrices6.size(); i++)
+				Solve(matrices6[i], b6[i], x6[i]);
+			DoNotOptimize(x6.data());
+		}
+		BENCHMARK_N(Solve 6x6 Batch, matrices6.size())
+		{
+			SolveBatch<float, 6>(matrices6, b6, x6);
+			DoNotOptimize(x6.data());
+		}
+
+		for (Mat<float, 6, 6>& m : matrices6)
+			m = m.GetTranspose() * m + Mat<float, 6, 6>(1.f);
+		BENCHMARK_N(Cholesky 6x6 Scalar, matrices6.size())
+		{
+			for (size_t i = 0; i < matrices6.size(); i++)
+			{
+				Mat<float, 6, 6> lower;
+				DecomposeCholesky(matrices6[i], lower);
+				x6[i] = SolveCholesky(lower, b6[i]);
+			}
+			DoNotOptimize(x6.data());
+		}
+		BENCHMARK_N(Cholesky 6x6 Batch, matrices6.size())
+		{
+			SolveCholeskyBatch<float, 6>(matrices6, b6, x6);
+			DoNotOptimize(x6.data());
+		}
+		// Rotations of a 1000 bone palette with non uniform scale
+		std::vector<Mat4f> palette(1000);
+		for (Mat4f& transform : palette)
+			transform = Mat4::CreateTransformMatrix(random.InBox(Vec3f(-5.f), Vec3f(5.f)), random.Rotation(), random.InBox(Vec3f(0.2f), Vec3f(3.f)));
+		std::vector<Quat> rotations(palette.size());
+		std::vector<Mat3f> stretches(palette.size());
+		BENCHMARK_N(Gram Schmidt Decomposition 1000, palette.size())
+		{
+			Vec3f translation, scale;
+			for (size_t i = 0; i < palette.size(); i++)
+				palette[i].DecomposeTransformMatrix(translation, rotations[i], scale);
+			DoNotOptimize(rotations.data());
+		}
+		BENCHMARK_N(Polar Decomposition 1000 Scalar, palette.size())
+		{
+			for (size_t i = 0; i < palette.size(); i++)
+				DecomposePolar(palette[i], rotations[i], stretches[i]);
+			DoNotOptimize(rotations.data());
+		}
+		BENCHMARK_N(Polar Decomposition 1000 Batch, palette.size())
+		{
+			DecomposePolar(palette, rotations, stretches);
+			DoNotOptimize(rotations.data());
+		}
+		BENCHMARK_N(Jacobi 3x3, matrices3.size())
+		{
+			VecN<float, 3> values;
+			Mat3f vectors;
+			for (const Mat3f& m : matrices3)
+			{
+				DecomposeSymmetric(m, values, vectors);
+				DoNotOptimize(values);
+			}
+		}
+	}
+#pragma endregion
+
+#pragma region Camera Benchmarks
+	NAMESPACE(Camera)
+	{
+		// 300 cameras of which one moves per frame
+		Random random(50);
+		std::vector<Camera> cameras(300);
+		std::vector<Vec3f> positions(cameras.size());
+		std::vector<Quat> rotations(cameras.size());
+		for (size_t i = 0; i < cameras.size(); i++)
+		{
+			positions[i] = random.InBox(Vec3f(-50.f), Vec3f(50.f));
+			rotations[i] = random.Rotation();
+			cameras[i].SetPosition(positions[i]);
+			cameras[i].SetRotation(rotations[i]);
+		}
+		size_t frame = 0;
+		BENCHMARK_N(Camera 300 Cached, cameras.size())
+		{
+			const size_t moved = frame++ % cameras.size();
+			positions[moved].x += 0.01f;
+			for (size_t i = 0; i < cameras.size(); i++)
+			{
+				cameras[i].SetPosition(positions[i]);
+				cameras[i].SetRotation(rotations[i]);
+				DoNotOptimize(cameras[i].GetViewProjectionMatrix());
+				DoNotOptimize(cameras[i].GetFrustum());
+			}
+		}
+		BENCHMARK_N(Camera 300 Recomputed, cameras.size())
+		{
+			for (size_t i = 0; i < cameras.size(); i++)
+			{
+				const Mat4 viewProjection = Mat4::CreateProjectionMatrix(60.f, 1.f, 0.1f, 1000.f) * Mat4::CreateViewMatrix(positions[i], rotations[i]);
+				const Frustum frustum = Frustum::FromMatrix(viewProjection);
+				DoNotOptimize(viewProjection);
+				DoNotOptimize(frustum);
+			}
+		}
+		BENCHMARK_N(Camera Moved Every Frame, 1)
+		{
+			positions[0].x += 0.01f;
+			cameras[0].SetPosition(positions[0]);
+			DoNotOptimize(cameras[0].GetViewProjectionMatrix());
+			DoNotOptimize(cameras[0].GetFrustum());
+		}
+		BENCHMARK(Inverse Projection Generic)
+		{
+			DoNotOptimize(Mat4::CreateProjectionMatrix(60.f, 1.5f, 0.1f, 1000.f).CreateInverseMatrix());
+		}
+		BENCHMARK(Inverse Projection Closed Form)
+		{
+			DoNotOptimize(Projection::CreatePerspective(60.f, 1.5f, 0.1f, 1000.f).inverse);
+		}
+
+		// Depth reconstruction of a 256x256 buffer
+		constexpr size_t width = 256, height = 256;
+		std::vector<float> depth(width * height);
+		for (float& value : depth)
+			value = random.NextFloat();
+		std::vector<Vec3f> reconstructed(depth.size());
+		const Mat4 viewProjection = cameras[0].GetViewProjectionMatrix();
+		BENCHMARK_N(Unproject Depth 256x256 Scalar, depth.size())
+		{
+			const Mat4 inverse = viewProjection.CreateInverseMatrix();
+			for (size_t y = 0; y < height; y++)
+			{
+				for (size_t x = 0; x < width; x++)
+				{
+					Vec4f point = inverse * Vec4f((x + 0.5f) / width * 2.f - 1.f, 1.f - (y + 0.5f) / height * 2.f, depth[y * width + x], 1.f);
+					point.Homogenize();
+					reconstructed[y * width + x] = Vec3f(point);
+				}
+			}
+			DoNotOptimize(reconstructed.data());
+		}
+		BENCHMARK_N(Unproject Depth 256x256 Batch, depth.size())
+		{
+			UnprojectDepth(cameras[0].GetInverseViewProjectionMatrix(), width, height, depth, reconstructed);
+			DoNotOptimize(reconstructed.data());
+		}
+
+		// 100K points through a view projection to a 1920x1080 screen
+		const Viewport viewport{ 1920.f, 1080.f };
+		std::vector<Vec3f> cloud(100000), screen(cloud.size());
+		std::vector<uint8_t> flags(cloud.size());
+		for (Vec3f& point : cloud)
+			point = random.InBox(Vec3f(-100.f), Vec3f(100.f));
+		BENCHMARK_N(Project To Screen 100K Scalar, cloud.size())
+		{
+			for (size_t i = 0; i < cloud.size(); i++)
+			{
+				Vec4f clip = viewProjection * Vec4f(cloud[i], 1.f);
+				flags[i] = (clip.x < -clip.w) | (clip.x > clip.w) << 1 | (clip.y < -clip.w) << 2 | (clip.y > clip.w) << 3 | (clip.z < -clip.w) << 4 | (clip.z > clip.w) << 5;
+				clip.Homogenize();
+				screen[i] = Vec3f((clip.x + 1.f) * 960.f, (1.f - clip.y) * 540.f, clip.z);
+			}
+			DoNotOptimize(screen.data());
+		}
+		BENCHMARK_N(Project To Screen 100K Batch, cloud.size())
+		{
+			ProjectToScreen(viewProjection, viewport, cloud, screen, flags);
+			DoNotOptimize(screen.data());
+		}
+		ScreenTiles tiles;
+		BENCHMARK_N(Bin To Tiles 100K, cloud.size())
+		{
+			BinToTiles(screen, flags, viewport, 64, tiles);
+			DoNotOptimize(tiles.indices.data());
+		}
+	}
+#pragma endregion
+
+#pragma region Expression Benchmarks
+	NAMESPACE(Expression)
+	{
+		// result = a + b * s - c over 1024 Vec3f
+		MathArray<Vec3f> a(points), b(rotated), c(points), result(count);
+		MathArray<Vec3f> scaled(count), sum(count);
+		Vec3SoA<float> sa(a), sb(b), sc(c), soaResult(count);
+		BENCHMARK_N(Eager Arrays, count)
+		{
+			// one pass and one temporary array per operator
+			for (size_t i = 0; i < count; i++)
+				scaled[i] = b[i] * 2.5f;
+			for (size_t i = 0; i < count; i++)
+				sum[i] = a[i] + scaled[i];
+			for (size_t i = 0; i < count; i++)
+				result[i] = sum[i] - c[i];
+			ClobberMemory();
+		}
+		BENCHMARK_N(Fused Arrays, count)
+		{
+			Evaluate(Lazy(a) + Lazy(b) * 2.5f - Lazy(c), result);
+			ClobberMemory();
+		}
+		BENCHMARK_N(Fused Structure Of Arrays, count)
+		{
+			Evaluate(Lazy(sa) + Lazy(sb) * 2.5f - Lazy(sc), soaResult);
+			ClobberMemory();
+		}
+	}
+#pragma endregion
+
+#pragma region Math Array Benchmarks
+	NAMESPACE(Math_Array)
+	{
+		FrameArena arena;
+		BENCHMARK(Frame Array)
+		{
+			arena.Reset();
+			FrameArray<Vec3f> temporary(count, Vec3f(), ArenaAllocator<Vec3f>(arena));
+			DoNotOptimize(temporary.data());
+		}
+		BENCHMARK(Std Vector)
+		{
+			std::vector<Vec3f> temporary(count);
+			DoNotOptimize(temporary.data());
+		}
+	}
+#pragma endregion
+}
+
+int main(int argc, char** argv) {
+	system("cls");   // used to clear and enable color on Windows
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::string(argv[i]).rfind("--fuzz-scale=", 0) == 0)
+			VFuzz::caseScale = std::stod(std::string(argv[i]).substr(13));
+	}
+	int failures = runTests(ParseRunOptions(argc, argv));
+	VFuzz::PrintReport();
+#ifdef MATH_INSTRUMENT
+	std::cout << Instrument::Report();
+#endif
 	system("pause"); // used to pause at the end on Windows;
-	return 0;
+	return failures == 0 ? 0 : 1;
 }
\ No newline at end of file
@@ -3,6 +3,21 @@ add_rules("plugin.vsxmake.autoupdate")
 
 add_requires("glm")
 
+option("deterministic")
+    set_default(false)
+    set_showmenu(true)
+    set_description("Bit-exact math across compilers and platforms (MATH_DETERMINISTIC)")
+    add_defines("MATH_DETERMINISTIC")
+    add_cxflags("gcc::-ffp-contract=off", "clang::-ffp-contract=off", "cl::/fp:precise")
+option_end()
+
+option("instrument")
+    set_default(false)
+    set_showmenu(true)
+    set_description("Per function call counters and sampled cycle timings (MATH_INSTRUMENT)")
+    add_defines("MATH_INSTRUMENT")
+option_end()
+
 target("GalaxyMath")
     set_languages("c++20")
     set_kind("binary")
@@ -12,4 +27,24 @@ target("GalaxyMath")
     add_files("main.cpp")
 
     add_packages("glm")
+    if is_plat("linux") then
+        add_syslinks("pthread")
+    end
+    add_options("deterministic", "instrument")
+target_end()
+
+-- The collision tests again with every float expression contracted to FMA, as -march=native builds get by default:
+-- the GJK and EPA tolerances have to hold up to the fused rounding
+target("GalaxyMathContract")
+    set_languages("c++20")
+    set_kind("binary")
+    add_includedirs("include")
+    add_files("main.cpp")
+    add_cxflags("gcc::-ffp-contract=fast", "clang::-ffp-contract=fast", "gcc::-march=native", "clang::-march=native", "cl::/fp:contract", "cl::/arch:AVX2")
+    set_runargs("MATH_TEST/Collision")
+
+    add_packages("glm")
+    if is_plat("linux") then
+        add_syslinks("pthread")
+    end
 target_end()
\ No newline at end of file